@@ -26,10 +26,165 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdlib.h>
 #include "intervals.h"
 
+/* The tree is a red-black tree keyed on the low value of each interval. The
+   usual red-black invariants (no red node has a red child, and every path from
+   a node to its leaves has the same number of black nodes) keep its height at
+   most 2*log2(n+1). NULL children count as black leaves. */
+
 static int check_overlap(Interval *a, Interval *b) {
 	return (a->low <= b->high && b->low <= a->high);
 }
 
+static int is_red(Interval *node) {
+	return (node != NULL && node->red);
+}
+
+static void rotate_left(Interval **root, Interval *node) {
+	Interval *pivot = node->right_child;
+
+	node->right_child = pivot->left_child;
+	if (pivot->left_child) {
+		pivot->left_child->parent = node;
+	}
+	pivot->parent = node->parent;
+	if (!node->parent) {
+		*root = pivot;
+	} else if (node == node->parent->left_child) {
+		node->parent->left_child = pivot;
+	} else {
+		node->parent->right_child = pivot;
+	}
+	pivot->left_child = node;
+	node->parent = pivot;
+}
+
+static void rotate_right(Interval **root, Interval *node) {
+	Interval *pivot = node->left_child;
+
+	node->left_child = pivot->right_child;
+	if (pivot->right_child) {
+		pivot->right_child->parent = node;
+	}
+	pivot->parent = node->parent;
+	if (!node->parent) {
+		*root = pivot;
+	} else if (node == node->parent->right_child) {
+		node->parent->right_child = pivot;
+	} else {
+		node->parent->left_child = pivot;
+	}
+	pivot->right_child = node;
+	node->parent = pivot;
+}
+
+/* Restore the red-black invariants after a red node was added as a leaf */
+static void insert_fixup(Interval **root, Interval *node) {
+	Interval *parent, *grandparent, *uncle;
+
+	while ((parent = node->parent) != NULL && parent->red) {
+		grandparent = parent->parent;
+		if (parent == grandparent->left_child) {
+			uncle = grandparent->right_child;
+			if (is_red(uncle)) {
+				parent->red = 0;
+				uncle->red = 0;
+				grandparent->red = 1;
+				node = grandparent;
+				continue;
+			}
+			if (node == parent->right_child) {
+				rotate_left(root, parent);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->red = 0;
+			grandparent->red = 1;
+			rotate_right(root, grandparent);
+		} else {
+			uncle = grandparent->left_child;
+			if (is_red(uncle)) {
+				parent->red = 0;
+				uncle->red = 0;
+				grandparent->red = 1;
+				node = grandparent;
+				continue;
+			}
+			if (node == parent->left_child) {
+				rotate_right(root, parent);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->red = 0;
+			grandparent->red = 1;
+			rotate_left(root, grandparent);
+		}
+	}
+	(*root)->red = 0;
+}
+
+/* Restore the red-black invariants after a black node was removed. The child
+   that took its place may be NULL, so its parent is passed in separately. */
+static void remove_fixup(Interval **root, Interval *child, Interval *parent) {
+	Interval *sibling;
+
+	while (child != *root && !is_red(child)) {
+		if (child == parent->left_child) {
+			sibling = parent->right_child;
+			if (is_red(sibling)) {
+				sibling->red = 0;
+				parent->red = 1;
+				rotate_left(root, parent);
+				sibling = parent->right_child;
+			}
+			if (!is_red(sibling->left_child) && !is_red(sibling->right_child)) {
+				sibling->red = 1;
+				child = parent;
+				parent = child->parent;
+			} else {
+				if (!is_red(sibling->right_child)) {
+					sibling->left_child->red = 0;
+					sibling->red = 1;
+					rotate_right(root, sibling);
+					sibling = parent->right_child;
+				}
+				sibling->red = parent->red;
+				parent->red = 0;
+				sibling->right_child->red = 0;
+				rotate_left(root, parent);
+				child = *root;
+			}
+		} else {
+			sibling = parent->left_child;
+			if (is_red(sibling)) {
+				sibling->red = 0;
+				parent->red = 1;
+				rotate_right(root, parent);
+				sibling = parent->left_child;
+			}
+			if (!is_red(sibling->left_child) && !is_red(sibling->right_child)) {
+				sibling->red = 1;
+				child = parent;
+				parent = child->parent;
+			} else {
+				if (!is_red(sibling->left_child)) {
+					sibling->right_child->red = 0;
+					sibling->red = 1;
+					rotate_left(root, sibling);
+					sibling = parent->left_child;
+				}
+				sibling->red = parent->red;
+				parent->red = 0;
+				sibling->left_child->red = 0;
+				rotate_right(root, parent);
+				child = *root;
+			}
+		}
+	}
+	if (child) {
+		child->red = 0;
+	}
+}
+
 Interval *alloc_interval(uint32_t start, uint32_t count) {
 	Interval *i;
 	i = calloc(1, sizeof (Interval));
@@ -47,10 +202,19 @@ void free_interval(Interval *node) {
 int insert_interval(Interval **root, Interval *node) {
 	Interval *current;
 
+	node->parent = NULL;
+	node->left_child = NULL;
+	node->right_child = NULL;
+	node->red = 1;
+
 	if (*root == NULL) {
+		node->red = 0;
 		*root = node;
 		return INTERVAL_SUCCESS;
 	}
+
+	/* The insertion path passes through both the predecessor and successor of
+	   the new node, so checking each node along the way finds any overlap */
 	current = *root;
 	while (1) {
 		if (check_overlap(current, node)) {
@@ -75,54 +239,78 @@ int insert_interval(Interval **root, Interval *node) {
 		}
 	}
 
+	insert_fixup(root, node);
+
 	return INTERVAL_SUCCESS;
 }
 
 Interval *remove_interval(Interval **root, Interval *node) {
-	Interval *snip, *child;
+	Interval *snip, *child, *parent;
+	int snip_was_red;
 
-	/* If the node to remove does not have two children, we will snip it,
-	   otherwise we will swap it with its successor and snip that one */
+	/* If the node to remove does not have two children, we will snip it.
+	   Otherwise we snip its successor (which has no left child) and move the
+	   successor into the position of the node being removed. */
 	if (!node->left_child || !node->right_child) {
 		snip = node;
 	} else {
-		snip = next_interval(node);
+		snip = minimum_interval(node->right_child);
 	}
+	snip_was_red = snip->red;
 
-	/* If the node to snip has a child, make its parent link point to the snipped
-	   node's parent */
+	/* Link the snipped node's only child (if any) to the snipped node's parent */
 	if (snip->left_child) {
 		child = snip->left_child;
 	} else {
 		child = snip->right_child;
 	}
+	parent = snip->parent;
 	if (child) {
-		child->parent = snip->parent;
+		child->parent = parent;
 	}
-
-	/* If the snipped node has no parent, it is the root node and we use the
-	   provided root pointer to point to the child. Otherwise, we find if the
-	   snipped node was a left or right child and set the appropriate link in the
-	   parent node */
-	if (!snip->parent) {
+	if (!parent) {
 		*root = child;
-	} else if (snip == snip->parent->left_child) {
-		snip->parent->left_child = child;
+	} else if (snip == parent->left_child) {
+		parent->left_child = child;
 	} else {
-		snip->parent->right_child = child;
+		parent->right_child = child;
 	}
 
-	/* Swap the contents of the node passed in to remove with the one chosen to be
-	   snipped */
+	/* Relink the successor in place of the node being removed, taking over its
+	   children and color so the tree shape is unchanged */
 	if (snip != node) {
-		void *old_data = node->data;
-		node->low = snip->low;
-		node->high = snip->high;
-		node->data = snip->data;
-		snip->data = old_data;
+		if (parent == node) {
+			parent = snip;
+		}
+		snip->parent = node->parent;
+		snip->left_child = node->left_child;
+		snip->right_child = node->right_child;
+		snip->red = node->red;
+		if (snip->left_child) {
+			snip->left_child->parent = snip;
+		}
+		if (snip->right_child) {
+			snip->right_child->parent = snip;
+		}
+		if (!node->parent) {
+			*root = snip;
+		} else if (node == node->parent->left_child) {
+			node->parent->left_child = snip;
+		} else {
+			node->parent->right_child = snip;
+		}
 	}
 
-	return snip;
+	if (!snip_was_red && *root) {
+		remove_fixup(root, child, parent);
+	}
+
+	node->parent = NULL;
+	node->left_child = NULL;
+	node->right_child = NULL;
+	node->red = 0;
+
+	return node;
 }
 
 Interval *minimum_interval(Interval *root) {
@@ -182,33 +370,30 @@ Interval *prev_interval(Interval *node) {
 }
 
 Interval *search_interval(Interval *root, uint32_t start, uint32_t count) {
-	Interval *current, *test;
+	Interval *current, *lowest;
 	Interval i;
 
 	i.low = start;
 	i.high = start + count - 1;
-	current = root;
 
-	while (current && !check_overlap(current, &i)) {
-		if (current->low > i.low) {
+	/* The intervals do not overlap, so their high values are in the same order
+	   as their low values. The lowest matching interval (if any) is the first
+	   one that ends at or after the start of the search range. */
+	lowest = NULL;
+	current = root;
+	while (current) {
+		if (current->high >= i.low) {
+			lowest = current;
 			current = current->left_child;
 		} else {
 			current = current->right_child;
 		}
 	}
 
-	/* Make sure we really are returning the first (lowest) matching interval. */
-	if (current) {
-		for (test = prev_interval(current);
-			test != NULL && check_overlap(test, &i);
-			test = prev_interval(test))
-		{
-			/* We found a lower interval that also matches the search parameters. */
-			current = test;
-		}
+	if (lowest && check_overlap(lowest, &i)) {
+		return lowest;
 	}
-
-	return current;
+	return NULL;
 }
 
 void traverse_interval(Interval *root, Visitor action) {
@@ -26,9 +26,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 /**
  * @file
  *
- * @brief Augmented Binary Search Tree for Intervals
+ * @brief Red-Black Tree for Intervals
  *
- * This library will keep track of non-overlapping intervals in the uint32 range
+ * This library will keep track of non-overlapping intervals in the uint32 range.
+ * The tree is kept balanced, so insert, remove, and search are O(log n) even
+ * when intervals are added in increasing order.
  *
  * It supports insert, remove, minimum, maximum, next, previous, search, and
  * traverse operations. All updates occur in-place.
@@ -78,6 +80,7 @@ struct interval_node {
 	Interval *parent;      /**< Pointer to the parent of the current tree, or NULL if this is the root node */
 	Interval *left_child;  /**< Pointer to a subtree with smaller intervals, or NULL if none */
 	Interval *right_child; /**< Pointer to a subtree with larger intervals, or NULL if none */
+	int red;               /**< Node color used to keep the tree balanced (non-zero for red) */
 };
 
 /**
@@ -129,9 +132,9 @@ int insert_interval(Interval **root, Interval *node);
 /**
  * Remove an Interval from the set of tracked Intervals.
  *
- * @note Because the actual node removed from the tree might not be the same
- * as the one passed in, the return value MUST be stored and used to free the
- * Interval that was removed from the set.
+ * @note The node passed in is the one removed from the tree. The remaining
+ * nodes are relinked but keep their contents, so pointers to them stay valid.
+ * The return value is kept for compatibility and is always the node passed in.
  *
  * @param root The address of the pointer to the root of the set of Intervals
  *
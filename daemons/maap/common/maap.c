@@ -244,32 +244,186 @@ static int inform_yielded(Maap_Client *mc, const void *sender, int id, Range *ra
 
 static void start_timer(Maap_Client *mc) {
 
-	if (mc->timer_queue) {
-		Time_setTimer(mc->timer, &mc->timer_queue->next_act_time);
+	if (mc->timer_count > 0) {
+		Time_setTimer(mc->timer, &mc->timer_queue[0]->next_act_time);
 	}
 }
 
 static void remove_range_interval(Interval **root, Interval *node) {
 	Range *old_range = node->data;
-	Interval *free_inter, *test_inter;
+	Interval *free_inter;
 
 	/* Remove and free the interval from the set of intervals.
-	 * Note that the interval freed may not be the same one supplied. */
+	 * The tree relinks the remaining nodes rather than moving their contents,
+	 * so the other ranges still point to the intervals that hold them. */
 	assert(!old_range || old_range->interval == node);
 	free_inter = remove_interval(root, node);
-	assert(free_inter->data == old_range);
+	assert(free_inter == node);
 	free_interval(free_inter);
+}
+
+
+/* The timer queue is a binary min-heap ordered by expiration time.
+ * Each range keeps its position in the heap, so it can be rescheduled or
+ * removed without searching for it. */
+
+static int timer_earlier(const Range *a, const Range *b) {
+	int cmp = Time_cmp(&a->next_act_time, &b->next_act_time);
+	if (cmp != 0) {
+		return (cmp < 0);
+	}
+	/* Equal times are handled in the order they were scheduled. */
+	return ((int) (a->timer_order - b->timer_order) < 0);
+}
+
+static void timer_heap_set(Maap_Client *mc, int index, Range *range) {
+	mc->timer_queue[index] = range;
+	range->timer_index = index;
+}
+
+static void timer_heap_sift_up(Maap_Client *mc, int index) {
+	Range *range = mc->timer_queue[index];
+
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+		if (!timer_earlier(range, mc->timer_queue[parent])) {
+			break;
+		}
+		timer_heap_set(mc, index, mc->timer_queue[parent]);
+		index = parent;
+	}
+	timer_heap_set(mc, index, range);
+}
+
+static void timer_heap_sift_down(Maap_Client *mc, int index) {
+	Range *range = mc->timer_queue[index];
+
+	while (1) {
+		int child = index * 2 + 1;
+		if (child >= mc->timer_count) {
+			break;
+		}
+		if (child + 1 < mc->timer_count &&
+			timer_earlier(mc->timer_queue[child + 1], mc->timer_queue[child])) {
+			child++;
+		}
+		if (!timer_earlier(mc->timer_queue[child], range)) {
+			break;
+		}
+		timer_heap_set(mc, index, mc->timer_queue[child]);
+		index = child;
+	}
+	timer_heap_set(mc, index, range);
+}
+
+static void timer_heap_remove(Maap_Client *mc, Range *range) {
+	int index = range->timer_index;
+	Range *last;
+
+	if (index < 0) {
+		return;
+	}
+	assert(index < mc->timer_count && mc->timer_queue[index] == range);
+
+	range->timer_index = -1;
+	last = mc->timer_queue[--(mc->timer_count)];
+	if (last != range) {
+		/* Move the last entry into the hole, and restore the heap order. */
+		timer_heap_set(mc, index, last);
+		timer_heap_sift_up(mc, index);
+		timer_heap_sift_down(mc, last->timer_index);
+	}
+}
+
+
+/* All the ranges (including released ranges waiting for their timers to
+ * elapse) are tracked in a hash table indexed by identifier, so requests for
+ * a specific range do not need to search every range. */
+
+static Range **id_bucket(Maap_Client *mc, int id) {
+	return &mc->id_table[(unsigned int) id & (unsigned int) (mc->id_table_size - 1)];
+}
 
-	/* Make sure the remaining ranges point to the intervals that hold them.
-	 * This is necessary as the Range object may have moved to a different node. */
-	for (test_inter = minimum_interval(*root); test_inter != NULL; test_inter = next_interval(test_inter)) {
-		Range *range = test_inter->data;
-		assert(range);
-		assert(range != old_range);
-		if (range->interval != test_inter) {
-			range->interval = test_inter;
+static int track_range(Maap_Client *mc, Range *range) {
+	Range **bucket;
+
+	/* Make sure there is room in the timer queue, so scheduling never fails.
+	 * Each tracked range uses at most one entry in the timer queue. */
+	if (mc->range_count >= mc->timer_size) {
+		int new_size = (mc->timer_size ? mc->timer_size * 2 : 64);
+		Range **new_queue = realloc(mc->timer_queue, new_size * sizeof(Range *));
+		if (new_queue == NULL) {
+			return -1;
+		}
+		mc->timer_queue = new_queue;
+		mc->timer_size = new_size;
+	}
+
+	/* Grow the hash table to keep the chains short. */
+	if (mc->range_count >= mc->id_table_size) {
+		int i, new_size = (mc->id_table_size ? mc->id_table_size * 2 : 64);
+		Range **new_table = calloc(new_size, sizeof(Range *));
+		if (new_table) {
+			for (i = 0; i < mc->id_table_size; ++i) {
+				Range *rp, *next;
+				for (rp = mc->id_table[i]; rp != NULL; rp = next) {
+					next = rp->next_id;
+					bucket = &new_table[(unsigned int) rp->id & (unsigned int) (new_size - 1)];
+					rp->next_id = *bucket;
+					*bucket = rp;
+				}
+			}
+			free(mc->id_table);
+			mc->id_table = new_table;
+			mc->id_table_size = new_size;
+		} else if (mc->id_table == NULL) {
+			return -1;
 		}
+		/* Otherwise keep using the smaller table. */
 	}
+
+	range->timer_index = -1;
+	bucket = id_bucket(mc, range->id);
+	range->next_id = *bucket;
+	*bucket = range;
+	mc->range_count++;
+
+	return 0;
+}
+
+static void untrack_range(Maap_Client *mc, Range *range) {
+	Range **link;
+
+	timer_heap_remove(mc, range);
+
+	for (link = id_bucket(mc, range->id); *link != NULL; link = &(*link)->next_id) {
+		if (*link == range) {
+			*link = range->next_id;
+			range->next_id = NULL;
+			mc->range_count--;
+			return;
+		}
+	}
+	assert(0);
+}
+
+/* Find a range with the specified identifier that has not been released.
+ * If defending_only is set, only a range in the DEFENDING state is returned. */
+static Range *find_range(Maap_Client *mc, int id, int defending_only) {
+	Range *range;
+
+	if (mc->id_table == NULL) {
+		return NULL;
+	}
+	for (range = *id_bucket(mc, id); range != NULL; range = range->next_id) {
+		if (range->id != id || range->state == MAAP_STATE_RELEASED) {
+			continue;
+		}
+		if (!defending_only || range->state == MAAP_STATE_DEFENDING) {
+			return range;
+		}
+	}
+	return NULL;
 }
 
 
@@ -475,6 +629,12 @@ int maap_init_client(Maap_Client *mc, const void *sender, uint64_t range_address
 	mc->range_len = range_len;
 	mc->ranges = NULL;
 	mc->timer_queue = NULL;
+	mc->timer_count = 0;
+	mc->timer_size = 0;
+	mc->timer_order = 0;
+	mc->id_table = NULL;
+	mc->id_table_size = 0;
+	mc->range_count = 0;
 	mc->maxid = 0;
 	mc->notifies = NULL;
 
@@ -488,11 +648,22 @@ int maap_init_client(Maap_Client *mc, const void *sender, uint64_t range_address
 
 void maap_deinit_client(Maap_Client *mc) {
 	if (mc->initialized) {
-		while (mc->timer_queue) {
-			Range * pDel = mc->timer_queue;
-			mc->timer_queue = mc->timer_queue->next_timer;
+		int i;
+
+		/* Free the released ranges, which are no longer in the interval tree. */
+		for (i = 0; i < mc->timer_count; ++i) {
+			Range * pDel = mc->timer_queue[i];
 			if (pDel->state == MAAP_STATE_RELEASED) { free(pDel); }
 		}
+		free(mc->timer_queue);
+		mc->timer_queue = NULL;
+		mc->timer_count = 0;
+		mc->timer_size = 0;
+
+		free(mc->id_table);
+		mc->id_table = NULL;
+		mc->id_table_size = 0;
+		mc->range_count = 0;
 
 		while (mc->ranges) {
 			Range *range = mc->ranges->data;
@@ -523,7 +694,6 @@ int rand_ms(int variation) {
 }
 
 int schedule_timer(Maap_Client *mc, Range *range) {
-	Range *rp, *prev_rp;
 	unsigned long long int ns;
 	Time ts;
 
@@ -563,55 +733,23 @@ int schedule_timer(Maap_Client *mc, Range *range) {
 #endif
 	}
 
-	/* Remove the range from the timer queue, if it is already in it. */
-	if (mc->timer_queue == range) {
-		/* Range was at the front of the queue. */
-		mc->timer_queue = range->next_timer;
-	} else if (mc->timer_queue) {
-		/* Search the rest of the queue. */
-		prev_rp = mc->timer_queue;
-		rp = prev_rp->next_timer;
-		while (rp && rp != range) {
-			prev_rp = rp;
-			rp = rp->next_timer;
-		}
-		if (rp) {
-			/* Range was found.  Remove it. */
-			prev_rp->next_timer = rp->next_timer;
-			rp->next_timer = NULL;
-		}
-	}
-
-	/* Add the range to the timer queue. */
-	if (mc->timer_queue == NULL ||
-		Time_cmp(&range->next_act_time, &mc->timer_queue->next_act_time) < 0) {
-		range->next_timer = mc->timer_queue;
-		mc->timer_queue = range;
-	} else {
-		rp = mc->timer_queue;
-		while (rp->next_timer &&
-			Time_cmp(&rp->next_timer->next_act_time, &range->next_act_time) <= 0)
-		{
-			rp = rp->next_timer;
-		}
-		range->next_timer = rp->next_timer;
-		rp->next_timer = range;
+	/* Add the range to the timer queue, or move it if it is already in it. */
+	range->timer_order = mc->timer_order++;
+	if (range->timer_index < 0) {
+		assert(mc->timer_count < mc->timer_size);
+		timer_heap_set(mc, mc->timer_count++, range);
 	}
+	timer_heap_sift_up(mc, range->timer_index);
+	timer_heap_sift_down(mc, range->timer_index);
 
 #ifdef DEBUG_TIMER_MSG
-	/* Perform a sanity test on the timer queue. */
+	/* Perform a sanity test on the timer queue entries around the range. */
 	{
-		Range *test = mc->timer_queue;
-		int i;
-		for (i = 0; test && i < 100000; ++i) {
-			assert(test->next_timer != test);
-			assert(test->next_timer == NULL || Time_cmp(&test->next_act_time, &test->next_timer->next_act_time) <= 0);
-			test = test->next_timer;
-		}
-		if (test) {
-			MAAP_LOG_ERROR("Timer infinite loop detected!");
-			assert(0);
-		}
+		int i = range->timer_index;
+		assert(i >= 0 && i < mc->timer_count && mc->timer_queue[i] == range);
+		assert(i == 0 || !timer_earlier(range, mc->timer_queue[(i - 1) / 2]));
+		assert(i * 2 + 1 >= mc->timer_count || !timer_earlier(mc->timer_queue[i * 2 + 1], range));
+		assert(i * 2 + 2 >= mc->timer_count || !timer_earlier(mc->timer_queue[i * 2 + 2], range));
 	}
 #endif
 
@@ -690,12 +828,19 @@ int maap_reserve_range(Maap_Client *mc, const void *sender, uint64_t attempt_bas
 	Time_setFromMonotonicTimer(&range->next_act_time);
 	range->interval = NULL;
 	range->sender = sender;
-	range->next_timer = NULL;
+	range->next_id = NULL;
+
+	if (track_range(mc, range) < 0) {
+		inform_not_acquired(mc, sender, -1, length, MAAP_NOTIFY_ERROR_OUT_OF_MEMORY);
+		free(range);
+		return -1;
+	}
 
 	if (assign_interval(mc, range, attempt_base, length) < 0)
 	{
 		/* Cannot find any available intervals of the requested size. */
 		inform_not_acquired(mc, sender, -1, length, MAAP_NOTIFY_ERROR_RESERVE_NOT_AVAILABLE);
+		untrack_range(mc, range);
 		free(range);
 		return -1;
 	}
@@ -723,24 +868,21 @@ int maap_release_range(Maap_Client *mc, const void *sender, int id) {
 		return -1;
 	}
 
-	range = mc->timer_queue;
-	while (range) {
-		if (range->id == id && range->state != MAAP_STATE_RELEASED) {
-			inform_released(mc, sender, id, range, MAAP_NOTIFY_ERROR_NONE);
-			if (sender != range->sender)
-			{
-				/* Also inform the sender that originally reserved this range. */
-				inform_released(mc, range->sender, id, range, MAAP_NOTIFY_ERROR_NONE);
-			}
+	range = find_range(mc, id, 0);
+	if (range) {
+		inform_released(mc, sender, id, range, MAAP_NOTIFY_ERROR_NONE);
+		if (sender != range->sender)
+		{
+			/* Also inform the sender that originally reserved this range. */
+			inform_released(mc, range->sender, id, range, MAAP_NOTIFY_ERROR_NONE);
+		}
 
-			iv = range->interval;
-			remove_range_interval(&mc->ranges, iv);
-			/* memory for range will be freed the next time its timer elapses */
-			range->state = MAAP_STATE_RELEASED;
+		iv = range->interval;
+		remove_range_interval(&mc->ranges, iv);
+		/* memory for range will be freed the next time its timer elapses */
+		range->state = MAAP_STATE_RELEASED;
 
-			return 0;
-		}
-		range = range->next_timer;
+		return 0;
 	}
 
 	MAAP_LOGF_DEBUG("Range id %d does not exist to release", id);
@@ -758,13 +900,10 @@ void maap_range_status(Maap_Client *mc, const void *sender, int id)
 		return;
 	}
 
-	range = mc->timer_queue;
-	while (range) {
-		if (range->id == id && range->state == MAAP_STATE_DEFENDING) {
-			inform_status(mc, sender, id, range, MAAP_NOTIFY_ERROR_NONE);
-			return;
-		}
-		range = range->next_timer;
+	range = find_range(mc, id, 1);
+	if (range) {
+		inform_status(mc, sender, id, range, MAAP_NOTIFY_ERROR_NONE);
+		return;
 	}
 
 	MAAP_LOGF_DEBUG("Range id %d does not exist", id);
@@ -782,21 +921,18 @@ int maap_yield_range(Maap_Client *mc, const void *sender, int id) {
 		return -1;
 	}
 
-	range = mc->timer_queue;
-	while (range) {
-		if (range->id == id && range->state == MAAP_STATE_DEFENDING) {
-			// Create a conflicting packet for this range.
-			// Use a source address which will always be less than our address, so we should always yield.
-			init_packet(&announce_packet, 0x010000000000ull, 0x010000000000ull);
-			announce_packet.message_type = MAAP_ANNOUNCE;
-			announce_packet.requested_start_address = get_start_address(mc, range);
-			announce_packet.requested_count = get_count(mc, range);
-			pack_maap(&announce_packet, announce_buffer);
-			maap_handle_packet(mc, announce_buffer, MAAP_NET_BUFFER_SIZE);
-
-			return 0;
-		}
-		range = range->next_timer;
+	range = find_range(mc, id, 1);
+	if (range) {
+		// Create a conflicting packet for this range.
+		// Use a source address which will always be less than our address, so we should always yield.
+		init_packet(&announce_packet, 0x010000000000ull, 0x010000000000ull);
+		announce_packet.message_type = MAAP_ANNOUNCE;
+		announce_packet.requested_start_address = get_start_address(mc, range);
+		announce_packet.requested_count = get_count(mc, range);
+		pack_maap(&announce_packet, announce_buffer);
+		maap_handle_packet(mc, announce_buffer, MAAP_NET_BUFFER_SIZE);
+
+		return 0;
 	}
 
 	MAAP_LOGF_DEBUG("Range id %d does not exist", id);
@@ -969,11 +1105,15 @@ int maap_handle_packet(Maap_Client *mc, const uint8_t *stream, int len) {
 					Time_setFromMonotonicTimer(&new_range->next_act_time);
 					new_range->interval = NULL;
 					new_range->sender = range->sender;
-					new_range->next_timer = NULL;
-					if (assign_interval(mc, new_range, 0, range_size) < 0)
+					new_range->next_id = NULL;
+					if (track_range(mc, new_range) < 0) {
+						inform_yielded(mc, range->sender, range->id, range, MAAP_NOTIFY_ERROR_OUT_OF_MEMORY);
+						free(new_range);
+					} else if (assign_interval(mc, new_range, 0, range_size) < 0)
 					{
 						/* Cannot find any available intervals of the requested size. */
 						inform_yielded(mc, range->sender, range->id, range, MAAP_NOTIFY_ERROR_RESERVE_NOT_AVAILABLE);
+						untrack_range(mc, new_range);
 						free(new_range);
 					} else {
 #ifdef DEBUG_NEGOTIATE_MSG
@@ -1036,12 +1176,12 @@ int maap_handle_timer(Maap_Client *mc) {
 	MAAP_LOGF_DEBUG("maap_handle_timer called at:  %s", Time_dump(&currenttime));
 #endif
 
-	while ((range = mc->timer_queue) && Time_passed(&currenttime, &range->next_act_time)) {
+	while (mc->timer_count > 0 && Time_passed(&currenttime, &mc->timer_queue[0]->next_act_time)) {
+		range = mc->timer_queue[0];
 #ifdef DEBUG_TIMER_MSG
 		MAAP_LOGF_DEBUG("Due timer:  %s", Time_dump(&range->next_act_time));
 #endif
-		mc->timer_queue = range->next_timer;
-		range->next_timer = NULL;
+		timer_heap_remove(mc, range);
 
 		if (range->state == MAAP_STATE_PROBING) {
 #ifdef DEBUG_TIMER_MSG
@@ -1057,6 +1197,7 @@ int maap_handle_timer(Maap_Client *mc) {
 #ifdef DEBUG_TIMER_MSG
 			MAAP_LOG_DEBUG("Freeing released timer");
 #endif
+			untrack_range(mc, range);
 			free(range);
 		}
 
@@ -1071,7 +1212,7 @@ int64_t maap_get_delay_to_next_timer(Maap_Client *mc)
 {
 	long long int timeRemaining;
 
-	if (!(mc->timer) || !(mc->timer_queue))
+	if (!(mc->timer) || mc->timer_count == 0)
 	{
 		/* There are no timers waiting, so wait for an hour.
 		 * (No particular reason; it just sounded reasonable.) */
@@ -91,7 +91,9 @@ struct range {
 	Time next_act_time; /**< Next time to perform an action for this range */
 	Interval *interval; /**< Interval information for the range */
 	const void *sender; /**< Sender information pointer for the entity that requested the range */
-	Range *next_timer;  /**< Next range in the list */
+	int timer_index;    /**< Position of this range in the timer queue, or -1 if it is not queued */
+	unsigned int timer_order; /**< Scheduling order, used to keep timers with equal times in FIFO order */
+	Range *next_id;     /**< Next range in the same identifier hash bucket */
 };
 
 
@@ -102,8 +104,14 @@ typedef struct {
 	uint64_t address_base;      /**< Starting address of the recognized range of addresses (typically #MAAP_DYNAMIC_POOL_BASE) */
 	uint32_t range_len;         /**< Number of recognized addresses (typically #MAAP_DYNAMIC_POOL_SIZE) */
 	Interval *ranges;           /**< Pointer to the root of the #Interval tree, which contains all the Range structures */
-	Range *timer_queue;         /**< Pointer to a linked list of ranges that need timer support,
-								 * with the first timer to expire being first in the list */
+	Range **timer_queue;        /**< Binary min-heap of ranges that need timer support,
+								 * with the first timer to expire at index 0 (NULL until first used) */
+	int timer_count;            /**< Number of ranges in the timer queue */
+	int timer_size;             /**< Number of entries allocated for the timer queue */
+	unsigned int timer_order;   /**< Counter used to set the scheduling order of each range */
+	Range **id_table;           /**< Hash table of all the tracked ranges, indexed by identifier */
+	int id_table_size;          /**< Number of buckets in the identifier hash table (a power of 2) */
+	int range_count;            /**< Number of ranges in the identifier hash table */
 	Timer *timer;               /**< Pointer to the platform-specific timing support (initialized by calling #Time_newTimer) */
 	Net *net;                   /**< Pointer to the platform-specific networking support (initialized by calling #Net_newNet) */
 	int maxid;                  /**< Identifier value of the latest reservation */
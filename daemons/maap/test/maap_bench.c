@@ -0,0 +1,237 @@
+/*************************************************************************************
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************************/
+
+/*
+ * Benchmark for the MAAP range bookkeeping.
+ *
+ * Reserves a large number of adjacent address ranges, runs the probe and
+ * announce timers until all of them are defended, and then releases them.
+ * The per-operation latency of each phase is reported, which shows how the
+ * interval tree and timer queue scale with the number of ranges.
+ *
+ * Uses the dummy timer, so no real time passes between timer events.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define random() rand()
+#define srandom(s) srand(s)
+#endif
+
+#include "maap.h"
+#include "maap_net.h"
+#include "maap_timer_dummy.h"
+
+#define DEFAULT_RANGES  100000
+#define RANGE_SIZE      16
+#define BENCH_POOL_SIZE 0x1000000
+
+typedef struct {
+	const char *name;
+	long long ops;
+	long long calls;
+	double total_ns;
+	double max_ns;
+} Bench_Stats;
+
+static double now_ns(void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER count;
+	if (freq.QuadPart == 0) { QueryPerformanceFrequency(&freq); }
+	QueryPerformanceCounter(&count);
+	return (double) count.QuadPart * 1.0e9 / (double) freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec * 1.0e9 + (double) ts.tv_nsec;
+#endif
+}
+
+/* Record a call that started at start_ns and performed the specified number of operations. */
+static void add_sample(Bench_Stats *stats, double start_ns, int ops)
+{
+	double elapsed = now_ns() - start_ns;
+	stats->ops += ops;
+	stats->calls++;
+	stats->total_ns += elapsed;
+	if (elapsed > stats->max_ns) { stats->max_ns = elapsed; }
+}
+
+static void print_stats(const Bench_Stats *stats)
+{
+	printf("%-8s %8lld ops %8lld calls %8.0f ns/op avg %10.0f ns/call max %7.3f s total\n",
+		stats->name, stats->ops, stats->calls,
+		(stats->ops ? stats->total_ns / (double) stats->ops : 0.0),
+		stats->max_ns, stats->total_ns / 1.0e9);
+}
+
+/* Discard the notifications and packets generated by the last operation.
+ * Returns the number of packets sent, and optionally the number of ranges acquired. */
+static int drain(Maap_Client *mc, Maap_Notify_Error *last_error, int *acquired)
+{
+	Maap_Notify mn;
+	void *packet;
+	int packets = 0;
+
+	while (get_notify(mc, NULL, &mn)) {
+		if (last_error) { *last_error = mn.result; }
+		if (acquired && mn.kind == MAAP_NOTIFY_ACQUIRED && mn.result == MAAP_NOTIFY_ERROR_NONE) { (*acquired)++; }
+	}
+	while ((packet = Net_getNextQueuedPacket(mc->net)) != NULL) {
+		Net_freeQueuedPacket(mc->net, packet);
+		packets++;
+	}
+	return packets;
+}
+
+/* Run the timers until none are left, as each released range is freed when
+ * its timer elapses. */
+static void run_all_timers(Maap_Client *mc, Bench_Stats *stats)
+{
+	int64_t delay;
+	double start;
+	int count;
+
+	while (mc->timer_count > 0) {
+		delay = maap_get_delay_to_next_timer(mc);
+		if (delay > 0) { Time_increaseNanos((uint64_t) delay); }
+
+		count = mc->timer_count;
+		start = now_ns();
+		maap_handle_timer(mc);
+		add_sample(stats, start, count - mc->timer_count);
+		drain(mc, NULL, NULL);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	Maap_Client mc;
+	Maap_Notify_Error result;
+	Bench_Stats reserve = { "reserve", 0, 0, 0.0, 0.0 };
+	Bench_Stats probe = { "timers", 0, 0, 0.0, 0.0 };
+	Bench_Stats release = { "release", 0, 0, 0.0, 0.0 };
+	Bench_Stats cleanup = { "cleanup", 0, 0, 0.0, 0.0 };
+	int *ids;
+	int num_ranges = DEFAULT_RANGES;
+	int i, acquired, sender = 1;
+	double start;
+
+	if (argc > 1) {
+		num_ranges = atoi(argv[1]);
+		if (num_ranges <= 0 || (long long) num_ranges * RANGE_SIZE > BENCH_POOL_SIZE) {
+			fprintf(stderr, "Usage:  %s [number of ranges (1-%d)]\n", argv[0], BENCH_POOL_SIZE / RANGE_SIZE);
+			return 1;
+		}
+	}
+
+	srandom(1);
+	ids = calloc(num_ranges, sizeof(int));
+	if (!ids) {
+		fprintf(stderr, "Error:  Out of memory\n");
+		return 1;
+	}
+
+	memset(&mc, 0, sizeof(Maap_Client));
+	mc.dest_mac = 0x91E0F000FF00LL;
+	mc.src_mac = 0x0123456789abLL;
+	if (maap_init_client(&mc, &sender, MAAP_DYNAMIC_POOL_BASE, BENCH_POOL_SIZE) < 0) {
+		fprintf(stderr, "Error:  maap_init_client failed\n");
+		return 1;
+	}
+	drain(&mc, NULL, NULL);
+
+	printf("Reserving %d ranges of %d addresses\n", num_ranges, RANGE_SIZE);
+
+	/* Request adjacent ranges in increasing order, which is the worst case for
+	 * an unbalanced tree of intervals. */
+	for (i = 0; i < num_ranges; ++i) {
+		start = now_ns();
+		ids[i] = maap_reserve_range(&mc, &sender, MAAP_DYNAMIC_POOL_BASE + (uint64_t) i * RANGE_SIZE, RANGE_SIZE);
+		add_sample(&reserve, start, 1);
+		drain(&mc, NULL, NULL);
+		if (ids[i] < 0) {
+			fprintf(stderr, "Error:  Reservation %d failed\n", i);
+			return 1;
+		}
+	}
+
+	/* Run the probe timers until every range is acquired.
+	 * Each range sends one packet for each of its timer events. */
+	for (acquired = 0; acquired < num_ranges; ) {
+		int64_t delay = maap_get_delay_to_next_timer(&mc);
+		if (delay > 0) { Time_increaseNanos((uint64_t) delay); }
+		start = now_ns();
+		maap_handle_timer(&mc);
+		add_sample(&probe, start, 0);
+		probe.ops += drain(&mc, NULL, &acquired);
+	}
+	printf("%d ranges acquired after %lld timer events\n", acquired, probe.ops);
+
+	/* Release the ranges in random order. */
+	for (i = num_ranges - 1; i > 0; --i) {
+		int j = random() % (i + 1);
+		int tmp = ids[i];
+		ids[i] = ids[j];
+		ids[j] = tmp;
+	}
+	for (i = 0; i < num_ranges; ++i) {
+		start = now_ns();
+		maap_release_range(&mc, &sender, ids[i]);
+		add_sample(&release, start, 1);
+		result = MAAP_NOTIFY_ERROR_NONE;
+		drain(&mc, &result, NULL);
+		if (result != MAAP_NOTIFY_ERROR_NONE) {
+			fprintf(stderr, "Error:  Release of range id %d failed\n", ids[i]);
+			return 1;
+		}
+	}
+	if (mc.ranges != NULL) {
+		fprintf(stderr, "Error:  Ranges remain after releasing all of them\n");
+		return 1;
+	}
+
+	/* Let the timers for the released ranges elapse, which frees them. */
+	run_all_timers(&mc, &cleanup);
+
+	printf("\n");
+	print_stats(&reserve);
+	print_stats(&probe);
+	print_stats(&release);
+	print_stats(&cleanup);
+
+	maap_deinit_client(&mc);
+	free(ids);
+
+	return 0;
+}
@@ -37,6 +37,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define INTERVALS_TO_ADD     1000
 #define INTERVALS_TO_REPLACE 100000
 #define INTERVALS_TO_SEARCH  10000
+#define INTERVALS_SEQUENTIAL 100000
 
 uint32_t last_high = 0;
 int total = 0;
@@ -52,6 +53,37 @@ void print_node(Interval *node) {
 	total++;
 }
 
+/* Returns the black height of the subtree, or -1 if the red-black invariants
+   or the parent links are broken. */
+int check_tree(Interval *node) {
+	int left, right;
+
+	if (node == NULL) {
+		return 0;
+	}
+	if ((node->left_child && node->left_child->parent != node) ||
+		(node->right_child && node->right_child->parent != node)) {
+		fprintf(stderr, "\nError:  Bad parent link at <%d,%d>\n", node->low, node->high);
+		return -1;
+	}
+	if (node->red &&
+		((node->left_child && node->left_child->red) ||
+		 (node->right_child && node->right_child->red))) {
+		fprintf(stderr, "\nError:  Red node <%d,%d> has a red child\n", node->low, node->high);
+		return -1;
+	}
+	left = check_tree(node->left_child);
+	right = check_tree(node->right_child);
+	if (left < 0 || right < 0) {
+		return -1;
+	}
+	if (left != right) {
+		fprintf(stderr, "\nError:  Unbalanced black height at <%d,%d>\n", node->low, node->high);
+		return -1;
+	}
+	return left + (node->red ? 0 : 1);
+}
+
 int main(void) {
 	Interval *set = NULL, *inter, *over, *prev;
 	int i, rv, count;
@@ -81,6 +113,39 @@ int main(void) {
 		free_interval(inter);
 	}
 
+	count = INTERVALS_SEQUENTIAL;
+	printf("\nInserting %d sequential intervals into a set\n", count);
+
+	for (i = 0; i < count; i++) {
+		inter = alloc_interval(i * 16, 16);
+		rv = insert_interval(&set, inter);
+		if (rv != INTERVAL_SUCCESS) {
+			fprintf(stderr, "Error:  Insert of [%d,%d] failed unexpectedly\n", inter->low, inter->high);
+			return 1; /* Error */
+		}
+	}
+	if (check_tree(set) < 0 || set->red) {
+		return 1; /* Error */
+	}
+
+	/* Remove every other interval, then the rest */
+	for (i = 0; i < count; i += 2) {
+		inter = search_interval(set, i * 16, 1);
+		if (inter == NULL || inter->low != (uint32_t) i * 16) {
+			fprintf(stderr, "Error:  Search for sequential interval %d failed\n", i);
+			return 1; /* Error */
+		}
+		free_interval(remove_interval(&set, inter));
+	}
+	if (check_tree(set) < 0) {
+		return 1; /* Error */
+	}
+	while (set) {
+		inter = remove_interval(&set, set);
+		free_interval(inter);
+	}
+	printf("Sequential insert and remove testing passed\n");
+
 	count = INTERVALS_TO_ADD;
 	printf("\nInserting %d random intervals into a set\n", count);
 
@@ -120,6 +185,10 @@ int main(void) {
 			if (over) over = remove_interval(&set, over);
 		}
 	}
+	if (check_tree(set) < 0) {
+		return 1; /* Error */
+	}
+	printf("\n" "Red-black tree checks passed\n");
 
 	/* Test that searches always return the first match */
 	for (i = 0; i < INTERVALS_TO_SEARCH; i++) {
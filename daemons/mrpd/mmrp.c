@@ -1402,28 +1402,12 @@ int mmrp_txpdu(void)
 	return -1;
 }
 
-int mmrp_send_notifications(struct mmrp_attribute *attrib, int notify)
+static int mmrp_format_notification(struct mmrp_attribute *attrib,
+				    int notify, char *msgbuf)
 {
-	char *msgbuf;
-	char *variant;
-	char *regsrc;
+	char variant[128];
+	char regsrc[128];
 	char mrp_state[8];
-	client_t *client;
-
-	if (NULL == attrib)
-		return -1;
-
-	msgbuf = (char *)malloc(MAX_MRPD_CMDSZ);
-	if (NULL == msgbuf)
-		return -1;
-
-	variant = regsrc = NULL;
-
-	variant = (char *)malloc(128);
-	regsrc = (char *)malloc(128);
-
-	if ((NULL == variant) || (NULL == regsrc))
-		goto free_msgbuf;
 
 	memset(msgbuf, 0, MAX_MRPD_CMDSZ);
 
@@ -1460,22 +1444,60 @@ int mmrp_send_notifications(struct mmrp_attribute *attrib, int notify)
 		snprintf(msgbuf, MAX_MRPD_CMDSZ - 1, "MLE %s %s %s\n",  variant, regsrc, mrp_state);
 		break;
 	default:
-		goto free_msgbuf;
-		break;
+		return -1;
 	}
 
+	return 0;
+}
+
+static void mmrp_bin_notification(struct mmrp_attribute *attrib, int notify,
+				  mrpd_bin_record_t *rec)
+{
+	mrp_bin_record_init(rec, 'M', notify, &attrib->registrar,
+			    &attrib->applicant);
+	rec->type = (uint8_t)attrib->type;
+	if (MMRP_SVCREQ_TYPE == attrib->type)
+		rec->value[0] = attrib->attribute.svcreq;
+	else
+		memcpy(rec->value, attrib->attribute.macaddr, 6);
+}
+
+int mmrp_send_notifications(struct mmrp_attribute *attrib, int notify)
+{
+	char msgbuf[MAX_MRPD_CMDSZ];
+	mrpd_bin_record_t rec;
+	int have_text = 0;
+	int have_bin = 0;
+	client_t *client;
+
+	if (NULL == attrib)
+		return -1;
+
+	if ((notify < MRP_NOTIFY_NEW) || (notify > MRP_NOTIFY_LV))
+		return 0;
+
+	/* each format is built at most once, and only if a client wants it */
 	client = MMRP_db->mrp_db.clients;
 	while (NULL != client) {
-		mrpd_send_ctl_msg(&(client->client), msgbuf, MAX_MRPD_CMDSZ);
+		if (mrp_client_is_binary(&client->client)) {
+			if (!have_bin) {
+				mmrp_bin_notification(attrib, notify, &rec);
+				have_bin = 1;
+			}
+			mrp_client_queue_binary(&client->client, &rec);
+		} else {
+			if (!have_text) {
+				if (mmrp_format_notification(attrib, notify,
+							     msgbuf))
+					return 0;
+				have_text = 1;
+			}
+			mrpd_send_ctl_msg(&(client->client), msgbuf,
+					  MAX_MRPD_CMDSZ);
+		}
 		client = client->next;
 	}
 
- free_msgbuf:
-	if (variant)
-		free(variant);
-	if (regsrc)
-		free(regsrc);
-	free(msgbuf);
 	return 0;
 }
 
@@ -349,6 +349,155 @@ int mrp_client_remove_all(client_t ** list)
 	return 0;
 }
 
+/*
+ * Clients that asked for binary notifications, each with the datagram
+ * being assembled for it.
+ */
+typedef struct bin_client_s {
+	struct bin_client_s *next;
+	struct sockaddr_in client;
+	int count;
+	unsigned char buf[MAX_MRPD_CMDSZ];
+} bin_client_t;
+
+static bin_client_t *bin_clients;
+
+static int client_match(struct sockaddr_in *a, struct sockaddr_in *b)
+{
+	return (a->sin_port == b->sin_port) &&
+	    (a->sin_addr.s_addr == b->sin_addr.s_addr);
+}
+
+static bin_client_t *bin_client_lookup(struct sockaddr_in *client)
+{
+	bin_client_t *item;
+
+	for (item = bin_clients; NULL != item; item = item->next) {
+		if (client_match(&item->client, client))
+			return item;
+	}
+	return NULL;
+}
+
+static void bin_client_flush(bin_client_t *item)
+{
+	mrpd_bin_hdr_t *hdr = (mrpd_bin_hdr_t *)item->buf;
+
+	if (0 == item->count)
+		return;
+
+	hdr->zero = 0;
+	hdr->version = MRPD_BIN_VERSION;
+	hdr->count[0] = (uint8_t)(item->count >> 8);
+	hdr->count[1] = (uint8_t)item->count;
+	mrpd_send_ctl_msg(&item->client, (char *)item->buf,
+			  (int)(sizeof(mrpd_bin_hdr_t) +
+				item->count * sizeof(mrpd_bin_record_t)));
+	item->count = 0;
+}
+
+int mrp_client_set_binary(struct sockaddr_in *client, int enable)
+{
+	bin_client_t *item;
+	bin_client_t **pprev;
+
+	if (NULL == client)
+		return -1;
+
+	if (enable) {
+		if (bin_client_lookup(client))
+			return 0;
+		item = (bin_client_t *)malloc(sizeof(bin_client_t));
+		if (NULL == item)
+			return -1;
+		item->client = *client;
+		item->count = 0;
+		item->next = bin_clients;
+		bin_clients = item;
+		return 0;
+	}
+
+	for (pprev = &bin_clients; NULL != *pprev; pprev = &(*pprev)->next) {
+		item = *pprev;
+		if (client_match(&item->client, client)) {
+			/* deliver whatever was already queued for it */
+			bin_client_flush(item);
+			*pprev = item->next;
+			free(item);
+			break;
+		}
+	}
+	return 0;
+}
+
+int mrp_client_is_binary(struct sockaddr_in *client)
+{
+	if (NULL == bin_clients)
+		return 0;
+	return NULL != bin_client_lookup(client);
+}
+
+int mrp_client_queue_binary(struct sockaddr_in *client, mrpd_bin_record_t *rec)
+{
+	bin_client_t *item;
+
+	item = bin_client_lookup(client);
+	if (NULL == item)
+		return -1;
+
+	if (item->count >= (int)MRPD_BIN_MAX_RECORDS)
+		bin_client_flush(item);
+
+	memcpy(item->buf + sizeof(mrpd_bin_hdr_t) +
+	       item->count * sizeof(mrpd_bin_record_t), rec,
+	       sizeof(mrpd_bin_record_t));
+	item->count++;
+	return 0;
+}
+
+void mrp_client_flush_binary(void)
+{
+	bin_client_t *item;
+
+	for (item = bin_clients; NULL != item; item = item->next)
+		bin_client_flush(item);
+}
+
+int mrp_client_format_cmd(char *buf, int buflen, struct sockaddr_in *client)
+{
+	char respbuf[16];
+	int rc = -1;
+
+	memset(respbuf, 0, sizeof(respbuf));
+
+	if ((buflen >= 3) && ('B' == buf[2])) {
+		if ('+' == buf[1])
+			rc = mrp_client_set_binary(client, 1);
+		else if ('-' == buf[1])
+			rc = mrp_client_set_binary(client, 0);
+	}
+
+	if (rc)
+		snprintf(respbuf, sizeof(respbuf) - 1, "ERP %.3s", buf);
+	else
+		snprintf(respbuf, sizeof(respbuf) - 1, "OK+");
+	mrpd_send_ctl_msg(client, respbuf, sizeof(respbuf));
+	return rc;
+}
+
+void mrp_bin_record_init(mrpd_bin_record_t *rec, char protocol, int notify,
+			 mrp_registrar_attribute_t *rattrib,
+			 mrp_applicant_attribute_t *aattrib)
+{
+	memset(rec, 0, sizeof(*rec));
+	rec->protocol = (uint8_t)protocol;
+	rec->notify = (uint8_t)notify;
+	rec->registrar_state = (uint8_t)rattrib->mrp_state;
+	rec->applicant_state = (uint8_t)aattrib->mrp_state;
+	memcpy(rec->registrar_mac, rattrib->macaddr,
+	       sizeof(rec->registrar_mac));
+}
+
 
 int mrp_jointimer_start(struct mrp_database *mrp_db)
 {
@@ -216,6 +216,21 @@ int mrp_client_add(client_t ** list, struct sockaddr_in *newclient);
 int mrp_client_delete(client_t ** list, struct sockaddr_in *newclient);
 int mrp_client_remove_all(client_t ** list);
 
+/*
+ * Per-client notification format. Binary records are batched per client
+ * and sent by mrp_client_flush_binary(), which the event loop calls once per
+ * wakeup, or earlier when a datagram fills up.
+ */
+int mrp_client_set_binary(struct sockaddr_in *client, int enable);
+int mrp_client_is_binary(struct sockaddr_in *client);
+int mrp_client_queue_binary(struct sockaddr_in *client,
+			    mrpd_bin_record_t *rec);
+void mrp_client_flush_binary(void);
+int mrp_client_format_cmd(char *buf, int buflen, struct sockaddr_in *client);
+void mrp_bin_record_init(mrpd_bin_record_t *rec, char protocol, int notify,
+			 mrp_registrar_attribute_t *rattrib,
+			 mrp_applicant_attribute_t *aattrib);
+
 int mrp_init(void);
 char *mrp_event_string(int e);
 int mrp_periodictimer_start();
@@ -47,6 +47,7 @@
 #include <sys/resource.h>
 #include <sys/mman.h>
 #include <sys/timerfd.h>
+#include <sys/epoll.h>
 #include <sys/user.h>
 #include <sys/socket.h>
 #include <linux/if.h>
@@ -115,10 +116,11 @@ extern struct msrp_database *MSRP_db;
 
 int mrpd_timer_create(void)
 {
-	int t = timerfd_create(CLOCK_MONOTONIC, 0);
-	if (-1 != t)
-		fcntl(t, F_SETFL, O_NONBLOCK);
-	return t;
+	/*
+	 * Non-blocking: a handler earlier in the same epoll batch may re-arm
+	 * or stop a timer, and the later acknowledging read must not block.
+	 */
+	return timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
 }
 
 void mrpd_timer_close(int t)
@@ -283,6 +285,8 @@ int process_ctl_msg(char *buf, int buflen, struct sockaddr_in *client)
 	 * I+S   Add a stream id to the interesting talker stream id list
 	 * I-S   Remove a stream id from the interesting talker stream id list
 	 * I-A   Remove all stream ids from the interesting talker and listener stream id lists
+	 * F+B   Send attribute notifications to this client in binary
+	 * F-B   Send attribute notifications to this client as text (default)
 	 *
 	 * Outbound messages
 	 * ERC - error, unrecognized command
@@ -337,10 +341,14 @@ int process_ctl_msg(char *buf, int buflen, struct sockaddr_in *client)
 	case 'I':
 		return msrp_recv_cmd(buf, buflen, client);
 		break;
+	case 'F':
+		return mrp_client_format_cmd(buf, buflen, client);
+		break;
 	case 'B':
 		mmrp_bye(client);
 		mvrp_bye(client);
 		msrp_bye(client);
+		mrp_client_set_binary(client, 0);
 		break;
 	default:
 		printf("unrecognized command %s\n", buf);
@@ -562,21 +570,58 @@ int init_timers(void)
 	return -1;
 }
 
-int mrp_register_timers(struct mrp_database *mrp_db, fd_set * fds)
+/*
+ * Every descriptor the daemon waits on is tagged with what it is, so one
+ * epoll_wait() wakeup dispatches straight to the right handler.
+ */
+enum {
+	MRPD_EV_CONTROL,
+	MRPD_EV_PERIODIC,
+	MRPD_EV_GC,
+	MRPD_EV_MMRP_RX,
+	MRPD_EV_MMRP_LVA,
+	MRPD_EV_MMRP_LV,
+	MRPD_EV_MMRP_JOIN,
+	MRPD_EV_MVRP_RX,
+	MRPD_EV_MVRP_LVA,
+	MRPD_EV_MVRP_LV,
+	MRPD_EV_MVRP_JOIN,
+	MRPD_EV_MSRP_RX,
+	MRPD_EV_MSRP_LVA,
+	MRPD_EV_MSRP_LV,
+	MRPD_EV_MSRP_JOIN,
+};
+
+#define MRPD_MAX_EVENTS	16
+
+static int mrpd_epoll_add(int epoll_fd, int fd, uint32_t tag)
 {
-	int max_fd;
-
-	FD_SET(mrp_db->join_timer, fds);
-	FD_SET(mrp_db->lv_timer, fds);
-	FD_SET(mrp_db->lva_timer, fds);
+	struct epoll_event ev;
 
-	max_fd = mrp_db->join_timer;
-	if (mrp_db->lv_timer > max_fd)
-		max_fd = mrp_db->lv_timer;
-	if (mrp_db->lva_timer > max_fd)
-		max_fd = mrp_db->lva_timer;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u64 = ((uint64_t)(uint32_t)fd << 32) | tag;
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+#if LOG_ERRORS
+		fprintf(stderr, "Error on epoll_ctl %s\r\n", strerror(errno));
+#endif
+		return -1;
+	}
+	return 0;
+}
 
-	return max_fd;
+/*
+ * lva, lv and join timers of one database, tagged with consecutive values
+ * starting at first_tag.
+ */
+int mrp_register_timers(struct mrp_database *mrp_db, int epoll_fd,
+			uint32_t first_tag)
+{
+	if (mrpd_epoll_add(epoll_fd, mrp_db->lva_timer, first_tag) ||
+	    mrpd_epoll_add(epoll_fd, mrp_db->lv_timer, first_tag + 1) ||
+	    mrpd_epoll_add(epoll_fd, mrp_db->join_timer, first_tag + 2))
+		return -1;
+	return 0;
 }
 
 int mrpd_reclaim()
@@ -598,192 +643,188 @@ int mrpd_reclaim()
 
 }
 
-void process_events(void)
+static void mrpd_timer_ack(int fd)
+{
+	uint64_t expirations;
+
+	/* clear the expiration so the level triggered fd goes quiet */
+	if (read(fd, &expirations, sizeof(expirations)) < 0 &&
+	    errno != EAGAIN) {
+#if LOG_ERRORS
+		fprintf(stderr, "Error reading timer %s\r\n", strerror(errno));
+#endif
+	}
+}
+
+static void mrpd_dispatch(uint32_t tag)
 {
+	switch (tag) {
+	case MRPD_EV_CONTROL:
+#if LOG_POLL_EVENTS
+		mrpd_log_printf("== EVENT recv_ctl_msg ==\n");
+#endif
+		recv_ctl_msg();
+		break;
+	case MRPD_EV_PERIODIC:
+#if LOG_POLL_EVENTS && LOG_TIMERS
+		mrpd_log_printf("== EVENT periodic_timer ==\n");
+#endif
+		mrp_periodictimer_fsm(&mrp_periodic_state, MRP_EVENT_PERIODIC);
+		if (mmrp_enable)
+			mmrp_event(MRP_EVENT_PERIODIC, NULL);
+		if (mvrp_enable)
+			mvrp_event(MRP_EVENT_PERIODIC, NULL);
+		if (msrp_enable)
+			msrp_event(MRP_EVENT_PERIODIC, NULL);
+		break;
+	case MRPD_EV_GC:
+		mrpd_reclaim();
+		break;
+	case MRPD_EV_MMRP_RX:
+#if LOG_POLL_EVENTS
+		mrpd_log_printf("== EVENT mmrp_recv_msg ==\n");
+#endif
+		mmrp_recv_msg();
+		break;
+	case MRPD_EV_MMRP_LVA:
+		mrpd_log_timer_event("MMRP", MRP_EVENT_LVATIMER);
+		mmrp_event(MRP_EVENT_LVATIMER, NULL);
+		break;
+	case MRPD_EV_MMRP_LV:
+		mrpd_log_timer_event("MMRP", MRP_EVENT_LVTIMER);
+		mmrp_event(MRP_EVENT_LVTIMER, NULL);
+		break;
+	case MRPD_EV_MMRP_JOIN:
+		mrpd_log_timer_event("MMRP", MRP_EVENT_TX);
+		mmrp_event(MRP_EVENT_TX, NULL);
+		break;
+	case MRPD_EV_MVRP_RX:
+#if LOG_POLL_EVENTS
+		mrpd_log_printf("== EVENT mvrp_recv_msg ==\n");
+#endif
+		mvrp_recv_msg();
+		break;
+	case MRPD_EV_MVRP_LVA:
+		mrpd_log_timer_event("MVRP", MRP_EVENT_LVATIMER);
+		mvrp_event(MRP_EVENT_LVATIMER, NULL);
+		break;
+	case MRPD_EV_MVRP_LV:
+		mrpd_log_timer_event("MVRP", MRP_EVENT_LVTIMER);
+		mvrp_event(MRP_EVENT_LVTIMER, NULL);
+		break;
+	case MRPD_EV_MVRP_JOIN:
+		mrpd_log_timer_event("MVRP", MRP_EVENT_TX);
+		mvrp_event(MRP_EVENT_TX, NULL);
+		break;
+	case MRPD_EV_MSRP_RX:
+#if LOG_POLL_EVENTS
+		mrpd_log_printf("== EVENT msrp_recv_msg ==\n");
+#endif
+		msrp_recv_msg();
+		break;
+	case MRPD_EV_MSRP_LVA:
+		mrpd_log_timer_event("MSRP", MRP_EVENT_LVATIMER);
+		msrp_event(MRP_EVENT_LVATIMER, NULL);
+		break;
+	case MRPD_EV_MSRP_LV:
+		mrpd_log_timer_event("MSRP", MRP_EVENT_LVTIMER);
+		msrp_event(MRP_EVENT_LVTIMER, NULL);
+		break;
+	case MRPD_EV_MSRP_JOIN:
+		mrpd_log_timer_event("MSRP", MRP_EVENT_TX);
+		msrp_event(MRP_EVENT_TX, NULL);
+		break;
+	default:
+		break;
+	}
+}
 
-	fd_set fds, sel_fds;
+void process_events(void)
+{
+	struct epoll_event events[MRPD_MAX_EVENTS];
+	int epoll_fd;
 	int rc;
-	int max_fd;
+	int i;
 
 	/* wait for events, demux the received packets, process packets */
 
-	FD_ZERO(&fds);
-	FD_SET(control_socket, &fds);
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (-1 == epoll_fd) {
+#if LOG_ERRORS
+		fprintf(stderr, "Error on epoll_create1 %s\r\n", strerror(errno));
+#endif
+		return;
+	}
 
-	max_fd = control_socket;
+	if (mrpd_epoll_add(epoll_fd, control_socket, MRPD_EV_CONTROL))
+		goto out;
 
 	if (mmrp_enable) {
-		FD_SET(mmrp_socket, &fds);
-		if (mmrp_socket > max_fd)
-			max_fd = mmrp_socket;
-
 		if (NULL == MMRP_db)
-			return;
-
-		rc = mrp_register_timers(&(MMRP_db->mrp_db), &fds);
-		if (rc > max_fd)
-			max_fd = rc;
+			goto out;
+		if (mrpd_epoll_add(epoll_fd, mmrp_socket, MRPD_EV_MMRP_RX) ||
+		    mrp_register_timers(&(MMRP_db->mrp_db), epoll_fd,
+					MRPD_EV_MMRP_LVA))
+			goto out;
 	}
 	if (mvrp_enable) {
-		FD_SET(mvrp_socket, &fds);
-		if (mvrp_socket > max_fd)
-			max_fd = mvrp_socket;
-
 		if (NULL == MVRP_db)
-			return;
-		rc = mrp_register_timers(&(MVRP_db->mrp_db), &fds);
-		if (rc > max_fd)
-			max_fd = rc;
-
+			goto out;
+		if (mrpd_epoll_add(epoll_fd, mvrp_socket, MRPD_EV_MVRP_RX) ||
+		    mrp_register_timers(&(MVRP_db->mrp_db), epoll_fd,
+					MRPD_EV_MVRP_LVA))
+			goto out;
 	}
 	if (msrp_enable) {
-		FD_SET(msrp_socket, &fds);
-		if (msrp_socket > max_fd)
-			max_fd = msrp_socket;
-
 		if (NULL == MSRP_db)
-			return;
-		rc = mrp_register_timers(&(MSRP_db->mrp_db), &fds);
-		if (rc > max_fd)
-			max_fd = rc;
-
+			goto out;
+		if (mrpd_epoll_add(epoll_fd, msrp_socket, MRPD_EV_MSRP_RX) ||
+		    mrp_register_timers(&(MSRP_db->mrp_db), epoll_fd,
+					MRPD_EV_MSRP_LVA))
+			goto out;
 	}
 
-	FD_SET(periodic_timer, &fds);
-	if (periodic_timer > max_fd)
-		max_fd = periodic_timer;
+	if (mrpd_epoll_add(epoll_fd, periodic_timer, MRPD_EV_PERIODIC))
+		goto out;
 
 	rc = mrp_periodictimer_fsm(&mrp_periodic_state, MRP_EVENT_BEGIN);
 	if (rc)
-		return;
+		goto out;
 
-	FD_SET(gc_timer, &fds);
-	if (gc_timer > max_fd)
-		max_fd = gc_timer;
+	if (mrpd_epoll_add(epoll_fd, gc_timer, MRPD_EV_GC))
+		goto out;
 
 	do {
-
-		sel_fds = fds;
-		rc = select(max_fd + 1, &sel_fds, NULL, NULL, NULL);
+		rc = epoll_wait(epoll_fd, events, MRPD_MAX_EVENTS, -1);
 
 		if (-1 == rc) {
+			if (EINTR == errno)
+				continue;
 #if LOG_ERRORS
-			fprintf(stderr, "Error on select %s\r\n", strerror(errno));
+			fprintf(stderr, "Error on epoll_wait %s\r\n", strerror(errno));
 #endif
-			return;	/* exit on error */
+			break;	/* exit on error */
 		}
-		else {
-			if (FD_ISSET(control_socket, &sel_fds)) {
-#if LOG_POLL_EVENTS
-				mrpd_log_printf("== EVENT recv_ctl_msg ==\n");
-#endif
-				recv_ctl_msg();
-			}
-			if (mmrp_enable) {
-				if FD_ISSET
-					(mmrp_socket, &sel_fds) {
-#if LOG_POLL_EVENTS
-					mrpd_log_printf("== EVENT mmrp_recv_msg ==\n");
-#endif
-					mmrp_recv_msg();
-					}
-				if FD_ISSET
-					(MMRP_db->mrp_db.lva_timer, &sel_fds) {
-					mrpd_log_timer_event("MMRP",
-							     MRP_EVENT_LVATIMER);
-					mmrp_event(MRP_EVENT_LVATIMER, NULL);
-					}
-				if FD_ISSET
-					(MMRP_db->mrp_db.lv_timer, &sel_fds) {
-					mrpd_log_timer_event("MMRP",
-							     MRP_EVENT_LVTIMER);
-					mmrp_event(MRP_EVENT_LVTIMER, NULL);
-					}
-				if FD_ISSET
-					(MMRP_db->mrp_db.join_timer, &sel_fds) {
-					mrpd_log_timer_event("MMRP",
-							     MRP_EVENT_TX);
-					mmrp_event(MRP_EVENT_TX, NULL);
-					}
-			}
-			if (mvrp_enable) {
-				if FD_ISSET
-					(mvrp_socket, &sel_fds) {
-#if LOG_POLL_EVENTS
-					mrpd_log_printf("== EVENT mvrp_recv_msg ==\n");
-#endif
-					mvrp_recv_msg();
-					}
-				if FD_ISSET
-					(MVRP_db->mrp_db.lva_timer, &sel_fds) {
-					mrpd_log_timer_event("MVRP",
-							     MRP_EVENT_LVATIMER);
-					mvrp_event(MRP_EVENT_LVATIMER, NULL);
-					}
-				if FD_ISSET
-					(MVRP_db->mrp_db.lv_timer, &sel_fds) {
-					mrpd_log_timer_event("MVRP",
-							     MRP_EVENT_LVTIMER);
-					mvrp_event(MRP_EVENT_LVTIMER, NULL);
-					}
-				if FD_ISSET
-					(MVRP_db->mrp_db.join_timer, &sel_fds) {
-					mrpd_log_timer_event("MVRP",
-							     MRP_EVENT_TX);
-					mvrp_event(MRP_EVENT_TX, NULL);
-					}
-			}
-			if (msrp_enable) {
-				if FD_ISSET
-					(msrp_socket, &sel_fds) {
-#if LOG_POLL_EVENTS
-					mrpd_log_printf("== EVENT msrp_recv_msg ==\n");
-#endif
-					msrp_recv_msg();
-				}
-				if FD_ISSET
-					(MSRP_db->mrp_db.lva_timer, &sel_fds) {
-					mrpd_log_timer_event("MSRP",
-							     MRP_EVENT_LVATIMER);
-					msrp_event(MRP_EVENT_LVATIMER, NULL);
-					}
-				if FD_ISSET
-					(MSRP_db->mrp_db.lv_timer, &sel_fds) {
-					mrpd_log_timer_event("MSRP",
-							     MRP_EVENT_LVTIMER);
-					msrp_event(MRP_EVENT_LVTIMER, NULL);
-					}
-				if FD_ISSET
-					(MSRP_db->mrp_db.join_timer, &sel_fds) {
-					mrpd_log_timer_event("MSRP",
-							     MRP_EVENT_TX);
-					msrp_event(MRP_EVENT_TX, NULL);
-					}
-			}
-			if (FD_ISSET(periodic_timer, &sel_fds)) {
-#if LOG_POLL_EVENTS && LOG_TIMERS
-				mrpd_log_printf("== EVENT periodic_timer ==\n");
-#endif
-				
-				mrp_periodictimer_fsm(&mrp_periodic_state, MRP_EVENT_PERIODIC);
-				if (mmrp_enable) {
-					mmrp_event(MRP_EVENT_PERIODIC, NULL);
-				}
-				if (mvrp_enable) {
-					mvrp_event(MRP_EVENT_PERIODIC, NULL);
-				}
-				if (msrp_enable) {
-					msrp_event(MRP_EVENT_PERIODIC, NULL);
-				}
-			}
-			if (FD_ISSET(gc_timer, &sel_fds)) {
-				mrpd_reclaim();
-			}
+
+		for (i = 0; i < rc; i++) {
+			uint32_t tag = (uint32_t)events[i].data.u64;
+			int fd = (int)(events[i].data.u64 >> 32);
+
+			if (tag != MRPD_EV_CONTROL && tag != MRPD_EV_MMRP_RX &&
+			    tag != MRPD_EV_MVRP_RX && tag != MRPD_EV_MSRP_RX)
+				mrpd_timer_ack(fd);
+			mrpd_dispatch(tag);
+		}
+
+		/* one datagram per binary client for everything that changed */
+		mrp_client_flush_binary();
 #if LOG_POLL_EVENTS
 		mrpd_log_printf("== EVENT DONE ==\n");
 #endif
-		}
 	} while (1);
+
+ out:
+	close(epoll_fd);
 }
 
 void usage(void)
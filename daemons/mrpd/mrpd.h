@@ -120,6 +120,50 @@ typedef struct mrpdu {
 #define MRPD_PORT_DEFAULT	7500
 #define MAX_MRPD_CMDSZ		(1500)
 
+/*
+ * Compact binary notifications. A client that sends "F+B" receives attribute
+ * notifications as fixed size records instead of text lines, several per
+ * datagram; "F-B" switches it back to text. Query responses stay text.
+ *
+ * Each datagram is an mrpd_bin_hdr followed by 'count' records. The first
+ * byte is always zero, which tells it apart from a text message. Every field
+ * is a byte or byte array; multi-byte values are big endian.
+ *
+ * value[] layout by protocol and type:
+ *   'M' MMRP_MACVEC_TYPE	[0..5] MAC address
+ *   'M' MMRP_SVCREQ_TYPE	[0] service requirement
+ *   'V' MVRP_VID_TYPE		[0..1] VID
+ *   'S' MSRP_DOMAIN_TYPE	[0] SRclassID, [1] SRclassPriority,
+ *				[2..3] SRclassVID, [4] neighborSRclassPriority
+ *   'S' MSRP_LISTENER_TYPE	[0..7] StreamID (declaration type in substate)
+ *   'S' talker types		[0..7] StreamID, [8..13] destination address,
+ *				[14..15] VLAN ID, [16..17] MaxFrameSize,
+ *				[18..19] MaxIntervalFrames, [20] PriorityAndRank,
+ *				[21..24] AccumulatedLatency, [25..32] BridgeID,
+ *				[33] FailureCode
+ */
+#define MRPD_BIN_VERSION	1
+
+typedef struct mrpd_bin_hdr {
+	uint8_t zero;
+	uint8_t version;	/* MRPD_BIN_VERSION */
+	uint8_t count[2];
+} mrpd_bin_hdr_t;
+
+typedef struct mrpd_bin_record {
+	uint8_t protocol;	/* 'M', 'V' or 'S' */
+	uint8_t notify;		/* MRP_NOTIFY_NEW, _JOIN or _LV */
+	uint8_t type;		/* attribute type within the protocol */
+	uint8_t substate;
+	uint8_t registrar_state;
+	uint8_t applicant_state;
+	uint8_t registrar_mac[6];
+	uint8_t value[36];
+} mrpd_bin_record_t;
+
+#define MRPD_BIN_MAX_RECORDS \
+	((MAX_MRPD_CMDSZ - sizeof(mrpd_bin_hdr_t)) / sizeof(mrpd_bin_record_t))
+
 /* forward declare */
 struct mrp_database;
 
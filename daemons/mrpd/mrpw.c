@@ -501,6 +501,8 @@ int process_ctl_msg(char *buf, int buflen, struct sockaddr_in *client)
 	 * S+? - JOIN_MT a Stream
 	 * S++ - JOIN_IN a Stream
 	 * S-- - LV a Stream
+	 * F+B   Send attribute notifications to this client in binary
+	 * F-B   Send attribute notifications to this client as text (default)
 	 *
 	 * Outbound messages
 	 * ERC - error, unrecognized command
@@ -554,10 +556,14 @@ int process_ctl_msg(char *buf, int buflen, struct sockaddr_in *client)
 	case 'S':
 		return msrp_recv_cmd(buf, buflen, client);
 		break;
+	case 'F':
+		return mrp_client_format_cmd(buf, buflen, client);
+		break;
 	case 'B':
 		mmrp_bye(client);
 		mvrp_bye(client);
 		msrp_bye(client);
+		mrp_client_set_binary(client, 0);
 		break;
 	default:
 		printf("unrecognized command %s\n", buf);
@@ -899,6 +905,7 @@ int mrpw_run_once(void)
 	default:
 		printf("Unknown event %d\n", dwEvent);
 	}
+	mrp_client_flush_binary();
 	return 0;
 }
 
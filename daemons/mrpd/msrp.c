@@ -142,33 +142,118 @@ int msrp_count_type(uint32_t attrib_type)
 }
 
 
+/*
+ * TalkerAdvertise and TalkerFailed for the same StreamID are the same
+ * declaration as far as lookups are concerned (msrp_merge() switches
+ * between them), so they hash and compare as one class.
+ */
+static uint32_t msrp_hash_class(uint32_t type)
+{
+	if (MSRP_TALKER_FAILED_TYPE == type)
+		return MSRP_TALKER_ADV_TYPE;
+	return type;
+}
+
+static unsigned int msrp_hash_bucket(const struct msrp_attribute *attrib,
+				     unsigned int size)
+{
+	uint64_t key;
+
+	if (MSRP_DOMAIN_TYPE == attrib->type)
+		key = attrib->attribute.domain.SRclassID;
+	else
+		key = eui64_read(attrib->attribute.talk_listen.StreamID);
+
+	key = (key ^ msrp_hash_class(attrib->type)) * 0x9E3779B97F4A7C15ULL;
+	return (unsigned int)(key >> 32) & (size - 1);
+}
+
+static int msrp_hash_match(const struct msrp_attribute *attrib,
+			   const struct msrp_attribute *rattrib)
+{
+	if (msrp_hash_class(attrib->type) != msrp_hash_class(rattrib->type))
+		return 0;
+
+	if (MSRP_DOMAIN_TYPE == attrib->type)
+		return attrib->attribute.domain.SRclassID ==
+		    rattrib->attribute.domain.SRclassID;
+
+	return 0 == memcmp(attrib->attribute.talk_listen.StreamID,
+			   rattrib->attribute.talk_listen.StreamID, 8);
+}
+
+static int msrp_hash_resize(unsigned int size)
+{
+	struct msrp_attribute **hash;
+	struct msrp_attribute *attrib;
+	unsigned int bucket;
+
+	hash = (struct msrp_attribute **)calloc(size, sizeof(*hash));
+	if (NULL == hash)
+		return -1;
+
+	/* every attribute on the list is indexed, so rebuild from the list */
+	for (attrib = MSRP_db->attrib_list; NULL != attrib; attrib = attrib->next) {
+		bucket = msrp_hash_bucket(attrib, size);
+		attrib->hash_next = hash[bucket];
+		hash[bucket] = attrib;
+	}
+
+	free(MSRP_db->attrib_hash);
+	MSRP_db->attrib_hash = hash;
+	MSRP_db->attrib_hash_size = size;
+	return 0;
+}
+
+static void msrp_hash_insert(struct msrp_attribute *attrib)
+{
+	unsigned int bucket;
+
+	bucket = msrp_hash_bucket(attrib, MSRP_db->attrib_hash_size);
+	attrib->hash_next = MSRP_db->attrib_hash[bucket];
+	MSRP_db->attrib_hash[bucket] = attrib;
+	MSRP_db->attrib_count++;
+}
+
+static void msrp_hash_remove(struct msrp_attribute *attrib)
+{
+	struct msrp_attribute **link;
+
+	link = &MSRP_db->attrib_hash[msrp_hash_bucket(attrib,
+					MSRP_db->attrib_hash_size)];
+	while (NULL != *link) {
+		if (*link == attrib) {
+			*link = attrib->hash_next;
+			attrib->hash_next = NULL;
+			MSRP_db->attrib_count--;
+			return;
+		}
+		link = &(*link)->hash_next;
+	}
+}
+
+/* remove an attribute from the list and the hash index, caller frees it */
+static void msrp_unlink(struct msrp_attribute *attrib)
+{
+	if (NULL != attrib->prev)
+		attrib->prev->next = attrib->next;
+	else
+		MSRP_db->attrib_list = attrib->next;
+	if (NULL != attrib->next)
+		attrib->next->prev = attrib->prev;
+	msrp_hash_remove(attrib);
+}
+
 struct msrp_attribute *msrp_lookup(struct msrp_attribute *rattrib)
 {
 	struct msrp_attribute *attrib;
-	int mac_eq;
 
-	attrib = MSRP_db->attrib_list;
+	attrib = MSRP_db->attrib_hash[msrp_hash_bucket(rattrib,
+					MSRP_db->attrib_hash_size)];
 	while (NULL != attrib) {
-		if (	(rattrib->type == attrib->type) ||
-			((MSRP_TALKER_ADV_TYPE == rattrib->type) && (MSRP_TALKER_FAILED_TYPE == attrib->type)) ||
-			((MSRP_TALKER_FAILED_TYPE == rattrib->type) && (MSRP_TALKER_ADV_TYPE == attrib->type)))
-			{
-			if (MSRP_DOMAIN_TYPE == attrib->type) {
-				if (attrib->attribute.domain.SRclassID ==
-				   rattrib->attribute.domain.SRclassID)
-					return attrib;
-			} else {
-				/* compare on the stream ID */
-				mac_eq =
-				    memcmp(attrib->attribute.talk_listen.
-					   StreamID,
-					   rattrib->attribute.talk_listen.
-					   StreamID, 8);
-				if (0 == mac_eq)
-					return attrib;
-			}
-		}
-		attrib = attrib->next;
+		if (msrp_hash_match(attrib, rattrib))
+			return attrib;
+		attrib = attrib->hash_next;
 	}
 	return NULL;
 }
@@ -197,6 +282,11 @@ int msrp_add(struct msrp_attribute *rattrib)
 
 	/* XXX do a lookup first to guarantee uniqueness? */
 
+	/* keep chains short as the number of streams grows */
+	if (MSRP_db->attrib_count >= 2 * MSRP_db->attrib_hash_size)
+		msrp_hash_resize(2 * MSRP_db->attrib_hash_size);
+	msrp_hash_insert(rattrib);
+
 	attrib_tail = attrib = MSRP_db->attrib_list;
 
 	while (NULL != attrib) {
@@ -3016,29 +3106,13 @@ int msrp_txpdu(void)
 	return -1;
 }
 
-int msrp_send_notifications(struct msrp_attribute *attrib, int notify)
+static int msrp_format_notification(struct msrp_attribute *attrib,
+				    int notify, char *msgbuf)
 {
-	char *msgbuf;
-	char *variant;
-	char *regsrc;
+	char variant[128];
+	char regsrc[128];
 	char mrp_state[8];
-	client_t *client;
-	size_t sub_str_len = 128;
-
-	if (NULL == attrib)
-		return -1;
-
-	msgbuf = (char *)malloc(MAX_MRPD_CMDSZ);
-	if (NULL == msgbuf)
-		return -1;
-
-	variant = regsrc = NULL;
-
-	variant = (char *)malloc(sub_str_len);
-	regsrc = (char *)malloc(sub_str_len);
-
-	if ((NULL == variant) || (NULL == regsrc))
-		goto free_msgbuf;
+	size_t sub_str_len = sizeof(variant);
 
 	memset(msgbuf, 0, MAX_MRPD_CMDSZ);
 
@@ -3171,22 +3245,92 @@ int msrp_send_notifications(struct msrp_attribute *attrib, int notify)
 		snprintf(msgbuf, MAX_MRPD_CMDSZ - 1, "SLE %s %s %s\n", variant, regsrc, mrp_state);
 		break;
 	default:
-		goto free_msgbuf;
-		break;
+		return -1;
 	}
 
+	return 0;
+}
+
+static void msrp_bin_notification(struct msrp_attribute *attrib, int notify,
+				  mrpd_bin_record_t *rec)
+{
+	uint8_t *v = rec->value;
+
+	mrp_bin_record_init(rec, 'S', notify, &attrib->registrar,
+			    &attrib->applicant);
+	rec->type = (uint8_t)attrib->type;
+	rec->substate = (uint8_t)attrib->substate;
+
+	if (MSRP_DOMAIN_TYPE == attrib->type) {
+		v[0] = attrib->attribute.domain.SRclassID;
+		v[1] = attrib->attribute.domain.SRclassPriority;
+		v[2] = (uint8_t)(attrib->attribute.domain.SRclassVID >> 8);
+		v[3] = (uint8_t)attrib->attribute.domain.SRclassVID;
+		v[4] = attrib->attribute.domain.neighborSRclassPriority;
+		return;
+	}
+
+	memcpy(v, attrib->attribute.talk_listen.StreamID, 8);
+	if (MSRP_LISTENER_TYPE == attrib->type)
+		return;
+
+	memcpy(v + 8, attrib->attribute.talk_listen.DataFrameParameters.
+	       Dest_Addr, 6);
+	v[14] = (uint8_t)(attrib->attribute.talk_listen.DataFrameParameters.
+			  Vlan_ID >> 8);
+	v[15] = (uint8_t)attrib->attribute.talk_listen.DataFrameParameters.
+	    Vlan_ID;
+	v[16] = (uint8_t)(attrib->attribute.talk_listen.TSpec.MaxFrameSize >> 8);
+	v[17] = (uint8_t)attrib->attribute.talk_listen.TSpec.MaxFrameSize;
+	v[18] = (uint8_t)(attrib->attribute.talk_listen.TSpec.
+			  MaxIntervalFrames >> 8);
+	v[19] = (uint8_t)attrib->attribute.talk_listen.TSpec.MaxIntervalFrames;
+	v[20] = attrib->attribute.talk_listen.PriorityAndRank;
+	v[21] = (uint8_t)(attrib->attribute.talk_listen.AccumulatedLatency >> 24);
+	v[22] = (uint8_t)(attrib->attribute.talk_listen.AccumulatedLatency >> 16);
+	v[23] = (uint8_t)(attrib->attribute.talk_listen.AccumulatedLatency >> 8);
+	v[24] = (uint8_t)attrib->attribute.talk_listen.AccumulatedLatency;
+	memcpy(v + 25, attrib->attribute.talk_listen.FailureInformation.
+	       BridgeID, 8);
+	v[33] = attrib->attribute.talk_listen.FailureInformation.FailureCode;
+}
+
+int msrp_send_notifications(struct msrp_attribute *attrib, int notify)
+{
+	char msgbuf[MAX_MRPD_CMDSZ];
+	mrpd_bin_record_t rec;
+	int have_text = 0;
+	int have_bin = 0;
+	client_t *client;
+
+	if (NULL == attrib)
+		return -1;
+
+	if ((notify < MRP_NOTIFY_NEW) || (notify > MRP_NOTIFY_LV))
+		return 0;
+
+	/* each format is built at most once, and only if a client wants it */
 	client = MSRP_db->mrp_db.clients;
 	while (NULL != client) {
-		mrpd_send_ctl_msg(&(client->client), msgbuf, MAX_MRPD_CMDSZ);
+		if (mrp_client_is_binary(&client->client)) {
+			if (!have_bin) {
+				msrp_bin_notification(attrib, notify, &rec);
+				have_bin = 1;
+			}
+			mrp_client_queue_binary(&client->client, &rec);
+		} else {
+			if (!have_text) {
+				if (msrp_format_notification(attrib, notify,
+							     msgbuf))
+					return 0;
+				have_text = 1;
+			}
+			mrpd_send_ctl_msg(&(client->client), msgbuf,
+					  MAX_MRPD_CMDSZ);
+		}
 		client = client->next;
 	}
 
- free_msgbuf:
-	if (regsrc)
-		free(regsrc);
-	if (variant)
-		free(variant);
-	free(msgbuf);
 	return 0;
 }
 
@@ -3653,12 +3797,7 @@ int msrp_recv_cmd(const char *buf, int buflen, struct sockaddr_in *client)
 				if (((free_sattrib->type == MSRP_TALKER_ADV_TYPE) ||
 					(free_sattrib->type == MSRP_TALKER_FAILED_TYPE)) &&
 					(memcmp(free_sattrib->attribute.talk_listen.StreamID, talker_param.StreamID, sizeof(talker_param.StreamID)) == 0)) {
-					if (NULL != free_sattrib->prev)
-						free_sattrib->prev->next = free_sattrib->next;
-					else
-						MSRP_db->attrib_list = free_sattrib->next;
-					if (NULL != free_sattrib->next)
-						free_sattrib->next->prev = free_sattrib->prev;
+					msrp_unlink(free_sattrib);
 					/* delete attribute */
 					free(free_sattrib);
 				}
@@ -3790,12 +3929,7 @@ int msrp_recv_cmd(const char *buf, int buflen, struct sockaddr_in *client)
 				if (((free_sattrib->type == MSRP_TALKER_ADV_TYPE) ||
 					 (free_sattrib->type == MSRP_TALKER_FAILED_TYPE)) &&
 					 (memcmp(free_sattrib->attribute.talk_listen.StreamID, stream_id, sizeof(stream_id)) == 0)) {
-						if (NULL != free_sattrib->prev)
-							free_sattrib->prev->next = free_sattrib->next;
-						else
-							MSRP_db->attrib_list = free_sattrib->next;
-						if (NULL != free_sattrib->next)
-							free_sattrib->next->prev = free_sattrib->prev;
+						msrp_unlink(free_sattrib);
 						/* delete attribute */
 						free(free_sattrib);
 				}
@@ -3857,6 +3991,9 @@ int msrp_init(int msrp_enable, int max_interesting_stream_ids, int enable_prunin
 	if( eui64set_init(&MSRP_db->interesting_stream_ids, max_interesting_stream_ids ) < 0 )
 		goto abort_alloc;
 
+	if (msrp_hash_resize(MSRP_HASH_MIN_BUCKETS) < 0)
+		goto abort_alloc;
+
 	MSRP_db->enable_pruning_of_uninteresting_ids = enable_pruning;
 
 	/* if registration is FIXED or FORBIDDEN
@@ -3883,6 +4020,7 @@ int msrp_init(int msrp_enable, int max_interesting_stream_ids, int enable_prunin
 
  abort_alloc:
 	/* free MSRP_db and related structures */
+	free(MSRP_db->attrib_hash);
 	free(MSRP_db);
 	MSRP_db = NULL;
  abort_socket:
@@ -3906,6 +4044,7 @@ void msrp_reset(void)
 		sattrib = sattrib->next;
 		free(free_sattrib);
    	}
+	free(MSRP_db->attrib_hash);
 	eui64set_free(&MSRP_db->interesting_stream_ids);
 	mrp_client_remove_all(&MSRP_db->mrp_db.clients);
 	free(MSRP_db);
@@ -3933,12 +4072,7 @@ static struct msrp_attribute *msrp_conditional_reclaim(struct msrp_attribute *sa
 	    ((sattrib->applicant.mrp_state == MRP_VO_STATE) ||
 	     (sattrib->applicant.mrp_state == MRP_AO_STATE) ||
 	     (sattrib->applicant.mrp_state == MRP_QO_STATE))) {
-		if (NULL != sattrib->prev)
-			sattrib->prev->next = sattrib->next;
-		else
-			MSRP_db->attrib_list = sattrib->next;
-		if (NULL != sattrib->next)
-			sattrib->next->prev = sattrib->prev;
+		msrp_unlink(sattrib);
 		free_sattrib = sattrib;
 		sattrib = sattrib->next;
 #if LOG_MSRP_GARBAGE_COLLECTION
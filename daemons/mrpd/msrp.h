@@ -151,6 +151,7 @@ typedef struct msrpdu_domain {
 struct msrp_attribute {
 	struct msrp_attribute *prev;
 	struct msrp_attribute *next;
+	struct msrp_attribute *hash_next;	/* StreamID hash bucket chain */
 	uint32_t type;
 	union {
 		msrpdu_talker_fail_t talk_listen;
@@ -162,9 +163,20 @@ struct msrp_attribute {
 	mrp_registrar_attribute_t registrar;
 };
 
+/*
+ * The attribute list is kept sorted by type and then by StreamID (or
+ * SRclassID) because the PDU encoders walk it to build vectors. Lookups
+ * go through a hash index on the same attributes; TalkerAdvertise and
+ * TalkerFailed share a key so a talker can change type in place.
+ */
+#define MSRP_HASH_MIN_BUCKETS	64
+
 struct msrp_database {
 	struct mrp_database mrp_db;
 	struct msrp_attribute *attrib_list;
+	struct msrp_attribute **attrib_hash;
+	unsigned int attrib_hash_size;	/* power of 2 */
+	unsigned int attrib_count;
 	int send_empty_LeaveAll_flag;
 	struct eui64set interesting_stream_ids;
 	int enable_pruning_of_uninteresting_ids;
@@ -1008,28 +1008,12 @@ int mvrp_txpdu(void)
 	return -1;
 }
 
-int mvrp_send_notifications(struct mvrp_attribute *attrib, int notify)
+static int mvrp_format_notification(struct mvrp_attribute *attrib,
+				    int notify, char *msgbuf)
 {
-	char *msgbuf;
-	char *variant;
-	char *regsrc;
+	char variant[128];
+	char regsrc[128];
 	char mrp_state[8];
-	client_t *client;
-
-	if (NULL == attrib)
-		return -1;
-
-	msgbuf = (char *)malloc(MAX_MRPD_CMDSZ);
-	if (NULL == msgbuf)
-		return -1;
-
-	variant = regsrc = NULL;
-
-	variant = (char *)malloc(128);
-	regsrc = (char *)malloc(128);
-
-	if ((NULL == variant) || (NULL == regsrc))
-		goto free_msgbuf;
 
 	memset(msgbuf, 0, MAX_MRPD_CMDSZ);
 
@@ -1057,22 +1041,58 @@ int mvrp_send_notifications(struct mvrp_attribute *attrib, int notify)
 		snprintf(msgbuf, MAX_MRPD_CMDSZ - 1, "VLE %s %s %s\n", variant, regsrc, mrp_state);
 		break;
 	default:
-		goto free_msgbuf;
-		break;
+		return -1;
 	}
 
+	return 0;
+}
+
+static void mvrp_bin_notification(struct mvrp_attribute *attrib, int notify,
+				  mrpd_bin_record_t *rec)
+{
+	mrp_bin_record_init(rec, 'V', notify, &attrib->registrar,
+			    &attrib->applicant);
+	rec->type = MVRP_VID_TYPE;
+	rec->value[0] = (uint8_t)(attrib->attribute >> 8);
+	rec->value[1] = (uint8_t)attrib->attribute;
+}
+
+int mvrp_send_notifications(struct mvrp_attribute *attrib, int notify)
+{
+	char msgbuf[MAX_MRPD_CMDSZ];
+	mrpd_bin_record_t rec;
+	int have_text = 0;
+	int have_bin = 0;
+	client_t *client;
+
+	if (NULL == attrib)
+		return -1;
+
+	if ((notify < MRP_NOTIFY_NEW) || (notify > MRP_NOTIFY_LV))
+		return 0;
+
+	/* each format is built at most once, and only if a client wants it */
 	client = MVRP_db->mrp_db.clients;
 	while (NULL != client) {
-		mrpd_send_ctl_msg(&(client->client), msgbuf, MAX_MRPD_CMDSZ);
+		if (mrp_client_is_binary(&client->client)) {
+			if (!have_bin) {
+				mvrp_bin_notification(attrib, notify, &rec);
+				have_bin = 1;
+			}
+			mrp_client_queue_binary(&client->client, &rec);
+		} else {
+			if (!have_text) {
+				if (mvrp_format_notification(attrib, notify,
+							     msgbuf))
+					return 0;
+				have_text = 1;
+			}
+			mrpd_send_ctl_msg(&(client->client), msgbuf,
+					  MAX_MRPD_CMDSZ);
+		}
 		client = client->next;
 	}
 
- free_msgbuf:
-	if (regsrc)
-		free(regsrc);
-	if (variant)
-		free(variant);
-	free(msgbuf);
 	return 0;
 }
 
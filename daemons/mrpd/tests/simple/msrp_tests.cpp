@@ -497,6 +497,88 @@ TEST(MsrpTestGroup, TxLVA_TalkerAdv_count_64)
 	LONGS_EQUAL(count, msrp_tests_event_counts_per_type(MSRP_TALKER_ADV_TYPE, MRP_EVENT_NEW));
 }
 
+/*
+ * This test declares several thousand talkers and listeners in a
+ * scrambled StreamID order and checks that every declaration can be
+ * looked up through the hash index, that TalkerAdvertise and
+ * TalkerFailed lookups resolve to the same attribute, that the
+ * attribute list stays sorted for the PDU encoders and that withdrawn
+ * talkers are removed from the index when they are reclaimed.
+ */
+TEST(MsrpTestGroup, Hash_Lookup_Stress_4096_Streams)
+{
+	struct msrp_attribute *attrib;
+	struct msrp_attribute *talker;
+	char cmd_string[128];
+	uint8_t stream_id[8];
+	uint64_t base_id = 0x0001f2fffe000000ull;
+	uint64_t da = 0x91e0f0000000ull;
+	int count = 4096;
+	int i;
+
+	/* declare count TalkerAdv, with a listener on every even index */
+	for (i = 0; i < count; i++)
+	{
+		/* 2053 is odd, so this visits every index once out of order */
+		uint64_t id = base_id + ((i * 2053) & (count - 1));
+
+		snprintf(cmd_string, sizeof(cmd_string),
+			"S++:S=%016" PRIx64 ",A=%" PRIx64 ",V=" VLAN_ID ",Z=" TSPEC_MAX_FRAME_SIZE
+			",I=" TSPEC_MAX_FRAME_INTERVAL ",P=" PRIORITY_AND_RANK ",L=" ACCUMULATED_LATENCY,
+			id, da + i);
+		msrp_recv_cmd(cmd_string, strlen(cmd_string) + 1, &client);
+		CHECK(msrp_tests_cmd_ok(test_state.ctl_msg_data));
+
+		if (0 == (id & 1))
+		{
+			snprintf(cmd_string, sizeof(cmd_string), "S+L:L=%016" PRIx64 ",D=2", id);
+			msrp_recv_cmd(cmd_string, strlen(cmd_string) + 1, &client);
+			CHECK(msrp_tests_cmd_ok(test_state.ctl_msg_data));
+		}
+	}
+	LONGS_EQUAL(count, msrp_count_type(MSRP_TALKER_ADV_TYPE));
+	LONGS_EQUAL(count / 2, msrp_count_type(MSRP_LISTENER_TYPE));
+
+	for (i = 0; i < count; i++)
+	{
+		eui64_write(stream_id, base_id + i);
+		talker = msrp_lookup_stream_declaration(MSRP_TALKER_ADV_TYPE, stream_id);
+		CHECK(NULL != talker);
+		CHECK(0 == memcmp(talker->attribute.talk_listen.StreamID, stream_id, 8));
+		CHECK(talker == msrp_lookup_stream_declaration(MSRP_TALKER_FAILED_TYPE, stream_id));
+
+		attrib = msrp_lookup_stream_declaration(MSRP_LISTENER_TYPE, stream_id);
+		CHECK((0 == (i & 1)) == (NULL != attrib));
+		CHECK(talker != attrib);
+	}
+
+	/* the encoders rely on each type being sorted by StreamID */
+	for (attrib = MSRP_db->attrib_list; NULL != attrib->next; attrib = attrib->next)
+	{
+		if (attrib->type == attrib->next->type)
+			CHECK(memcmp(attrib->attribute.talk_listen.StreamID,
+				attrib->next->attribute.talk_listen.StreamID, 8) < 0);
+	}
+
+	/* withdraw the odd talkers and let the applicant reach VO */
+	for (i = 1; i < count; i += 2)
+	{
+		snprintf(cmd_string, sizeof(cmd_string), "S--:S=%016" PRIx64, base_id + i);
+		msrp_recv_cmd(cmd_string, strlen(cmd_string) + 1, &client);
+		CHECK(msrp_tests_cmd_ok(test_state.ctl_msg_data));
+	}
+	msrp_event(MRP_EVENT_TX, NULL);
+	msrp_reclaim();
+
+	LONGS_EQUAL(count / 2, msrp_count_type(MSRP_TALKER_ADV_TYPE));
+	for (i = 0; i < count; i++)
+	{
+		eui64_write(stream_id, base_id + i);
+		attrib = msrp_lookup_stream_declaration(MSRP_TALKER_ADV_TYPE, stream_id);
+		CHECK((0 == (i & 1)) == (NULL != attrib));
+	}
+}
+
 /*
  * Without pruning enabled, more than one client is supported.
  */
@@ -657,3 +739,58 @@ TEST(MsrpTestGroup, TalkerAdvertise_To_Failed_Transition_With_Rx_rIn)
 
 }
 
+
+/*
+ * A client that selected the binary format gets its notifications as
+ * fixed size records, batched into one datagram until the event loop
+ * flushes them.
+ */
+TEST(MsrpTestGroup, Binary_Notifications_Batched)
+{
+	char cmd_string[] = ST_PLUS_PLUS;
+	char fmt_string[] = "F+B";
+	uint8_t thisStreamID[8] = { 0xDE, 0xAD, 0xBE, 0xEF, 0xBA, 0xDF, 0xCA, 0x11 };
+	struct msrp_attribute *attrib;
+	mrpd_bin_hdr_t *hdr;
+	mrpd_bin_record_t *rec;
+	int sent;
+
+	msrp_recv_cmd(cmd_string, sizeof(cmd_string), &client);
+	CHECK(msrp_tests_cmd_ok(test_state.ctl_msg_data));
+	attrib = msrp_lookup_stream_declaration(MSRP_TALKER_ADV_TYPE, thisStreamID);
+	CHECK(NULL != attrib);
+
+	LONGS_EQUAL(0, mrp_client_format_cmd(fmt_string, sizeof(fmt_string), &client));
+	CHECK(msrp_tests_cmd_ok(test_state.ctl_msg_data));
+	CHECK(mrp_client_is_binary(&client));
+
+	sent = test_state.sent_ctl_msg_count;
+	msrp_send_notifications(attrib, MRP_NOTIFY_NEW);
+	msrp_send_notifications(attrib, MRP_NOTIFY_JOIN);
+	LONGS_EQUAL(sent, test_state.sent_ctl_msg_count);
+
+	mrp_client_flush_binary();
+	LONGS_EQUAL(sent + 1, test_state.sent_ctl_msg_count);
+
+	hdr = (mrpd_bin_hdr_t *)test_state.ctl_msg_data;
+	LONGS_EQUAL(0, hdr->zero);
+	LONGS_EQUAL(MRPD_BIN_VERSION, hdr->version);
+	LONGS_EQUAL(2, (hdr->count[0] << 8) | hdr->count[1]);
+
+	rec = (mrpd_bin_record_t *)(test_state.ctl_msg_data + sizeof(*hdr));
+	LONGS_EQUAL('S', rec[0].protocol);
+	LONGS_EQUAL(MRP_NOTIFY_NEW, rec[0].notify);
+	LONGS_EQUAL(MRP_NOTIFY_JOIN, rec[1].notify);
+	LONGS_EQUAL(MSRP_TALKER_ADV_TYPE, rec[0].type);
+	CHECK(0 == memcmp(thisStreamID, rec[0].value, 8));
+	LONGS_EQUAL(0x0002, (rec[0].value[14] << 8) | rec[0].value[15]);
+	LONGS_EQUAL(576, (rec[0].value[16] << 8) | rec[0].value[17]);
+
+	/* nothing left to send */
+	mrp_client_flush_binary();
+	LONGS_EQUAL(sent + 1, test_state.sent_ctl_msg_count);
+
+	fmt_string[1] = '-';
+	LONGS_EQUAL(0, mrp_client_format_cmd(fmt_string, sizeof(fmt_string), &client));
+	CHECK(!mrp_client_is_binary(&client));
+}
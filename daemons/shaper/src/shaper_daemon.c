@@ -36,14 +36,26 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <errno.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <stdint.h>
+#include <linux/if_ether.h>
+#include <linux/pkt_sched.h>
 
 #define SHAPER_LOG_COMPONENT "Main"
 #include "shaper_log.h"
+#include "shaper_netlink.h"
 
 #define STREAMDA_LENGTH 18
 #define SHAPER_PORT 15365 /* Unassigned at https://www.iana.org/assignments/port-numbers */
 #define MAX_CLIENT_CONNECTIONS 10
 #define USER_COMMAND_PROMPT "\nEnter the command:  "
+#define COMMAND_BUFFER_SIZE 4096 /* Several commands may arrive in one read */
+
+#define ROOT_HANDLE 1
+#define CLASSA_PARENT 2
+#define CLASSB_PARENT 3
+#define U32_FILTER_HANDLE(n) (0x80000000 | (n)) /* 800::n */
+#define DEFAULT_PORT_RATE 1000 /* Mbit/s, if the link speed is unknown */
+#define CBS_MAX_INTERFERENCE_SIZE 1522 /* Largest frame that can delay an SR class frame */
 
 typedef struct cmd_ip
 {
@@ -59,30 +71,62 @@ typedef struct cmd_ip
 	int quit;
 } cmd_ip;
 
+/* An HTB class and the credit based shaper below it as installed in the kernel, so changes never need to query tc.
+ * HTB caps each measurement interval at its reserved rate; CBS spaces the frames within it the way IEEE 802.1Q
+ * requires. */
+typedef struct shaper_class
+{
+	char sr_class;
+	int measurement_interval;//usec
+	uint32_t classid;
+	uint32_t cbs_handle;
+	uint32_t rate; /* 0 if not installed */
+	uint32_t cburst;
+	int bandwidth;
+	int max_frame_size; /* largest reserved so far */
+	struct tc_cbs_qopt cbs; /* idleslope 0 if not installed */
+} shaper_class;
+
 typedef struct stream_da
 {
 	char dest_addr[STREAMDA_LENGTH];
 	int bandwidth;
-	char class_id[5];
+	shaper_class *sclass;
 	int filter_handle;
 	struct stream_da *next;
 } stream_da;
 
 stream_da *head = NULL;
 int sr_classa=0, sr_classb=0;
-int classa_48=0, classa_44=0, classb_48=0, classb_44=0;
-int classa_bw_48=0, classa_bw_44=0, classb_bw_48=0, classb_bw_44=0;
+shaper_class shaper_classes[] =
+{
+	{ 'A', 125, TC_H_MAKE(CLASSA_PARENT << 16, 0x10), TC_H_MAKE(0x10 << 16, 0), 0, 0, 0, 0, { 0 } }, /* 2:10, cbs 10: */
+	{ 'A', 136, TC_H_MAKE(CLASSA_PARENT << 16, 0x20), TC_H_MAKE(0x20 << 16, 0), 0, 0, 0, 0, { 0 } }, /* 2:20, cbs 20: */
+	{ 'B', 250, TC_H_MAKE(CLASSB_PARENT << 16, 0x30), TC_H_MAKE(0x30 << 16, 0), 0, 0, 0, 0, { 0 } }, /* 3:30, cbs 30: */
+	{ 'B', 272, TC_H_MAKE(CLASSB_PARENT << 16, 0x40), TC_H_MAKE(0x40 << 16, 0), 0, 0, 0, 0, { 0 } }, /* 3:40, cbs 40: */
+};
+#define NUM_SHAPER_CLASSES (sizeof(shaper_classes) / sizeof(shaper_classes[0]))
 int daemonize=0,c=0;
 int filterhandle_classa=1,filterhandle_classb=20;
-char classid_a_48[]="2:10";
-char classid_a_44[]="2:20";
-char classid_b_48[]="3:30";
-char classid_b_44[]="3:40";
 char interface[IFNAMSIZ] = {0};
+int port_rate = DEFAULT_PORT_RATE; /* Mbit/s */
 int bandwidth = 0;
-int classa_parent = 2, classb_parent=3;
 int exit_received = 0;
 
+/* The model as it was when the current batch started, restored if the kernel rejects the batch. */
+typedef struct shaper_state
+{
+	stream_da *head;
+	int sr_classa, sr_classb;
+	shaper_class classes[NUM_SHAPER_CLASSES];
+	int filterhandle_classa, filterhandle_classb;
+	char interface[IFNAMSIZ];
+	int port_rate;
+} shaper_state;
+shaper_state saved_state;
+int batch_sockfd = -1;
+int batch_failures = 0;
+
 static void signal_handler(int signal)
 {
 	if (signal == SIGINT || signal == SIGTERM) {
@@ -172,7 +216,21 @@ int is_empty()
 	return head == NULL;
 }
 
-void insert_stream_da(int sockfd, char dest_addr[], int bandwidth, char class_id[], int filter_handle)
+shaper_class* find_shaper_class(char sr_class, int measurement_interval)
+{
+	unsigned int i;
+	for (i = 0; i < NUM_SHAPER_CLASSES; ++i)
+	{
+		if (shaper_classes[i].sr_class == sr_class &&
+			shaper_classes[i].measurement_interval == measurement_interval)
+		{
+			return &shaper_classes[i];
+		}
+	}
+	return NULL;
+}
+
+void insert_stream_da(int sockfd, char dest_addr[], int bandwidth, shaper_class *sclass, int filter_handle)
 {
 	stream_da *node = (stream_da *)malloc(sizeof(stream_da));
 	if (node == NULL)
@@ -183,7 +241,7 @@ void insert_stream_da(int sockfd, char dest_addr[], int bandwidth, char class_id
 	}
 	strcpy(node->dest_addr,dest_addr);
 	node->bandwidth = bandwidth;
-	strcpy(node->class_id,class_id);
+	node->sclass = sclass;
 	node->filter_handle=filter_handle;
 	node->next = NULL;
 	if (is_empty())
@@ -257,9 +315,9 @@ void remove_stream_da(int sockfd, char dest_addr[])
 	}
 }
 
-void delete_streamda_list()
+void free_streamda_list(stream_da *list)
 {
-	stream_da *current = head;
+	stream_da *current = list;
 	stream_da *next = NULL;
 	while (current != NULL)
 	{
@@ -267,9 +325,119 @@ void delete_streamda_list()
 		free(current);
 		current = next;
 	}
+}
+
+void delete_streamda_list()
+{
+	free_streamda_list(head);
 	head = NULL;
 }
 
+stream_da* copy_streamda_list(int sockfd)
+{
+	stream_da *copy = NULL, **tail = &copy;
+	stream_da *current;
+
+	for (current = head; current != NULL; current = current->next)
+	{
+		stream_da *node = (stream_da *)malloc(sizeof(stream_da));
+		if (node == NULL)
+		{
+			log_client_error_message(sockfd, "Unable to allocate memory. Exiting program");
+			shaperLogExit();
+			exit(1);
+		}
+		*node = *current;
+		node->next = NULL;
+		*tail = node;
+		tail = &node->next;
+	}
+	return copy;
+}
+
+// Start a batch of traffic control changes, remembering the model so the batch can be undone.
+void begin_batch(int sockfd)
+{
+	batch_sockfd = sockfd;
+	saved_state.head = copy_streamda_list(sockfd);
+	saved_state.sr_classa = sr_classa;
+	saved_state.sr_classb = sr_classb;
+	memcpy(saved_state.classes, shaper_classes, sizeof(shaper_classes));
+	saved_state.filterhandle_classa = filterhandle_classa;
+	saved_state.filterhandle_classb = filterhandle_classb;
+	strcpy(saved_state.interface, interface);
+	saved_state.port_rate = port_rate;
+	shaperNetlinkBegin(sockfd);
+}
+
+// Send the batch to the kernel. The kernel changes are all or nothing, so if any of them failed
+// the model goes back to the state saved by begin_batch(). Returns the number of failed requests.
+int commit_batch()
+{
+	int failures = shaperNetlinkCommit();
+
+	if (failures != 0)
+	{
+		delete_streamda_list();
+		head = saved_state.head;
+		sr_classa = saved_state.sr_classa;
+		sr_classb = saved_state.sr_classb;
+		memcpy(shaper_classes, saved_state.classes, sizeof(shaper_classes));
+		filterhandle_classa = saved_state.filterhandle_classa;
+		filterhandle_classb = saved_state.filterhandle_classb;
+		strcpy(interface, saved_state.interface);
+		port_rate = saved_state.port_rate;
+		log_client_error_message(batch_sockfd, "The kernel rejected %d request(s); the commands have been undone", failures);
+		batch_failures += failures;
+	}
+	else
+	{
+		free_streamda_list(saved_state.head);
+	}
+	saved_state.head = NULL;
+	return failures;
+}
+
+// Link speed in Mbit/s, or DEFAULT_PORT_RATE if the driver does not report one.
+int read_port_rate(const char *ifname)
+{
+	char path[64 + IFNAMSIZ];
+	int speed = 0;
+	FILE *fp;
+
+	snprintf(path, sizeof(path), "/sys/class/net/%s/speed", ifname);
+	fp = fopen(path, "r");
+	if (fp != NULL)
+	{
+		if (fscanf(fp, "%d", &speed) != 1)
+		{
+			speed = 0;
+		}
+		fclose(fp);
+	}
+	if (speed <= 0)
+	{
+		SHAPER_LOGF_WARNING("Link speed of %s unknown; assuming %d Mbit/s", ifname, DEFAULT_PORT_RATE);
+		return DEFAULT_PORT_RATE;
+	}
+	return speed;
+}
+
+// Queue programming the credit based shaper below sclass for its current rate (IEEE 802.1Q Annex L).
+void update_cbs(shaper_class *sclass)
+{
+	struct tc_cbs_qopt opt;
+	int32_t port_kbps = port_rate * 1000;
+
+	memset(&opt, 0, sizeof(opt));
+	opt.idleslope = ((int64_t)sclass->rate * 8 + 999) / 1000;
+	opt.sendslope = opt.idleslope - port_kbps;
+	opt.hicredit = ceil((double)opt.idleslope * CBS_MAX_INTERFERENCE_SIZE / port_kbps);
+	opt.locredit = floor((double)opt.sendslope * sclass->max_frame_size / port_kbps);
+	shaperNetlinkCbs(sclass->classid, sclass->cbs_handle, &opt, &sclass->cbs);
+	sclass->cbs = opt;
+}
+
 void usage (int sockfd)
 {
 	const char *usage = "Usage:\n"
@@ -414,36 +582,13 @@ cmd_ip parse_cmd(char command[])
 	return inputs;
 }
 
-void tc_class_command(int sockfd, char command[], char class_id[], char interface[], int bandwidth, int cburst)
-{
-	char tc_command[1000]={0};
-	sprintf(tc_command, "tc class %s dev %s classid %s htb rate %dbps cburst %d",
-		command, interface, class_id, bandwidth, cburst);
-	log_client_debug_message(sockfd, "tc command:  \"%s\"", tc_command);
-	if (system(tc_command) < 0)
-	{
-		log_client_error_message(sockfd, "command(\"%s\") failed", tc_command);
-	}
-}
-
-void add_filter(int sockfd, char interface[], int parent, int filter_handle, char class_id[], char dest_addr[])
-{
-	char tc_command[1000]={0};
-	sprintf(tc_command, "tc filter add dev %s prio 1 handle 800::%d parent %d: u32 classid %s  match ether dst %s",
-		interface, filter_handle, parent, class_id, dest_addr);
-	log_client_debug_message(sockfd, "tc command:  \"%s\"", tc_command);
-	if (system(tc_command) < 0)
-	{
-		log_client_error_message(sockfd, "command(\"%s\") failed", tc_command);
-	}
-}
-
 // Returns 1 if successful, -1 on an error, or 0 if exit requested.
+// Traffic control requests are queued in the batch started by begin_batch(); the caller commits them.
 int process_command(int sockfd, char command[])
 {
 	cmd_ip input = parse_cmd(command);
-	char tc_command[1000]={0};
 	int maxburst = 0;
+	uint8_t dest_addr[ETH_ALEN];
 
 	if (input.reserve_bw && input.unreserve_bw)
 	{
@@ -469,10 +614,18 @@ int process_command(int sockfd, char command[])
 			usage(sockfd);
 			return -1;
 		}
+
+		if (sscanf(input.stream_da, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+				&dest_addr[0], &dest_addr[1], &dest_addr[2], &dest_addr[3], &dest_addr[4], &dest_addr[5]) != ETH_ALEN)
+		{
+			log_client_error_message(sockfd, "Invalid Stream Destination Address \"%s\"", input.stream_da);
+			usage(sockfd);
+			return -1;
+		}
 	}
 	if (input.unreserve_bw)
 	{
-		if (input.stream_da == 0)
+		if (input.stream_da[0] == '\0')
 		{
 			log_client_error_message(sockfd, "Stream Destination Address is required to unreserve bandwidth");
 			usage(sockfd);
@@ -490,21 +643,34 @@ int process_command(int sockfd, char command[])
 	{
 		if (sr_classa != 0 || sr_classb != 0)
 		{
+			unsigned int i;
+
+			/* Deleting the root qdisc cannot be rolled back, so settle the earlier commands and send it on its own. */
+			commit_batch();
+			begin_batch(sockfd);
+
 			//delete all the Stream DAs in list
 			delete_streamda_list();
 			if (strlen(interface) != 0)
 			{
 				//delete qdisc
-				sprintf(tc_command, "tc qdisc del dev %s root handle 1:", interface);
-				log_client_debug_message(sockfd, "tc command:  \"%s\"", tc_command);
-				if (system(tc_command) < 0)
-				{
-					log_client_error_message(sockfd, "command(\"%s\") failed", tc_command);
-				}
+				shaperNetlinkDelRootQdisc(TC_H_MAKE(ROOT_HANDLE << 16, 0));
 			}
 			sr_classa = sr_classb = 0;
-			classa_48 = classa_44 = classb_48 = classb_44 = 0;
-			classa_bw_48 = classa_bw_44 = classb_bw_48 = classb_bw_44 = 0;
+			for (i = 0; i < NUM_SHAPER_CLASSES; ++i)
+			{
+				shaper_classes[i].rate = 0;
+				shaper_classes[i].cburst = 0;
+				shaper_classes[i].bandwidth = 0;
+				shaper_classes[i].max_frame_size = 0;
+				memset(&shaper_classes[i].cbs, 0, sizeof(shaper_classes[i].cbs));
+			}
+
+			/* The configuration is gone even if the kernel reports an error, so keep the cleared model. */
+			shaperNetlinkCommit();
+			free_streamda_list(saved_state.head);
+			saved_state.head = NULL;
+			begin_batch(sockfd);
 		}
 
 		if (input.quit == 1)
@@ -525,14 +691,14 @@ int process_command(int sockfd, char command[])
 			usage(sockfd);
 			return -1;
 		}
-		sprintf(tc_command, "tc qdisc add dev %s root handle 1: mqprio num_tc 4 map 3 3 1 0 2 2 2 2 2 2 2 2 2 2 2 2 queues 1@0 1@1 1@2 1@3 hw 0", input.interface);
-		log_client_debug_message(sockfd, "tc command:  \"%s\"", tc_command);
-		if (system(tc_command) < 0)
+		if (shaperNetlinkSetInterface(input.interface) < 0)
 		{
-			log_client_error_message(sockfd, "command(\"%s\") failed", tc_command);
+			log_client_error_message(sockfd, "Unknown interface \"%s\"", input.interface);
 			return -1;
 		}
+		shaperNetlinkAddMqprio(TC_H_MAKE(ROOT_HANDLE << 16, 0));
 		strcpy(interface,input.interface);
+		port_rate = read_port_rate(interface);
 	}
 
 	if (input.unreserve_bw || input.reserve_bw)
@@ -543,66 +709,41 @@ int process_command(int sockfd, char command[])
 
 	if (input.reserve_bw == 1)
 	{
+		shaper_class *sclass;
+		int *filter_handle;
+
 		if (check_stream_da(sockfd, input.stream_da))
 		{
 			return 1;
 		}
-		if (input.class_a)
-		{
-			if (sr_classa == 0)
-			{
-				sr_classa = 1;
-				//Create qdisc for Class A traffic
-				sprintf(tc_command, "tc qdisc add dev %s handle %d:  parent 1:5 htb", interface, classa_parent);
-				log_client_debug_message(sockfd, "tc command:  \"%s\"", tc_command);
-				if (system(tc_command) < 0)
-				{
-					log_client_error_message(sockfd, "command(\"%s\") failed", tc_command);
-					return -1;
-				}
-			}
 
-			if (input.measurement_interval == 125)
-			{
-				classa_bw_48 = classa_bw_48 + bandwidth;
-				if (classa_48 == 0)
-				{
-					classa_48 = 1;
-					tc_class_command(sockfd, "add", classid_a_48, interface, classa_bw_48, maxburst);
-				}
-				else
-				{
-					tc_class_command(sockfd, "change", classid_a_48, interface, classa_bw_48, maxburst);
-				}
-
-				add_filter(sockfd, interface, classa_parent, filterhandle_classa, classid_a_48, input.stream_da);
-				insert_stream_da(sockfd, input.stream_da, bandwidth, classid_a_48, filterhandle_classa );
-				filterhandle_classa++;
-			}
-			else if (input.measurement_interval == 136)
+		sclass = find_shaper_class(input.class_a ? 'A' : 'B', input.measurement_interval);
+		if (sclass == NULL)
+		{
+			if (input.class_a)
 			{
-				classa_bw_44 = classa_bw_44 + bandwidth;
-				if (classa_44 == 0)
-				{
-					classa_44 = 1;
-					tc_class_command(sockfd, "add", classid_a_44, interface, classa_bw_44, maxburst);
-				}
-				else
-				{
-					tc_class_command(sockfd, "change", classid_a_44, interface, classa_bw_44, maxburst);
-				}
-
-				add_filter(sockfd, interface, classa_parent, filterhandle_classa, classid_a_44, input.stream_da);
-				insert_stream_da(sockfd, input.stream_da, bandwidth, classid_a_44, filterhandle_classa);
-				filterhandle_classa++;
+				log_client_error_message(sockfd, "Measurement Interval (%d) doesn't match that of Class A (125 or 136) traffic. "
+						"Enter a valid measurement interval",
+						input.measurement_interval);
 			}
 			else
 			{
-				log_client_error_message(sockfd, "Measurement Interval (%d) doesn't match that of Class A (125 or 136) traffic. "
+				log_client_error_message(sockfd, "Measurement Interval (%d) doesn't match that of Class B (250 or 272) traffic. "
 						"Enter a valid measurement interval",
 						input.measurement_interval);
-				return -1;
 			}
+			return -1;
+		}
+
+		if (input.class_a)
+		{
+			if (sr_classa == 0)
+			{
+				sr_classa = 1;
+				//Create qdisc for Class A traffic
+				shaperNetlinkAddHtb(TC_H_MAKE(ROOT_HANDLE << 16, 5), TC_H_MAKE(CLASSA_PARENT << 16, 0));
+			}
+			filter_handle = &filterhandle_classa;
 		}
 		else
 		{
@@ -610,97 +751,49 @@ int process_command(int sockfd, char command[])
 			{
 				sr_classb = 1;
 				//Create qdisc for Class B traffic
-				sprintf(tc_command, "tc qdisc add dev %s handle %d:  parent 1:6 htb", interface, classb_parent);
-				log_client_debug_message(sockfd, "tc command:  \"%s\"", tc_command);
-				if (system(tc_command) < 0)
-				{
-					log_client_error_message(sockfd, "command(\"%s\") failed", tc_command);
-					return -1;
-				}
+				shaperNetlinkAddHtb(TC_H_MAKE(ROOT_HANDLE << 16, 6), TC_H_MAKE(CLASSB_PARENT << 16, 0));
 			}
+			filter_handle = &filterhandle_classb;
+		}
 
-			if (input.measurement_interval == 250)
-			{
-				classb_bw_48 = classb_bw_48 + bandwidth;
-				if (classb_48 == 0)
-				{
-					classb_48 = 1;
-					tc_class_command(sockfd, "add", classid_b_48, interface, classb_bw_48, maxburst);
-				}
-				else
-				{
-					tc_class_command(sockfd, "change", classid_b_48, interface, classb_bw_48, maxburst);
-				}
-				add_filter(sockfd, interface, classb_parent, filterhandle_classb, classid_b_48, input.stream_da);
-				insert_stream_da(sockfd, input.stream_da, bandwidth, classid_b_48, filterhandle_classb);
-				filterhandle_classb++;
-			}
-			else if (input.measurement_interval == 272)
-			{
-				classb_bw_44 = classb_bw_44 + bandwidth;
-				if (classb_44 == 0)
-				{
-					classb_44 = 1;
-					tc_class_command(sockfd, "add", classid_b_44, interface, classb_bw_44, maxburst);
-				}
-				else
-				{
-					tc_class_command(sockfd, "change", classid_b_44, interface, classb_bw_44, maxburst);
-				}
-				add_filter(sockfd, interface, classb_parent, filterhandle_classb, classid_b_44, input.stream_da);
-				insert_stream_da(sockfd, input.stream_da, bandwidth, classid_b_44, filterhandle_classb);
-				filterhandle_classb++;
-			}
-			else
-			{
-				log_client_error_message(sockfd, "Measurement Interval (%d) doesn't match that of Class B (250 or 272) traffic. "
-						"Enter a valid measurement interval",
-						input.measurement_interval);
-				return -1;
-			}
+		sclass->bandwidth = sclass->bandwidth + bandwidth;
+		shaperNetlinkHtbClass(sclass->classid, sclass->bandwidth, maxburst, sclass->rate, sclass->cburst);
+		sclass->rate = sclass->bandwidth;
+		sclass->cburst = maxburst;
+		if (input.max_frame_size > sclass->max_frame_size)
+		{
+			sclass->max_frame_size = input.max_frame_size;
 		}
+		update_cbs(sclass);
+
+		shaperNetlinkAddFilter(TC_H_MAJ(sclass->classid), U32_FILTER_HANDLE(*filter_handle), sclass->classid, dest_addr);
+		insert_stream_da(sockfd, input.stream_da, bandwidth, sclass, *filter_handle);
+		(*filter_handle)++;
 	}
 	else if (input.unreserve_bw==1)
 	{
 		stream_da *remove_stream = get_stream_da(sockfd, input.stream_da);
 		if (remove_stream != NULL)
 		{
-			int class_bw = 0;
-			if (!strcmp(remove_stream->class_id, classid_a_48))
-			{
-				classa_bw_48 = classa_bw_48 - remove_stream->bandwidth;
-				class_bw = classa_bw_48;
-			}
-			else if (!strcmp(remove_stream->class_id, classid_a_44))
-			{
-				classa_bw_44 = classa_bw_44 - remove_stream->bandwidth;
-				class_bw = classa_bw_44;
-			}
-			else if (!strcmp(remove_stream->class_id, classid_b_48))
-			{
-				classb_bw_48 = classb_bw_48 - remove_stream->bandwidth;
-				class_bw = classb_bw_48;
-			}
-			else if (!strcmp(remove_stream->class_id, classid_b_44))
-			{
-				classb_bw_44 = classb_bw_44 - remove_stream->bandwidth;
-				class_bw = classb_bw_44;
-			}
+			shaper_class *sclass = remove_stream->sclass;
+			int class_bw;
+
+			/* Validated when the stream was reserved. */
+			sscanf(remove_stream->dest_addr, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+				&dest_addr[0], &dest_addr[1], &dest_addr[2], &dest_addr[3], &dest_addr[4], &dest_addr[5]);
+
+			sclass->bandwidth = sclass->bandwidth - remove_stream->bandwidth;
+			class_bw = sclass->bandwidth;
 			if (class_bw == 0)
 			{
 				class_bw = 1;
 			}
-			tc_class_command(sockfd, "change", remove_stream->class_id, interface, class_bw, maxburst);
-			char parent[3] = {0};
-			strncpy(parent,remove_stream->class_id,2);
-			sprintf(tc_command, "tc filter del dev %s parent %s handle 800::%d prio 1 protocol all u32",
-				interface, parent, remove_stream->filter_handle);
-			log_client_debug_message(sockfd, "tc command:  \"%s\"", tc_command);
-			if (system(tc_command) < 0)
-			{
-				log_client_error_message(sockfd, "command(\"%s\") failed", tc_command);
-				return -1;
-			}
+			shaperNetlinkHtbClass(sclass->classid, class_bw, maxburst, sclass->rate, sclass->cburst);
+			sclass->rate = class_bw;
+			sclass->cburst = maxburst;
+			update_cbs(sclass);
+			shaperNetlinkDelFilter(TC_H_MAJ(sclass->classid), U32_FILTER_HANDLE(remove_stream->filter_handle),
+				sclass->classid, dest_addr);
 			remove_stream_da(sockfd, remove_stream->dest_addr);
 		}
 	}
@@ -708,6 +801,56 @@ int process_command(int sockfd, char command[])
 	return 1;
 }
 
+// Process each line of command text, sending the resulting traffic control changes to the kernel as one batch.
+// Returns 1 if successful, -1 on an error, or 0 if exit requested.
+int process_commands(int sockfd, char commands[])
+{
+	char *line, *next;
+	int ret = 1;
+
+	batch_failures = 0;
+	begin_batch(sockfd);
+
+	for (line = commands; line != NULL && ret != 0; line = next)
+	{
+		int len, result;
+
+		next = strchr(line, '\n');
+		if (next != NULL)
+		{
+			*next++ = '\0';
+		}
+
+		/* Remove trailing whitespace. */
+		len = strlen(line);
+		while (len > 0 && isspace((unsigned char) line[len - 1]))
+		{
+			line[--len] = '\0';
+		}
+		if (len == 0)
+		{
+			continue;
+		}
+
+		if (sockfd >= 0)
+		{
+			SHAPER_LOGF_INFO("The received command is \"%s\"", line);
+		}
+		result = process_command(sockfd, line);
+		if (result <= 0)
+		{
+			ret = result;
+		}
+	}
+
+	commit_batch();
+	if (batch_failures != 0 && ret > 0)
+	{
+		ret = -1;
+	}
+	return ret;
+}
+
 int init_socket()
 {
 	int socketfd = 0;
@@ -750,7 +893,7 @@ int init_socket()
 
 int main (int argc, char *argv[])
 {
-	char command[100];
+	char command[COMMAND_BUFFER_SIZE];
 	int socketfd = 0,newfd = 0;
 	int clientfd[MAX_CLIENT_CONNECTIONS];
 	int i, nextclientindex;
@@ -783,6 +926,13 @@ int main (int argc, char *argv[])
 		return 1;
 	}
 
+	if (shaperNetlinkOpen(log_client_error_message) < 0)
+	{
+		close(socketfd);
+		shaperLogExit();
+		return 1;
+	}
+
 	// Setup signal handler
 	// We catch SIGINT and shutdown cleanly
 	int err;
@@ -851,7 +1001,8 @@ int main (int argc, char *argv[])
 			{
 				// Assume the app received a signal to quit.
 				// Process the quit command.
-				process_command(-1, "-q");
+				char quit_command[] = "-q";
+				process_commands(-1, quit_command);
 			}
 			else
 			{
@@ -874,7 +1025,7 @@ int main (int argc, char *argv[])
 					command[recvbytes] = '\0';
 
 					/* Process the command data. */
-					int ret = process_command(-1, command);
+					int ret = process_commands(-1, command);
 					if (!ret)
 					{
 						/* Received a command to exit. */
@@ -947,13 +1098,7 @@ int main (int argc, char *argv[])
 					}
 
 					command[recvbytes] = '\0';
-					while (recvbytes > 0 && isspace(command[recvbytes - 1]))
-					{
-						/* Remove trailing whitespace. */
-						command[--recvbytes] = '\0';
-					}
-					SHAPER_LOGF_INFO("The received command is \"%s\"",command);
-					int ret = process_command(clientfd[i], command);
+					int ret = process_commands(clientfd[i], command);
 					if (!ret)
 					{
 						/* Received a command to exit. */
@@ -980,6 +1125,7 @@ int main (int argc, char *argv[])
 		}
 	}
 
+	shaperNetlinkClose();
 	shaperLogExit();
 
 	return 0;
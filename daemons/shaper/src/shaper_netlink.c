@@ -0,0 +1,764 @@
+/*************************************************************************************************************
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/pkt_sched.h>
+#include <linux/pkt_cls.h>
+#include <linux/if_ether.h>
+
+#define SHAPER_LOG_COMPONENT "Netlink"
+#include "shaper_log.h"
+#include "shaper_netlink.h"
+
+// Room reserved for a single request; none of the requests below come close.
+#define NL_MAX_REQUEST_SIZE		512
+#define NL_BATCH_SIZE			(64 * 1024)
+// Initial sizes of the transaction tables; they grow as needed, as a single command read can hold
+// more requests than this.
+#define NL_INITIAL_REQUESTS		256
+#define NL_INITIAL_UNDO_SIZE	(64 * 1024)
+#define NL_DESC_LENGTH			48
+
+// tc defaults used when a burst size is not given.
+#define TC_DEFAULT_MTU			1600
+#define TC_FILTER_PRIO			1
+
+// One request of the current transaction, with the request that reverses it if the kernel accepts it.
+typedef struct nl_request
+{
+	uint32_t seq;
+	int sockfd;
+	int applied;
+	size_t undoOffset;
+	size_t undoLen;
+	char desc[NL_DESC_LENGTH];
+} nl_request;
+
+static int nlSocket = -1;
+static uint32_t nlSeq = 0;
+static int nlIfindex = 0;
+// Interface selected when the transaction began, restored if it is rolled back
+static int nlIfindexBegin = 0;
+static int nlSockfd = -1;
+static int nlFailures = 0;
+static shaper_netlink_error_fn nlErrorFn = NULL;
+
+static char nlBatch[NL_BATCH_SIZE] __attribute__((aligned(NLMSG_ALIGNTO)));
+static size_t nlBatchUsed = 0;
+
+// Requests since shaperNetlinkBegin(); those from nlBatchFirst on have not been sent yet.
+static nl_request *nlRequests = NULL;
+static int nlRequestMax = 0;
+static int nlRequestCount = 0;
+static int nlBatchFirst = 0;
+
+// Requests reversing those of the transaction, referenced by offset as the buffer may move.
+static char *nlUndo = NULL;
+static size_t nlUndoSize = 0;
+static size_t nlUndoUsed = 0;
+
+// Packet scheduler clock, as reported by /proc/net/psched (see iproute2 tc_core.c).
+static double tickInUsec = 1.0;
+static uint32_t clockHz = 1000000;
+
+static void x_readPsched(void)
+{
+	uint32_t t2us, us2t, clockRes, hz;
+	FILE *fp = fopen("/proc/net/psched", "r");
+
+	if (fp == NULL)
+	{
+		SHAPER_LOGF_WARNING("Unable to open /proc/net/psched (%s); using default clock", strerror(errno));
+		return;
+	}
+	if (fscanf(fp, "%08x%08x%08x%08x", &t2us, &us2t, &clockRes, &hz) == 4 && us2t != 0)
+	{
+		// Kernels with a nanosecond clock advertise a multiplier of 1000 that is really 1.
+		if (clockRes == 1000000000)
+		{
+			t2us = us2t;
+		}
+		tickInUsec = (double)t2us / us2t * ((double)clockRes / 1000000);
+		if (clockRes == 1000000 && hz != 0)
+		{
+			clockHz = hz;
+		}
+	}
+	fclose(fp);
+}
+
+// Time in scheduler ticks to send size bytes at rate bytes per second.
+static uint32_t x_xmitTime(uint32_t rate, uint32_t size)
+{
+	double ticks = 1000000.0 * size / rate * tickInUsec;
+	return ticks < UINT32_MAX ? (uint32_t)ticks : UINT32_MAX;
+}
+
+static struct rtattr *x_attrPut(struct nlmsghdr *n, int type, const void *data, int len)
+{
+	struct rtattr *rta = (struct rtattr *)((char *)n + NLMSG_ALIGN(n->nlmsg_len));
+
+	rta->rta_type = type;
+	rta->rta_len = RTA_LENGTH(len);
+	if (len)
+	{
+		memcpy(RTA_DATA(rta), data, len);
+	}
+	n->nlmsg_len = NLMSG_ALIGN(n->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+	return rta;
+}
+
+static void x_attrPutString(struct nlmsghdr *n, int type, const char *str)
+{
+	x_attrPut(n, type, str, strlen(str) + 1);
+}
+
+static struct rtattr *x_nestStart(struct nlmsghdr *n, int type)
+{
+	return x_attrPut(n, type, NULL, 0);
+}
+
+static void x_nestEnd(struct nlmsghdr *n, struct rtattr *nest)
+{
+	nest->rta_len = (char *)n + n->nlmsg_len - (char *)nest;
+}
+
+static void x_reportFailure(const nl_request *req, int error, const char *extMsg)
+{
+	nlFailures++;
+	if (extMsg)
+	{
+		SHAPER_LOGF_ERROR("%s failed: %s (%s)", req->desc, strerror(error), extMsg);
+	}
+	else
+	{
+		SHAPER_LOGF_ERROR("%s failed: %s", req->desc, strerror(error));
+	}
+	if (nlErrorFn && req->sockfd >= 0)
+	{
+		nlErrorFn(req->sockfd, "%s failed: %s", req->desc, strerror(error));
+	}
+}
+
+static nl_request *x_findRequest(uint32_t seq)
+{
+	// Acknowledgements come back in order, so this rarely looks past the first few entries.
+	int i;
+	for (i = nlBatchFirst; i < nlRequestCount; ++i)
+	{
+		if (nlRequests[i].seq == seq)
+		{
+			return &nlRequests[i];
+		}
+	}
+	return NULL;
+}
+
+// Extended ack error string, if the kernel supplied one.
+static const char *x_extAckMessage(const struct nlmsghdr *h)
+{
+#ifdef NLM_F_ACK_TLVS
+	const struct nlmsgerr *err = (const struct nlmsgerr *)NLMSG_DATA(h);
+	const struct rtattr *rta;
+	int len, offset;
+
+	if (!(h->nlmsg_flags & NLM_F_ACK_TLVS))
+	{
+		return NULL;
+	}
+	offset = sizeof(*err);
+	if (!(h->nlmsg_flags & NLM_F_CAPPED))
+	{
+		offset += err->msg.nlmsg_len - sizeof(err->msg);
+	}
+	len = h->nlmsg_len - NLMSG_HDRLEN - offset;
+	for (rta = (const struct rtattr *)((const char *)err + offset); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+	{
+		if (rta->rta_type == NLMSGERR_ATTR_MSG)
+		{
+			return (const char *)RTA_DATA(rta);
+		}
+	}
+#else
+	(void) h;
+#endif
+	return NULL;
+}
+
+// Send the queued requests in one message and collect one acknowledgement per request.
+static void x_flush(void)
+{
+	struct sockaddr_nl kernel;
+	char reply[16 * 1024] __attribute__((aligned(NLMSG_ALIGNTO)));
+	int pending = nlRequestCount - nlBatchFirst;
+	int i;
+
+	if (pending == 0)
+	{
+		return;
+	}
+
+	memset(&kernel, 0, sizeof(kernel));
+	kernel.nl_family = AF_NETLINK;
+	if (sendto(nlSocket, nlBatch, nlBatchUsed, 0, (struct sockaddr *)&kernel, sizeof(kernel)) < 0)
+	{
+		int error = errno;
+		for (i = nlBatchFirst; i < nlRequestCount; ++i)
+		{
+			x_reportFailure(&nlRequests[i], error, NULL);
+		}
+		pending = 0;
+	}
+
+	while (pending > 0)
+	{
+		struct nlmsghdr *h;
+		int len = recv(nlSocket, reply, sizeof(reply), 0);
+		if (len < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			SHAPER_LOGF_ERROR("rtnetlink receive error %d (%s); %d request(s) unconfirmed", errno, strerror(errno), pending);
+			nlFailures += pending;
+			break;
+		}
+
+		for (h = (struct nlmsghdr *)reply; NLMSG_OK(h, (unsigned int)len); h = NLMSG_NEXT(h, len))
+		{
+			nl_request *req;
+			const struct nlmsgerr *err;
+
+			if (h->nlmsg_type != NLMSG_ERROR)
+			{
+				continue;
+			}
+			req = x_findRequest(h->nlmsg_seq);
+			if (req == NULL)
+			{
+				continue;
+			}
+			pending--;
+			err = (const struct nlmsgerr *)NLMSG_DATA(h);
+			if (err->error != 0)
+			{
+				x_reportFailure(req, -err->error, x_extAckMessage(h));
+			}
+			else
+			{
+				req->applied = 1;
+				SHAPER_LOGF_DEBUG("%s done", req->desc);
+			}
+		}
+	}
+
+	nlBatchUsed = 0;
+	nlBatchFirst = nlRequestCount;
+}
+
+// Send a single request and wait for its acknowledgement. Returns 0 or the error number.
+static int x_sendRequest(struct nlmsghdr *n)
+{
+	struct sockaddr_nl kernel;
+	char reply[4 * 1024] __attribute__((aligned(NLMSG_ALIGNTO)));
+
+	memset(&kernel, 0, sizeof(kernel));
+	kernel.nl_family = AF_NETLINK;
+	n->nlmsg_seq = ++nlSeq;
+	if (sendto(nlSocket, n, n->nlmsg_len, 0, (struct sockaddr *)&kernel, sizeof(kernel)) < 0)
+	{
+		return errno;
+	}
+
+	for (;;)
+	{
+		struct nlmsghdr *h;
+		int len = recv(nlSocket, reply, sizeof(reply), 0);
+		if (len < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			return errno;
+		}
+		for (h = (struct nlmsghdr *)reply; NLMSG_OK(h, (unsigned int)len); h = NLMSG_NEXT(h, len))
+		{
+			if (h->nlmsg_type == NLMSG_ERROR && h->nlmsg_seq == n->nlmsg_seq)
+			{
+				return -((const struct nlmsgerr *)NLMSG_DATA(h))->error;
+			}
+		}
+	}
+}
+
+// Reverse the requests of the transaction that the kernel accepted, newest first, so a transaction
+// with any failure leaves the kernel configured as it was before shaperNetlinkBegin().
+static void x_rollback(void)
+{
+	int i;
+
+	for (i = nlRequestCount - 1; i >= 0; --i)
+	{
+		nl_request *req = &nlRequests[i];
+		int error;
+
+		if (!req->applied)
+		{
+			continue;
+		}
+		if (req->undoLen == 0)
+		{
+			SHAPER_LOGF_WARNING("%s cannot be rolled back", req->desc);
+			continue;
+		}
+		error = x_sendRequest((struct nlmsghdr *)(nlUndo + req->undoOffset));
+		if (error != 0)
+		{
+			SHAPER_LOGF_ERROR("Rolling back %s failed: %s", req->desc, strerror(error));
+		}
+		else
+		{
+			SHAPER_LOGF_DEBUG("%s rolled back", req->desc);
+		}
+	}
+	nlIfindex = nlIfindexBegin;
+}
+
+static void x_resetTransaction(void)
+{
+	nlBatchUsed = 0;
+	nlRequestCount = 0;
+	nlBatchFirst = 0;
+	nlUndoUsed = 0;
+}
+
+static struct nlmsghdr *x_msgInit(char *buffer, int type, int flags, uint32_t handle, uint32_t parent, uint32_t info)
+{
+	struct nlmsghdr *n = (struct nlmsghdr *)buffer;
+	struct tcmsg *tcm;
+
+	memset(n, 0, NL_MAX_REQUEST_SIZE);
+	n->nlmsg_len = NLMSG_LENGTH(sizeof(struct tcmsg));
+	n->nlmsg_type = type;
+	n->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+
+	tcm = (struct tcmsg *)NLMSG_DATA(n);
+	tcm->tcm_family = AF_UNSPEC;
+	tcm->tcm_ifindex = nlIfindex;
+	tcm->tcm_handle = handle;
+	tcm->tcm_parent = parent;
+	tcm->tcm_info = info;
+	return n;
+}
+
+// Make room in the transaction tables for one more request and its undo request.
+// The whole transaction must stay in them so that it can be rolled back.
+static void x_transactionReserve(void)
+{
+	if (nlRequestCount == nlRequestMax)
+	{
+		int max = nlRequestMax ? nlRequestMax * 2 : NL_INITIAL_REQUESTS;
+		nl_request *requests = (nl_request *)realloc(nlRequests, max * sizeof(nl_request));
+		if (requests == NULL)
+		{
+			SHAPER_LOG_ERROR("Unable to allocate memory. Exiting program");
+			shaperLogExit();
+			exit(1);
+		}
+		nlRequests = requests;
+		nlRequestMax = max;
+	}
+	if (nlUndoUsed + NL_MAX_REQUEST_SIZE > nlUndoSize)
+	{
+		size_t size = nlUndoSize ? nlUndoSize * 2 : NL_INITIAL_UNDO_SIZE;
+		char *undo = (char *)realloc(nlUndo, size);
+		if (undo == NULL)
+		{
+			SHAPER_LOG_ERROR("Unable to allocate memory. Exiting program");
+			shaperLogExit();
+			exit(1);
+		}
+		nlUndo = undo;
+		nlUndoSize = size;
+	}
+}
+
+// Start a new request in the batch, flushing the batch first if it is full.
+static struct nlmsghdr *x_requestStart(int type, int flags, uint32_t handle, uint32_t parent, uint32_t info, const char *fmt, ...)
+{
+	struct nlmsghdr *n;
+	nl_request *req;
+	va_list args;
+
+	if (nlBatchUsed + NL_MAX_REQUEST_SIZE > sizeof(nlBatch))
+	{
+		x_flush();
+	}
+	x_transactionReserve();
+
+	n = x_msgInit(nlBatch + nlBatchUsed, type, flags, handle, parent, info);
+	n->nlmsg_seq = ++nlSeq;
+
+	req = &nlRequests[nlRequestCount];
+	req->seq = n->nlmsg_seq;
+	req->sockfd = nlSockfd;
+	req->applied = 0;
+	req->undoOffset = 0;
+	req->undoLen = 0;
+	va_start(args, fmt);
+	vsnprintf(req->desc, sizeof(req->desc), fmt, args);
+	va_end(args);
+
+	return n;
+}
+
+static void x_requestEnd(struct nlmsghdr *n)
+{
+	nlBatchUsed += NLMSG_ALIGN(n->nlmsg_len);
+	nlRequestCount++;
+}
+
+// Start the request that reverses the one being built; call before x_requestEnd().
+static struct nlmsghdr *x_undoStart(int type, int flags, uint32_t handle, uint32_t parent, uint32_t info)
+{
+	return x_msgInit(nlUndo + nlUndoUsed, type, flags, handle, parent, info);
+}
+
+static void x_undoEnd(struct nlmsghdr *u)
+{
+	nl_request *req = &nlRequests[nlRequestCount];
+
+	req->undoOffset = nlUndoUsed;
+	req->undoLen = u->nlmsg_len;
+	nlUndoUsed += NLMSG_ALIGN(u->nlmsg_len);
+}
+
+int shaperNetlinkOpen(shaper_netlink_error_fn errorFn)
+{
+	struct sockaddr_nl local;
+	int one = 1;
+
+	nlErrorFn = errorFn;
+
+	nlSocket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+	if (nlSocket < 0)
+	{
+		SHAPER_LOGF_ERROR("Could not open rtnetlink socket.  Error %d (%s)", errno, strerror(errno));
+		return -1;
+	}
+
+	memset(&local, 0, sizeof(local));
+	local.nl_family = AF_NETLINK;
+	if (bind(nlSocket, (struct sockaddr *)&local, sizeof(local)) < 0)
+	{
+		SHAPER_LOGF_ERROR("rtnetlink bind() error %d (%s)", errno, strerror(errno));
+		close(nlSocket);
+		nlSocket = -1;
+		return -1;
+	}
+
+	// Keep acknowledgements small and ask for the kernel error strings when available.
+#ifdef NETLINK_CAP_ACK
+	setsockopt(nlSocket, SOL_NETLINK, NETLINK_CAP_ACK, &one, sizeof(one));
+#endif
+#ifdef NETLINK_EXT_ACK
+	setsockopt(nlSocket, SOL_NETLINK, NETLINK_EXT_ACK, &one, sizeof(one));
+#endif
+	(void) one;
+
+	x_readPsched();
+	return 0;
+}
+
+void shaperNetlinkClose(void)
+{
+	if (nlSocket >= 0)
+	{
+		close(nlSocket);
+		nlSocket = -1;
+	}
+	x_resetTransaction();
+	free(nlRequests);
+	nlRequests = NULL;
+	nlRequestMax = 0;
+	free(nlUndo);
+	nlUndo = NULL;
+	nlUndoSize = 0;
+}
+
+int shaperNetlinkSetInterface(const char *ifname)
+{
+	int ifindex = if_nametoindex(ifname);
+	if (ifindex == 0)
+	{
+		return -1;
+	}
+	nlIfindex = ifindex;
+	return 0;
+}
+
+void shaperNetlinkBegin(int sockfd)
+{
+	x_resetTransaction();
+	nlSockfd = sockfd;
+	nlFailures = 0;
+	nlIfindexBegin = nlIfindex;
+}
+
+int shaperNetlinkCommit(void)
+{
+	int failures;
+
+	x_flush();
+	failures = nlFailures;
+	if (failures > 0)
+	{
+		SHAPER_LOGF_INFO("%d request(s) failed; rolling back the rest of the batch", failures);
+		x_rollback();
+	}
+	x_resetTransaction();
+	nlFailures = 0;
+	nlSockfd = -1;
+	return failures;
+}
+
+void shaperNetlinkAddMqprio(uint32_t handle)
+{
+	// Equivalent to "mqprio num_tc 4 map 3 3 1 0 2 2 2 2 2 2 2 2 2 2 2 2 queues 1@0 1@1 1@2 1@3 hw 0"
+	static const uint8_t prioMap[TC_QOPT_BITMASK + 1] = { 3, 3, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 };
+	struct tc_mqprio_qopt opt;
+	struct nlmsghdr *n;
+	int i;
+
+	memset(&opt, 0, sizeof(opt));
+	opt.num_tc = 4;
+	memcpy(opt.prio_tc_map, prioMap, sizeof(opt.prio_tc_map));
+	opt.hw = 0;
+	for (i = 0; i < opt.num_tc; ++i)
+	{
+		opt.count[i] = 1;
+		opt.offset[i] = i;
+	}
+
+	n = x_requestStart(RTM_NEWQDISC, NLM_F_CREATE | NLM_F_EXCL, handle, TC_H_ROOT, 0,
+		"qdisc add root %x: mqprio", TC_H_MAJ(handle) >> 16);
+	x_attrPutString(n, TCA_KIND, "mqprio");
+	x_attrPut(n, TCA_OPTIONS, &opt, sizeof(opt));
+	x_undoEnd(x_undoStart(RTM_DELQDISC, 0, handle, TC_H_ROOT, 0));
+	x_requestEnd(n);
+}
+
+void shaperNetlinkDelRootQdisc(uint32_t handle)
+{
+	struct nlmsghdr *n;
+
+	n = x_requestStart(RTM_DELQDISC, 0, handle, TC_H_ROOT, 0,
+		"qdisc del root %x:", TC_H_MAJ(handle) >> 16);
+	x_requestEnd(n);
+}
+
+void shaperNetlinkAddHtb(uint32_t parent, uint32_t handle)
+{
+	struct tc_htb_glob opt;
+	struct nlmsghdr *n;
+	struct rtattr *nest;
+
+	memset(&opt, 0, sizeof(opt));
+	opt.version = 3;
+	opt.rate2quantum = 10;
+
+	n = x_requestStart(RTM_NEWQDISC, NLM_F_CREATE | NLM_F_EXCL, handle, parent, 0,
+		"qdisc add %x: parent %x:%x htb", TC_H_MAJ(handle) >> 16, TC_H_MAJ(parent) >> 16, TC_H_MIN(parent));
+	x_attrPutString(n, TCA_KIND, "htb");
+	nest = x_nestStart(n, TCA_OPTIONS);
+	x_attrPut(n, TCA_HTB_INIT, &opt, sizeof(opt));
+	x_nestEnd(n, nest);
+	x_undoEnd(x_undoStart(RTM_DELQDISC, 0, handle, parent, 0));
+	x_requestEnd(n);
+}
+
+static void x_htbClassOptions(struct nlmsghdr *n, uint32_t rate_bytes_per_sec, uint32_t cburst)
+{
+	struct tc_htb_opt opt;
+	struct rtattr *nest;
+	uint32_t buffer;
+
+	// Same defaults as "tc class ... htb rate <rate>bps cburst <cburst>": ceil = rate, burst = rate/HZ + MTU.
+	buffer = rate_bytes_per_sec / clockHz + TC_DEFAULT_MTU;
+	if (cburst == 0)
+	{
+		cburst = buffer;
+	}
+
+	memset(&opt, 0, sizeof(opt));
+	opt.rate.rate = rate_bytes_per_sec;
+	opt.rate.linklayer = TC_LINKLAYER_ETHERNET;
+	opt.ceil = opt.rate;
+	opt.buffer = x_xmitTime(rate_bytes_per_sec, buffer);
+	opt.cbuffer = x_xmitTime(rate_bytes_per_sec, cburst);
+
+	x_attrPutString(n, TCA_KIND, "htb");
+	nest = x_nestStart(n, TCA_OPTIONS);
+	x_attrPut(n, TCA_HTB_PARMS, &opt, sizeof(opt));
+	x_nestEnd(n, nest);
+}
+
+void shaperNetlinkHtbClass(uint32_t classid, uint32_t rate_bytes_per_sec, uint32_t cburst, uint32_t old_rate, uint32_t old_cburst)
+{
+	struct nlmsghdr *n, *u;
+	int create = (old_rate == 0);
+
+	n = x_requestStart(RTM_NEWTCLASS, create ? (NLM_F_CREATE | NLM_F_EXCL) : 0, classid, TC_H_UNSPEC, 0,
+		"class %s %x:%x rate %ubps", create ? "add" : "change", TC_H_MAJ(classid) >> 16, TC_H_MIN(classid), rate_bytes_per_sec);
+	x_htbClassOptions(n, rate_bytes_per_sec, cburst);
+	if (create)
+	{
+		u = x_undoStart(RTM_DELTCLASS, 0, classid, TC_H_UNSPEC, 0);
+	}
+	else
+	{
+		u = x_undoStart(RTM_NEWTCLASS, 0, classid, TC_H_UNSPEC, 0);
+		x_htbClassOptions(u, old_rate, old_cburst);
+	}
+	x_undoEnd(u);
+	x_requestEnd(n);
+}
+
+static void x_cbsOptions(struct nlmsghdr *n, const struct tc_cbs_qopt *opt)
+{
+	struct rtattr *nest;
+
+	x_attrPutString(n, TCA_KIND, "cbs");
+	nest = x_nestStart(n, TCA_OPTIONS);
+	x_attrPut(n, TCA_CBS_PARMS, opt, sizeof(*opt));
+	x_nestEnd(n, nest);
+}
+
+void shaperNetlinkCbs(uint32_t parent, uint32_t handle, const struct tc_cbs_qopt *opt, const struct tc_cbs_qopt *old_opt)
+{
+	struct nlmsghdr *n, *u;
+	int create = (old_opt->idleslope == 0);
+
+	n = x_requestStart(RTM_NEWQDISC, create ? (NLM_F_CREATE | NLM_F_EXCL) : 0, handle, parent, 0,
+		"qdisc %s %x: cbs idleslope %d", create ? "add" : "change", TC_H_MAJ(handle) >> 16, opt->idleslope);
+	x_cbsOptions(n, opt);
+	if (create)
+	{
+		u = x_undoStart(RTM_DELQDISC, 0, handle, parent, 0);
+	}
+	else
+	{
+		u = x_undoStart(RTM_NEWQDISC, 0, handle, parent, 0);
+		x_cbsOptions(u, old_opt);
+	}
+	x_undoEnd(u);
+	x_requestEnd(n);
+}
+
+// u32 keys are 32-bit words at 4-byte aligned offsets; pack a byte the way "match u8" does.
+static void x_u32PackByte(struct tc_u32_sel *sel, uint8_t value, int off)
+{
+	int shift = 24 - 8 * (off & 3);
+	int keyOff = off & ~3;
+	struct tc_u32_key *key;
+	int i;
+
+	for (i = 0; i < sel->nkeys; ++i)
+	{
+		if (sel->keys[i].off == keyOff)
+		{
+			break;
+		}
+	}
+	key = &sel->keys[i];
+	if (i == sel->nkeys)
+	{
+		key->off = keyOff;
+		sel->nkeys++;
+	}
+	key->val |= htonl((uint32_t)value << shift);
+	key->mask |= htonl((uint32_t)0xFF << shift);
+}
+
+static void x_u32Options(struct nlmsghdr *n, uint32_t classid, const uint8_t dest_addr[6])
+{
+	// The destination address spans two keys relative to the network header.
+	char selBuffer[sizeof(struct tc_u32_sel) + 2 * sizeof(struct tc_u32_key)];
+	struct tc_u32_sel *sel = (struct tc_u32_sel *)selBuffer;
+	struct rtattr *nest;
+	int i;
+
+	memset(selBuffer, 0, sizeof(selBuffer));
+	sel->flags = TC_U32_TERMINAL;
+	for (i = 0; i < 6; ++i)
+	{
+		x_u32PackByte(sel, dest_addr[i], -ETH_HLEN + i);
+	}
+
+	x_attrPutString(n, TCA_KIND, "u32");
+	nest = x_nestStart(n, TCA_OPTIONS);
+	x_attrPut(n, TCA_U32_CLASSID, &classid, sizeof(classid));
+	x_attrPut(n, TCA_U32_SEL, selBuffer, sizeof(struct tc_u32_sel) + sel->nkeys * sizeof(struct tc_u32_key));
+	x_nestEnd(n, nest);
+}
+
+void shaperNetlinkAddFilter(uint32_t parent, uint32_t handle, uint32_t classid, const uint8_t dest_addr[6])
+{
+	struct nlmsghdr *n, *u;
+	uint32_t info = TC_H_MAKE(TC_FILTER_PRIO << 16, htons(ETH_P_ALL));
+
+	n = x_requestStart(RTM_NEWTFILTER, NLM_F_CREATE | NLM_F_EXCL, handle, parent, info,
+		"filter add %x: handle %x::%x", TC_H_MAJ(parent) >> 16, handle >> 20, handle & 0xFFF);
+	x_u32Options(n, classid, dest_addr);
+	u = x_undoStart(RTM_DELTFILTER, 0, handle, parent, info);
+	x_attrPutString(u, TCA_KIND, "u32");
+	x_undoEnd(u);
+	x_requestEnd(n);
+}
+
+void shaperNetlinkDelFilter(uint32_t parent, uint32_t handle, uint32_t classid, const uint8_t dest_addr[6])
+{
+	struct nlmsghdr *n, *u;
+	uint32_t info = TC_H_MAKE(TC_FILTER_PRIO << 16, htons(ETH_P_ALL));
+
+	n = x_requestStart(RTM_DELTFILTER, 0, handle, parent, info,
+		"filter del %x: handle %x::%x", TC_H_MAJ(parent) >> 16, handle >> 20, handle & 0xFFF);
+	x_attrPutString(n, TCA_KIND, "u32");
+	u = x_undoStart(RTM_NEWTFILTER, NLM_F_CREATE | NLM_F_EXCL, handle, parent, info);
+	x_u32Options(u, classid, dest_addr);
+	x_undoEnd(u);
+	x_requestEnd(n);
+}
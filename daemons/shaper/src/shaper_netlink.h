@@ -0,0 +1,83 @@
+/*************************************************************************************************************
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Programs the kernel traffic control configuration over rtnetlink.
+*
+* - Requests are queued and sent to the kernel in one batch by shaperNetlinkCommit().
+* - Each request is acknowledged by the kernel; failures are reported per request.
+* - A batch is all or nothing: if any request fails, the ones the kernel accepted are reversed.
+* - Handles and class IDs use the kernel format (major << 16 | minor).
+*/
+
+#ifndef SHAPER_NETLINK_H
+#define SHAPER_NETLINK_H 1
+
+#include <stdint.h>
+#include <linux/pkt_sched.h>
+
+// Callback used to report a failed request to the client that caused it.
+typedef void (*shaper_netlink_error_fn)(int sockfd, const char *fmt, ...);
+
+// Open the rtnetlink socket. Returns 0 on success, -1 on failure.
+int shaperNetlinkOpen(shaper_netlink_error_fn errorFn);
+
+// Close the rtnetlink socket, discarding any queued requests.
+void shaperNetlinkClose(void);
+
+// Select the interface used by the following requests. Returns 0 on success, -1 if the interface is unknown.
+int shaperNetlinkSetInterface(const char *ifname);
+
+// Start a batch of requests on behalf of the client sockfd (-1 for stdin).
+void shaperNetlinkBegin(int sockfd);
+
+// Send all queued requests and wait for the kernel replies. Returns the number of failed requests;
+// when it is not 0, the accepted requests of the batch have been rolled back.
+int shaperNetlinkCommit(void);
+
+// Queue adding the root mqprio qdisc with one queue per traffic class.
+void shaperNetlinkAddMqprio(uint32_t handle);
+
+// Queue deleting the root qdisc (and everything below it). This is the one request that cannot be rolled back.
+void shaperNetlinkDelRootQdisc(uint32_t handle);
+
+// Queue adding an HTB qdisc below the given parent class.
+void shaperNetlinkAddHtb(uint32_t parent, uint32_t handle);
+
+// Queue adding (old_rate == 0) or changing an HTB class; the old values are restored on rollback.
+// A cburst of 0 selects the tc default.
+void shaperNetlinkHtbClass(uint32_t classid, uint32_t rate_bytes_per_sec, uint32_t cburst, uint32_t old_rate, uint32_t old_cburst);
+
+// Queue adding (old_opt->idleslope == 0) or changing the credit based shaper qdisc below an HTB class;
+// the old values are restored on rollback. Slopes are in kbit/s and credits in bytes.
+void shaperNetlinkCbs(uint32_t parent, uint32_t handle, const struct tc_cbs_qopt *opt, const struct tc_cbs_qopt *old_opt);
+
+// Queue adding a u32 filter that sends frames for dest_addr to classid.
+void shaperNetlinkAddFilter(uint32_t parent, uint32_t handle, uint32_t classid, const uint8_t dest_addr[6]);
+
+// Queue deleting a u32 filter added by shaperNetlinkAddFilter(), with the same arguments it was added with.
+void shaperNetlinkDelFilter(uint32_t parent, uint32_t handle, uint32_t classid, const uint8_t dest_addr[6]);
+
+#endif // SHAPER_NETLINK_H
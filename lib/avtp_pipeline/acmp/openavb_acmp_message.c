@@ -50,6 +50,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_avtp.h"
 #include "openavb_srp.h"
 #include "openavb_acmp.h"
+#include "openavb_avdecc_loop.h"
 #include "openavb_acmp_sm_controller.h"
 #include "openavb_acmp_sm_listener.h"
 #include "openavb_acmp_sm_talker.h"
@@ -88,11 +89,16 @@ THREAD_TYPE(openavbAcmpMessageRxThread);
 THREAD_DEFINITON(openavbAcmpMessageRxThread);
 
 static bool bRunning = FALSE;
+static bool bLoopRxJoined = FALSE;
 
 void openavbAcmpCloseSocket()
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_ACMP);
 
+	if (bLoopRxJoined) {
+		openavbAvdeccLoopRxMulticast(FALSE, ADDR_PTR(&acmpAddr));
+		bLoopRxJoined = FALSE;
+	}
 	if (rxSock) {
 		openavbRawsockClose(rxSock);
 		rxSock = NULL;
@@ -111,15 +117,19 @@ bool openavbAcmpOpenSocket(const char* ifname, U16 vlanID, U8 vlanPCP)
 
 	hdr_info_t hdr;
 
-	rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_AVTP, ACMP_FRAME_LEN, ACMP_NUM_RX_BUFFERS);
+	// With the event loop, frames arrive through its shared socket instead.
+	if (!gAvdeccCfg.bEventLoop) {
+		rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_AVTP, ACMP_FRAME_LEN, ACMP_NUM_RX_BUFFERS);
+	}
 	txSock = openavbRawsockOpen(ifname, FALSE, TRUE, ETHERTYPE_AVTP, ACMP_FRAME_LEN, ACMP_NUM_TX_BUFFERS);
 
-	if (txSock && rxSock
+	if (txSock && (rxSock || gAvdeccCfg.bEventLoop)
 		&& openavbRawsockGetAddr(txSock, ADDR_PTR(&intfAddr))
 		&& ether_aton_r(ACMP_PROTOCOL_ADDR, &acmpAddr)
-		&& openavbRawsockRxMulticast(rxSock, TRUE, ADDR_PTR(&acmpAddr)))
+		&& (rxSock ? openavbRawsockRxMulticast(rxSock, TRUE, ADDR_PTR(&acmpAddr))
+			: (bLoopRxJoined = openavbAvdeccLoopRxMulticast(TRUE, ADDR_PTR(&acmpAddr)))))
 	{
-		if (!openavbRawsockRxAVTPSubtype(rxSock, OPENAVB_ACMP_AVTP_SUBTYPE | 0x80)) {
+		if (rxSock && !openavbRawsockRxAVTPSubtype(rxSock, OPENAVB_ACMP_AVTP_SUBTYPE | 0x80)) {
 			AVB_LOG_DEBUG("RX AVTP Subtype not supported");
 		}
 
@@ -385,6 +395,15 @@ openavbRC openavbAcmpMessageHandlerStart()
 
 	if (openavbAcmpOpenSocket((const char *)gAvdeccCfg.ifname, gAvdeccCfg.vlanID, gAvdeccCfg.vlanPCP)) {
 
+		if (gAvdeccCfg.bEventLoop) {
+			if (!openavbAvdeccLoopRegisterRx(0x80 | OPENAVB_ACMP_AVTP_SUBTYPE, openavbAcmpMessageRxFrameParse)) {
+				bRunning = FALSE;
+				openavbAcmpCloseSocket();
+				AVB_RC_TRACE_RET(OPENAVB_AVDECC_FAILURE, AVB_TRACE_ACMP);
+			}
+			AVB_RC_TRACE_RET(OPENAVB_AVDECC_SUCCESS, AVB_TRACE_ACMP);
+		}
+
 		// Start the RX thread
 		bool errResult;
 		THREAD_CREATE(openavbAcmpMessageRxThread, openavbAcmpMessageRxThread, NULL, openavbAcmpMessageRxThreadFn, NULL);
@@ -408,7 +427,12 @@ void openavbAcmpMessageHandlerStop()
 
 	if (bRunning) {
 		bRunning = FALSE;
-		THREAD_JOIN(openavbAcmpMessageRxThread, NULL);
+		if (gAvdeccCfg.bEventLoop) {
+			openavbAvdeccLoopRegisterRx(0x80 | OPENAVB_ACMP_AVTP_SUBTYPE, NULL);
+		}
+		else {
+			THREAD_JOIN(openavbAcmpMessageRxThread, NULL);
+		}
 		openavbAcmpCloseSocket();
 	}
 
@@ -50,6 +50,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_avtp.h"
 #include "openavb_srp.h"
 #include "openavb_adp.h"
+#include "openavb_avdecc_loop.h"
 #include "openavb_adp_sm_advertise_interface.h"
 #include "openavb_acmp_sm_listener.h"
 
@@ -100,11 +101,16 @@ THREAD_TYPE(openavbAdpMessageRxThread);
 THREAD_DEFINITON(openavbAdpMessageRxThread);
 
 static bool bRunning = FALSE;
+static bool bLoopRxJoined = FALSE;
 
 void openavbAdpCloseSocket()
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_ADP);
 
+	if (bLoopRxJoined) {
+		openavbAvdeccLoopRxMulticast(FALSE, ADDR_PTR(&adpAddr));
+		bLoopRxJoined = FALSE;
+	}
 	if (rxSock) {
 		openavbRawsockClose(rxSock);
 		rxSock = NULL;
@@ -123,20 +129,24 @@ bool openavbAdpOpenSocket(const char* ifname, U16 vlanID, U8 vlanPCP)
 
 	hdr_info_t hdr;
 
+	// With the event loop, frames arrive through its shared socket instead.
+	if (!gAvdeccCfg.bEventLoop) {
 #ifndef UBUNTU
-	// This is the normal case for most of our supported platforms
-	rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_8021Q, ADP_FRAME_LEN, ADP_NUM_BUFFERS);
+		// This is the normal case for most of our supported platforms
+		rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_8021Q, ADP_FRAME_LEN, ADP_NUM_BUFFERS);
 #else
-	rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_AVTP, ADP_FRAME_LEN, ADP_NUM_BUFFERS);
+		rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_AVTP, ADP_FRAME_LEN, ADP_NUM_BUFFERS);
 #endif
+	}
 	txSock = openavbRawsockOpen(ifname, FALSE, TRUE, ETHERTYPE_AVTP, ADP_FRAME_LEN, ADP_NUM_BUFFERS);
 
-	if (txSock && rxSock
+	if (txSock && (rxSock || gAvdeccCfg.bEventLoop)
 		&& openavbRawsockGetAddr(txSock, ADDR_PTR(&intfAddr))
 		&& ether_aton_r(ADP_PROTOCOL_ADDR, &adpAddr)
-		&& openavbRawsockRxMulticast(rxSock, TRUE, ADDR_PTR(&adpAddr)))
+		&& (rxSock ? openavbRawsockRxMulticast(rxSock, TRUE, ADDR_PTR(&adpAddr))
+			: (bLoopRxJoined = openavbAvdeccLoopRxMulticast(TRUE, ADDR_PTR(&adpAddr)))))
 	{
-		if (!openavbRawsockRxAVTPSubtype(rxSock, OPENAVB_ADP_AVTP_SUBTYPE | 0x80)) {
+		if (rxSock && !openavbRawsockRxAVTPSubtype(rxSock, OPENAVB_ADP_AVTP_SUBTYPE | 0x80)) {
 			AVB_LOG_DEBUG("RX AVTP Subtype not supported");
 		}
 
@@ -286,6 +296,14 @@ static void openavbAdpMessageRxFrameReceive(U32 timeoutUsec)
 	AVB_TRACE_EXIT(AVB_TRACE_ADP);
 }
 
+// Called from the AVDECC event loop for each ADP PDU.
+static void openavbAdpMessageRxLoopCb(U8 *pdu, int len, hdr_info_t *hdr)
+{
+	if (memcmp(hdr->shost, ADDR_PTR(&intfAddr), 6) != 0) { // Not from us!
+		openavbAdpMessageRxFrameParse(pdu, len, hdr);
+	}
+}
+
 
 void openavbAdpMessageTxFrame(U8 msgType, U8 *destAddr)
 {
@@ -387,6 +405,15 @@ openavbRC openavbAdpMessageHandlerStart()
 
 	if (openavbAdpOpenSocket((const char *)gAvdeccCfg.ifname, gAvdeccCfg.vlanID, gAvdeccCfg.vlanPCP)) {
 
+		if (gAvdeccCfg.bEventLoop) {
+			if (!openavbAvdeccLoopRegisterRx(0x80 | OPENAVB_ADP_AVTP_SUBTYPE, openavbAdpMessageRxLoopCb)) {
+				bRunning = FALSE;
+				openavbAdpCloseSocket();
+				AVB_RC_TRACE_RET(OPENAVB_AVDECC_FAILURE, AVB_TRACE_ADP);
+			}
+			AVB_RC_TRACE_RET(OPENAVB_AVDECC_SUCCESS, AVB_TRACE_ADP);
+		}
+
 		// Start the RX thread
 		bool errResult;
 		THREAD_CREATE(openavbAdpMessageRxThread, openavbAdpMessageRxThread, NULL, openavbAdpMessageRxThreadFn, NULL);
@@ -410,7 +437,12 @@ void openavbAdpMessageHandlerStop()
 
 	if (bRunning) {
 		bRunning = FALSE;
-		THREAD_JOIN(openavbAdpMessageRxThread, NULL);
+		if (gAvdeccCfg.bEventLoop) {
+			openavbAvdeccLoopRegisterRx(0x80 | OPENAVB_ADP_AVTP_SUBTYPE, NULL);
+		}
+		else {
+			THREAD_JOIN(openavbAdpMessageRxThread, NULL);
+		}
 		openavbAdpCloseSocket();
 	}
 
@@ -48,6 +48,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_adp.h"
 #include "openavb_adp_sm_advertise_interface.h"
 #include "openavb_adp_sm_advertise_entity.h"
+#include "openavb_avdecc_loop.h"
 
 typedef enum {
 	OPENAVB_ADP_SM_ADVERTISE_ENTITY_STATE_INITIALIZE,
@@ -57,6 +58,7 @@ typedef enum {
 	OPENAVB_ADP_SM_ADVERTISE_ENTITY_STATE_TERMINATE,
 } openavb_adp_sm_advertise_entity_state_t;
 
+extern openavb_avdecc_cfg_t gAvdeccCfg;
 extern openavb_adp_sm_global_vars_t openavbAdpSMGlobalVars;
 extern openavb_adp_sm_advertise_interface_vars_t openavbAdpSMAdvertiseInterfaceVars;
 openavb_adp_sm_advertise_entity_vars_t openavbAdpSMAdvertiseEntityVars;
@@ -69,6 +71,9 @@ SEM_T(openavbAdpSMAdvertiseEntitySemaphore);
 THREAD_TYPE(openavbAdpSmAdvertiseEntityThread);
 THREAD_DEFINITON(openavbAdpSmAdvertiseEntityThread);
 
+// Used in place of the thread when running on the AVDECC event loop.
+static openavb_avdecc_loop_timer_t reannounceTimer;
+
 void openavbAdpSMAdvertiseEntity_sendAvailable()
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_ADP);
@@ -76,6 +81,52 @@ void openavbAdpSMAdvertiseEntity_sendAvailable()
 	AVB_TRACE_EXIT(AVB_TRACE_ADP);
 }
 
+// RESET_WAIT state actions. Returns the reannounce delay.
+static U32 openavbAdpSMAdvertiseEntity_resetWait()
+{
+	ADP_LOCK();
+	CLOCK_GETTIME(OPENAVB_CLOCK_REALTIME, &openavbAdpSMAdvertiseEntityVars.reannounceTimerTimeout);
+	/* The advertisements should be sent at intervals of 1/4 valid_time, where valid_time is in 2-second units.
+	 * See IEEE Std 1722.1-2013 clauses 6.2.1.6 and 6.2.4. */
+	U32 advDelayUsec = openavbAdpSMGlobalVars.entityInfo.header.valid_time / 2 * MICROSECONDS_PER_SECOND;
+	if (advDelayUsec < MICROSECONDS_PER_SECOND) {
+		advDelayUsec = MICROSECONDS_PER_SECOND;
+	}
+	openavbTimeTimespecAddUsec(&openavbAdpSMAdvertiseEntityVars.reannounceTimerTimeout, advDelayUsec);
+	ADP_UNLOCK();
+	return advDelayUsec;
+}
+
+// Actions on entering the WAITING state.
+static void openavbAdpSMAdvertiseEntity_enterWaiting()
+{
+	ADP_LOCK();
+	openavbAdpSMAdvertiseInterfaceSet_rcvdDiscover(FALSE);
+	openavbAdpSMGlobalVars.entityInfo.pdu.available_index++;
+	ADP_UNLOCK();
+}
+
+// Event loop form of the state machine. The reannounce timer expiring, or being fired early by
+// needsAdvertise, is the WAITING -> ADVERTISE transition.
+static void openavbAdpSMAdvertiseEntityTimerCb(void *arg)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_ADP);
+
+	if (!openavbAdpSMAdvertiseEntityVars.doTerminate) {
+		AVB_LOG_DEBUG("State:  OPENAVB_ADP_SM_ADVERTISE_ENTITY_STATE_ADVERTISE");
+		openavbAdpSMAdvertiseEntity_sendAvailable();
+		ADP_LOCK();
+		openavbAdpSMAdvertiseEntityVars.needsAdvertise = FALSE;
+		ADP_UNLOCK();
+
+		U32 advDelayUsec = openavbAdpSMAdvertiseEntity_resetWait();
+		openavbAdpSMAdvertiseEntity_enterWaiting();
+		openavbAvdeccLoopTimerStart(&reannounceTimer, advDelayUsec);
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_ADP);
+}
+
 void openavbAdpSMAdvertiseEntityStateMachine()
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_ADP);
@@ -117,16 +168,7 @@ void openavbAdpSMAdvertiseEntityStateMachine()
 					AVB_TRACE_LINE(AVB_TRACE_ADP);
 					AVB_LOG_DEBUG("State:  OPENAVB_ADP_SM_ADVERTISE_ENTITY_STATE_RESET_WAIT");
 
-					ADP_LOCK();
-					CLOCK_GETTIME(OPENAVB_CLOCK_REALTIME, &openavbAdpSMAdvertiseEntityVars.reannounceTimerTimeout);
-					/* The advertisements should be sent at intervals of 1/4 valid_time, where valid_time is in 2-second units.
-					 * See IEEE Std 1722.1-2013 clauses 6.2.1.6 and 6.2.4. */
-					U32 advDelayUsec = openavbAdpSMGlobalVars.entityInfo.header.valid_time / 2 * MICROSECONDS_PER_SECOND;
-					if (advDelayUsec < MICROSECONDS_PER_SECOND) {
-						advDelayUsec = MICROSECONDS_PER_SECOND;
-					}
-					openavbTimeTimespecAddUsec(&openavbAdpSMAdvertiseEntityVars.reannounceTimerTimeout, advDelayUsec);
-					ADP_UNLOCK();
+					openavbAdpSMAdvertiseEntity_resetWait();
 					state = OPENAVB_ADP_SM_ADVERTISE_ENTITY_STATE_WAITING;
 				}
 				break;
@@ -135,10 +177,7 @@ void openavbAdpSMAdvertiseEntityStateMachine()
 					AVB_TRACE_LINE(AVB_TRACE_ADP);
 					AVB_LOG_DEBUG("State:  OPENAVB_ADP_SM_ADVERTISE_ENTITY_STATE_WAITING");
 
-					ADP_LOCK();
-					openavbAdpSMAdvertiseInterfaceSet_rcvdDiscover(FALSE);
-					openavbAdpSMGlobalVars.entityInfo.pdu.available_index++;
-					ADP_UNLOCK();
+					openavbAdpSMAdvertiseEntity_enterWaiting();
 
 					// Wait for change in state
 					while (state == OPENAVB_ADP_SM_ADVERTISE_ENTITY_STATE_WAITING && bRunning) {
@@ -197,6 +236,19 @@ void openavbAdpSMAdvertiseEntityStart()
 	openavbAdpSMAdvertiseEntityVars.doTerminate = FALSE;
 	ADP_UNLOCK();
 
+	if (gAvdeccCfg.bEventLoop) {
+		// INITIALIZE, RESET_WAIT and WAITING, then let the reannounce timer drive the rest.
+		ADP_LOCK();
+		openavbAdpSMGlobalVars.entityInfo.pdu.available_index = 0;
+		ADP_UNLOCK();
+		openavbAvdeccLoopTimerInit(&reannounceTimer, openavbAdpSMAdvertiseEntityTimerCb, NULL);
+		U32 advDelayUsec = openavbAdpSMAdvertiseEntity_resetWait();
+		openavbAdpSMAdvertiseEntity_enterWaiting();
+		openavbAvdeccLoopTimerStart(&reannounceTimer, advDelayUsec);
+		AVB_TRACE_EXIT(AVB_TRACE_ADP);
+		return;
+	}
+
 	// Start the Advertise Entity State Machine
 	bool errResult;
 	THREAD_CREATE(openavbAdpSmAdvertiseEntityThread, openavbAdpSmAdvertiseEntityThread, NULL, openavbAdpSMAdvertiseEntityThreadFn, NULL);
@@ -211,7 +263,12 @@ void openavbAdpSMAdvertiseEntityStop()
 	AVB_TRACE_ENTRY(AVB_TRACE_ADP);
 
 	openavbAdpSMAdvertiseEntitySet_doTerminate(TRUE);
-	THREAD_JOIN(openavbAdpSmAdvertiseEntityThread, NULL);
+	if (gAvdeccCfg.bEventLoop) {
+		openavbAvdeccLoopTimerCancel(&reannounceTimer);
+	}
+	else {
+		THREAD_JOIN(openavbAdpSmAdvertiseEntityThread, NULL);
+	}
 
 	SEM_ERR_T(err);
 	SEM_DESTROY(openavbAdpSMAdvertiseEntitySemaphore, err);
@@ -226,6 +283,10 @@ void openavbAdpSMAdvertiseEntitySet_needsAdvertise(bool value)
 
 	openavbAdpSMAdvertiseEntityVars.needsAdvertise = value;
 
+	if (gAvdeccCfg.bEventLoop && value) {
+		openavbAvdeccLoopTimerStart(&reannounceTimer, 0);
+	}
+
 	SEM_ERR_T(err);
 	SEM_POST(openavbAdpSMAdvertiseEntitySemaphore, err);
 	SEM_LOG_ERR(err);
@@ -50,6 +50,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_avtp.h"
 #include "openavb_srp.h"
 #include "openavb_aecp.h"
+#include "openavb_avdecc_loop.h"
 #include "openavb_aecp_sm_entity_model_entity.h"
 
 #define INVALID_SOCKET (-1)
@@ -77,11 +78,16 @@ THREAD_TYPE(openavbAecpMessageRxThread);
 THREAD_DEFINITON(openavbAecpMessageRxThread);
 
 static bool bRunning = FALSE;
+static bool bLoopRxJoined = FALSE;
 
 void openavbAecpCloseSocket()
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_AECP);
 
+	if (bLoopRxJoined) {
+		openavbAvdeccLoopRxMulticast(FALSE, ADDR_PTR(&intfAddr));
+		bLoopRxJoined = FALSE;
+	}
 	if (rxSock) {
 		openavbRawsockClose(rxSock);
 		rxSock = NULL;
@@ -100,19 +106,24 @@ bool openavbAecpOpenSocket(const char* ifname, U16 vlanID, U8 vlanPCP)
 
 	hdr_info_t hdr;
 
+	// With the event loop, frames arrive through its shared socket instead.
+	if (!gAvdeccCfg.bEventLoop) {
 #ifndef UBUNTU
-	// This is the normal case for most of our supported platforms
-	rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_8021Q, AECP_FRAME_LEN, AECP_NUM_BUFFERS);
+		// This is the normal case for most of our supported platforms
+		rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_8021Q, AECP_FRAME_LEN, AECP_NUM_BUFFERS);
 #else
-	rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_AVTP, AECP_FRAME_LEN, AECP_NUM_BUFFERS);
+		rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_AVTP, AECP_FRAME_LEN, AECP_NUM_BUFFERS);
 #endif
+	}
 	txSock = openavbRawsockOpen(ifname, FALSE, TRUE, ETHERTYPE_AVTP, AECP_FRAME_LEN, AECP_NUM_BUFFERS);
 
-	if (txSock && rxSock
+	// Only accept packets sent directly to this interface
+	if (txSock && (rxSock || gAvdeccCfg.bEventLoop)
 		&& openavbRawsockGetAddr(txSock, ADDR_PTR(&intfAddr))
-		&& openavbRawsockRxMulticast(rxSock, TRUE, ADDR_PTR(&intfAddr))) // Only accept packets sent directly to this interface
+		&& (rxSock ? openavbRawsockRxMulticast(rxSock, TRUE, ADDR_PTR(&intfAddr))
+			: (bLoopRxJoined = openavbAvdeccLoopRxMulticast(TRUE, ADDR_PTR(&intfAddr)))))
 	{
-		if (!openavbRawsockRxAVTPSubtype(rxSock, OPENAVB_AECP_AVTP_SUBTYPE | 0x80)) {
+		if (rxSock && !openavbRawsockRxAVTPSubtype(rxSock, OPENAVB_AECP_AVTP_SUBTYPE | 0x80)) {
 			AVB_LOG_DEBUG("RX AVTP Subtype not supported");
 		}
 
@@ -153,9 +164,12 @@ static void openavbAecpMessageRxFrameParse(U8* payload, int payload_len, hdr_inf
 	AVB_LOG_BUFFER(AVB_LOG_LEVEL_DEBUG, payload, payload_len, 16);
 #endif
 
+	// Parsed on the stack, the state machine copies what it queues.
+	openavb_aecp_AEMCommandResponse_t commandResponse;
+	openavb_aecp_AEMCommandResponse_t * openavbAecpCommandResponse = &commandResponse;
+	memset(&commandResponse, 0, sizeof(commandResponse));
+
 	// Save the source address
-	openavb_aecp_AEMCommandResponse_t * openavbAecpCommandResponse = calloc(1, sizeof(openavb_aecp_AEMCommandResponse_t));
-	if (!openavbAecpCommandResponse) { return; }
 	memcpy(openavbAecpCommandResponse->host, hdr->shost, ETH_ALEN);
 
 	U8 *pSrc = payload;
@@ -179,7 +193,7 @@ static void openavbAecpMessageRxFrameParse(U8* payload, int payload_len, hdr_inf
 		OCT_B2DNTOHS(pDst->sequence_id, pSrc);
 	}
 	else {
-		free(openavbAecpCommandResponse);
+		AVB_TRACE_EXIT(AVB_TRACE_AECP);
 		return;
 	}
 
@@ -509,12 +523,10 @@ static void openavbAecpMessageRxFrameParse(U8* payload, int payload_len, hdr_inf
 
 		if (pSrc - payload <= payload_len) {
 			// Notify the state machine of the command request
-			// The buffer will be deleted once the request is handled.
 			openavbAecpSMEntityModelEntitySet_rcvdCommand(openavbAecpCommandResponse);
 		}
 		else {
 			AVB_LOGF_ERROR("Expected packet of size %d, but received one of size %d.  Discarding.", pSrc - payload, payload_len);
-			free(openavbAecpCommandResponse);
 		}
 	}
 
@@ -999,6 +1011,15 @@ openavbRC openavbAecpMessageHandlerStart()
 
 	if (openavbAecpOpenSocket((const char *)gAvdeccCfg.ifname, gAvdeccCfg.vlanID, gAvdeccCfg.vlanPCP)) {
 
+		if (gAvdeccCfg.bEventLoop) {
+			if (!openavbAvdeccLoopRegisterRx(0x80 | OPENAVB_AECP_AVTP_SUBTYPE, openavbAecpMessageRxFrameParse)) {
+				bRunning = FALSE;
+				openavbAecpCloseSocket();
+				AVB_RC_TRACE_RET(OPENAVB_AVDECC_FAILURE, AVB_TRACE_AECP);
+			}
+			AVB_RC_TRACE_RET(OPENAVB_AVDECC_SUCCESS, AVB_TRACE_AECP);
+		}
+
 		// Start the RX thread
 		bool errResult;
 		THREAD_CREATE(openavbAecpMessageRxThread, openavbAecpMessageRxThread, NULL, openavbAecpMessageRxThreadFn, NULL);
@@ -1022,7 +1043,12 @@ void openavbAecpMessageHandlerStop()
 
 	if (bRunning) {
 		bRunning = FALSE;
-		THREAD_JOIN(openavbAecpMessageRxThread, NULL);
+		if (gAvdeccCfg.bEventLoop) {
+			openavbAvdeccLoopRegisterRx(0x80 | OPENAVB_AECP_AVTP_SUBTYPE, NULL);
+		}
+		else {
+			THREAD_JOIN(openavbAecpMessageRxThread, NULL);
+		}
 		openavbAecpCloseSocket();
 	}
 
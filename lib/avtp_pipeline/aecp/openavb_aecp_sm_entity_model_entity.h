@@ -62,10 +62,14 @@ void openavbAecpSMEntityModelEntityStart(void);
 void openavbAecpSMEntityModelEntityStop(void);
 
 // Accessors
-void openavbAecpSMEntityModelEntitySet_rcvdCommand(openavb_aecp_AEMCommandResponse_t *rcvdCommand);
+void openavbAecpSMEntityModelEntitySet_rcvdCommand(const openavb_aecp_AEMCommandResponse_t *rcvdCommand);
 	// Note:  rcvdAEMCommand is set during the call to openavbAecpSMEntityModelEntitySet_rcvdCommand()
+	// Note:  The command is copied into the command queue, the caller keeps its buffer
 void openavbAecpSMEntityModelEntitySet_unsolicited(openavb_aecp_AEMCommandResponse_t *unsolicited);
 	// Note:  doUnsolicited is set during the call to openavbAecpSMEntityModelEntitySet_unsolicited()
 void openavbAecpSMEntityModelEntitySet_doTerminate(bool value);
 
+// Commands dropped because the command queue was full, and repeated reads answered together with a queued one.
+void openavbAecpSMEntityModelEntityGetQueueStats(U32 *pDropped, U32 *pCoalesced);
+
 #endif // OPENAVB_AECP_SM_ENTITY_MODEL_ENTITY_H
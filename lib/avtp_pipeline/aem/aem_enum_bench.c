@@ -0,0 +1,285 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Benchmark for READ_DESCRIPTOR serialization.
+*
+* Builds an entity model with many stream and audio cluster descriptors and enumerates
+* all of them the way a controller does, once encoding every descriptor and once served
+* from the serialized descriptor cache. Prints descriptors per second for both and checks
+* that the cache returns the same bytes, also after a descriptor was changed.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include "openavb_types_pub.h"
+#include "openavb_aem.h"
+#include "openavb_descriptor_entity_pub.h"
+#include "openavb_descriptor_configuration_pub.h"
+#include "openavb_descriptor_stream_io_pub.h"
+#include "openavb_descriptor_audio_cluster_pub.h"
+
+//Common usage: ./aem_enum_bench -s 128 -c 256 -r 200
+
+#define NANOSECONDS_PER_SECOND		(1000000000ULL)
+#define TIMESPEC_TO_NSEC(ts) (((uint64_t)ts.tv_sec * (uint64_t)NANOSECONDS_PER_SECOND) + (uint64_t)ts.tv_nsec)
+
+// Room for descriptor data in a READ_DESCRIPTOR response
+#define DESCRIPTOR_BUF_SIZE			508
+
+static int streams = 128;
+static int clusters = 256;
+static int rounds = 200;
+
+static GOptionEntry entries[] =
+{
+  { "streams",  's', 0, G_OPTION_ARG_INT, &streams,  "stream inputs and stream outputs each", "NUM" },
+  { "clusters", 'c', 0, G_OPTION_ARG_INT, &clusters, "audio clusters",                        "NUM" },
+  { "rounds",   'r', 0, G_OPTION_ARG_INT, &rounds,   "enumerations of the whole entity",      "NUM" },
+  { NULL }
+};
+
+typedef struct {
+	U16 type;
+	U16 count;
+} descriptor_set_t;
+
+static descriptor_set_t sets[5];
+static int nSets = 0;
+static U16 configIdx;
+
+static U64 nowNSec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return TIMESPEC_TO_NSEC(now);
+}
+
+static bool buildModel(void)
+{
+	int i1;
+	U16 idx;
+
+	openavb_aem_descriptor_entity_t *pEntity = openavbAemDescriptorEntityNew();
+	if (!pEntity || IS_OPENAVB_FAILURE(openavbAemCreate(pEntity))) {
+		return FALSE;
+	}
+	openavbAemDescriptorEntitySet_entity_name(pEntity, "aem_enum_bench");
+
+	openavb_aem_descriptor_configuration_t *pConfig = openavbAemDescriptorConfigurationNew();
+	if (!pConfig || !openavbAemAddDescriptor(pConfig, OPENAVB_AEM_DESCRIPTOR_INVALID, &configIdx)) {
+		return FALSE;
+	}
+
+	for (i1 = 0; i1 < streams; i1++) {
+		char name[32];
+		openavb_aem_descriptor_stream_io_t *pInput = openavbAemDescriptorStreamInputNew();
+		openavb_aem_descriptor_stream_io_t *pOutput = openavbAemDescriptorStreamOutputNew();
+		if (!pInput || !pOutput) {
+			return FALSE;
+		}
+		snprintf(name, sizeof(name), "Stream input %d", i1);
+		openavbAemSetString(pInput->object_name, name);
+		snprintf(name, sizeof(name), "Stream output %d", i1);
+		openavbAemSetString(pOutput->object_name, name);
+		if (!openavbAemAddDescriptor(pInput, configIdx, &idx) || !openavbAemAddDescriptor(pOutput, configIdx, &idx)) {
+			return FALSE;
+		}
+	}
+
+	for (i1 = 0; i1 < clusters; i1++) {
+		char name[32];
+		openavb_aem_descriptor_audio_cluster_t *pCluster = openavbAemDescriptorAudioClusterNew();
+		if (!pCluster) {
+			return FALSE;
+		}
+		snprintf(name, sizeof(name), "Cluster %d", i1);
+		openavbAemSetString(pCluster->object_name, name);
+		pCluster->channel_count = 1;
+		if (!openavbAemAddDescriptor(pCluster, OPENAVB_AEM_DESCRIPTOR_INVALID, &idx)) {
+			return FALSE;
+		}
+	}
+
+	sets[nSets].type = OPENAVB_AEM_DESCRIPTOR_ENTITY;
+	sets[nSets++].count = 1;
+	sets[nSets].type = OPENAVB_AEM_DESCRIPTOR_CONFIGURATION;
+	sets[nSets++].count = 1;
+	sets[nSets].type = OPENAVB_AEM_DESCRIPTOR_STREAM_INPUT;
+	sets[nSets++].count = streams;
+	sets[nSets].type = OPENAVB_AEM_DESCRIPTOR_STREAM_OUTPUT;
+	sets[nSets++].count = streams;
+	sets[nSets].type = OPENAVB_AEM_DESCRIPTOR_AUDIO_CLUSTER;
+	sets[nSets++].count = clusters;
+	return TRUE;
+}
+
+// Read every descriptor once. Returns the number read, or -1 on a failure.
+static int enumerate(void)
+{
+	U8 buf[DESCRIPTOR_BUF_SIZE];
+	U16 size;
+	int i1, i2, n = 0;
+
+	for (i1 = 0; i1 < nSets; i1++) {
+		for (i2 = 0; i2 < sets[i1].count; i2++) {
+			if (IS_OPENAVB_FAILURE(openavbAemSerializeDescriptor(configIdx, sets[i1].type, i2, sizeof(buf), buf, &size))) {
+				printf("error: reading descriptor 0x%04x %d failed\n", sets[i1].type, i2);
+				return -1;
+			}
+			n++;
+		}
+	}
+	return n;
+}
+
+static bool bench(bool cached, const char *name)
+{
+	int i1;
+	U64 n = 0;
+
+	openavbAemDescriptorCacheEnable(cached);
+	// Warm up, this also fills the cache
+	if (enumerate() < 0) {
+		return FALSE;
+	}
+
+	U64 startNSec = nowNSec();
+	for (i1 = 0; i1 < rounds; i1++) {
+		int count = enumerate();
+		if (count < 0) {
+			return FALSE;
+		}
+		n += count;
+	}
+	U64 elapsedNSec = nowNSec() - startNSec;
+
+	printf("%-8s %12.0f descriptors/s %8.1f ns/descriptor\n",
+		name, (double)n * NANOSECONDS_PER_SECOND / (elapsedNSec ? elapsedNSec : 1), (double)elapsedNSec / n);
+	return TRUE;
+}
+
+// Compare one descriptor read from the cache against a fresh encoding
+static bool same(U16 type, U16 idx)
+{
+	U8 encoded[DESCRIPTOR_BUF_SIZE], cached[DESCRIPTOR_BUF_SIZE];
+	U16 encodedSize, cachedSize;
+
+	openavbAemDescriptorCacheEnable(FALSE);
+	openavbRC rc1 = openavbAemSerializeDescriptor(configIdx, type, idx, sizeof(encoded), encoded, &encodedSize);
+	openavbAemDescriptorCacheEnable(TRUE);
+	openavbAemSerializeDescriptor(configIdx, type, idx, sizeof(cached), cached, &cachedSize);
+	openavbRC rc2 = openavbAemSerializeDescriptor(configIdx, type, idx, sizeof(cached), cached, &cachedSize);
+
+	if (IS_OPENAVB_FAILURE(rc1) || IS_OPENAVB_FAILURE(rc2) || encodedSize != cachedSize || memcmp(encoded, cached, encodedSize) != 0) {
+		printf("error: cached descriptor 0x%04x %u differs from its encoding\n", type, idx);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static bool check(void)
+{
+	int i1, i2;
+
+	for (i1 = 0; i1 < nSets; i1++) {
+		for (i2 = 0; i2 < sets[i1].count; i2++) {
+			if (!same(sets[i1].type, i2)) {
+				return FALSE;
+			}
+		}
+	}
+
+	// A changed descriptor must not be served from the cache
+	U8 before[DESCRIPTOR_BUF_SIZE];
+	U16 beforeSize;
+	openavbAemDescriptorCacheEnable(TRUE);
+	openavbAemSerializeDescriptor(configIdx, OPENAVB_AEM_DESCRIPTOR_STREAM_INPUT, 0, sizeof(before), before, &beforeSize);
+
+	openavb_aem_descriptor_stream_io_t *pInput = openavbAemGetDescriptor(configIdx, OPENAVB_AEM_DESCRIPTOR_STREAM_INPUT, 0);
+	openavbAemSetString(pInput->object_name, "Renamed");
+	openavbAemDescriptorChanged(pInput);
+	if (!same(OPENAVB_AEM_DESCRIPTOR_STREAM_INPUT, 0)) {
+		return FALSE;
+	}
+
+	U8 after[DESCRIPTOR_BUF_SIZE];
+	U16 afterSize;
+	openavbAemSerializeDescriptor(configIdx, OPENAVB_AEM_DESCRIPTOR_STREAM_INPUT, 0, sizeof(after), after, &afterSize);
+	if (afterSize == beforeSize && memcmp(before, after, afterSize) == 0) {
+		printf("error: changed descriptor still served from the cache\n");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+int main(int argc, char* argv[])
+{
+	GError *error = NULL;
+	GOptionContext *context;
+	U32 hits, misses;
+
+	context = g_option_context_new("- AEM descriptor enumeration benchmark");
+	g_option_context_add_main_entries(context, entries, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		printf("error: %s\n", error->message);
+		exit(1);
+	}
+
+	if (streams < 0 || clusters < 0 || rounds <= 0 || streams > 0xffff || clusters > 0xffff) {
+		printf("error: streams and clusters must be 0 to 65535 and rounds positive\n");
+		exit(2);
+	}
+
+	if (!buildModel()) {
+		printf("error: could not build the entity model\n");
+		exit(1);
+	}
+
+	printf("%d stream inputs, %d stream outputs, %d audio clusters, %d rounds\n", streams, streams, clusters, rounds);
+	if (!bench(FALSE, "encoded") || !bench(TRUE, "cached")) {
+		exit(1);
+	}
+	openavbAemDescriptorCacheStats(&hits, &misses);
+	printf("cache: %u hits, %u misses\n", hits, misses);
+
+	if (!check()) {
+		exit(1);
+	}
+	printf("cache check passed\n");
+
+	g_option_context_free(context);
+	return 0;
+}
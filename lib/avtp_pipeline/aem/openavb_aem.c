@@ -50,6 +50,110 @@ MUTEX_HANDLE(openavbAemMutex);
 
 static openavb_avdecc_entity_model_t *pAemEntityModel = NULL;
 
+// Serialized descriptors kept for READ_DESCRIPTOR. Controllers enumerate every descriptor of every
+// entity they find, so in steady state most reads are answered with a copy of the previous encoding.
+#define AEM_CACHE_BUCKETS	256
+
+typedef struct aem_cache_entry {
+	struct aem_cache_entry *next;
+	const void *pDescriptor;	// Descriptor the data was encoded from
+	U16 configIdx;
+	U16 descriptorType;
+	U16 descriptorIdx;
+	bool bDirty;
+	U16 length;
+	U16 capacity;
+	U8 *pData;
+} aem_cache_entry_t;
+
+static aem_cache_entry_t *aemCache[AEM_CACHE_BUCKETS];
+static bool bAemCacheEnabled = TRUE;
+static U32 aemCacheHits = 0;
+static U32 aemCacheMisses = 0;
+
+// The AVB Interface descriptor is encoded from live gPTP state by its update() callback, so it is never cached.
+static bool x_cacheable(U16 descriptorType)
+{
+	return descriptorType != OPENAVB_AEM_DESCRIPTOR_AVB_INTERFACE;
+}
+
+static U32 x_cacheBucket(U16 configIdx, U16 descriptorType, U16 descriptorIdx)
+{
+	U32 hash = ((U32)configIdx * 31 + descriptorType) * 257 + descriptorIdx;
+	return (hash ^ (hash >> 8)) % AEM_CACHE_BUCKETS;
+}
+
+// Must be called with the AEM mutex held.
+static aem_cache_entry_t *x_cacheLookup(U16 configIdx, U16 descriptorType, U16 descriptorIdx)
+{
+	aem_cache_entry_t *pEntry;
+	for (pEntry = aemCache[x_cacheBucket(configIdx, descriptorType, descriptorIdx)]; pEntry; pEntry = pEntry->next) {
+		if (pEntry->configIdx == configIdx && pEntry->descriptorType == descriptorType && pEntry->descriptorIdx == descriptorIdx) {
+			return pEntry;
+		}
+	}
+	return NULL;
+}
+
+// Must be called with the AEM mutex held. Only existing descriptors get an entry. A new entry starts out dirty.
+static aem_cache_entry_t *x_cacheAdd(U16 configIdx, U16 descriptorType, U16 descriptorIdx)
+{
+	U32 bucket = x_cacheBucket(configIdx, descriptorType, descriptorIdx);
+	aem_cache_entry_t *pEntry = calloc(1, sizeof(*pEntry));
+	if (pEntry) {
+		pEntry->configIdx = configIdx;
+		pEntry->descriptorType = descriptorType;
+		pEntry->descriptorIdx = descriptorIdx;
+		pEntry->bDirty = TRUE;
+		pEntry->next = aemCache[bucket];
+		aemCache[bucket] = pEntry;
+	}
+	return pEntry;
+}
+
+// Must be called with the AEM mutex held. On failure the entry simply stays dirty.
+static void x_cacheStore(aem_cache_entry_t *pEntry, const void *pDescriptor, const U8 *pBuf, U16 length)
+{
+	if (length > pEntry->capacity) {
+		U8 *pData = realloc(pEntry->pData, length);
+		if (!pData) {
+			return;
+		}
+		pEntry->pData = pData;
+		pEntry->capacity = length;
+	}
+	memcpy(pEntry->pData, pBuf, length);
+	pEntry->length = length;
+	pEntry->pDescriptor = pDescriptor;
+	pEntry->bDirty = FALSE;
+}
+
+// Must be called with the AEM mutex held.
+static void x_cacheInvalidateAll(void)
+{
+	int i1;
+	aem_cache_entry_t *pEntry;
+	for (i1 = 0; i1 < AEM_CACHE_BUCKETS; i1++) {
+		for (pEntry = aemCache[i1]; pEntry; pEntry = pEntry->next) {
+			pEntry->bDirty = TRUE;
+		}
+	}
+}
+
+// Must be called with the AEM mutex held.
+static void x_cacheFree(void)
+{
+	int i1;
+	for (i1 = 0; i1 < AEM_CACHE_BUCKETS; i1++) {
+		while (aemCache[i1]) {
+			aem_cache_entry_t *pEntry = aemCache[i1];
+			aemCache[i1] = pEntry->next;
+			free(pEntry->pData);
+			free(pEntry);
+		}
+	}
+}
+
 ////////////////////////////////
 // Private (internal) functions
 ////////////////////////////////
@@ -89,6 +193,12 @@ openavbRC openavbAemDestroy()
 	AVB_TRACE_ENTRY(AVB_TRACE_AEM);
 	// AVDECC_TODO all deallocations will occur here
 
+	if (pAemEntityModel) {
+		AEM_LOCK();
+		x_cacheFree();
+		AEM_UNLOCK();
+	}
+
 	AVB_RC_TRACE_RET(OPENAVB_AVDECC_SUCCESS, AVB_TRACE_AEM);
 }
 
@@ -254,19 +364,82 @@ openavbRC openavbAemSerializeDescriptor(U16 configIdx, U16 descriptorType, U16 d
 
 	*descriptorSize = 0;
 
+	openavbRC rc = AVB_RC(OPENAVB_AVDECC_FAILURE | OPENAVBAVDECC_RC_UNKNOWN_DESCRIPTOR);
+
+	AEM_LOCK();
+	bool bCache = bAemCacheEnabled && x_cacheable(descriptorType);
+	aem_cache_entry_t *pEntry = bCache ? x_cacheLookup(configIdx, descriptorType, descriptorIdx) : NULL;
+
+	// Descriptors are never removed and adding one invalidates the whole cache, so a clean entry
+	// can be served without looking up the descriptor.
+	if (pEntry && !pEntry->bDirty) {
+		if (pEntry->length <= bufSize) {
+			memcpy(pBuf, pEntry->pData, pEntry->length);
+			*descriptorSize = pEntry->length;
+			aemCacheHits++;
+			rc = OPENAVB_AVDECC_SUCCESS;
+		}
+		else {
+			rc = AVB_RC(OPENAVB_AVDECC_FAILURE | OPENAVBAVDECC_RC_GENERIC);
+		}
+		AEM_UNLOCK();
+		AVB_RC_TRACE_RET(rc, AVB_TRACE_AEM);
+	}
+
 	void *pDescriptor = openavbAemFindDescriptor(configIdx, descriptorType, descriptorIdx);
 	if (pDescriptor) {
 		openavb_aem_descriptor_common_t *pDescriptorCommon = pDescriptor;
 		if (IS_OPENAVB_FAILURE(pDescriptorCommon->descriptorPvtPtr->update(pDescriptor))) {
-			AVB_RC_TRACE_RET(AVB_RC(OPENAVB_AVDECC_FAILURE | OPENAVBAVDECC_RC_STALE_DATA), AVB_TRACE_AEM);
+			rc = AVB_RC(OPENAVB_AVDECC_FAILURE | OPENAVBAVDECC_RC_STALE_DATA);
 		}
-		if (IS_OPENAVB_FAILURE(pDescriptorCommon->descriptorPvtPtr->toBuf(pDescriptor, bufSize, pBuf, descriptorSize))) {
-			AVB_RC_TRACE_RET(AVB_RC(OPENAVB_AVDECC_FAILURE | OPENAVBAVDECC_RC_GENERIC), AVB_TRACE_AEM);
+		else if (IS_OPENAVB_FAILURE(pDescriptorCommon->descriptorPvtPtr->toBuf(pDescriptor, bufSize, pBuf, descriptorSize))) {
+			rc = AVB_RC(OPENAVB_AVDECC_FAILURE | OPENAVBAVDECC_RC_GENERIC);
+		}
+		else {
+			if (bCache && !pEntry) {
+				pEntry = x_cacheAdd(configIdx, descriptorType, descriptorIdx);
+			}
+			if (pEntry) {
+				x_cacheStore(pEntry, pDescriptor, pBuf, *descriptorSize);
+			}
+			aemCacheMisses++;
+			rc = OPENAVB_AVDECC_SUCCESS;
 		}
-		AVB_RC_TRACE_RET(OPENAVB_AVDECC_SUCCESS, AVB_TRACE_AEM);
+	}
+	AEM_UNLOCK();
+
+	AVB_RC_TRACE_RET(rc, AVB_TRACE_AEM);
+}
+
+void openavbAemDescriptorCacheEnable(bool enable)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AEM);
+
+	if (openavbAemCheckModel(FALSE)) {
+		AEM_LOCK();
+		bAemCacheEnabled = enable;
+		x_cacheInvalidateAll();
+		AEM_UNLOCK();
+	}
+	else {
+		bAemCacheEnabled = enable;
 	}
 
-	AVB_RC_TRACE_RET(AVB_RC(OPENAVB_AVDECC_FAILURE | OPENAVBAVDECC_RC_UNKNOWN_DESCRIPTOR), AVB_TRACE_AEM);
+	AVB_TRACE_EXIT(AVB_TRACE_AEM);
+}
+
+void openavbAemDescriptorCacheStats(U32 *pHits, U32 *pMisses)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AEM);
+
+	if (pHits) {
+		*pHits = aemCacheHits;
+	}
+	if (pMisses) {
+		*pMisses = aemCacheMisses;
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_AEM);
 }
 
 bool openavbAemAddDescriptorConfiguration(openavb_aem_descriptor_configuration_t *pDescriptor, U16 *pResultIdx)
@@ -345,6 +518,11 @@ extern DLL_EXPORT bool openavbAemAddDescriptor(void *pDescriptor, U16 configIdx,
 
 	openavb_aem_descriptor_common_t *pDescriptorCommon = pDescriptor;
 
+	// Adding descriptors changes the counts held by the Entity and Configuration descriptors
+	AEM_LOCK();
+	x_cacheInvalidateAll();
+	AEM_UNLOCK();
+
 	if (pDescriptorCommon->descriptor_type == OPENAVB_AEM_DESCRIPTOR_ENTITY) {
 		// Entity Descriptors aren't handled in this function.
 		AVB_RC_LOG(OPENAVB_AVDECC_FAILURE | OPENAVB_RC_INVALID_ARGUMENT);
@@ -440,6 +618,32 @@ extern DLL_EXPORT U16 openavbAemGetDescriptorIndex(U16 configIdx, const void *pD
 	return OPENAVB_AEM_DESCRIPTOR_INVALID;
 }
 
+extern DLL_EXPORT void openavbAemDescriptorChanged(const void *pDescriptor)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AEM);
+
+	if (!pDescriptor || !openavbAemCheckModel(FALSE)) {
+		AVB_TRACE_EXIT(AVB_TRACE_AEM);
+		return;
+	}
+
+	int i1;
+	aem_cache_entry_t *pEntry;
+
+	AEM_LOCK();
+	for (i1 = 0; i1 < AEM_CACHE_BUCKETS; i1++) {
+		for (pEntry = aemCache[i1]; pEntry; pEntry = pEntry->next) {
+			// Non-top-level descriptors may be cached under several configurations
+			if (pEntry->pDescriptor == pDescriptor) {
+				pEntry->bDirty = TRUE;
+			}
+		}
+	}
+	AEM_UNLOCK();
+
+	AVB_TRACE_EXIT(AVB_TRACE_AEM);
+}
+
 extern DLL_EXPORT bool openavbAemSetString(U8 *pMem, const char *pString)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_AEM);
@@ -99,5 +99,12 @@ openavb_array_t openavbAemGetDescriptorArray(U16 configIdx, U16 descriptorType);
 
 // Serialize a descriptor into a buffer. pBuf is filled with the descriptor data. descriptorSize is set to the size of the data placed into the buffer.
 openavbRC openavbAemSerializeDescriptor(U16 configIdx, U16 descriptorType, U16 descriptorIdx, U16 bufSize, U8 *pBuf, U16 *descriptorSize);
+// The encoding is kept and copied out again until openavbAemDescriptorChanged() is called for the descriptor.
+
+// Turn the serialized descriptor cache on or off. It is on by default.
+void openavbAemDescriptorCacheEnable(bool enable);
+
+// Number of openavbAemSerializeDescriptor() calls answered from the cache and encoded from the descriptor.
+void openavbAemDescriptorCacheStats(U32 *pHits, U32 *pMisses);
 
 #endif // OPENAVB_AEM_H
@@ -61,6 +61,10 @@ void *openavbAemGetDescriptor(U16 configIdx, U16 descriptorType, U16 descriptorI
 // Get the index of the descriptor in the Entity Model, or OPENAVB_AEM_DESCRIPTOR_INVALID if not found.
 U16 openavbAemGetDescriptorIndex(U16 configIdx, const void *pDescriptor);
 
+// Must be called after changing a descriptor that is already part of the Entity Model, so READ_DESCRIPTOR
+// responses are encoded from the new contents instead of being served from the serialized descriptor cache.
+void openavbAemDescriptorChanged(const void *pDescriptor);
+
 // Add a string to a standard descriptor U8 [64] string field.
 bool openavbAemSetString(U8 *pMem, const char *pString);
 
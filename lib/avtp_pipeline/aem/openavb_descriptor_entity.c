@@ -323,6 +323,7 @@ extern DLL_EXPORT bool openavbAemDescriptorEntitySet_entity_name(openavb_aem_des
 	}
 
 	openavbAemSetString(pDescriptor->entity_name, aName);
+	openavbAemDescriptorChanged(pDescriptor);
 
 	AVB_TRACE_EXIT(AVB_TRACE_AEM);
 	return TRUE;
@@ -389,6 +390,7 @@ extern DLL_EXPORT bool openavbAemDescriptorEntitySet_group_name(openavb_aem_desc
 	}
 
 	openavbAemSetString(pDescriptor->group_name, aGroupName);
+	openavbAemDescriptorChanged(pDescriptor);
 
 	AVB_TRACE_EXIT(AVB_TRACE_AEM);
 	return TRUE;
@@ -0,0 +1,92 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+ ******************************************************************
+ * MODULE : AVDECC - Event loop
+ * MODULE SUMMARY : Single RX socket, subtype dispatch and timer wheel shared by ADP, AECP and ACMP
+ ******************************************************************
+ */
+
+#ifndef OPENAVB_AVDECC_LOOP_H
+#define OPENAVB_AVDECC_LOOP_H 1
+
+#include "openavb_types.h"
+#include "openavb_rawsock.h"
+
+// Resolution of the timer wheel. AVDECC timeouts are all multiples of a millisecond.
+#define OPENAVB_AVDECC_LOOP_TICK_USEC		1000
+
+// Number of wheel slots. Timers further out than this many ticks simply stay in their slot for extra turns.
+#define OPENAVB_AVDECC_LOOP_WHEEL_SLOTS		256
+
+// Called on the loop thread for every received AVTP control PDU of the registered subtype.
+// pdu points at the AVTP subtype octet and len counts from there.
+typedef void (*openavb_avdecc_loop_rx_cb_t)(U8 *pdu, int len, hdr_info_t *hdr);
+
+// Called on the loop thread when a timer expires.
+typedef void (*openavb_avdecc_loop_timer_cb_t)(void *arg);
+
+typedef struct openavb_avdecc_loop_timer {
+	struct openavb_avdecc_loop_timer *next;
+	struct openavb_avdecc_loop_timer *prev;
+	U64 expires;		// Absolute wheel tick
+	bool armed;
+	openavb_avdecc_loop_timer_cb_t cb;
+	void *arg;
+} openavb_avdecc_loop_timer_t;
+
+// Open the shared RX socket on ifname and start the loop thread. If the raw socket backend
+// has no pollable descriptor the loop is not started (openavbAvdeccLoopRunning() stays FALSE)
+// and TRUE is still returned, so the protocols fall back to their own RX threads.
+bool openavbAvdeccLoopStart(const char *ifname);
+
+// Stop the loop thread and close the shared RX socket. Safe to call when not started.
+void openavbAvdeccLoopStop(void);
+
+// TRUE between a successful openavbAvdeccLoopStart() and openavbAvdeccLoopStop().
+bool openavbAvdeccLoopRunning(void);
+
+// Route PDUs whose first octet (cd bit and subtype) equals subtype to cb. Pass a NULL cb to unregister;
+// once that returns the previous callback is guaranteed not to be running.
+bool openavbAvdeccLoopRegisterRx(U8 subtype, openavb_avdecc_loop_rx_cb_t cb);
+
+// Add or remove a destination address accepted by the shared socket. Reference counted, so ADP and
+// ACMP may both join the AVDECC multicast address.
+bool openavbAvdeccLoopRxMulticast(bool add, const U8 addr[ETH_ALEN]);
+
+// Timers may be started and cancelled from any thread, including from their own callback.
+void openavbAvdeccLoopTimerInit(openavb_avdecc_loop_timer_t *pTimer, openavb_avdecc_loop_timer_cb_t cb, void *arg);
+void openavbAvdeccLoopTimerStart(openavb_avdecc_loop_timer_t *pTimer, U32 timeoutUsec);
+// Once this returns the callback is guaranteed not to be running, unless called from the callback itself.
+void openavbAvdeccLoopTimerCancel(openavb_avdecc_loop_timer_t *pTimer);
+
+#endif // OPENAVB_AVDECC_LOOP_H
@@ -97,6 +97,8 @@ typedef struct {
 
 	bool bFastConnectSupported; // FAST_CONNECT and SAVED_STATE supported
 
+	bool bEventLoop; // ADP, AECP and ACMP share one RX socket and event loop thread
+
 	U8 valid_time; // Number of 2-second units
 
 	// Information to add to the descriptor.
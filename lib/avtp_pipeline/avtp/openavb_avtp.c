@@ -54,6 +54,9 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 // Maximum time that AVTP RX/TX calls should block before returning
 #define AVTP_MAX_BLOCK_USEC (1 * MICROSECONDS_PER_SECOND)
 
+// Max number of frames taken from the rawsock per wakeup
+#define AVTP_RX_BATCH_FRAMES 32
+
 /*
  * This is broken out into a function, so that we can close and reopen
  * the socket if we detect a problem receiving frames.
@@ -75,6 +78,11 @@ static openavbRC openAvtpSock(avtp_stream_t *pStream)
 	if (pStream->rawsock != NULL) {
 		openavbSetRxSignalMode(pStream->rawsock, pStream->bRxSignalMode);
 
+		if (pStream->tx) {
+			pStream->bTxLaunchTime = openavbRawsockTxLaunchTime(pStream->rawsock);
+			pStream->txLastLaunchNsec = 0;
+		}
+
 		if (!pStream->tx) {
 			// Set the multicast address that we want to receive
 			openavbRawsockRxMulticast(pStream->rawsock, TRUE, pStream->dest_addr.ether_addr_octet);
@@ -110,6 +118,88 @@ static void processTimestampEval(avtp_stream_t *pStream, U8 *pHdr)
 	AVB_TRACE_EXIT(AVB_TRACE_AVTP_DETAIL);
 }
 
+static void processPtimeError(avtp_stream_t *pStream, U8 *pHdr)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVTP_DETAIL);
+
+	bool tsValid =  (pHdr[HIDX_AVTP_HIDE7_TV1] & 0x01) ? TRUE : FALSE;
+	bool tsUncertain = (pHdr[HIDX_AVTP_HIDE7_TU1] & 0x01) ? TRUE : FALSE;
+
+	if (tsValid && !tsUncertain) {
+		U64 nowNS;
+		CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &nowNS);
+
+		// The AVTP timestamp is the low 32 bits of the presentation time in nanoseconds
+		U32 ts = ntohl(*(U32 *)(&pHdr[HIDX_AVTP_TIMESPAMP32]));
+		S32 errNS = (S32)((U32)nowNS + pStream->statsMaxTransitNsec - ts);
+		openavbHistogramRecord(pStream->stats.ptimeError, errNS > 0 ? errNS : 0);
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVTP_DETAIL);
+}
+
+// Time left until the frame is launched, or presented when the rawsock does not use launch times
+static void processTxSlack(avtp_stream_t *pStream, U8 *pHdr, U64 launchNsec)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVTP_DETAIL);
+
+	U64 nowNS;
+	S64 slackNS = 0;
+	CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &nowNS);
+
+	if (launchNsec) {
+		slackNS = (S64)(launchNsec - nowNS);
+	}
+	else if (pHdr[HIDX_AVTP_HIDE7_TV1] & 0x01) {
+		U32 ts = ntohl(*(U32 *)(&pHdr[HIDX_AVTP_TIMESPAMP32]));
+		slackNS = (S32)(ts - (U32)nowNS);
+	}
+	else {
+		AVB_TRACE_EXIT(AVB_TRACE_AVTP_DETAIL);
+		return;
+	}
+	openavbHistogramRecord(pStream->stats.txSlack, slackNS > 0 ? slackNS : 0);
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVTP_DETAIL);
+}
+
+/* Launch time for a frame the mapping module gave none.
+ * A valid AVTP timestamp is the presentation time, so the frame may leave once
+ * max transit before it; frames without one follow the transmit interval. Launch
+ * times never go back, and stay at least one interval ahead of now so the
+ * qdisc does not drop the frame as missed.
+ */
+static U64 x_avtpTxLaunchTime(avtp_stream_t *pStream, U8 *pHdr)
+{
+	U64 nowNS, launchNS;
+	CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &nowNS);
+
+	if (pHdr[HIDX_AVTP_HIDE7_TV1] & 0x01) {
+		U32 ts = ntohl(*(U32 *)(&pHdr[HIDX_AVTP_TIMESPAMP32]));
+		launchNS = nowNS + (S32)(ts - (U32)nowNS) - pStream->max_transit_usec * 1000;
+	}
+	else {
+		launchNS = pStream->txLastLaunchNsec + pStream->txIntervalNsec;
+	}
+
+	if ((S64)(launchNS - pStream->txLastLaunchNsec) < 0) {
+		launchNS = pStream->txLastLaunchNsec;
+	}
+	if ((S64)(launchNS - nowNS) < (S64)pStream->txIntervalNsec) {
+		launchNS = nowNS + pStream->txIntervalNsec;
+	}
+
+	pStream->txLastLaunchNsec = launchNS;
+	return launchNS;
+}
+
+static inline void x_avtpRecordSince(openavb_histogram_t hist, U64 startNS)
+{
+	U64 nowNS;
+	CLOCK_GETTIME64(OPENAVB_CLOCK_MONOTONIC, &nowNS);
+	openavbHistogramRecord(hist, nowNS - startNS);
+}
+
 
 /* Initialize AVTP for talking
  */
@@ -121,6 +211,7 @@ openavbRC openavbAvtpTxInit(
 	AVBStreamID_t *streamID,
 	U8 *destAddr,
 	U32 max_transit_usec,
+	U32 transmitInterval,
 	U32 fwmark,
 	U16 vlanID,
 	U8  vlanPCP,
@@ -155,13 +246,26 @@ openavbRC openavbAvtpTxInit(
 	// and the latency
 	pStream->max_transit_usec = max_transit_usec;
 
+	// Frames without a timestamp are launched at this interval
+	pStream->txIntervalNsec = transmitInterval ? NANOSECONDS_PER_SECOND / transmitInterval : 0;
+
 	// and save other stuff needed to (re)open the socket
 	pStream->ifname = strdup(ifname);
 	pStream->nbuffers = nbuffers;
 
+	// Room to reserve all the rawsock buffers for one batch
+	pStream->nTxBatch = nbuffers > 0 ? nbuffers : 1;
+	pStream->ppTxBatch = calloc(pStream->nTxBatch, sizeof(U8 *));
+	if (!pStream->ppTxBatch) {
+		free(pStream->ifname);
+		free(pStream);
+		AVB_RC_LOG_TRACE_RET(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_OUT_OF_MEMORY), AVB_TRACE_AVTP);
+	}
+
 	// Open a raw socket
 	openavbRC rc = openAvtpSock(pStream);
 	if (IS_OPENAVB_FAILURE(rc)) {
+		free(pStream->ppTxBatch);
 		free(pStream);
 		AVB_RC_LOG_TRACE_RET(rc, AVB_TRACE_AVTP);
 	}
@@ -175,6 +279,7 @@ openavbRC openavbAvtpTxInit(
 	}
 	else {
 		openavbRawsockClose(pStream->rawsock);
+		free(pStream->ppTxBatch);
 		free(pStream);
 		AVB_LOG_ERROR("Failed to get source MAC address");
 		AVB_RC_TRACE_RET(OPENAVB_AVTP_FAILURE, AVB_TRACE_AVTP);
@@ -286,6 +391,113 @@ static openavbRC fillAvtpHdr(avtp_stream_t *pStream, U8 *pFill)
 	AVB_RC_TRACE_RET(OPENAVB_AVTP_SUCCESS, AVB_TRACE_AVTP_DETAIL);
 }
 
+/* Fill one TX frame with data from the interface and mapping modules.
+ * Returns success only if the frame is ready to be sent.
+ */
+static openavbRC x_avtpTxFillFrame(avtp_stream_t *pStream, U8 *pBuf, bool txBlockingInIntf, U32 *pFrameLen, U64 *pTimeNsec)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVTP_DETAIL);
+
+	U8 * pAvtpFrame,*pFill;
+	U32 avtpFrameLen;
+	tx_cb_ret_t txCBResult = TX_CB_RET_PACKET_NOT_READY;
+
+	// AVTP frame starts right after the Ethernet header
+	pAvtpFrame = pFill = pBuf + pStream->ethHdrLen;
+	avtpFrameLen = pStream->frameLen - pStream->ethHdrLen;
+
+	// Fill the AVTP Header. This must be done before calling the interface and mapping modules.
+	openavbRC rc = fillAvtpHdr(pStream, pFill);
+	if (IS_OPENAVB_FAILURE(rc)) {
+		AVB_RC_LOG_TRACE_RET(rc, AVB_TRACE_AVTP_DETAIL);
+	}
+
+	U64 timeNsec = 0;
+	U64 mapStartNS = 0;
+
+	if (!txBlockingInIntf) {
+		// Call interface module to read data
+		pStream->pIntfCB->intf_tx_cb(pStream->pMediaQ);
+
+#if IGB_LAUNCHTIME_ENABLED
+		// lets get unmodified timestamp from mediaq item about to be sent by mapping
+		media_q_item_t* item = openavbMediaQTailLock(pStream->pMediaQ, true);
+		if (item) {
+			timeNsec = item->pAvtpTime->timeNsec;
+			openavbMediaQTailUnlock(pStream->pMediaQ);
+		}
+#elif ATL_LAUNCHTIME_ENABLED
+		if( pStream->pMapCB->map_lt_calc_cb ) {
+			pStream->pMapCB->map_lt_calc_cb(pStream->pMediaQ, &timeNsec);
+		}
+#endif
+
+		// Call mapping module to move data into AVTP frame
+		if (pStream->stats.mapTime) {
+			CLOCK_GETTIME64(OPENAVB_CLOCK_MONOTONIC, &mapStartNS);
+		}
+		txCBResult = pStream->pMapCB->map_tx_cb(pStream->pMediaQ, pAvtpFrame, &avtpFrameLen);
+
+		pStream->bytes += avtpFrameLen;
+	}
+	else {
+
+#if IGB_LAUNCHTIME_ENABLED
+		// lets get unmodified timestamp from mediaq item about to be sent by mapping
+		media_q_item_t* item = openavbMediaQTailLock(pStream->pMediaQ, true);
+		if (item) {
+			timeNsec = item->pAvtpTime->timeNsec;
+			openavbMediaQTailUnlock(pStream->pMediaQ);
+		}
+#elif ATL_LAUNCHTIME_ENABLED
+		if( pStream->pMapCB->map_lt_calc_cb ) {
+			pStream->pMapCB->map_lt_calc_cb(pStream->pMediaQ, &timeNsec);
+		}
+#endif
+
+		// Blocking in interface mode. Pull from media queue for tx first
+		if (pStream->stats.mapTime) {
+			CLOCK_GETTIME64(OPENAVB_CLOCK_MONOTONIC, &mapStartNS);
+		}
+		if ((txCBResult = pStream->pMapCB->map_tx_cb(pStream->pMediaQ, pAvtpFrame, &avtpFrameLen)) == TX_CB_RET_PACKET_NOT_READY) {
+			// Call interface module to read data
+			pStream->pIntfCB->intf_tx_cb(pStream->pMediaQ);
+		}
+		else {
+			pStream->bytes += avtpFrameLen;
+		}
+	}
+
+	// If we got data from the mapping module and stream is not paused,
+	// the frame can go to the raw sockets.
+	if (txCBResult == TX_CB_RET_PACKET_NOT_READY || pStream->bPause) {
+		AVB_RC_TRACE_RET(OPENAVB_AVTP_FAILURE, AVB_TRACE_AVTP_DETAIL);
+	}
+
+	if (pStream->stats.mapTime) {
+		x_avtpRecordSince(pStream->stats.mapTime, mapStartNS);
+	}
+
+	if (pStream->bTxLaunchTime && !timeNsec) {
+		timeNsec = x_avtpTxLaunchTime(pStream, pAvtpFrame);
+	}
+	if (pStream->stats.txSlack) {
+		processTxSlack(pStream, pAvtpFrame, timeNsec);
+	}
+
+	if (pStream->tsEval) {
+		processTimestampEval(pStream, pAvtpFrame);
+	}
+
+	// Increment the sequence number now that we are sure this is a good packet.
+	pStream->avtp_sequence_num++;
+
+	*pFrameLen = avtpFrameLen + pStream->ethHdrLen;
+	*pTimeNsec = timeNsec;
+
+	AVB_RC_TRACE_RET(OPENAVB_AVTP_SUCCESS, AVB_TRACE_AVTP_DETAIL);
+}
+
 /* Send a frame
  */
 openavbRC openavbAvtpTx(void *pv, bool bSend, bool txBlockingInIntf)
@@ -297,9 +509,7 @@ openavbRC openavbAvtpTx(void *pv, bool bSend, bool txBlockingInIntf)
 		AVB_RC_LOG_TRACE_RET(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_INVALID_ARGUMENT), AVB_TRACE_AVTP_DETAIL);
 	}
 
-	U8 * pAvtpFrame,*pFill;
-	U32 avtpFrameLen, frameLen;
-	tx_cb_ret_t txCBResult = TX_CB_RET_PACKET_NOT_READY;
+	U32 frameLen;
 
 	// Get a TX buf if we don't already have one.
 	//   (We keep the TX buf in our stream data, so that if we don't
@@ -315,92 +525,101 @@ openavbRC openavbAvtpTx(void *pv, bool bSend, bool txBlockingInIntf)
 	}
 
 	if (pStream->pBuf) {
-		// AVTP frame starts right after the Ethernet header
-		pAvtpFrame = pFill = pStream->pBuf + pStream->ethHdrLen;
-		avtpFrameLen = pStream->frameLen - pStream->ethHdrLen;
+		U64 timeNsec;
 
-		// Fill the AVTP Header. This must be done before calling the interface and mapping modules.
-		openavbRC rc = fillAvtpHdr(pStream, pFill);
+		openavbRC rc = x_avtpTxFillFrame(pStream, pStream->pBuf, txBlockingInIntf, &frameLen, &timeNsec);
 		if (IS_OPENAVB_FAILURE(rc)) {
-			AVB_RC_LOG_TRACE_RET(rc, AVB_TRACE_AVTP_DETAIL);
+			AVB_RC_TRACE_RET(rc, AVB_TRACE_AVTP_DETAIL);
 		}
 
-		U64 timeNsec = 0;
+		// Mark the frame "ready to send".
+		openavbRawsockTxFrameReady(pStream->rawsock, pStream->pBuf, frameLen, timeNsec);
+		// Send if requested
+		if (bSend)
+			openavbRawsockSend(pStream->rawsock);
+		// Drop our reference to it
+		pStream->pBuf = NULL;
+	}
+	else {
+		AVB_RC_TRACE_RET(OPENAVB_AVTP_FAILURE, AVB_TRACE_AVTP_DETAIL);
+	}
 
-		if (!txBlockingInIntf) {
-			// Call interface module to read data
-			pStream->pIntfCB->intf_tx_cb(pStream->pMediaQ);
+	AVB_RC_TRACE_RET(OPENAVB_AVTP_SUCCESS, AVB_TRACE_AVTP_DETAIL);
+}
 
-#if IGB_LAUNCHTIME_ENABLED
-			// lets get unmodified timestamp from mediaq item about to be sent by mapping
-			media_q_item_t* item = openavbMediaQTailLock(pStream->pMediaQ, true);
-			if (item) {
-				timeNsec = item->pAvtpTime->timeNsec;
-				openavbMediaQTailUnlock(pStream->pMediaQ);
-			}
-#elif ATL_LAUNCHTIME_ENABLED
-			if( pStream->pMapCB->map_lt_calc_cb ) {
-				pStream->pMapCB->map_lt_calc_cb(pStream->pMediaQ, &timeNsec);
-			}
-#endif
+/* Send a batch of frames
+ *
+ * Reserves the TX buffers from the rawsock together, fills them one after
+ * the other and hands them all to the kernel with a single send.
+ */
+openavbRC openavbAvtpTxBatch(void *pv, U32 nFrames, U32 *pFramesSent)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVTP_DETAIL);
 
-			// Call mapping module to move data into AVTP frame
-			txCBResult = pStream->pMapCB->map_tx_cb(pStream->pMediaQ, pAvtpFrame, &avtpFrameLen);
+	avtp_stream_t *pStream = (avtp_stream_t *)pv;
+	if (!pStream || !pFramesSent) {
+		AVB_RC_LOG_TRACE_RET(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_INVALID_ARGUMENT), AVB_TRACE_AVTP_DETAIL);
+	}
 
-			pStream->bytes += avtpFrameLen;
-		}
-		else {
+	*pFramesSent = 0;
+	if (nFrames > pStream->nTxBatch) {
+		nFrames = pStream->nTxBatch;
+	}
 
-#if IGB_LAUNCHTIME_ENABLED
-			// lets get unmodified timestamp from mediaq item about to be sent by mapping
-			media_q_item_t* item = openavbMediaQTailLock(pStream->pMediaQ, true);
-			if (item) {
-				timeNsec = item->pAvtpTime->timeNsec;
-				openavbMediaQTailUnlock(pStream->pMediaQ);
-			}
-#elif ATL_LAUNCHTIME_ENABLED
-			if( pStream->pMapCB->map_lt_calc_cb ) {
-				pStream->pMapCB->map_lt_calc_cb(pStream->pMediaQ, &timeNsec);
-			}
-#endif
+	openavbRC rc = OPENAVB_AVTP_SUCCESS;
+	U32 nReady = 0;
+
+	while (nReady < nFrames && IS_OPENAVB_SUCCESS(rc)) {
+		U32 frameLen, nHeld = 0, i;
 
-			// Blocking in interface mode. Pull from media queue for tx first
-			if ((txCBResult = pStream->pMapCB->map_tx_cb(pStream->pMediaQ, pAvtpFrame, &avtpFrameLen)) == TX_CB_RET_PACKET_NOT_READY) {
-				// Call interface module to read data
-				pStream->pIntfCB->intf_tx_cb(pStream->pMediaQ);
+		if (pStream->pBuf) {
+			// Use up the TX buf left from an earlier call first
+			pStream->ppTxBatch[nHeld++] = pStream->pBuf;
+			pStream->pBuf = NULL;
+		}
+		else {
+			nHeld = openavbRawsockGetTxFrames(pStream->rawsock, TRUE, pStream->ppTxBatch, nFrames - nReady, &frameLen);
+			if (nHeld == 0) {
+				rc = OPENAVB_AVTP_FAILURE;
+				break;
 			}
-			else {
-				pStream->bytes += avtpFrameLen;
+			for (i = 0; i < nHeld; i++) {
+				assert(frameLen >= pStream->frameLen);
+				// Fill in the Ethernet header
+				openavbRawsockTxFillHdr(pStream->rawsock, pStream->ppTxBatch[i], &pStream->ethHdrLen);
 			}
 		}
 
-		// If we got data from the mapping module and stream is not paused,
-		// notify the raw sockets.
-		if (txCBResult != TX_CB_RET_PACKET_NOT_READY && !pStream->bPause) {
+		for (i = 0; i < nHeld; i++) {
+			U64 timeNsec;
 
-			if (pStream->tsEval) {
-				processTimestampEval(pStream, pAvtpFrame);
+			rc = x_avtpTxFillFrame(pStream, pStream->ppTxBatch[i], FALSE, &frameLen, &timeNsec);
+			if (IS_OPENAVB_FAILURE(rc)) {
+				break;
 			}
 
-			// Increment the sequence number now that we are sure this is a good packet.
-			pStream->avtp_sequence_num++;
 			// Mark the frame "ready to send".
-			openavbRawsockTxFrameReady(pStream->rawsock, pStream->pBuf, avtpFrameLen + pStream->ethHdrLen, timeNsec);
-			// Send if requested
-			if (bSend)
-				openavbRawsockSend(pStream->rawsock);
-			// Drop our reference to it
-			pStream->pBuf = NULL;
+			openavbRawsockTxFrameReady(pStream->rawsock, pStream->ppTxBatch[i], frameLen, timeNsec);
+			nReady++;
 		}
-		else {
-			AVB_RC_TRACE_RET(OPENAVB_AVTP_FAILURE, AVB_TRACE_AVTP_DETAIL);
+
+		// Give back the buffers the mapping module had no data for, last one first.
+		// If the rawsock can't take one back, keep it for next time.
+		while (nHeld > i) {
+			nHeld--;
+			if (!openavbRawsockRelTxFrame(pStream->rawsock, pStream->ppTxBatch[nHeld])) {
+				pStream->pBuf = pStream->ppTxBatch[nHeld];
+			}
 		}
 	}
-	else {
-		AVB_RC_TRACE_RET(OPENAVB_AVTP_FAILURE, AVB_TRACE_AVTP_DETAIL);
+
+	// One send for the whole batch
+	if (nReady > 0) {
+		openavbRawsockSend(pStream->rawsock);
 	}
 
-	AVB_RC_TRACE_RET(OPENAVB_AVTP_SUCCESS, AVB_TRACE_AVTP_DETAIL);
+	*pFramesSent = nReady;
+	AVB_RC_TRACE_RET(rc, AVB_TRACE_AVTP_DETAIL);
 }
 
 openavbRC openavbAvtpRxInit(
@@ -412,6 +631,7 @@ openavbRC openavbAvtpRxInit(
 	U8 *daddr,
 	U16 nbuffers,
 	bool rxSignalMode,
+	bool rxDemux,
 	void **pStream_out)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_AVTP);
@@ -462,10 +682,22 @@ openavbRC openavbAvtpRxInit(
 	pStream->nbuffers = nbuffers;
 	pStream->bRxSignalMode = rxSignalMode;
 
-	openavbRC rc = openAvtpSock(pStream);
-	if (IS_OPENAVB_FAILURE(rc)) {
-		free(pStream);
-		AVB_RC_LOG_TRACE_RET(rc, AVB_TRACE_AVTP);
+	if (rxDemux) {
+		// Share one rawsock per interface with the other listener streams
+		pStream->rxInbox = openavbAvtpRxDemuxAttach(ifname, pStream->streamIDnet, daddr,
+			pStream->frameLen - ETH_HDR_LEN, nbuffers);
+		if (!pStream->rxInbox) {
+			free(pStream->ifname);
+			free(pStream);
+			AVB_RC_LOG_TRACE_RET(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_RAWSOCK_OPEN), AVB_TRACE_AVTP);
+		}
+	}
+	else {
+		openavbRC rc = openAvtpSock(pStream);
+		if (IS_OPENAVB_FAILURE(rc)) {
+			free(pStream);
+			AVB_RC_LOG_TRACE_RET(rc, AVB_TRACE_AVTP);
+		}
 	}
 
 	// Save the AVTP subtype
@@ -518,11 +750,27 @@ static void x_avtpRxFrame(avtp_stream_t *pStream, U8 *pFrame, U32 frameLen)
 
 			pRead += 8;
 
+			if (pStream->stats.pRxFrames) {
+				ATOMIC_STORE_RELAXED(pStream->stats.pRxFrames, *pStream->stats.pRxFrames + 1);
+			}
+
+			if (pStream->stats.ptimeError) {
+				processPtimeError(pStream, pFrame);
+			}
+
 			if (pStream->tsEval) {
 				processTimestampEval(pStream, pFrame);
 			}
 
-			pStream->pMapCB->map_rx_cb(pStream->pMediaQ, pFrame, frameLen);
+			if (pStream->stats.mapTime) {
+				U64 mapStartNS;
+				CLOCK_GETTIME64(OPENAVB_CLOCK_MONOTONIC, &mapStartNS);
+				pStream->pMapCB->map_rx_cb(pStream->pMediaQ, pFrame, frameLen);
+				x_avtpRecordSince(pStream->stats.mapTime, mapStartNS);
+			}
+			else {
+				pStream->pMapCB->map_rx_cb(pStream->pMediaQ, pFrame, frameLen);
+			}
 
 			// NOTE : This is a redundant call. It is handled in avtpTryRx()
 			// pStream->pIntfCB->intf_rx_cb(pStream->pMediaQ);
@@ -544,31 +792,45 @@ static void x_avtpRxFrame(avtp_stream_t *pStream, U8 *pFrame, U32 frameLen)
 	AVB_TRACE_EXIT(AVB_TRACE_AVTP_DETAIL);
 }
 
+// Take received frames from the stream's own rawsock or from its demultiplexer inbox
+static int x_avtpGetRxFrames(avtp_stream_t *pStream, U32 timeout, U8 **pBufs, U32 *offsetsToFrame, U32 *frameLens)
+{
+	if (pStream->rxInbox) {
+		return openavbAvtpRxDemuxGetFrames(pStream->rxInbox, timeout, pBufs, frameLens, AVTP_RX_BATCH_FRAMES);
+	}
+	return openavbRawsockGetRxFrames(pStream->rawsock, timeout, pBufs, offsetsToFrame, frameLens, AVTP_RX_BATCH_FRAMES);
+}
+
 /*
  * Try to receive some data.
  *
  * Keeps state information in pStream.
  * Look at pStream->info for the received data.
+ *
+ * All frames the rawsock already holds are taken in one go,
+ * so a block based rawsock is drained with a single wakeup.
  */
 static void avtpTryRx(avtp_stream_t *pStream)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_AVTP_DETAIL);
 
-	U8         *pBuf = NULL;   // pointer to buffer containing rcvd frame, if any
+	U8         *pBufs[AVTP_RX_BATCH_FRAMES];          // pointers to buffers containing rcvd frames
+	U32         offsetsToFrame[AVTP_RX_BATCH_FRAMES]; // offsets into pBufs where Ethernet frames begin (bytes)
+	U32         frameLens[AVTP_RX_BATCH_FRAMES];      // lengths of the Ethernet frames (bytes)
+	int         nFrames = 0;   // number of rcvd frames
 	U8         *pAvtpPdu;      // pointer to AVTP PDU within Ethernet frame
-	U32         offsetToFrame; // offset into pBuf where Ethernet frame begins (bytes)
-	U32         frameLen;      // length of the Ethernet frame (bytes)
 	int         hdrLen;        // length of the Ethernet frame header (bytes)
 	U32         avtpPduLen;    // length of the AVTP PDU (bytes)
 	hdr_info_t  hdrInfo;       // Ethernet header contents
 	U32         timeout;
+	int         i;
 
-	while (!pBuf) {
+	while (nFrames == 0) {
 		if (!openavbMediaQUsecTillTail(pStream->pMediaQ, &timeout)) {
 			// No mediaQ item available therefore wait for a new packet
 			timeout = AVTP_MAX_BLOCK_USEC;
-			pBuf = (U8 *)openavbRawsockGetRxFrame(pStream->rawsock, timeout, &offsetToFrame, &frameLen);
-			if (!pBuf) {
+			nFrames = x_avtpGetRxFrames(pStream, timeout, pBufs, offsetsToFrame, frameLens);
+			if (nFrames == 0) {
 				AVB_TRACE_EXIT(AVB_TRACE_AVTP_DETAIL);
 				return;
 			}
@@ -578,7 +840,7 @@ static void avtpTryRx(avtp_stream_t *pStream)
 			pStream->pIntfCB->intf_rx_cb(pStream->pMediaQ);
 
 			// Previously would check for new packets but disabled to favor presentation times.
-			// pBuf = (U8 *)openavbRawsockGetRxFrame(pStream->rawsock, OPENAVB_RAWSOCK_NONBLOCK, &offsetToFrame, &frameLen);
+			// nFrames = openavbRawsockGetRxFrames(pStream->rawsock, OPENAVB_RAWSOCK_NONBLOCK, pBufs, offsetsToFrame, frameLens, AVTP_RX_BATCH_FRAMES);
 		}
 		else {
 			if (timeout > AVTP_MAX_BLOCK_USEC)
@@ -586,22 +848,34 @@ static void avtpTryRx(avtp_stream_t *pStream)
 			if (timeout < RAWSOCK_MIN_TIMEOUT_USEC)
 				timeout = RAWSOCK_MIN_TIMEOUT_USEC;
 
-			pBuf = (U8 *)openavbRawsockGetRxFrame(pStream->rawsock, timeout, &offsetToFrame, &frameLen);
-			if (!pBuf)
+			nFrames = x_avtpGetRxFrames(pStream, timeout, pBufs, offsetsToFrame, frameLens);
+			if (nFrames == 0)
 				pStream->pIntfCB->intf_rx_cb(pStream->pMediaQ);
 		}
 	}
 
-	hdrLen = openavbRawsockRxParseHdr(pStream->rawsock, pBuf, &hdrInfo);
-	if (hdrLen < 0) {
-		AVB_RC_LOG(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVBAVTP_RC_PARSING_FRAME_HEADER));
+	if (pStream->rxInbox) {
+		// The demultiplexer already stripped the Ethernet header
+		for (i = 0; i < nFrames; i++) {
+			x_avtpRxFrame(pStream, pBufs[i], frameLens[i]);
+		}
+		openavbAvtpRxDemuxRelFrames(pStream->rxInbox);
+		AVB_TRACE_EXIT(AVB_TRACE_AVTP_DETAIL);
+		return;
 	}
-	else {
-		pAvtpPdu = pBuf + offsetToFrame + hdrLen;
-		avtpPduLen = frameLen - hdrLen;
-		x_avtpRxFrame(pStream, pAvtpPdu, avtpPduLen);
+
+	for (i = 0; i < nFrames; i++) {
+		hdrLen = openavbRawsockRxParseHdr(pStream->rawsock, pBufs[i], &hdrInfo);
+		if (hdrLen < 0) {
+			AVB_RC_LOG(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVBAVTP_RC_PARSING_FRAME_HEADER));
+		}
+		else {
+			pAvtpPdu = pBufs[i] + offsetsToFrame[i] + hdrLen;
+			avtpPduLen = frameLens[i] - hdrLen;
+			x_avtpRxFrame(pStream, pAvtpPdu, avtpPduLen);
+		}
+		openavbRawsockRelRxFrame(pStream->rawsock, pBufs[i]);
 	}
-	openavbRawsockRelRxFrame(pStream->rawsock, pBuf);
 
 	AVB_TRACE_EXIT(AVB_TRACE_AVTP_DETAIL);
 }
@@ -623,6 +897,9 @@ int openavbAvtpRxBufferLevel(void *pv)
 		AVB_RC_LOG(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_INVALID_ARGUMENT));
 		return 0;
 	}
+	if (pStream->rxInbox) {
+		return openavbAvtpRxDemuxLevel(pStream->rxInbox);
+	}
 	return openavbRawsockRxBufLevel(pStream->rawsock);
 }
 
@@ -638,6 +915,16 @@ int openavbAvtpLost(void *pv)
 	return count;
 }
 
+int openavbAvtpRxDropped(void *pv)
+{
+	avtp_stream_t *pStream = (avtp_stream_t *)pv;
+	if (!pStream || !pStream->rxInbox) {
+		// Quietly return. Only streams on the shared demultiplexer drop frames here.
+		return 0;
+	}
+	return openavbAvtpRxDemuxDropped(pStream->rxInbox);
+}
+
 U64 openavbAvtpBytes(void *pv)
 {
 	avtp_stream_t *pStream = (avtp_stream_t *)pv;
@@ -693,6 +980,28 @@ void openavbAvtpConfigTimsstampEval(void *handle, U32 tsInterval, U32 reportInte
 	AVB_TRACE_EXIT(AVB_TRACE_AVTP);
 }
 
+void openavbAvtpConfigStats(void *handle, const avtp_stats_t *pStats, U32 maxTransitUsec)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVTP);
+
+	avtp_stream_t *pStream = (avtp_stream_t *)handle;
+	if (!pStream) {
+		AVB_RC_LOG(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_INVALID_ARGUMENT));
+		AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+		return;
+	}
+
+	pStream->statsMaxTransitNsec = maxTransitUsec * NANOSECONDS_PER_USEC;
+	if (pStats) {
+		pStream->stats = *pStats;
+	}
+	else {
+		memset(&pStream->stats, 0, sizeof(pStream->stats));
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+}
+
 void openavbAvtpPause(void *handle, bool bPause)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_AVTP);
@@ -730,6 +1039,9 @@ void openavbAvtpShutdownTalker(void *pv)
 		if (pStream->ifname)
 			free(pStream->ifname);
 
+		if (pStream->ppTxBatch)
+			free(pStream->ppTxBatch);
+
 		// free the malloc'd stream info
 		free(pStream);
 	}
@@ -749,6 +1061,10 @@ void openavbAvtpShutdownListener(void *pv)
 			openavbRawsockClose(pStream->rawsock);
 			pStream->rawsock = NULL;
 		}
+		if (pStream->rxInbox) {
+			openavbAvtpRxDemuxDetach(pStream->rxInbox);
+			pStream->rxInbox = NULL;
+		}
 
 		pStream->pIntfCB->intf_end_cb(pStream->pMediaQ);
 		pStream->pMapCB->map_end_cb(pStream->pMediaQ);
@@ -43,6 +43,8 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_map_pub.h"
 #include "openavb_rawsock.h"
 #include "openavb_timestamp.h"
+#include "openavb_histogram.h"
+#include "openavb_avtp_rx_demux.h"
 
 #define ETHERTYPE_AVTP 0x22F0
 #define ETHERTYPE_8021Q 0x8100
@@ -81,6 +83,18 @@ typedef struct {
 	media_q_t 				mediaq;
 } avtp_state_t;
 
+// Where a stream records its statistics. Members left NULL are not gathered.
+typedef struct {
+	// Time spent in the mapping module per frame
+	openavb_histogram_t		mapTime;
+	// TX: time left from handing a frame to the rawsock until its launch or presentation time
+	openavb_histogram_t		txSlack;
+	// RX: part of max_transit_usec used up when the frame arrived
+	openavb_histogram_t		ptimeError;
+	// RX: frames received
+	U64						*pRxFrames;
+} avtp_stats_t;
+
 
 /* Info associated with an AVTP stream (RX or TX).
  *
@@ -101,6 +115,8 @@ typedef struct
 	U16 nbuffers;
 	// The rawsock library handle.  Used to send or receive frames.
 	void *rawsock;
+	// Inbox of the shared RX demultiplexer. Used instead of rawsock when set.
+	avtp_rx_inbox_t *rxInbox;
 	// The streamID - in network form
 	U8 streamIDnet[8];
 	// The destination address for stream
@@ -109,6 +125,11 @@ typedef struct
 	U8 subtype;
 	// Max Transit - value added to current time to get play time
 	U64 max_transit_usec;
+	// TX: the rawsock holds frames until their launch time, so each frame needs one
+	bool bTxLaunchTime;
+	// TX: time between frames, and the launch time given to the last frame
+	U64 txIntervalNsec;
+	U64 txLastLaunchNsec;
 	// Max frame size
 	U16 frameLen;
 	// AVTP sequence number
@@ -129,12 +150,19 @@ typedef struct
 
 	// TX frame buffer
 	U8* pBuf;
+	// TX frame buffers reserved for a batch
+	U8** ppTxBatch;
+	U32 nTxBatch;
 	// Ethernet header length
 	U32 ethHdrLen;
 	
 	// Timestamp evaluation related
 	openavb_timestamp_eval_t tsEval;
 
+	// Statistics, owned by the talker or listener
+	avtp_stats_t stats;
+	U32 statsMaxTransitNsec;
+
 	// Stat related	
 	// RX frames lost
 	int nLost;
@@ -154,6 +182,7 @@ openavbRC openavbAvtpTxInit(media_q_t *pMediaQ,
 					AVBStreamID_t *streamID,
 					U8* destAddr,
 					U32 max_transit_usec,
+					U32 transmitInterval,
 					U32 fwmark,
 					U16 vlanID,
 					U8  vlanPCP,
@@ -162,6 +191,10 @@ openavbRC openavbAvtpTxInit(media_q_t *pMediaQ,
 
 openavbRC openavbAvtpTx(void *pv, bool bSend, bool txBlockingInIntf);
 
+// Fill and send up to nFrames frames with a single rawsock send.
+// The number of frames actually sent is returned in pFramesSent.
+openavbRC openavbAvtpTxBatch(void *pv, U32 nFrames, U32 *pFramesSent);
+
 openavbRC openavbAvtpRxInit(media_q_t *pMediaQ, 
 					openavb_map_cb_t *pMapCB,
 					openavb_intf_cb_t *pIntfCB,
@@ -170,12 +203,18 @@ openavbRC openavbAvtpRxInit(media_q_t *pMediaQ,
 					U8* destAddr,
 					U16 nbuffers,
 					bool rxSignalMode,
+					bool rxDemux,
 					void **pStream_out);
 
 openavbRC openavbAvtpRx(void *handle);
 
 void openavbAvtpConfigTimsstampEval(void *handle, U32 tsInterval, U32 reportInterval, bool smoothing, U32 tsMaxJitter, U32 tsMaxDrift);
 
+// Set where the stream records its statistics. The presentation time error is how much of
+// maxTransitUsec had passed when a frame with a valid timestamp was received, frames arriving
+// with more than maxTransitUsec to spare are recorded as 0. Pass NULL to stop.
+void openavbAvtpConfigStats(void *handle, const avtp_stats_t *pStats, U32 maxTransitUsec);
+
 void openavbAvtpPause(void *handle, bool bPause);
 
 void openavbAvtpShutdownTalker(void *handle);
@@ -187,6 +226,9 @@ int openavbAvtpRxBufferLevel(void *handle);
 
 int openavbAvtpLost(void *handle);
 
+// Frames dropped by the shared RX demultiplexer because the stream inbox was full
+int openavbAvtpRxDropped(void *handle);
+
 U64 openavbAvtpBytes(void *handle);
 
 #endif //AVB_AVTP_H
@@ -0,0 +1,515 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+
+/*
+* MODULE SUMMARY : Shared AVTP receive demultiplexer.
+*
+* Every listener stream normally opens its own rawsock, so the kernel
+* copies each AVTP frame once per listener socket and every listener
+* thread wakes up for frames that belong to other streams. With the
+* demultiplexer one thread per interface receives all AVTP frames and
+* copies each one only into the inbox of the stream it belongs to.
+*
+* A stream is found by the StreamID of the AVTP header in a hash table
+* and must also match the destination MAC address it was attached with.
+* The inbox is a lock-free single producer / single consumer ring; the
+* demux thread is the producer and the listener thread the consumer.
+* A full inbox drops the frame and counts it for that stream only.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "openavb_platform.h"
+#include "openavb_types.h"
+#include "openavb_trace.h"
+#include "openavb_avtp.h"
+#include "openavb_rawsock.h"
+#include "openavb_time.h"
+#include "openavb_avtp_rx_demux.h"
+
+#define	AVB_LOG_COMPONENT	"AVTP"
+#include "openavb_log.h"
+
+// Number of StreamID hash buckets. Must be a power of 2.
+#define AVTP_RX_DEMUX_HASH_SIZE		64
+
+// Max number of frames taken from the rawsock per wakeup
+#define AVTP_RX_DEMUX_BATCH_FRAMES	32
+
+// Longest time the demux thread blocks before checking for shutdown
+#define AVTP_RX_DEMUX_BLOCK_USEC	(100 * MICROSECONDS_PER_MSEC)
+
+// Frame size and min number of frame buffers of the shared rawsock
+#define AVTP_RX_DEMUX_FRAME_LEN		(1500 + ETH_HDR_LEN_VLAN)
+#define AVTP_RX_DEMUX_MIN_BUFFERS	256
+
+// Offset of the StreamID in the AVTP stream data header
+#define AVTP_RX_DEMUX_STREAM_ID_OFFSET	4
+
+typedef struct avtp_rx_demux avtp_rx_demux_t;
+
+struct avtp_rx_inbox {
+	// Next inbox in the same hash bucket
+	avtp_rx_inbox_t *next;
+	avtp_rx_demux_t *pDemux;
+
+	U8 streamIDnet[8];
+	U8 destAddr[ETH_ALEN];
+
+	// Ring of nSlots PDU copies of slotSize bytes each. nSlots is a power of 2.
+	U8 *pSlots;
+	U32 *pLens;
+	U32 slotSize;
+	U32 nSlots;
+
+	// Set by the listener thread before it sleeps on wakeSem
+	U32 bWaiting;
+	SEM_T(wakeSem)
+
+	// Producer (demux thread) and consumer (listener thread) fields are kept
+	// on separate cache lines. The indexes run freely and wrap at 2^32.
+	U8 lfPad0[CACHE_LINE_SIZE];
+
+	// Next slot to be filled. Written only by the demux thread.
+	U32 lfHead;
+
+	// Frames dropped because the inbox was full. Written only by the demux thread.
+	U32 dropped;
+
+	U8 lfPad1[CACHE_LINE_SIZE];
+
+	// Next slot to be read. Written only by the listener thread.
+	U32 lfTail;
+
+	// Number of slots handed out by the last get
+	U32 nTaken;
+
+	// Part of dropped already returned by openavbAvtpRxDemuxDropped
+	U32 droppedReported;
+
+	U8 lfPad2[CACHE_LINE_SIZE];
+};
+
+THREAD_TYPE(avtpRxDemuxThread);
+
+struct avtp_rx_demux {
+	avtp_rx_demux_t *next;
+	char *ifname;
+	void *rawsock;
+
+	// Protects pHash. Held by the demux thread while it dispatches a batch.
+	MUTEX_HANDLE_ALT(mutex);
+	avtp_rx_inbox_t *pHash[AVTP_RX_DEMUX_HASH_SIZE];
+	U32 nStreams;
+
+	// Frames that matched no attached stream
+	U32 nUnclaimed;
+
+	bool bRunning;
+	THREAD_DEFINITON(avtpRxDemuxThread);
+};
+
+// All running demultiplexers, one per interface
+static avtp_rx_demux_t *gRxDemuxList = NULL;
+static MUTEX_HANDLE_ALT(gRxDemuxListMutex);
+
+static U32 x_hashStreamID(const U8 streamIDnet[8])
+{
+	U64 key;
+	memcpy(&key, streamIDnet, sizeof(key));
+	return (U32)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (AVTP_RX_DEMUX_HASH_SIZE - 1);
+}
+
+static avtp_rx_inbox_t *x_findInbox(avtp_rx_demux_t *pDemux, const U8 *pStreamIDnet, const U8 *pDestAddr)
+{
+	avtp_rx_inbox_t *pInbox = pDemux->pHash[x_hashStreamID(pStreamIDnet)];
+	while (pInbox) {
+		if (memcmp(pInbox->streamIDnet, pStreamIDnet, sizeof(pInbox->streamIDnet)) == 0
+			&& memcmp(pInbox->destAddr, pDestAddr, ETH_ALEN) == 0) {
+			return pInbox;
+		}
+		pInbox = pInbox->next;
+	}
+	return NULL;
+}
+
+// Copy one PDU into the inbox and wake the listener if it waits. Demux thread only.
+static void x_inboxPush(avtp_rx_inbox_t *pInbox, const U8 *pPdu, U32 pduLen)
+{
+	U32 head = pInbox->lfHead;
+	if (pduLen > pInbox->slotSize
+		|| head - ATOMIC_LOAD_ACQUIRE(&pInbox->lfTail) >= pInbox->nSlots) {
+		ATOMIC_STORE_RELAXED(&pInbox->dropped, pInbox->dropped + 1);
+		return;
+	}
+
+	U32 slot = head & (pInbox->nSlots - 1);
+	memcpy(pInbox->pSlots + slot * pInbox->slotSize, pPdu, pduLen);
+	pInbox->pLens[slot] = pduLen;
+	ATOMIC_STORE_RELEASE(&pInbox->lfHead, head + 1);
+
+	// Pairs with the fence in openavbAvtpRxDemuxGetFrames so that either the
+	// listener sees the new head or we see that it is waiting.
+	ATOMIC_FENCE_FULL();
+	if (ATOMIC_LOAD_RELAXED(&pInbox->bWaiting)) {
+		U32 expected = TRUE;
+		if (ATOMIC_CAS(&pInbox->bWaiting, &expected, FALSE)) {
+			SEM_ERR_T(err);
+			SEM_POST(pInbox->wakeSem, err);
+			SEM_LOG_ERR(err);
+		}
+	}
+}
+
+static void *x_avtpRxDemuxThreadFn(void *pv)
+{
+	avtp_rx_demux_t *pDemux = (avtp_rx_demux_t *)pv;
+
+	U8         *pBufs[AVTP_RX_DEMUX_BATCH_FRAMES];
+	U32         offsetsToFrame[AVTP_RX_DEMUX_BATCH_FRAMES];
+	U32         frameLens[AVTP_RX_DEMUX_BATCH_FRAMES];
+	hdr_info_t  hdrInfo;
+	int         nFrames, hdrLen, i;
+
+	AVB_LOGF_INFO("RX demultiplexer started on %s", pDemux->ifname);
+
+	while (ATOMIC_LOAD_ACQUIRE(&pDemux->bRunning)) {
+		nFrames = openavbRawsockGetRxFrames(pDemux->rawsock, AVTP_RX_DEMUX_BLOCK_USEC,
+			pBufs, offsetsToFrame, frameLens, AVTP_RX_DEMUX_BATCH_FRAMES);
+		if (nFrames <= 0)
+			continue;
+
+		MUTEX_LOCK_ALT(pDemux->mutex);
+		for (i = 0; i < nFrames; i++) {
+			avtp_rx_inbox_t *pInbox = NULL;
+			hdrLen = openavbRawsockRxParseHdr(pDemux->rawsock, pBufs[i], &hdrInfo);
+			if (hdrLen >= 0 && frameLens[i] >= hdrLen + AVTP_COMMON_STREAM_DATA_HDR_LEN) {
+				U8 *pPdu = pBufs[i] + offsetsToFrame[i] + hdrLen;
+				// Only stream data frames with a valid StreamID are dispatched
+				if ((pPdu[0] & 0x80) == 0 && (pPdu[1] & 0x80) != 0) {
+					pInbox = x_findInbox(pDemux, pPdu + AVTP_RX_DEMUX_STREAM_ID_OFFSET, hdrInfo.dhost);
+				}
+				if (pInbox) {
+					x_inboxPush(pInbox, pPdu, frameLens[i] - hdrLen);
+				}
+			}
+			if (!pInbox) {
+				pDemux->nUnclaimed++;
+			}
+			openavbRawsockRelRxFrame(pDemux->rawsock, pBufs[i]);
+		}
+		MUTEX_UNLOCK_ALT(pDemux->mutex);
+	}
+
+	AVB_LOGF_INFO("RX demultiplexer stopped on %s, unclaimed frames: %u", pDemux->ifname, pDemux->nUnclaimed);
+	return NULL;
+}
+
+static avtp_rx_demux_t *x_demuxOpen(const char *ifname, U32 nbuffers)
+{
+	avtp_rx_demux_t *pDemux = calloc(1, sizeof(avtp_rx_demux_t));
+	if (!pDemux) {
+		AVB_LOG_ERROR("RX demultiplexer; out of memory");
+		return NULL;
+	}
+
+	pDemux->ifname = strdup(ifname);
+	if (nbuffers < AVTP_RX_DEMUX_MIN_BUFFERS)
+		nbuffers = AVTP_RX_DEMUX_MIN_BUFFERS;
+
+#ifndef UBUNTU
+	pDemux->rawsock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_8021Q, AVTP_RX_DEMUX_FRAME_LEN, nbuffers);
+#else
+	pDemux->rawsock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_AVTP, AVTP_RX_DEMUX_FRAME_LEN, nbuffers);
+#endif
+	if (!pDemux->rawsock) {
+		AVB_LOGF_ERROR("RX demultiplexer; failed to open rawsock on %s", ifname);
+		free(pDemux->ifname);
+		free(pDemux);
+		return NULL;
+	}
+	openavbSetRxSignalMode(pDemux->rawsock, TRUE);
+
+	if (MUTEX_CREATE_ALT(pDemux->mutex) != 0) {
+		AVB_LOG_ERROR("RX demultiplexer; error creating mutex");
+		openavbRawsockClose(pDemux->rawsock);
+		free(pDemux->ifname);
+		free(pDemux);
+		return NULL;
+	}
+
+	// The thread inherits the scheduling and CPU affinity of the first listener thread.
+	bool errResult;
+	pDemux->bRunning = TRUE;
+	THREAD_CREATE(avtpRxDemuxThread, pDemux->avtpRxDemuxThread, NULL, x_avtpRxDemuxThreadFn, pDemux);
+	THREAD_CHECK_ERROR(pDemux->avtpRxDemuxThread, "Thread / task creation failed", errResult);
+	if (errResult) {
+		MUTEX_DESTROY_ALT(pDemux->mutex);
+		openavbRawsockClose(pDemux->rawsock);
+		free(pDemux->ifname);
+		free(pDemux);
+		return NULL;
+	}
+
+	return pDemux;
+}
+
+static void x_demuxClose(avtp_rx_demux_t *pDemux)
+{
+	ATOMIC_STORE_RELEASE(&pDemux->bRunning, FALSE);
+	THREAD_JOIN(pDemux->avtpRxDemuxThread, NULL);
+
+	MUTEX_DESTROY_ALT(pDemux->mutex);
+
+	openavbRawsockClose(pDemux->rawsock);
+	free(pDemux->ifname);
+	free(pDemux);
+}
+
+bool openavbAvtpRxDemuxInitialize(void)
+{
+	if (MUTEX_CREATE_ALT(gRxDemuxListMutex) != 0) {
+		AVB_LOG_ERROR("RX demultiplexer; error creating mutex");
+		return FALSE;
+	}
+	return TRUE;
+}
+
+void openavbAvtpRxDemuxCleanup(void)
+{
+	if (gRxDemuxList) {
+		AVB_LOG_WARNING("RX demultiplexer still has attached streams");
+	}
+
+	MUTEX_DESTROY_ALT(gRxDemuxListMutex);
+}
+
+avtp_rx_inbox_t *openavbAvtpRxDemuxAttach(const char *ifname, const U8 streamIDnet[8], const U8 destAddr[ETH_ALEN], U32 maxPduLen, U32 nbuffers)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVTP);
+
+	if (!ifname || !streamIDnet || !destAddr || maxPduLen == 0) {
+		AVB_RC_LOG(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_INVALID_ARGUMENT));
+		AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+		return NULL;
+	}
+
+	avtp_rx_inbox_t *pInbox = calloc(1, sizeof(avtp_rx_inbox_t));
+	if (!pInbox) {
+		AVB_RC_LOG(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_OUT_OF_MEMORY));
+		AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+		return NULL;
+	}
+
+	memcpy(pInbox->streamIDnet, streamIDnet, sizeof(pInbox->streamIDnet));
+	memcpy(pInbox->destAddr, destAddr, ETH_ALEN);
+	pInbox->slotSize = (maxPduLen + 7) & ~7;
+	pInbox->nSlots = 1;
+	while (pInbox->nSlots < nbuffers)
+		pInbox->nSlots <<= 1;
+	pInbox->pSlots = malloc(pInbox->nSlots * pInbox->slotSize);
+	pInbox->pLens = malloc(pInbox->nSlots * sizeof(U32));
+	if (!pInbox->pSlots || !pInbox->pLens) {
+		AVB_RC_LOG(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_OUT_OF_MEMORY));
+		free(pInbox->pSlots);
+		free(pInbox->pLens);
+		free(pInbox);
+		AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+		return NULL;
+	}
+
+	SEM_ERR_T(err);
+	SEM_INIT(pInbox->wakeSem, 0, err);
+	SEM_LOG_ERR(err);
+
+	MUTEX_LOCK_ALT(gRxDemuxListMutex);
+
+	avtp_rx_demux_t *pDemux = gRxDemuxList;
+	while (pDemux && strcmp(pDemux->ifname, ifname) != 0)
+		pDemux = pDemux->next;
+	if (!pDemux) {
+		pDemux = x_demuxOpen(ifname, nbuffers);
+		if (!pDemux) {
+			MUTEX_UNLOCK_ALT(gRxDemuxListMutex);
+			SEM_DESTROY(pInbox->wakeSem, err);
+			free(pInbox->pSlots);
+			free(pInbox->pLens);
+			free(pInbox);
+			AVB_RC_LOG(AVB_RC(OPENAVB_AVTP_FAILURE | OPENAVB_RC_RAWSOCK_OPEN));
+			AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+			return NULL;
+		}
+		pDemux->next = gRxDemuxList;
+		gRxDemuxList = pDemux;
+	}
+
+	MUTEX_LOCK_ALT(pDemux->mutex);
+	if (x_findInbox(pDemux, pInbox->streamIDnet, pInbox->destAddr)) {
+		AVB_LOG_WARNING("RX demultiplexer; stream already attached, frames go to the newest listener");
+	}
+	U32 bucket = x_hashStreamID(pInbox->streamIDnet);
+	pInbox->pDemux = pDemux;
+	pInbox->next = pDemux->pHash[bucket];
+	pDemux->pHash[bucket] = pInbox;
+	pDemux->nStreams++;
+	MUTEX_UNLOCK_ALT(pDemux->mutex);
+
+	// The filter of the shared rawsock accepts all joined groups
+	openavbRawsockRxMulticast(pDemux->rawsock, TRUE, destAddr);
+
+	MUTEX_UNLOCK_ALT(gRxDemuxListMutex);
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+	return pInbox;
+}
+
+void openavbAvtpRxDemuxDetach(avtp_rx_inbox_t *pInbox)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVTP);
+
+	if (!pInbox) {
+		AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+		return;
+	}
+
+	avtp_rx_demux_t *pDemux = pInbox->pDemux;
+
+	MUTEX_LOCK_ALT(gRxDemuxListMutex);
+
+	MUTEX_LOCK_ALT(pDemux->mutex);
+	avtp_rx_inbox_t **ppInbox = &pDemux->pHash[x_hashStreamID(pInbox->streamIDnet)];
+	while (*ppInbox && *ppInbox != pInbox)
+		ppInbox = &(*ppInbox)->next;
+	if (*ppInbox)
+		*ppInbox = pInbox->next;
+	pDemux->nStreams--;
+	MUTEX_UNLOCK_ALT(pDemux->mutex);
+
+	// Another stream may still use the same group
+	bool bGroupUsed = FALSE;
+	U32 i;
+	for (i = 0; i < AVTP_RX_DEMUX_HASH_SIZE && !bGroupUsed; i++) {
+		avtp_rx_inbox_t *pOther;
+		for (pOther = pDemux->pHash[i]; pOther; pOther = pOther->next) {
+			if (memcmp(pOther->destAddr, pInbox->destAddr, ETH_ALEN) == 0) {
+				bGroupUsed = TRUE;
+				break;
+			}
+		}
+	}
+
+	if (pDemux->nStreams == 0) {
+		avtp_rx_demux_t **ppDemux = &gRxDemuxList;
+		while (*ppDemux != pDemux)
+			ppDemux = &(*ppDemux)->next;
+		*ppDemux = pDemux->next;
+		x_demuxClose(pDemux);
+	}
+	else if (!bGroupUsed) {
+		openavbRawsockRxMulticast(pDemux->rawsock, FALSE, pInbox->destAddr);
+	}
+
+	MUTEX_UNLOCK_ALT(gRxDemuxListMutex);
+
+	SEM_ERR_T(err);
+	SEM_DESTROY(pInbox->wakeSem, err);
+	SEM_LOG_ERR(err);
+	free(pInbox->pSlots);
+	free(pInbox->pLens);
+	free(pInbox);
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVTP);
+}
+
+int openavbAvtpRxDemuxGetFrames(avtp_rx_inbox_t *pInbox, U32 usecTimeout, U8 **ppPdus, U32 *pLens, U32 count)
+{
+	U32 tail = pInbox->lfTail;
+	U32 head = ATOMIC_LOAD_ACQUIRE(&pInbox->lfHead);
+
+	if (head == tail && usecTimeout != OPENAVB_RAWSOCK_NONBLOCK) {
+		bool bWoken = FALSE;
+
+		ATOMIC_STORE_RELAXED(&pInbox->bWaiting, TRUE);
+		ATOMIC_FENCE_FULL();
+		head = ATOMIC_LOAD_ACQUIRE(&pInbox->lfHead);
+		if (head == tail) {
+			SEM_ERR_T(err);
+			SEM_TIMEDWAIT_USEC(pInbox->wakeSem, usecTimeout, err);
+			bWoken = SEM_IS_ERR_NONE(err);
+			head = ATOMIC_LOAD_ACQUIRE(&pInbox->lfHead);
+		}
+		if (!bWoken) {
+			// If the demux thread already claimed the wakeup, take its post
+			// so that it does not end the next wait early.
+			U32 expected = TRUE;
+			if (!ATOMIC_CAS(&pInbox->bWaiting, &expected, FALSE)) {
+				SEM_ERR_T(err);
+				SEM_WAIT(pInbox->wakeSem, err);
+				SEM_LOG_ERR(err);
+			}
+		}
+	}
+
+	U32 n = head - tail;
+	if (n > count)
+		n = count;
+
+	U32 i;
+	for (i = 0; i < n; i++) {
+		U32 slot = (tail + i) & (pInbox->nSlots - 1);
+		ppPdus[i] = pInbox->pSlots + slot * pInbox->slotSize;
+		pLens[i] = pInbox->pLens[slot];
+	}
+	pInbox->nTaken = n;
+	return n;
+}
+
+void openavbAvtpRxDemuxRelFrames(avtp_rx_inbox_t *pInbox)
+{
+	if (pInbox->nTaken) {
+		ATOMIC_STORE_RELEASE(&pInbox->lfTail, pInbox->lfTail + pInbox->nTaken);
+		pInbox->nTaken = 0;
+	}
+}
+
+U32 openavbAvtpRxDemuxLevel(avtp_rx_inbox_t *pInbox)
+{
+	return ATOMIC_LOAD_ACQUIRE(&pInbox->lfHead) - pInbox->lfTail;
+}
+
+U32 openavbAvtpRxDemuxDropped(avtp_rx_inbox_t *pInbox)
+{
+	U32 dropped = ATOMIC_LOAD_RELAXED(&pInbox->dropped);
+	U32 count = dropped - pInbox->droppedReported;
+	pInbox->droppedReported = dropped;
+	return count;
+}
@@ -0,0 +1,74 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+
+/*
+* HEADER SUMMARY : Shared AVTP receive demultiplexer. A single rawsock per
+* interface receives the frames of all listener streams that use it. Each
+* frame is handed to the inbox of the stream with the matching StreamID and
+* destination MAC address.
+*/
+
+#ifndef AVB_AVTP_RX_DEMUX_H
+#define AVB_AVTP_RX_DEMUX_H 1
+
+#include "openavb_platform.h"
+#include "openavb_types.h"
+
+typedef struct avtp_rx_inbox avtp_rx_inbox_t;
+
+// Called once before and after all other demux functions
+bool openavbAvtpRxDemuxInitialize(void);
+void openavbAvtpRxDemuxCleanup(void);
+
+// Attach a listener stream to the demultiplexer of ifname, which is created on first use.
+// streamIDnet is the StreamID in network form as carried in the AVTP header.
+// maxPduLen is the largest AVTP PDU the stream will accept and nbuffers the inbox depth.
+avtp_rx_inbox_t *openavbAvtpRxDemuxAttach(const char *ifname, const U8 streamIDnet[8], const U8 destAddr[ETH_ALEN], U32 maxPduLen, U32 nbuffers);
+
+// Detach the stream. The last stream on an interface stops its demultiplexer.
+void openavbAvtpRxDemuxDetach(avtp_rx_inbox_t *pInbox);
+
+// Take up to count AVTP PDUs from the inbox, waiting up to usecTimeout for the first one
+// (or use OPENAVB_RAWSOCK_NONBLOCK). Frames stay valid until openavbAvtpRxDemuxRelFrames.
+// Returns the number of PDUs stored in ppPdus.
+int openavbAvtpRxDemuxGetFrames(avtp_rx_inbox_t *pInbox, U32 usecTimeout, U8 **ppPdus, U32 *pLens, U32 count);
+
+// Give back the PDUs returned by the last openavbAvtpRxDemuxGetFrames call
+void openavbAvtpRxDemuxRelFrames(avtp_rx_inbox_t *pInbox);
+
+// Number of PDUs waiting in the inbox
+U32 openavbAvtpRxDemuxLevel(avtp_rx_inbox_t *pInbox);
+
+// Frames dropped because the inbox was full since the last call
+U32 openavbAvtpRxDemuxDropped(avtp_rx_inbox_t *pInbox);
+
+#endif // AVB_AVTP_RX_DEMUX_H
@@ -39,6 +39,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_types.h"
 #include "openavb_trace.h"
 #include "openavb_avtp_time_pub.h"
+#include "openavb_mcr_hal_pub.h"
 
 #define	AVB_LOG_COMPONENT	"AVTP"
 #include "openavb_log.h"
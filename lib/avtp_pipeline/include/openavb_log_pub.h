@@ -138,6 +138,19 @@ static const bool OPENAVB_LOG_PULL_MODE = FALSE;
 #define LOG_QUEUE_MSG_CNT		82
 #define LOG_QUEUE_SLEEP_MSEC	100
 
+// When OPENAVB_LOG_RING is used along with OPENAVB_LOG_FROM_THREAD, each thread writes its messages as
+// compact binary records (timestamp, format and arguments) into its own lock-free ring buffer,
+// and the logging thread does all of the formatting and output. Logging from a time critical thread then
+// never waits on the log lock or on I/O. Messages that do not fit into a full ring are dropped and counted.
+// Messages using formats that cannot be recorded (such as %n or long double, or formats longer than 512
+// characters) use the normal locked path.
+static const bool OPENAVB_LOG_RING = TRUE;
+
+// When using the OPENAVB_LOG_RING option. Size in bytes of each per thread ring (must be a power of 2)
+// and of the largest record. String arguments that do not fit within a record are truncated.
+#define LOG_RING_SIZE			16384
+#define LOG_RING_REC_MAX		1024
+
 // RT (RealTime logging) related defines
 #define LOG_RT_QUEUE_CNT		128
 #define LOG_RT_BEGIN			TRUE
@@ -283,4 +296,8 @@ void avbLogBuffer(
 // Message will not be null terminated.
 U32 avbLogGetMsg(U8 *pBuf, U32 bufSize);
 
+// Get the total number of messages dropped because a per thread log ring was full.
+// Only used with the OPENAVB_LOG_RING option.
+U32 avbLogGetDropCount(void);
+
 #endif // OPENAVB_LOG_PUB_H
@@ -33,7 +33,8 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 * MODULE SUMMARY : Tone generator interface module. Talker only.
 * 
 * - This interface module generates and audio tone for use with -6 and AAF mappings
-* - Requires an OSAL sin implementation of reasonable performance. 
+* - Tones come from a wavetable read by a phase accumulator per channel. Sweeps and
+*   seeded noise make it usable as a deterministic load generator.
 */
 
 #include <stdlib.h>
@@ -55,6 +56,36 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 
 #define PI 3.14159265358979f
 
+// Wavetable size. Linear interpolation between entries keeps the error below -120 dB.
+#define TONEGEN_TABLE_BITS		12
+#define TONEGEN_TABLE_SIZE		(1 << TONEGEN_TABLE_BITS)
+#define TONEGEN_FRAC_BITS		(32 - TONEGEN_TABLE_BITS)
+#define TONEGEN_FRAC_MASK		((1 << TONEGEN_FRAC_BITS) - 1)
+
+typedef enum {
+	TONEGEN_PATTERN_TONE,		// Fixed tone, on / off tone or melody
+	TONEGEN_PATTERN_SWEEP,		// Linear frequency sweep, restarting at the start frequency
+	TONEGEN_PATTERN_NOISE,		// White noise from a seeded generator
+} tonegen_pattern_t;
+
+typedef struct {
+	// Phase accumulator. The top TONEGEN_TABLE_BITS index the wavetable.
+	U32 phase;
+	U32 phaseInc;
+
+	// Sweep phase increment in 32.32 fixed point, its start value and per frame step
+	U64 sweepInc;
+	U64 sweepStart;
+	S64 sweepStep;
+
+	// xorshift32 state for noise
+	U32 noiseState;
+} tonegen_osc_t;
+
+// Writes frames of the output format from the generated block. Sample ch of a frame is
+// read from pBlock[ch * oscStride + frame], and pFixed is appended to every frame.
+typedef void (*tonegen_write_fn_t)(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen);
+
 typedef struct {
 	/////////////
 	// Config data
@@ -94,6 +125,20 @@ typedef struct {
 	bool fv2Enabled;
 	U32 fv2;
 
+	// intf_nv_pattern
+	tonegen_pattern_t pattern;
+
+	// intf_nv_tone_step_hz: Channel n plays the tone raised by n times this many hz
+	U32 toneStepHz;
+
+	// intf_nv_sweep_start_hz, intf_nv_sweep_end_hz, intf_nv_sweep_msec
+	U32 sweepStartHz;
+	U32 sweepEndHz;
+	U32 sweepMSec;
+
+	// intf_nv_noise_seed
+	U32 noiseSeed;
+
 	/////////////
 	// Variable data
 	/////////////
@@ -107,8 +152,31 @@ typedef struct {
 	// Keeps track of how long before toggling the tone on / off
 	U32 freqCountdown;
 
-	// Ratio precalc
-	float ratio;
+	// Wavetable scaled to the output format and volume
+	float *pTable;
+
+	// Noise scale to the output format and volume
+	float noiseScale;
+
+	// One oscillator per tone channel, or a single one when all channels are the same
+	tonegen_osc_t *pOsc;
+	U32 oscCount;
+
+	// Frames generated so far in the current sweep
+	U32 sweepPos;
+	U32 sweepFrames;
+
+	// Channels carrying generated samples, ahead of the fixed value channels
+	U32 toneChannels;
+
+	// Generated samples, framesPerItem per oscillator
+	float *pBlock;
+	U32 blockFrames;
+
+	// Output format writer and the fixed value channels in output format
+	tonegen_write_fn_t writeFn;
+	U8 fixed[8];
+	U32 fixedLen;
 
 	// Index to into the melody string
 	U32 melodyIdx;
@@ -337,6 +405,39 @@ void openavbIntfToneGenCfgCB(media_q_t *pMediaQ, const char *name, const char *v
 			pPvtData->volume = pow(10.0, vol/10.0);
 		}
 
+		else if (strcmp(name, "intf_nv_pattern") == 0) {
+			if (strncasecmp(value, "tone", 4) == 0)
+				pPvtData->pattern = TONEGEN_PATTERN_TONE;
+			else if (strncasecmp(value, "sweep", 5) == 0)
+				pPvtData->pattern = TONEGEN_PATTERN_SWEEP;
+			else if (strncasecmp(value, "noise", 5) == 0)
+				pPvtData->pattern = TONEGEN_PATTERN_NOISE;
+			else {
+				AVB_LOG_ERROR("Invalid pattern configured for intf_nv_pattern.");
+				pPvtData->pattern = TONEGEN_PATTERN_TONE;
+			}
+		}
+
+		else if (strcmp(name, "intf_nv_tone_step_hz") == 0) {
+			pPvtData->toneStepHz = strtol(value, &pEnd, 10);
+		}
+
+		else if (strcmp(name, "intf_nv_sweep_start_hz") == 0) {
+			pPvtData->sweepStartHz = strtol(value, &pEnd, 10);
+		}
+
+		else if (strcmp(name, "intf_nv_sweep_end_hz") == 0) {
+			pPvtData->sweepEndHz = strtol(value, &pEnd, 10);
+		}
+
+		else if (strcmp(name, "intf_nv_sweep_msec") == 0) {
+			pPvtData->sweepMSec = strtol(value, &pEnd, 10);
+		}
+
+		else if (strcmp(name, "intf_nv_noise_seed") == 0) {
+			pPvtData->noiseSeed = strtoul(value, &pEnd, 10);
+		}
+
 		else if (strcmp(name, "intf_nv_fv1") == 0) {
 			pPvtData->fv1 = strtol(value, &pEnd, 10);
 			pPvtData->fv1Enabled = true;
@@ -360,6 +461,421 @@ void openavbIntfToneGenGenInitCB(media_q_t *pMediaQ)
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
 }
 
+static U32 x_hzToPhaseInc(U32 hz, U32 audioRate)
+{
+	if (hz >= audioRate)
+		hz %= audioRate;
+	return (U32)(((U64)hz << 32) / audioRate);
+}
+
+static bool x_bigEndianOutput(avb_audio_endian_t audioEndian)
+{
+	if (audioEndian == AVB_AUDIO_ENDIAN_BIG)
+		return TRUE;
+	if (audioEndian == AVB_AUDIO_ENDIAN_LITTLE)
+		return FALSE;
+	// Unspecified means host order
+#if defined __BYTE_ORDER && defined __BIG_ENDIAN && __BYTE_ORDER == __BIG_ENDIAN
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+// Encode one sample of the output format
+static inline __attribute__((always_inline)) void x_encodeSample(U8 *pData, const float *pValue, const U32 sampleBytes, const bool bigEndian, const bool isFloat)
+{
+	U32 sample;
+	if (isFloat)
+		memcpy(&sample, pValue, 4);  // done so no warning with -Wstrict-aliasing
+	else
+		sample = (U32)(S32)*pValue;
+
+	if (sampleBytes == 2) {
+		if (bigEndian) {
+			pData[0] = sample >> 8;
+			pData[1] = sample;
+		} else {
+			pData[0] = sample;
+			pData[1] = sample >> 8;
+		}
+	}
+	else if (sampleBytes == 3) {
+		// Top 24 bits of the 32 bit sample
+		if (bigEndian) {
+			pData[0] = sample >> 24;
+			pData[1] = sample >> 16;
+			pData[2] = sample >> 8;
+		} else {
+			pData[0] = sample >> 8;
+			pData[1] = sample >> 16;
+			pData[2] = sample >> 24;
+		}
+	}
+	else {
+		if (bigEndian) {
+			pData[0] = sample >> 24;
+			pData[1] = sample >> 16;
+			pData[2] = sample >> 8;
+			pData[3] = sample;
+		} else {
+			pData[0] = sample;
+			pData[1] = sample >> 8;
+			pData[2] = sample >> 16;
+			pData[3] = sample >> 24;
+		}
+	}
+}
+
+// Converts and stores the samples. Called with constant format arguments only, so each
+// writer below is compiled without any per sample format checks.
+static inline __attribute__((always_inline)) void x_writeFrames(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames,
+	const U8 *pFixed, U32 fixedLen, const U32 sampleBytes, const bool bigEndian, const bool isFloat)
+{
+	U32 frame, ch;
+	for (frame = 0; frame < frames; frame++) {
+		if (oscStride) {
+			const float *pValue = pBlock + frame;
+			for (ch = 0; ch < toneChannels; ch++) {
+				x_encodeSample(pData, pValue, sampleBytes, bigEndian, isFloat);
+				pValue += oscStride;
+				pData += sampleBytes;
+			}
+		}
+		else if (toneChannels) {
+			// Same sample in every channel: encode it once
+			U8 *pFirst = pData;
+			x_encodeSample(pFirst, pBlock + frame, sampleBytes, bigEndian, isFloat);
+			pData += sampleBytes;
+			for (ch = 1; ch < toneChannels; ch++) {
+				memcpy(pData, pFirst, sampleBytes);
+				pData += sampleBytes;
+			}
+		}
+
+		if (fixedLen) {
+			memcpy(pData, pFixed, fixedLen);
+			pData += fixedLen;
+		}
+	}
+}
+
+static void x_writeInt16BE(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen)
+{
+	x_writeFrames(pData, pBlock, oscStride, toneChannels, frames, pFixed, fixedLen, 2, TRUE, FALSE);
+}
+
+static void x_writeInt16LE(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen)
+{
+	x_writeFrames(pData, pBlock, oscStride, toneChannels, frames, pFixed, fixedLen, 2, FALSE, FALSE);
+}
+
+static void x_writeInt24BE(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen)
+{
+	x_writeFrames(pData, pBlock, oscStride, toneChannels, frames, pFixed, fixedLen, 3, TRUE, FALSE);
+}
+
+static void x_writeInt24LE(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen)
+{
+	x_writeFrames(pData, pBlock, oscStride, toneChannels, frames, pFixed, fixedLen, 3, FALSE, FALSE);
+}
+
+static void x_writeInt32BE(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen)
+{
+	x_writeFrames(pData, pBlock, oscStride, toneChannels, frames, pFixed, fixedLen, 4, TRUE, FALSE);
+}
+
+static void x_writeInt32LE(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen)
+{
+	x_writeFrames(pData, pBlock, oscStride, toneChannels, frames, pFixed, fixedLen, 4, FALSE, FALSE);
+}
+
+static void x_writeFloatBE(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen)
+{
+	x_writeFrames(pData, pBlock, oscStride, toneChannels, frames, pFixed, fixedLen, 4, TRUE, TRUE);
+}
+
+static void x_writeFloatLE(U8 *pData, const float *pBlock, U32 oscStride, U32 toneChannels, U32 frames, const U8 *pFixed, U32 fixedLen)
+{
+	x_writeFrames(pData, pBlock, oscStride, toneChannels, frames, pFixed, fixedLen, 4, FALSE, TRUE);
+}
+
+static void x_oscSine(tonegen_osc_t *pOsc, const float *pTable, float *pOut, U32 frames)
+{
+	U32 phase = pOsc->phase;
+	U32 phaseInc = pOsc->phaseInc;
+	U32 i1;
+
+	for (i1 = 0; i1 < frames; i1++) {
+		U32 idx = phase >> TONEGEN_FRAC_BITS;
+		float frac = (float)(phase & TONEGEN_FRAC_MASK) * (1.0f / (1 << TONEGEN_FRAC_BITS));
+		pOut[i1] = pTable[idx] + (pTable[idx + 1] - pTable[idx]) * frac;
+		phase += phaseInc;
+	}
+	pOsc->phase = phase;
+}
+
+static void x_oscSweep(tonegen_osc_t *pOsc, const float *pTable, float *pOut, U32 frames, U32 sweepPos, U32 sweepFrames)
+{
+	U32 phase = pOsc->phase;
+	U64 sweepInc = pOsc->sweepInc;
+	U32 i1;
+
+	for (i1 = 0; i1 < frames; i1++) {
+		U32 idx = phase >> TONEGEN_FRAC_BITS;
+		float frac = (float)(phase & TONEGEN_FRAC_MASK) * (1.0f / (1 << TONEGEN_FRAC_BITS));
+		pOut[i1] = pTable[idx] + (pTable[idx + 1] - pTable[idx]) * frac;
+		phase += (U32)(sweepInc >> 32);
+		sweepInc = (U64)((S64)sweepInc + pOsc->sweepStep);
+		if (++sweepPos >= sweepFrames) {
+			sweepPos = 0;
+			sweepInc = pOsc->sweepStart;
+		}
+	}
+	pOsc->phase = phase;
+	pOsc->sweepInc = sweepInc;
+}
+
+static void x_oscNoise(tonegen_osc_t *pOsc, float scale, float *pOut, U32 frames)
+{
+	U32 state = pOsc->noiseState;
+	U32 i1;
+
+	for (i1 = 0; i1 < frames; i1++) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		pOut[i1] = (float)(S32)state * scale;
+	}
+	pOsc->noiseState = state;
+}
+
+static void x_setToneFreq(pvt_data_t *pPvtData, U32 audioRate)
+{
+	U32 i1;
+	for (i1 = 0; i1 < pPvtData->oscCount; i1++) {
+		if (pPvtData->freq) {
+			pPvtData->pOsc[i1].phaseInc = x_hzToPhaseInc(pPvtData->freq + i1 * pPvtData->toneStepHz, audioRate);
+		}
+		else {
+			// Silence. Table entry 0 is sin(0).
+			pPvtData->pOsc[i1].phaseInc = 0;
+			pPvtData->pOsc[i1].phase = 0;
+		}
+	}
+}
+
+// Pick the frequency of the tone pattern for the next stretch of frames
+static void x_toneNextState(pvt_data_t *pPvtData, U32 audioRate)
+{
+	if (pPvtData->pMelodyString) {
+		// Melody logic
+		U32 intervalMSec;
+		xGetMelodyToneAndDuration(
+			pPvtData->pMelodyString[pPvtData->melodyIdx],
+			pPvtData->pMelodyString[pPvtData->melodyIdx + 1],
+			&pPvtData->freq, &intervalMSec);
+		pPvtData->melodyIdx += 2;
+
+		pPvtData->freqCountdown = (audioRate / 1000) * intervalMSec;
+		if (pPvtData->melodyIdx >= pPvtData->melodyLen)
+			pPvtData->melodyIdx = 0;
+	}
+	else {
+		// Fixed tone
+		if (pPvtData->onOffIntervalMSec > 0) {
+			if (pPvtData->freq == 0) {
+				pPvtData->freq = pPvtData->toneHz;
+			} else {
+				pPvtData->freq = 0;
+			}
+			pPvtData->freqCountdown = (audioRate / 1000) * pPvtData->onOffIntervalMSec;
+		}
+		else {
+			pPvtData->freqCountdown = audioRate;		// Just run steady for 1 sec
+			pPvtData->freq = pPvtData->toneHz;
+		}
+	}
+	if (!pPvtData->freqCountdown)
+		pPvtData->freqCountdown = 1;
+
+	x_setToneFreq(pPvtData, audioRate);
+}
+
+// Fill the block with frames samples per oscillator
+static void x_generate(pvt_data_t *pPvtData, U32 audioRate, U32 frames)
+{
+	U32 done = 0;
+	U32 i1;
+
+	while (done < frames) {
+		U32 run = frames - done;
+
+		if (pPvtData->pattern == TONEGEN_PATTERN_TONE) {
+			// Check for tone on / off toggle
+			if (!pPvtData->freqCountdown)
+				x_toneNextState(pPvtData, audioRate);
+			if (run > pPvtData->freqCountdown)
+				run = pPvtData->freqCountdown;
+			pPvtData->freqCountdown -= run;
+		}
+
+		for (i1 = 0; i1 < pPvtData->oscCount; i1++) {
+			float *pOut = pPvtData->pBlock + i1 * frames + done;
+			switch (pPvtData->pattern) {
+				case TONEGEN_PATTERN_SWEEP:
+					x_oscSweep(&pPvtData->pOsc[i1], pPvtData->pTable, pOut, run, pPvtData->sweepPos, pPvtData->sweepFrames);
+					break;
+				case TONEGEN_PATTERN_NOISE:
+					x_oscNoise(&pPvtData->pOsc[i1], pPvtData->noiseScale, pOut, run);
+					break;
+				case TONEGEN_PATTERN_TONE:
+				default:
+					x_oscSine(&pPvtData->pOsc[i1], pPvtData->pTable, pOut, run);
+					break;
+			}
+		}
+
+		if (pPvtData->pattern == TONEGEN_PATTERN_SWEEP)
+			pPvtData->sweepPos = (pPvtData->sweepPos + run) % pPvtData->sweepFrames;
+
+		done += run;
+	}
+}
+
+static void x_freeEngine(pvt_data_t *pPvtData)
+{
+	free(pPvtData->pTable);
+	pPvtData->pTable = NULL;
+	free(pPvtData->pOsc);
+	pPvtData->pOsc = NULL;
+	pPvtData->oscCount = 0;
+	free(pPvtData->pBlock);
+	pPvtData->pBlock = NULL;
+	pPvtData->blockFrames = 0;
+}
+
+static bool x_initEngine(pvt_data_t *pPvtData, media_q_pub_map_uncmp_audio_info_t *pPubMapUncmpAudioInfo)
+{
+	U32 audioRate = pPubMapUncmpAudioInfo->audioRate;
+	U32 toneChannels = 0;
+	U32 sampleBytes = 4;
+	bool bigEndian = x_bigEndianOutput(pPvtData->audioEndian);
+	float scale = pPvtData->volume;
+	U32 i1;
+
+	if (!audioRate) {
+		AVB_LOG_ERROR("Audio rate not set.");
+		return FALSE;
+	}
+
+	if (pPubMapUncmpAudioInfo->audioChannels > pPvtData->fvChannels)
+		toneChannels = pPubMapUncmpAudioInfo->audioChannels - pPvtData->fvChannels;
+	pPvtData->toneChannels = toneChannels;
+
+	// Pick the writer for the output format and scale the samples to it
+	pPvtData->writeFn = NULL;
+	if (pPvtData->audioType == AVB_AUDIO_TYPE_INT) {
+		if (pPvtData->audioBitDepth == 32) {
+			pPvtData->writeFn = bigEndian ? x_writeInt32BE : x_writeInt32LE;
+			sampleBytes = 4;
+			scale *= (float)(32000 << 16);
+		} else if (pPvtData->audioBitDepth == 24) {
+			pPvtData->writeFn = bigEndian ? x_writeInt24BE : x_writeInt24LE;
+			sampleBytes = 3;
+			scale *= (float)(32000 << 16);
+		} else if (pPvtData->audioBitDepth == 16) {
+			pPvtData->writeFn = bigEndian ? x_writeInt16BE : x_writeInt16LE;
+			sampleBytes = 2;
+			scale *= 32000.0f;
+		}
+	} else if (pPvtData->audioType == AVB_AUDIO_TYPE_FLOAT) {
+		pPvtData->writeFn = bigEndian ? x_writeFloatBE : x_writeFloatLE;
+		sampleBytes = 4;
+	}
+	if (!pPvtData->writeFn) {
+		// CORE_TODO
+		AVB_LOG_ERROR("Audio sample size format not implemented yet for tone generator interface module");
+	}
+
+	// The fixed value channels carry fixed 32 bit values. In other formats they are left silent.
+	memset(pPvtData->fixed, 0, sizeof(pPvtData->fixed));
+	pPvtData->fixedLen = pPvtData->fvChannels * sampleBytes;
+	if (pPvtData->fixedLen > sizeof(pPvtData->fixed))
+		pPvtData->fixedLen = sizeof(pPvtData->fixed);
+	if (pPvtData->audioType == AVB_AUDIO_TYPE_INT && pPvtData->audioBitDepth == 32) {
+		U8 *pFixed = pPvtData->fixed;
+		U32 fv[2];
+		U32 fvCnt = 0;
+		if (pPvtData->fv1Enabled)
+			fv[fvCnt++] = pPvtData->fv1;
+		if (pPvtData->fv2Enabled)
+			fv[fvCnt++] = pPvtData->fv2;
+		for (i1 = 0; i1 < fvCnt; i1++) {
+			if (bigEndian) {
+				pFixed[0] = fv[i1] >> 24;
+				pFixed[1] = fv[i1] >> 16;
+				pFixed[2] = fv[i1] >> 8;
+				pFixed[3] = fv[i1];
+			} else {
+				pFixed[0] = fv[i1];
+				pFixed[1] = fv[i1] >> 8;
+				pFixed[2] = fv[i1] >> 16;
+				pFixed[3] = fv[i1] >> 24;
+			}
+			pFixed += 4;
+		}
+	}
+
+	// One period of the sine scaled to the output, plus a guard entry for the interpolation
+	pPvtData->pTable = malloc((TONEGEN_TABLE_SIZE + 1) * sizeof(float));
+	if (!pPvtData->pTable) {
+		return FALSE;
+	}
+	for (i1 = 0; i1 < TONEGEN_TABLE_SIZE; i1++) {
+		pPvtData->pTable[i1] = SIN(2 * PI * i1 / TONEGEN_TABLE_SIZE) * scale;
+	}
+	pPvtData->pTable[TONEGEN_TABLE_SIZE] = pPvtData->pTable[0];
+	pPvtData->noiseScale = scale / 2147483648.0f;
+
+	// All channels share one oscillator unless they differ
+	pPvtData->oscCount = 1;
+	if (toneChannels > 1 && (pPvtData->toneStepHz || pPvtData->pattern == TONEGEN_PATTERN_NOISE))
+		pPvtData->oscCount = toneChannels;
+
+	pPvtData->pOsc = calloc(pPvtData->oscCount, sizeof(tonegen_osc_t));
+	if (!pPvtData->pOsc) {
+		return FALSE;
+	}
+
+	pPvtData->sweepFrames = (U32)(((U64)audioRate * pPvtData->sweepMSec) / 1000);
+	if (!pPvtData->sweepFrames)
+		pPvtData->sweepFrames = 1;
+	pPvtData->sweepPos = 0;
+
+	for (i1 = 0; i1 < pPvtData->oscCount; i1++) {
+		tonegen_osc_t *pOsc = &pPvtData->pOsc[i1];
+		U64 sweepEnd = (U64)x_hzToPhaseInc(pPvtData->sweepEndHz + i1 * pPvtData->toneStepHz, audioRate) << 32;
+
+		pOsc->sweepStart = (U64)x_hzToPhaseInc(pPvtData->sweepStartHz + i1 * pPvtData->toneStepHz, audioRate) << 32;
+		pOsc->sweepInc = pOsc->sweepStart;
+		pOsc->sweepStep = ((S64)sweepEnd - (S64)pOsc->sweepStart) / pPvtData->sweepFrames;
+
+		// Distinct, never zero, seed per channel
+		pOsc->noiseState = pPvtData->noiseSeed + i1 * 0x9E3779B9;
+		if (!pOsc->noiseState)
+			pOsc->noiseState = 0x9E3779B9;
+	}
+
+	pPvtData->blockFrames = pPubMapUncmpAudioInfo->framesPerItem;
+	pPvtData->pBlock = malloc(pPvtData->blockFrames * pPvtData->oscCount * sizeof(float));
+	if (!pPvtData->pBlock) {
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 // A call to this callback indicates that this interface module will be
 // a talker. Any talker initialization can be done in this function.
 void openavbIntfToneGenTxInitCB(media_q_t *pMediaQ) 
@@ -393,64 +909,15 @@ void openavbIntfToneGenTxInitCB(media_q_t *pMediaQ)
 		}
 		
 		pPvtData->melodyIdx = 0;
-	}
-
-	AVB_TRACE_EXIT(AVB_TRACE_INTF);
-}
-
 
-#define SWAPU16(x)	(((x) >> 8) | ((x) << 8))
-static U16 convertToDesiredEndianOrder16(U16 hostData, avb_audio_endian_t audioEndian)
-{
-#if defined __BYTE_ORDER && defined __BIG_ENDIAN && defined __LITTLE_ENDIAN
-#if __BYTE_ORDER == __BIG_ENDIAN
-	if (audioEndian == AVB_AUDIO_ENDIAN_LITTLE) { hostData = SWAPU16(hostData); }
-	return hostData;
-#elif __BYTE_ORDER == __LITTLE_ENDIAN
-	if (audioEndian == AVB_AUDIO_ENDIAN_BIG) { hostData = SWAPU16(hostData); }
-	return hostData;
-#else
-	#error Unsupported Endian format
-#endif
-#else
-	U16 test_var = 1;
-	unsigned char test_endian* = (unsigned char*)&test_var;
-	if (test_endian[0] == 0) {
-		// This is big-endian.
-		if (audioEndian == AVB_AUDIO_ENDIAN_LITTLE) { hostData = SWAPU16(hostData); }
-	} else {
-		// This is little-endian.
-		if (audioEndian == AVB_AUDIO_ENDIAN_BIG) { hostData = SWAPU16(hostData); }
+		x_freeEngine(pPvtData);
+		if (!x_initEngine(pPvtData, pPubMapUncmpAudioInfo)) {
+			AVB_LOG_ERROR("Unable to set up the tone generator.");
+			x_freeEngine(pPvtData);
+		}
 	}
-	return hostData;
-#endif
-}
 
-#define SWAPU32(x)	(((x) >> 24) | (((x) & 0x00FF0000) >> 8) | (((x) & 0x0000FF00) << 8) | ((x) << 24))
-static U32 convertToDesiredEndianOrder32(U32 hostData, avb_audio_endian_t audioEndian)
-{
-#if defined __BYTE_ORDER && defined __BIG_ENDIAN && defined __LITTLE_ENDIAN
-#if __BYTE_ORDER == __BIG_ENDIAN
-	if (audioEndian == AVB_AUDIO_ENDIAN_LITTLE) { hostData = SWAPU32(hostData); }
-	return hostData;
-#elif __BYTE_ORDER == __LITTLE_ENDIAN
-	if (audioEndian == AVB_AUDIO_ENDIAN_BIG) { hostData = SWAPU32(hostData); }
-	return hostData;
-#else
-	#error Unsupported Endian format
-#endif
-#else
-	U16 test_var = 1;
-	unsigned char test_endian* = (unsigned char*)&test_var;
-	if (test_endian[0] == 0) {
-		// This is big-endian.
-		if (audioEndian == AVB_AUDIO_ENDIAN_LITTLE) { hostData = SWAPU32(hostData); }
-	} else {
-		// This is little-endian.
-		if (audioEndian == AVB_AUDIO_ENDIAN_BIG) { hostData = SWAPU32(hostData); }
-	}
-	return hostData;
-#endif
+	AVB_TRACE_EXIT(AVB_TRACE_INTF);
 }
 
 // This callback will be called for each AVB transmit interval. Commonly this will be
@@ -474,104 +941,19 @@ bool openavbIntfToneGenTxCB(media_q_t *pMediaQ)
 		if (pMediaQItem) {
 			if (pMediaQItem->itemSize < pPubMapUncmpAudioInfo->itemSize) {
 				AVB_LOG_ERROR("Media queue item not large enough for samples");
+				openavbMediaQHeadUnlock(pMediaQ);
+				AVB_TRACE_EXIT(AVB_TRACE_INTF_DETAIL);
+				return FALSE;
 			}
 
-			// Tone on
-			static U32 runningFrameCnt = 0;
-			U32 frameCnt;
-			U32 channelCnt;
-			U8 *pData = pMediaQItem->pPubData;
-
-			for (frameCnt = 0; frameCnt < pPubMapUncmpAudioInfo->framesPerItem; frameCnt++) {
-
-				// Check for tone on / off toggle
-				if (!pPvtData->freqCountdown) {
-					if (pPvtData->pMelodyString) {
-						// Melody logic
-						U32 intervalMSec;
-						xGetMelodyToneAndDuration(
-							pPvtData->pMelodyString[pPvtData->melodyIdx],
-							pPvtData->pMelodyString[pPvtData->melodyIdx + 1],
-							&pPvtData->freq, &intervalMSec);
-							pPvtData->melodyIdx += 2;
-							
-							pPvtData->freqCountdown = (pPubMapUncmpAudioInfo->audioRate / 1000) * intervalMSec;
-							if (pPvtData->melodyIdx >= pPvtData->melodyLen)
-								pPvtData->melodyIdx = 0;
-					}
-					else {
-						// Fixed tone
-						if (pPvtData->onOffIntervalMSec > 0) {
-							if (pPvtData->freq == 0) {
-								pPvtData->freq = pPvtData->toneHz;
-							} else {
-								pPvtData->freq = 0;
-							}
-							pPvtData->freqCountdown = (pPubMapUncmpAudioInfo->audioRate / 1000) * pPvtData->onOffIntervalMSec;
-						}
-						else {
-							pPvtData->freqCountdown = pPubMapUncmpAudioInfo->audioRate;		// Just run steady for 1 sec
-							pPvtData->freq = pPvtData->toneHz;
-						}
-					}
-					pPvtData->ratio = (float)pPvtData->freq / (float)pPubMapUncmpAudioInfo->audioRate;
-				}
-				pPvtData->freqCountdown--;
-
-				float value = SIN(2 * PI * (runningFrameCnt++ % pPubMapUncmpAudioInfo->audioRate) * pPvtData->ratio) * pPvtData->volume;
-
-				for (channelCnt = 0; channelCnt < pPubMapUncmpAudioInfo->audioChannels - pPvtData->fvChannels; channelCnt++) {
-					if (pPvtData->audioType == AVB_AUDIO_TYPE_INT) {
-						if (pPvtData->audioBitDepth == 32) {
-							S32 sample32 = (S32)(value * (32000 << 16));
-							S32 tmp32 = convertToDesiredEndianOrder32(sample32, pPvtData->audioEndian);
-							memcpy(pData, (U8 *)&tmp32, 4);
-							pData += 4;
-						} else if (pPvtData->audioBitDepth == 24) {
-							S32 sample24 = (S32)(value * (32000 << 16));
-							S32 tmp24 = convertToDesiredEndianOrder32(sample24, pPvtData->audioEndian);
-							if (pPvtData->audioEndian == AVB_AUDIO_ENDIAN_BIG) {
-								memcpy(pData, (U8 *)&tmp24, 3);
-							} else {
-								memcpy(pData, ((U8 *)&tmp24) + 1, 3);
-							}
-							pData += 3;
-						} else if (pPvtData->audioBitDepth == 16) {
-							S16 sample16 = (S32)(value * 32000);
-							S16 tmp16 = convertToDesiredEndianOrder16(sample16, pPvtData->audioEndian);
-							memcpy(pData, (U8 *)&tmp16, 2);
-							pData += 2;
-						}
-					} else if (pPvtData->audioType == AVB_AUDIO_TYPE_FLOAT) {
-						U32 tmp32f;
-						// value *= .75; // attenuate value
-						memcpy((U8 *)&tmp32f, (U8 *)&value, 4);  // done so no warning with -Wstrict-aliasing
-						tmp32f = convertToDesiredEndianOrder32(tmp32f, pPvtData->audioEndian);
-						memcpy(pData, (U8 *)&tmp32f, 4);
-						pData += 4;
-					} else {
-						// CORE_TODO
-						AVB_LOG_ERROR("Audio sample size format not implemented yet for tone generator interface module");
-					}
-				}
-
-				if (pPvtData->fvChannels > 0) {
-					if (pPvtData->audioType == AVB_AUDIO_TYPE_INT) {
-						if (pPvtData->audioBitDepth == 32) {
-							if (pPvtData->fv1Enabled) {
-								S32 tmp32 = convertToDesiredEndianOrder32(pPvtData->fv1, pPvtData->audioEndian);
-								memcpy(pData, (U8 *)&tmp32, 4);
-								pData += 4;
-							}
-
-							if (pPvtData->fv2Enabled) {
-								S32 tmp32 = convertToDesiredEndianOrder32(pPvtData->fv2, pPvtData->audioEndian);
-								memcpy(pData, (U8 *)&tmp32, 4);
-								pData += 4;
-							}
-						}
-					}
-				}
+			U32 frames = pPubMapUncmpAudioInfo->framesPerItem;
+			if (pPvtData->writeFn && pPvtData->pBlock && frames <= pPvtData->blockFrames) {
+				x_generate(pPvtData, pPubMapUncmpAudioInfo->audioRate, frames);
+				pPvtData->writeFn(pMediaQItem->pPubData, pPvtData->pBlock, pPvtData->oscCount > 1 ? frames : 0,
+					pPvtData->toneChannels, frames, pPvtData->fixed, pPvtData->fixedLen);
+			}
+			else {
+				memset(pMediaQItem->pPubData, 0, pPubMapUncmpAudioInfo->itemSize);
 			}
 			
 			pMediaQItem->dataLen = pPubMapUncmpAudioInfo->itemSize;
@@ -619,6 +1001,12 @@ bool openavbIntfToneGenRxCB(media_q_t *pMediaQ)
 void openavbIntfToneGenEndCB(media_q_t *pMediaQ) 
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_INTF);
+
+	if (pMediaQ && pMediaQ->pPvtIntfInfo) {
+		pvt_data_t *pPvtData = pMediaQ->pPvtIntfInfo;
+		x_freeEngine(pPvtData);
+	}
+
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
 }
 
@@ -699,6 +1087,13 @@ extern bool DLL_EXPORT openavbIntfToneGenInitialize(media_q_t *pMediaQ, openavb_
 		pPvtData->fv2 = 0;
 		pPvtData->fvChannels = 0;
 
+		pPvtData->pattern = TONEGEN_PATTERN_TONE;
+		pPvtData->toneStepHz = 0;
+		pPvtData->sweepStartHz = 20;
+		pPvtData->sweepEndHz = 20000;
+		pPvtData->sweepMSec = 1000;
+		pPvtData->noiseSeed = 1;
+
 		pPvtData->fixedTimestampEnabled = false;
 	}
 
@@ -44,6 +44,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_mediaq_pub.h"
 #include "openavb_map_pub.h"
 #include "openavb_map_aaf_audio_pub.h"
+#include "openavb_audio_conv_pub.h"
 
 #define	AVB_LOG_COMPONENT	"AAF Mapping"
 #include "openavb_log_pub.h"
@@ -764,6 +765,11 @@ bool openavbMapAVTPAudioRxCB(media_q_t *pMediaQ, U8 *pData, U32 dataLen)
 
 						// Set timestamp uncertain flag
 						openavbAvtpTimeSetTimestampUncertain(pMediaQItem->pAvtpTime, (pHdrV0[HIDX_AVTP_HIDE7_TU1] & 0x01) ? TRUE : FALSE);
+
+						if (pPvtData->audioMcr != AVB_MCR_NONE && !openavbAvtpTimeTimestampIsUncertain(pMediaQItem->pAvtpTime)) {
+							// One event per media queue item, as configured in HAL_INIT_MCR_V2
+							openavbAvtpTimePushMCR(pMediaQItem->pAvtpTime, timestamp);
+						}
 						// Set flag to inform that MediaQ is synchronized with timestamped packets
 						 pPvtData->mediaQItemSyncTS = TRUE;
 					}
@@ -784,42 +790,22 @@ bool openavbMapAVTPAudioRxCB(media_q_t *pMediaQ, U8 *pData, U32 dataLen)
 						memcpy((uint8_t *)pMediaQItem->pPubData + pMediaQItem->dataLen, pPayload, pPvtData->payloadSize);
 					}
 					else {
-						static U8 s_audioBuffer[1500];
-						U8 *pInData = pPayload;
-						U8 *pInDataEnd = pPayload + payloadLen;
-						U8 *pOutData = s_audioBuffer;
+						// Convert straight into the media queue item.
+						U8 *pOutData = (U8 *)pMediaQItem->pPubData + pMediaQItem->dataLen;
 						int nInSampleLength = 6 - incoming_aaf_format; // Calculate the number of integer bytes per sample received
 						int nOutSampleLength = 6 - pPvtData->aaf_format; // Calculate the number of integer bytes per sample we want
-						int i;
-						if (nInSampleLength < nOutSampleLength) {
-							// We need to pad the data supplied.
-							while (pInData < pInDataEnd) {
-								for (i = 0; i < nInSampleLength; ++i) {
-									*pOutData++ = *pInData++;
-								}
-								for ( ; i < nOutSampleLength; ++i) {
-									*pOutData++ = 0; // Value specified in Clause 7.3.4.
-								}
-							}
-						}
-						else {
-							// We need to truncate the data supplied.
-							while (pInData < pInDataEnd) {
-								for (i = 0; i < nOutSampleLength; ++i) {
-									*pOutData++ = *pInData++;
-								}
-								pInData += (nInSampleLength - nOutSampleLength);
+						U32 nSamples = payloadLen / nInSampleLength;
+						if (nSamples * nOutSampleLength != pPvtData->payloadSize) {
+							AVB_LOGF_ERROR("Output not expected size (%d instead of %d)", nSamples * nOutSampleLength, pPvtData->payloadSize);
+							if (nSamples * nOutSampleLength > pPvtData->payloadSize) {
+								nSamples = pPvtData->payloadSize / nOutSampleLength;
 							}
 						}
-						if (pOutData - s_audioBuffer != pPvtData->payloadSize) {
-							AVB_LOGF_ERROR("Output not expected size (%d instead of %d)", pOutData - s_audioBuffer, pPvtData->payloadSize);
-						}
+						openavbAudioConvWidthBE(pOutData, nOutSampleLength, pPayload, nInSampleLength, nSamples);
 
 						if (pPubMapInfo->intf_rx_translate_cb) {
-							pPubMapInfo->intf_rx_translate_cb(pMediaQ, s_audioBuffer, pPvtData->payloadSize);
+							pPubMapInfo->intf_rx_translate_cb(pMediaQ, pOutData, pPvtData->payloadSize);
 						}
-
-						memcpy((uint8_t *)pMediaQItem->pPubData + pMediaQItem->dataLen, s_audioBuffer, pPvtData->payloadSize);
 					}
 
 					pMediaQItem->dataLen += pPvtData->payloadSize;
@@ -51,6 +51,8 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #define MPEG2_TS_PKT_SIZE			188
 // MPEG2TS sync byte
 #define MPEG2_TS_SYNC_BYTE			0x47
+// Sync bytes that must follow a candidate, one packet apart, before we resynchronize on it
+#define MPEG2_TS_SYNC_CONFIRM		2
 
 // GStreamer likes to pass 4096-byte buffers, so we want a buffer
 // bigger than that.  And, we're more efficient if the interface layer
@@ -326,22 +328,72 @@ void openavbMapMpeg2tsTxInitCB(media_q_t *pMediaQ)
 	AVB_TRACE_EXIT(AVB_TRACE_MAP);
 }
 
-static int syncScan(media_q_item_t *pMediaQItem, int startIdx)
+// Find the start of the next transport stream packet at or after startIdx. A sync byte
+// only counts when the bytes one and two packets further on are sync bytes too, as far
+// as the item holds them, so we don't lock onto a 0x47 inside a packet payload.
+static int syncScan(pvt_data_t *pPvtData, media_q_item_t *pMediaQItem, int startIdx)
 {
-	char *data = pMediaQItem->pPubData;
-	int offset;
-	for (offset = startIdx; offset < pMediaQItem->dataLen; offset++) {
-		if (data[offset] == MPEG2_TS_SYNC_BYTE)
+	U8 *data = pMediaQItem->pPubData;
+	int hdrLen = pPvtData->tsPacketSize - MPEG2_TS_PKT_SIZE;
+	int searchIdx = startIdx + hdrLen;
+	int offset = -1;
+
+	while (searchIdx < (int)pMediaQItem->dataLen) {
+		U8 *pSync = memchr(data + searchIdx, MPEG2_TS_SYNC_BYTE, pMediaQItem->dataLen - searchIdx);
+		if (!pSync)
 			break;
+
+		int syncIdx = pSync - data;
+		int i1;
+		for (i1 = 1; i1 <= MPEG2_TS_SYNC_CONFIRM; i1++) {
+			int nextIdx = syncIdx + i1 * pPvtData->tsPacketSize;
+			if (nextIdx >= (int)pMediaQItem->dataLen || data[nextIdx] != MPEG2_TS_SYNC_BYTE)
+				break;
+		}
+		if (i1 > MPEG2_TS_SYNC_CONFIRM || syncIdx + i1 * (int)pPvtData->tsPacketSize >= (int)pMediaQItem->dataLen) {
+			offset = syncIdx - hdrLen;
+			break;
+		}
+		searchIdx = syncIdx + 1;
 	}
 
-	AVB_LOGF_WARNING("Dropped %d bytes", offset - startIdx);
-	if (offset >= pMediaQItem->dataLen)
-		offset = -1;
+	int dropped = (offset >= 0 ? offset : (int)pMediaQItem->dataLen) - startIdx;
+	if (dropped > 0) {
+		AVB_LOGF_WARNING("Dropped %d bytes", dropped);
+	}
 
 	return offset;
 }
 
+// Number of packets, up to nPackets, from pPkt on that carry a sync byte where expected.
+static inline int syncCount(pvt_data_t *pPvtData, const U8 *pPkt, int nPackets)
+{
+	const U8 *pSync = pPkt + (pPvtData->tsPacketSize - MPEG2_TS_PKT_SIZE);
+	int i1;
+	for (i1 = 0; i1 < nPackets; i1++) {
+		if (*pSync != MPEG2_TS_SYNC_BYTE)
+			break;
+		pSync += pPvtData->tsPacketSize;
+	}
+	return i1;
+}
+
+// Skip ahead to the next packet after a misaligned one at readIdx.
+static void syncRecover(pvt_data_t *pPvtData, media_q_item_t *pMediaQItem)
+{
+	AVB_LOG_WARNING("Alignment problem");
+
+	// Ignore saved data if there was any, start from what's in current item.
+	int offset = syncScan(pPvtData, pMediaQItem, pMediaQItem->readIdx + 1);
+	if (offset >= 0)
+		pMediaQItem->readIdx = offset;
+	else {
+		pPvtData->unsynched = TRUE;
+		pMediaQItem->dataLen = 0;
+		pMediaQItem->readIdx = 0;
+	}
+}
+
 // This talker callback will be called for each AVB observation interval.
 tx_cb_ret_t openavbMapMpeg2tsTxCB(media_q_t *pMediaQ, U8 *pData, U32 *dataLen)
 {
@@ -375,18 +427,22 @@ tx_cb_ret_t openavbMapMpeg2tsTxCB(media_q_t *pMediaQ, U8 *pData, U32 *dataLen)
 		int sourcePacketsAdded = 0;
 		int nItemBytes, nAvailBytes;
 		int offset, bytesNeeded;
-		U32 timestamp;
 		bool moreSourcePackets = TRUE;
+		// Source packet header of every packet taken from pSphItem, in network order
+		media_q_item_t *pSphItem = NULL;
+		U32 sph = 0;
 
 		while (pMediaQItem && moreSourcePackets) {
+			bool bNewItem = (pMediaQItem->readIdx == 0);
 
 			if (pPvtData->unsynched) {
 				// Scan forward, looking for next sync byte.
-				offset = syncScan(pMediaQItem, 0);
-				if (offset >= 0)
+				offset = syncScan(pPvtData, pMediaQItem, pMediaQItem->readIdx);
+				if (offset >= 0) {
 					pMediaQItem->readIdx = offset;
+					pPvtData->unsynched = FALSE;
+				}
 				else {
-					pPvtData->unsynched = TRUE;
 					pMediaQItem->dataLen = 0;
 					pMediaQItem->readIdx = 0;
 				}
@@ -399,88 +455,113 @@ tx_cb_ret_t openavbMapMpeg2tsTxCB(media_q_t *pMediaQ, U8 *pData, U32 *dataLen)
 				// Empty MQ item, ignore
 			}
 			else if (nAvailBytes >= pPvtData->tsPacketSize) {
-				// PTP walltime already set in the interface module. Just add the max transit time.
-				// If this is a new mq item, add the AVTP transit time to the timestamp
-				if (pMediaQItem->readIdx == 0) {
-					openavbAvtpTimeAddUSec(pMediaQItem->pAvtpTime, pPvtData->maxTransitUsec);
-				}
+				// All packets of an item share its timestamp, so work it out once per item
+				if (pSphItem != pMediaQItem) {
+					// PTP walltime already set in the interface module. Just add the max transit time.
+					// If this is a new mq item, add the AVTP transit time to the timestamp
+					if (bNewItem) {
+						openavbAvtpTimeAddUSec(pMediaQItem->pAvtpTime, pPvtData->maxTransitUsec);
+					}
 
-				timestamp = openavbAvtpTimeGetAvtpTimestamp(pMediaQItem->pAvtpTime);
+					// Set timestamp valid flag
+					if (openavbAvtpTimeTimestampIsValid(pMediaQItem->pAvtpTime))
+						pHdr[HIDX_AVTP_HIDE7_TV1] |= 0x01;      // Set
+					else {
+						pHdr[HIDX_AVTP_HIDE7_TV1] &= ~0x01;     // Clear
+					}
 
-				// Set timestamp valid flag
-				if (openavbAvtpTimeTimestampIsValid(pMediaQItem->pAvtpTime))
-					pHdr[HIDX_AVTP_HIDE7_TV1] |= 0x01;      // Set
-				else {
-					pHdr[HIDX_AVTP_HIDE7_TV1] &= ~0x01;     // Clear
-				}
+					// Set timestamp uncertain flag
+					if (openavbAvtpTimeTimestampIsUncertain(pMediaQItem->pAvtpTime))
+						pHdr[HIDX_AVTP_HIDE7_TU1] |= 0x01;      // Set
+					else pHdr[HIDX_AVTP_HIDE7_TU1] &= ~0x01;     // Clear
 
-				// Set timestamp uncertain flag
-				if (openavbAvtpTimeTimestampIsUncertain(pMediaQItem->pAvtpTime))
-					pHdr[HIDX_AVTP_HIDE7_TU1] |= 0x01;      // Set
-				else pHdr[HIDX_AVTP_HIDE7_TU1] &= ~0x01;     // Clear
+					sph = htonl(openavbAvtpTimeGetAvtpTimestamp(pMediaQItem->pAvtpTime));
+					pSphItem = pMediaQItem;
+				}
 
 				// Set the timestamp.
 				if (sourcePacketsAdded == 0) {
 					// TODO: I think this is wrong with source packets
-					*(U32 *)(&pHdr[HIDX_AVTP_TIMESTAMP32]) = htonl(timestamp);
+					*(U32 *)(&pHdr[HIDX_AVTP_TIMESTAMP32]) = sph;
 				}
 
-				/* Copy the TS packets into the outgoing AVTP frame
-				 */
-				offset = 0, bytesNeeded = pPvtData->tsPacketSize;
+				if (pPvtData->nSavedBytes == 0) {
+					/* Take as many whole TS packets from the MQ item as fit into the frame,
+					 * checking all their sync bytes before copying any of them.
+					 */
+					U8 *pSrc = (U8 *)pMediaQItem->pPubData + pMediaQItem->readIdx;
+					int nPackets = nItemBytes / pPvtData->tsPacketSize;
+					if (nPackets > pPvtData->numSourcePackets - sourcePacketsAdded)
+						nPackets = pPvtData->numSourcePackets - sourcePacketsAdded;
+					int nSynced = syncCount(pPvtData, pSrc, nPackets);
+
+					if (pPvtData->tsPacketSize == MPEG2_TS_PKT_SIZE) {
+						// Getting 188-byte packets from interface, need to add source packet headers
+						int i1;
+						for (i1 = 0; i1 < nSynced; i1++) {
+							*((U32 *)pPayload) = sph;
+							memcpy(pPayload + MPEGTS_SRC_PKT_HDR_SIZE, pSrc, MPEG2_TS_PKT_SIZE);
+							pPayload += MPEGTS_SRC_PKT_SIZE;
+							pSrc += MPEG2_TS_PKT_SIZE;
+						}
+					}
+					else {
+						// Source packets already, the layout matches the frame
+						memcpy(pPayload, pSrc, nSynced * MPEGTS_SRC_PKT_SIZE);
+						pPayload += nSynced * MPEGTS_SRC_PKT_SIZE;
+					}
 
-				// If getting 188-byte packets from interface, need to add source packet header
-				if (pPvtData->tsPacketSize == MPEG2_TS_PKT_SIZE) {
-					// Set the timestamp on this source packet
-					*((U32 *)pPayload) = htonl(timestamp);
-					offset = MPEGTS_SRC_PKT_HDR_SIZE;
+					pMediaQItem->readIdx += nSynced * pPvtData->tsPacketSize;
+					sourcePacketsAdded += nSynced;
+
+					if (nSynced < nPackets) {
+						syncRecover(pPvtData, pMediaQItem);
+					}
 				}
+				else {
+					/* Complete the packet started in the last MQ item
+					 */
+					offset = 0, bytesNeeded = pPvtData->tsPacketSize;
+
+					// If getting 188-byte packets from interface, need to add source packet header
+					if (pPvtData->tsPacketSize == MPEG2_TS_PKT_SIZE) {
+						// Set the timestamp on this source packet
+						*((U32 *)pPayload) = sph;
+						offset = MPEGTS_SRC_PKT_HDR_SIZE;
+					}
 
-				// Use any leftover data from last MQ item
-				if (pPvtData->nSavedBytes) {
+					// Use the leftover data from last MQ item
 					memcpy(pPayload + offset, pPvtData->savedBytes, pPvtData->nSavedBytes);
 					offset += pPvtData->nSavedBytes;
 					bytesNeeded -= pPvtData->nSavedBytes;
 					pPvtData->nSavedBytes = 0;
-				}
 
-				// Now, copy data from current MQ item
-				memcpy(pPayload + offset, pMediaQItem->pPubData + pMediaQItem->readIdx, bytesNeeded);
+					// Now, copy data from current MQ item
+					memcpy(pPayload + offset, (U8 *)pMediaQItem->pPubData + pMediaQItem->readIdx, bytesNeeded);
 
-				// Check that the data we've copied is synchronized
-				/// i.e. that the transport stream packet starts
-				//  where we think it should
-				if (pPayload[4] == MPEG2_TS_SYNC_BYTE) {
-					// OK, now we can update the read index
-					pMediaQItem->readIdx += bytesNeeded;
-					// and move the payload ptr for the next source packet
-					pPayload += MPEGTS_SRC_PKT_SIZE;
+					// Check that the data we've copied is synchronized
+					/// i.e. that the transport stream packet starts
+					//  where we think it should
+					if (pPayload[4] == MPEG2_TS_SYNC_BYTE) {
+						// OK, now we can update the read index
+						pMediaQItem->readIdx += bytesNeeded;
+						// and move the payload ptr for the next source packet
+						pPayload += MPEGTS_SRC_PKT_SIZE;
 
-					// Keep track of how many source packets have been added to the outgoing packet
-					sourcePacketsAdded++;
-				}
-				else {
-					AVB_LOG_WARNING("Alignment problem");
-
-					// Scan forward, looking for next sync byte.
-					// Start scan after 4-byte header if getting 192 byte packets.
-					// Ignore saved data if there was any, start from what's in current item.
-					offset = syncScan(pMediaQItem, pMediaQItem->readIdx + (pPvtData->tsPacketSize - MPEG2_TS_PKT_SIZE) + 1);
-					if (offset >= 0)
-						pMediaQItem->readIdx = offset;
+						// Keep track of how many source packets have been added to the outgoing packet
+						sourcePacketsAdded++;
+					}
 					else {
-						pPvtData->unsynched = TRUE;
-						pMediaQItem->dataLen = 0;
-						pMediaQItem->readIdx = 0;
+						syncRecover(pPvtData, pMediaQItem);
 					}
 				}
 			}
 			else {
 				// Arghhh - a partial packet.
-				assert(pPvtData->nSavedBytes + nItemBytes <= MPEG2_TS_PKT_SIZE);
+				assert(pPvtData->nSavedBytes + nItemBytes < pPvtData->tsPacketSize);
 
 				memcpy(pPvtData->savedBytes + pPvtData->nSavedBytes,
-					pMediaQItem->pPubData + pMediaQItem->readIdx,
+					(U8 *)pMediaQItem->pPubData + pMediaQItem->readIdx,
 					nItemBytes);
 				pPvtData->nSavedBytes += nItemBytes;
 
@@ -496,6 +577,7 @@ tx_cb_ret_t openavbMapMpeg2tsTxCB(media_q_t *pMediaQ, U8 *pData, U32 *dataLen)
 			if (pMediaQItem->dataLen - pMediaQItem->readIdx == 0) {
 				// release used-up item
 				openavbMediaQTailPull(pMediaQ);
+				pSphItem = NULL;
 
 				// and get a new one, if needed
 				if (moreSourcePackets)
@@ -41,6 +41,8 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_mediaq_pub.h"
 #include "openavb_map_pub.h"
 #include "openavb_map_uncmp_audio_pub.h"
+#include "openavb_audio_conv_pub.h"
+#include "openavb_mcr_hal_pub.h"
 
 // DEBUG Uncomment to turn on logging for just this module.
 #define AVB_LOG_ON	1
@@ -539,37 +541,26 @@ tx_cb_ret_t openavbMapUncmpAudioTxCB(media_q_t *pMediaQ, U8 *pData, U32 *dataLen
 
 				}
 
-				while (framesProcessed < pPubMapInfo->framesPerPacket && pMediaQItem->readIdx < pMediaQItem->dataLen) {
-					int i1;
-					for (i1 = 0; i1 < pPubMapInfo->audioChannels; i1++) {
-						if (pPubMapInfo->itemSampleSizeBytes == 2) {
-							S32 sample = *(S16 *)pItemData;
-							sample &= 0x0000ffff;
-							sample = sample << 8;
-							sample |= pPvtData->AM824_label;
-							sample = htonl(sample);
-							*(U32 *)(pAVTPDataUnit) = sample;
-							pAVTPDataUnit += 4;
-							pItemData += 2;
-						}
-						else {
-							S32 sample = *(S32 *)pItemData;
-							sample &= 0x00ffffff;
-							sample |= pPvtData->AM824_label;
-							sample = htonl(sample);
-							*(U32 *)(pAVTPDataUnit) = sample;
-							pAVTPDataUnit += 4;
-							pItemData += 3;
-						}
-					}
-					framesProcessed++;
-					if (dbc % sytInt == 0) {
-						*(U32 *)(&pHdr[HIDX_AVTP_TIMESTAMP32]) = htonl(openavbAvtpTimeGetAvtpTimestamp(pMediaQItem->pAvtpTime));
+				U32 nFrames = (pMediaQItem->dataLen - pMediaQItem->readIdx) / pPubMapInfo->itemFrameSizeBytes;
+				if (nFrames > pPubMapInfo->framesPerPacket - framesProcessed) {
+					nFrames = pPubMapInfo->framesPerPacket - framesProcessed;
+				}
+				openavbAudioConvAM824Pack(pAVTPDataUnit, pItemData, pPubMapInfo->itemSampleSizeBytes,
+					nFrames * pPubMapInfo->audioChannels, pPvtData->AM824_label);
+				pAVTPDataUnit += nFrames * pPubMapInfo->packetFrameSizeBytes;
 
-						timestampSet = TRUE;
-					}
-					dbc++;
-					pMediaQItem->readIdx += pPubMapInfo->itemFrameSizeBytes;
+				// The timestamp goes with the frame whose DBC is a multiple of the SYT interval
+				if (nFrames > 0 && (sytInt - (dbc % sytInt)) % sytInt < nFrames) {
+					*(U32 *)(&pHdr[HIDX_AVTP_TIMESTAMP32]) = htonl(openavbAvtpTimeGetAvtpTimestamp(pMediaQItem->pAvtpTime));
+
+					timestampSet = TRUE;
+				}
+				framesProcessed += nFrames;
+				dbc += nFrames;
+				pMediaQItem->readIdx += nFrames * pPubMapInfo->itemFrameSizeBytes;
+				if (nFrames == 0) {
+					// Only a partial frame left in the item, drop it
+					pMediaQItem->readIdx = pMediaQItem->dataLen;
 				}
 
 				if (pMediaQItem->readIdx >= pMediaQItem->dataLen) {
@@ -615,6 +606,18 @@ tx_cb_ret_t openavbMapUncmpAudioTxCB(media_q_t *pMediaQ, U8 *pData, U32 *dataLen
 void openavbMapUncmpAudioRxInitCB(media_q_t *pMediaQ)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_MAP);
+	if (pMediaQ) {
+		media_q_pub_map_uncmp_audio_info_t *pPubMapInfo = pMediaQ->pPubMapInfo;
+		pvt_data_t *pPvtData = pMediaQ->pPvtMapInfo;
+		if (!pPvtData) {
+			AVB_LOG_ERROR("Private mapping module data not allocated.");
+			return;
+		}
+		if (pPvtData->audioMcr != AVB_MCR_NONE) {
+			// Talkers timestamp one frame in every SYT_INTERVAL
+			HAL_INIT_MCR_V2(pPubMapInfo->audioRate, pPubMapInfo->sytInterval, 0, 0);
+		}
+	}
 	AVB_TRACE_EXIT(AVB_TRACE_MAP);
 }
 
@@ -688,27 +691,14 @@ bool openavbMapUncmpAudioRxCB(media_q_t *pMediaQ, U8 *pData, U32 dataLen)
 					openavbAvtpTimeSetTimestampUncertain(pMediaQItem->pAvtpTime, tsUncertain);
 				}
 
-				while (((pAVTPDataUnit + pPubMapInfo->packetFrameSizeBytes) <= pAVTPDataUnitEnd) && ((pItemData + pPubMapInfo->itemFrameSizeBytes) <= pItemDataEnd)) {
-					int i1;
-					for (i1 = 0; i1 < pPubMapInfo->audioChannels; i1++) {
-						if (pPubMapInfo->itemSampleSizeBytes == 2) {
-							S32 sample = ntohl(*(S32 *)pAVTPDataUnit);
-							sample = sample * 1;
-							*(S16 *)(pItemData) = (sample & 0x00ffffff) >> 8;
-							pAVTPDataUnit += 4;
-							pItemData += 2;
-							itemSizeWritten += 2;
-						}
-						else {
-							S32 sample = ntohl(*(S32 *)pAVTPDataUnit);
-							sample = sample * 1;
-							*(S32 *)(pItemData) = sample & 0x00ffffff;
-							pAVTPDataUnit += 4;
-							pItemData += 3;
-							itemSizeWritten += 3;
-						}
-					}
+				U32 nFrames = (pAVTPDataUnitEnd - pAVTPDataUnit) / pPubMapInfo->packetFrameSizeBytes;
+				if (nFrames > (pItemDataEnd - pItemData) / pPubMapInfo->itemFrameSizeBytes) {
+					nFrames = (pItemDataEnd - pItemData) / pPubMapInfo->itemFrameSizeBytes;
 				}
+				openavbAudioConvAM824Unpack(pItemData, pPubMapInfo->itemSampleSizeBytes, pAVTPDataUnit,
+					nFrames * pPubMapInfo->audioChannels);
+				pAVTPDataUnit += nFrames * pPubMapInfo->packetFrameSizeBytes;
+				itemSizeWritten += nFrames * pPubMapInfo->itemFrameSizeBytes;
 
 				pMediaQItem->dataLen += itemSizeWritten;
 
@@ -742,6 +732,12 @@ bool openavbMapUncmpAudioRxCB(media_q_t *pMediaQ, U8 *pData, U32 dataLen)
 void openavbMapUncmpAudioEndCB(media_q_t *pMediaQ)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_MAP);
+	if (pMediaQ) {
+		pvt_data_t *pPvtData = pMediaQ->pPvtMapInfo;
+		if (pPvtData && pPvtData->audioMcr != AVB_MCR_NONE) {
+			HAL_CLOSE_MCR_V2();
+		}
+	}
 	AVB_TRACE_EXIT(AVB_TRACE_MAP);
 }
 
@@ -0,0 +1,220 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Replays AVTP timestamp sequences through the software media clock recovery.
+*
+* Reads presentation times as written by test/avtp_astimes.py (index, unwrapped time in ns),
+* or generates a talker clock with a given frequency offset, jitter and packet loss, feeds
+* them to the delay locked loop and reports how long it took to lock and how much of the
+* input jitter is left on the recovered clock. Exits with 1 when the loop does not lock in
+* time or the recovered clock jitters more than allowed, so it can be used as a regression test.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <glib.h>
+#include "openavb_types_pub.h"
+#include "openavb_mcr_dll.h"
+
+//Common usage: ./mcr_replay seq0.csv
+//              ./mcr_replay --ppm 40 --jitter 500 --loss 1 --max-lock-ms 200 --max-jitter-ns 50
+
+static double periodNSec = 1000000000.0 * 8 / 48000;
+static double ppm = 0;
+static double jitterNSec = 0;
+static double lossPercent = 0;
+static int count = 60000;
+static int loopEvents = 0;
+static double lockNSec = 0;
+static double maxLockMSec = 0;
+static double maxJitterNSec = 0;
+
+static GOptionEntry entries[] =
+{
+  { "period",        'P', 0, G_OPTION_ARG_DOUBLE, &periodNSec,    "nominal time between timestamps in ns (default 8 samples at 48 kHz)", "NS" },
+  { "ppm",           'p', 0, G_OPTION_ARG_DOUBLE, &ppm,           "generate: talker frequency offset",                    "PPM" },
+  { "jitter",        'j', 0, G_OPTION_ARG_DOUBLE, &jitterNSec,    "generate: timestamp jitter, standard deviation",        "NS" },
+  { "loss",          'l', 0, G_OPTION_ARG_DOUBLE, &lossPercent,   "generate: percentage of timestamps lost",              "PERCENT" },
+  { "count",         'c', 0, G_OPTION_ARG_INT,    &count,         "timestamps to replay",                                 "NUM" },
+  { "loop",          'e', 0, G_OPTION_ARG_INT,    &loopEvents,    "loop time constant in events (default 512)",           "NUM" },
+  { "lock",          'k', 0, G_OPTION_ARG_DOUBLE, &lockNSec,      "phase error counting as locked (default 2% of period)", "NS" },
+  { "max-lock-ms",   'L', 0, G_OPTION_ARG_DOUBLE, &maxLockMSec,   "fail when locking takes longer",                       "MS" },
+  { "max-jitter-ns", 'J', 0, G_OPTION_ARG_DOUBLE, &maxJitterNSec, "fail when the recovered clock jitters more",           "NS" },
+  { NULL }
+};
+
+// Approximately normal, mean 0 and standard deviation 1
+static double gauss(void)
+{
+	double sum = 0;
+	int i1;
+	for (i1 = 0; i1 < 12; i1++) {
+		sum += (double)rand() / RAND_MAX;
+	}
+	return sum - 6.0;
+}
+
+static int loadFile(const char *fileName, double *pX, double *pY, int maxCount)
+{
+	FILE *pFile = fopen(fileName, "r");
+	char line[256];
+	int n = 0;
+
+	if (!pFile) {
+		perror(fileName);
+		return -1;
+	}
+	while (n < maxCount && fgets(line, sizeof(line), pFile)) {
+		if (sscanf(line, "%lf , %lf", &pX[n], &pY[n]) == 2) {
+			n++;
+		}
+	}
+	fclose(pFile);
+	return n;
+}
+
+static int generate(double *pX, double *pY, int maxCount)
+{
+	double talkerPeriod = periodNSec / (1.0 + ppm / 1000000.0);
+	double startNSec = 4000000000.0 - 1000 * periodNSec;	// Wrap the 32 bit timestamps early on
+	int n = 0;
+	int i1;
+
+	srand(1);
+	for (i1 = 0; n < maxCount; i1++) {
+		if (lossPercent > 0 && (double)rand() / RAND_MAX * 100 < lossPercent) {
+			continue;
+		}
+		pX[n] = i1;
+		pY[n] = startNSec + i1 * talkerPeriod + jitterNSec * gauss();
+		n++;
+	}
+	return n;
+}
+
+int main(int argc, char* argv[])
+{
+	GError *error = NULL;
+	GOptionContext *context = g_option_context_new("[timestamps.csv] - replay AVTP timestamps through media clock recovery");
+	g_option_context_add_main_entries(context, entries, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		printf("error: %s\n", error->message);
+		exit(1);
+	}
+
+	double *pX = calloc(count, sizeof(double));
+	double *pY = calloc(count, sizeof(double));
+	double *pRec = calloc(count, sizeof(double));
+	if (!pX || !pY || !pRec) {
+		printf("error: out of memory\n");
+		exit(1);
+	}
+
+	int n = argc > 1 ? loadFile(argv[1], pX, pY, count) : generate(pX, pY, count);
+	if (n < 2) {
+		printf("error: not enough timestamps\n");
+		exit(1);
+	}
+
+	// Replay
+	openavb_mcr_dll_t dll;
+	int lockIdx = -1;
+	int i1;
+	openavbMcrDllInit(&dll, periodNSec, loopEvents, lockNSec);
+	for (i1 = 0; i1 < n; i1++) {
+		U32 ts = (U32)(U64)pY[i1];
+		openavbMcrDllUpdate(&dll, ts);
+		pRec[i1] = pY[i1] + (S32)(openavbMcrDllPhase(&dll) - ts);
+		if (lockIdx < 0 && dll.bLocked) {
+			lockIdx = i1;
+		}
+	}
+
+	printf("timestamps        : %d\n", n);
+	if (lockIdx < 0) {
+		printf("locked            : no\n");
+		exit(maxLockMSec > 0 || maxJitterNSec > 0 ? 1 : 0);
+	}
+
+	double lockMSec = (pY[lockIdx] - pY[0]) / 1000000.0;
+	printf("locked            : %s, after %d timestamps, %.1f ms\n", dll.bLocked ? "yes" : "lost again", lockIdx + 1, lockMSec);
+
+	// Fit a line to the timestamps after lock and measure both sequences against it
+	double sx = 0, sy = 0, sxx = 0, sxy = 0;
+	int nFit = n - lockIdx;
+	for (i1 = lockIdx; i1 < n; i1++) {
+		double x = pX[i1] - pX[lockIdx];
+		double y = pY[i1] - pY[lockIdx];
+		sx += x; sy += y; sxx += x * x; sxy += x * y;
+	}
+	double slope = (nFit * sxy - sx * sy) / (nFit * sxx - sx * sx);
+	double intercept = (sy - slope * sx) / nFit;
+
+	double inMax = 0, inSq = 0, outMax = 0, outSq = 0;
+	for (i1 = lockIdx; i1 < n; i1++) {
+		double line = pY[lockIdx] + intercept + slope * (pX[i1] - pX[lockIdx]);
+		double inDev = fabs(pY[i1] - line);
+		double outDev = fabs(pRec[i1] - line);
+		inSq += inDev * inDev;
+		outSq += outDev * outDev;
+		if (inDev > inMax) inMax = inDev;
+		if (outDev > outMax) outMax = outDev;
+	}
+
+	printf("fitted period     : %.3f ns\n", slope);
+	printf("recovered period  : %.3f ns (%+.3f ppm against the fit)\n", dll.periodNSec, (slope / dll.periodNSec - 1.0) * 1000000.0);
+	printf("rate ratio        : %.9f\n", openavbMcrDllRateRatio(&dll));
+	printf("input jitter      : %.1f ns rms, %.1f ns max\n", sqrt(inSq / nFit), inMax);
+	printf("recovered jitter  : %.1f ns rms, %.1f ns max\n", sqrt(outSq / nFit), outMax);
+
+	int rc = 0;
+	if (maxLockMSec > 0 && lockMSec > maxLockMSec) {
+		printf("FAIL: locking took longer than %.1f ms\n", maxLockMSec);
+		rc = 1;
+	}
+	if (maxJitterNSec > 0 && outMax > maxJitterNSec) {
+		printf("FAIL: recovered clock jitter above %.1f ns\n", maxJitterNSec);
+		rc = 1;
+	}
+	if (maxJitterNSec > 0 && !dll.bLocked) {
+		printf("FAIL: lock lost\n");
+		rc = 1;
+	}
+
+	free(pX);
+	free(pY);
+	free(pRec);
+	g_option_context_free(context);
+	return rc;
+}
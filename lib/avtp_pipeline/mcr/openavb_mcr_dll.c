@@ -0,0 +1,233 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Software media clock recovery
+*
+* A second order delay locked loop, in the form described by Fons Adriaensen in
+* "Using a DLL to filter time". The phase error of each timestamp event against its
+* prediction corrects the recovered phase (proportional term) and period (integral term).
+*/
+
+#include <math.h>
+#include "openavb_mcr_dll.h"
+
+// Lock is possible once the loop has narrowed down to this fraction of its final time constant
+#define MCR_DLL_ACQUIRE_SPEEDUP		16
+// Time constant in events right after a (re)start
+#define MCR_DLL_MIN_WINDOW			2.0
+// Events averaged into the rms phase error
+#define MCR_DLL_ERR_EVENTS			16
+// Missing events bridged before the loop restarts. A locked loop knows the period well
+// enough to bridge up to loopEvents.
+#define MCR_DLL_MAX_GAP				8
+// Default lock threshold as a fraction of the event period
+#define MCR_DLL_LOCK_FRACTION		0.02
+// A locked loop gives up when the phase error is this many times the lock threshold
+#define MCR_DLL_UNLOCK_FACTOR		4
+// Multiples of the nominal period within this fraction count as a match
+#define MCR_DLL_NOMINAL_TOLERANCE	0.01
+
+// Widening the loop gradually instead of switching from a fast to a slow loop in one go avoids
+// the phase wander a sudden switch leaves behind while the slow loop works off the period error.
+static void x_setWindow(openavb_mcr_dll_t *pDll, double windowEvents)
+{
+	if (windowEvents > pDll->loopEvents) {
+		windowEvents = pDll->loopEvents;
+	}
+	pDll->windowEvents = windowEvents;
+
+	// Critically damped
+	double omega = 1.0 / windowEvents;
+	pDll->kp = sqrt(2.0) * omega;
+	pDll->ki = omega * omega;
+}
+
+static double x_lockNSec(const openavb_mcr_dll_t *pDll)
+{
+	return pDll->lockNSec > 0 ? pDll->lockNSec : pDll->periodNSec * MCR_DLL_LOCK_FRACTION;
+}
+
+// Start over from the event at timestamp, keeping the period if we had one
+static void x_restart(openavb_mcr_dll_t *pDll, U32 timestamp)
+{
+	x_setWindow(pDll, MCR_DLL_MIN_WINDOW);
+	pDll->bLocked = FALSE;
+	pDll->lastTs = timestamp;
+	pDll->errNSec = 0;
+	pDll->errSqNSec2 = 0;
+	if (pDll->periodNSec > 0) {
+		pDll->t0Off = 0;
+		pDll->t1Off = pDll->periodNSec;
+		pDll->nEvents = 2;
+	}
+	else {
+		pDll->nEvents = 1;
+	}
+}
+
+// Settle the nominal period once the recovered one is known
+static void x_checkNominal(openavb_mcr_dll_t *pDll)
+{
+	if (pDll->nominalNSec > 0) {
+		double ratio = pDll->periodNSec / pDll->nominalNSec;
+		double multiple = floor(ratio + 0.5);
+		if (multiple >= 1 && fabs(ratio - multiple) < MCR_DLL_NOMINAL_TOLERANCE * multiple) {
+			pDll->nominalNSec *= multiple;
+			return;
+		}
+	}
+	pDll->nominalNSec = pDll->periodNSec;
+}
+
+void openavbMcrDllInit(openavb_mcr_dll_t *pDll, double nominalNSec, U32 loopEvents, double lockNSec)
+{
+	pDll->nominalNSec = nominalNSec;
+	pDll->loopEvents = loopEvents ? loopEvents : OPENAVB_MCR_DLL_DFLT_EVENTS;
+	pDll->lockNSec = lockNSec;
+	pDll->periodNSec = 0;
+	pDll->t0Off = 0;
+	pDll->t1Off = 0;
+	pDll->errNSec = 0;
+	pDll->errSqNSec2 = 0;
+	pDll->lastTs = 0;
+	pDll->nEvents = 0;
+	pDll->bLocked = FALSE;
+	x_setWindow(pDll, MCR_DLL_MIN_WINDOW);
+}
+
+bool openavbMcrDllUpdate(openavb_mcr_dll_t *pDll, U32 timestamp)
+{
+	if (pDll->nEvents == 0) {
+		x_restart(pDll, timestamp);
+		return TRUE;
+	}
+
+	S32 deltaNSec = (S32)(timestamp - pDll->lastTs);
+	if (deltaNSec == 0) {
+		// Several packets may carry the timestamp of the same event
+		return FALSE;
+	}
+
+	if (pDll->nEvents == 1) {
+		if (deltaNSec < 0) {
+			x_restart(pDll, timestamp);
+			return TRUE;
+		}
+		// First estimate of the period, allowing for events missing in between
+		double period = deltaNSec;
+		if (pDll->nominalNSec > 0) {
+			double multiple = floor(period / pDll->nominalNSec + 0.5);
+			if (multiple > 1 && fabs(period - multiple * pDll->nominalNSec) < MCR_DLL_NOMINAL_TOLERANCE * period) {
+				period /= multiple;
+			}
+		}
+		pDll->periodNSec = period;
+		pDll->lastTs = timestamp;
+		pDll->t0Off = 0;
+		pDll->t1Off = period;
+		pDll->nEvents = 2;
+		return TRUE;
+	}
+
+	double err = deltaNSec - pDll->t1Off;
+	if (err > pDll->periodNSec / 2) {
+		// Bridge missing events
+		double missing = floor(err / pDll->periodNSec + 0.5);
+		if (missing > (pDll->bLocked ? pDll->loopEvents : MCR_DLL_MAX_GAP)) {
+			x_restart(pDll, timestamp);
+			return TRUE;
+		}
+		pDll->t1Off += missing * pDll->periodNSec;
+		err -= missing * pDll->periodNSec;
+	}
+	else if (err < -pDll->periodNSec / 2) {
+		if (err < -MCR_DLL_MAX_GAP * pDll->periodNSec) {
+			x_restart(pDll, timestamp);
+			return TRUE;
+		}
+		// Out of order or spurious
+		return FALSE;
+	}
+
+	// Correct the phase and period, then predict the next event. Offsets are kept
+	// relative to the newest timestamp, which is deltaNSec after the previous one.
+	pDll->t0Off = pDll->t1Off + pDll->kp * err - deltaNSec;
+	pDll->t1Off = pDll->t0Off + pDll->periodNSec;
+	pDll->periodNSec += pDll->ki * err;
+	pDll->lastTs = timestamp;
+	pDll->errNSec = err;
+	if (pDll->nEvents < 0xffffffff) {
+		pDll->nEvents++;
+	}
+
+	if (pDll->windowEvents < pDll->loopEvents) {
+		x_setWindow(pDll, pDll->windowEvents + 0.5);
+	}
+
+	// Single events may be late by a lot on a busy host, so lock follows the rms error
+	pDll->errSqNSec2 += (err * err - pDll->errSqNSec2) / MCR_DLL_ERR_EVENTS;
+	double lockNSec = x_lockNSec(pDll);
+	if (!pDll->bLocked) {
+		if (pDll->windowEvents * MCR_DLL_ACQUIRE_SPEEDUP >= pDll->loopEvents
+				&& pDll->nEvents > 2 * MCR_DLL_ERR_EVENTS
+				&& pDll->errSqNSec2 < lockNSec * lockNSec) {
+			pDll->bLocked = TRUE;
+			x_checkNominal(pDll);
+		}
+	}
+	else if (pDll->errSqNSec2 > MCR_DLL_UNLOCK_FACTOR * MCR_DLL_UNLOCK_FACTOR * lockNSec * lockNSec) {
+		// Talker clock jumped, acquire again from the current period
+		pDll->bLocked = FALSE;
+		x_setWindow(pDll, MCR_DLL_MIN_WINDOW);
+	}
+
+	return TRUE;
+}
+
+void openavbMcrDllShift(openavb_mcr_dll_t *pDll, double shiftNSec)
+{
+	pDll->t0Off += shiftNSec;
+	pDll->t1Off += shiftNSec;
+}
+
+double openavbMcrDllRateRatio(const openavb_mcr_dll_t *pDll)
+{
+	if (pDll->periodNSec <= 0 || pDll->nominalNSec <= 0) {
+		return 1.0;
+	}
+	return pDll->nominalNSec / pDll->periodNSec;
+}
+
+U32 openavbMcrDllPhase(const openavb_mcr_dll_t *pDll)
+{
+	return pDll->lastTs + (S32)lround(pDll->t0Off);
+}
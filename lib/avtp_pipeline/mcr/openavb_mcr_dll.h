@@ -0,0 +1,95 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE : Software media clock recovery
+* MODULE SUMMARY : Second order delay locked loop that filters AVTP timestamp events into a
+*   recovered media clock. It only does arithmetic, the caller supplies the events and any
+*   locking, so it can be used by a HAL or fed from recorded timestamps.
+*/
+
+#ifndef OPENAVB_MCR_DLL_H
+#define OPENAVB_MCR_DLL_H 1
+
+#include "openavb_types_base_pub.h"
+
+// Loop time constant in events used when the caller has no preference
+#define OPENAVB_MCR_DLL_DFLT_EVENTS		512
+
+typedef struct {
+	// Configuration, see openavbMcrDllInit()
+	double nominalNSec;
+	U32 loopEvents;
+	double lockNSec;
+
+	// Time constant in events currently used, widens to loopEvents after a (re)start
+	double windowEvents;
+	// Proportional and integral gains for windowEvents
+	double kp, ki;
+
+	// Distinct timestamps seen since the loop was (re)started
+	U32 nEvents;
+	bool bLocked;
+
+	// The loop runs relative to the last timestamp, so the doubles stay small
+	U32 lastTs;
+	// Filtered time of the last event and predicted time of the next, relative to lastTs
+	double t0Off, t1Off;
+	// Recovered time between events
+	double periodNSec;
+	// Phase error of the last event and its short term mean square
+	double errNSec;
+	double errSqNSec2;
+} openavb_mcr_dll_t;
+
+// Prepare the loop. nominalNSec is the expected time between timestamp events, or 0 when not
+// known. Talkers may only timestamp every few packets, so when the loop first locks a whole
+// multiple of nominalNSec close to the recovered period is used instead, and the recovered
+// period itself when there is none. The loop starts out fast and narrows down to a time
+// constant of about loopEvents events. It is locked once it has narrowed down to a 16th of that
+// while the rms phase error stays below lockNSec, pass 0 to use 2% of the event period.
+void openavbMcrDllInit(openavb_mcr_dll_t *pDll, double nominalNSec, U32 loopEvents, double lockNSec);
+
+// Feed the presentation time of a timestamp event, in the 32 bit AVTP timestamp domain.
+// Repeated timestamps are ignored and a few missing events are bridged; anything further
+// off than that restarts the acquisition. Returns TRUE when the event was used.
+bool openavbMcrDllUpdate(openavb_mcr_dll_t *pDll, U32 timestamp);
+
+// Move the recovered clock by shiftNSec. Positive values delay it.
+void openavbMcrDllShift(openavb_mcr_dll_t *pDll, double shiftNSec);
+
+// Talker media clock rate over the nominal rate. 1.0 until the period is known.
+double openavbMcrDllRateRatio(const openavb_mcr_dll_t *pDll);
+
+// Filtered presentation time of the last event, in the 32 bit AVTP timestamp domain.
+U32 openavbMcrDllPhase(const openavb_mcr_dll_t *pDll);
+
+#endif // OPENAVB_MCR_DLL_H
@@ -52,6 +52,16 @@ bool halCloseMCR(void);
 // Push MCR Event
 bool halPushMCR(void);
 
+// Push the presentation time of a media clock event, taken from a valid AVTP timestamp.
+// Used where the HAL recovers the media clock in software.
+bool halPushMCRTimestamp(U32 timestamp);
+
+// Recovered media clock, for interface modules that follow the talker in software.
+// pRateRatio is set to the talker media clock rate over the nominal rate and pPhaseTimestamp
+// to the presentation time of the last event on the recovered clock (low 32 bits of gPTP time).
+// Either may be NULL. Returns FALSE while no media clock is locked.
+bool halGetMCRClock(double *pRateRatio, U32 *pPhaseTimestamp);
+
 // MCR timer adjustment. Negative value speed up the media clock. Positive values slow the media clock.
 // Will take effect during the next clock recovery interval. This is completely indepentant from pure MCR and
 // allows for adjustments based on media buffer levels. The value past in works as credit with each 
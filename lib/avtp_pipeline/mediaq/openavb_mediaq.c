@@ -89,8 +89,54 @@ typedef struct {
 	// Maximum stale tail
 	U32 maxStaleTailUsec;
 
+	// Determines if the lock-free single producer / single consumer protocol is used.
+	bool lockFreeOn;
+
+	// Lock-free mode serialization of producers when threadSafeOn is also set.
+	MUTEX_HANDLE(lfHeadMutex);
+
+	// Lock-free mode indexes run from 0 to (2 * itemCount) - 1 so that a full
+	// queue can be told apart from an empty one without a shared counter.
+	// The producer and consumer fields are kept on separate cache lines.
+	U8 lfPad0[CACHE_LINE_SIZE];
+
+	// Next item to be filled. Written only by the producer.
+	U32 lfHead;
+
+	// Producer copy of lfTail. Refreshed only when the queue looks full.
+	U32 lfTailCache;
+
+	U8 lfPad1[CACHE_LINE_SIZE];
+
+	// Next item to be pulled. Written only by the consumer.
+	U32 lfTail;
+
+	U8 lfPad2[CACHE_LINE_SIZE];
 } media_q_info_t;
 
+#define LF_COUNT(pInfo)			((U32)(pInfo)->itemCount)
+#define LF_SLOT(pInfo, idx)		((idx) < LF_COUNT(pInfo) ? (idx) : (idx) - LF_COUNT(pInfo))
+#define LF_NEXT(pInfo, idx)		((idx) + 1 < LF_COUNT(pInfo) * 2 ? (idx) + 1 : 0)
+#define LF_USED(pInfo, h, t)	((h) >= (t) ? (h) - (t) : (h) + LF_COUNT(pInfo) * 2 - (t))
+
+// Drops the external memory of an item, if any, and points it back at its own storage.
+static void x_openavbMediaQItemReleaseExternal(media_q_item_t *pItem)
+{
+	if (pItem->pOwnPubData) {
+		openavb_media_q_item_release_t release = pItem->pExtRelease;
+		void *pRef = pItem->pExtRef;
+
+		pItem->pPubData = pItem->pOwnPubData;
+		pItem->pOwnPubData = NULL;
+		pItem->pExtRelease = NULL;
+		pItem->pExtRef = NULL;
+
+		if (release) {
+			release(pRef);
+		}
+	}
+}
+
 static void x_openavbMediaQIncrementHead(media_q_info_t *pMediaQInfo)	
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_MEDIAQ_DETAIL);
@@ -153,6 +199,198 @@ static void x_openavbMediaQIncrementTail(media_q_info_t *pMediaQInfo)
 	AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Lock-free mode.
+// The producer (head) side only writes lfHead and the consumer (tail) side
+// only writes lfTail. Publishing an index with release semantics makes the
+// item contents written before it visible to the other side. Taken items
+// stay in their slot and the producer waits for them to be given back
+// instead of scanning for a free slot.
+/////////////////////////////////////////////////////////////////////////////
+
+static media_q_item_t *x_openavbMediaQLFHeadLock(media_q_info_t *pMediaQInfo)
+{
+	if (pMediaQInfo->itemCount <= 0) {
+		return NULL;
+	}
+
+	if (pMediaQInfo->threadSafeOn) {
+		MUTEX_LOCK_ALT(pMediaQInfo->lfHeadMutex);
+	}
+
+	U32 head = pMediaQInfo->lfHead;
+	if (LF_USED(pMediaQInfo, head, pMediaQInfo->lfTailCache) >= LF_COUNT(pMediaQInfo)) {
+		pMediaQInfo->lfTailCache = ATOMIC_LOAD_ACQUIRE(&pMediaQInfo->lfTail);
+		if (LF_USED(pMediaQInfo, head, pMediaQInfo->lfTailCache) >= LF_COUNT(pMediaQInfo)) {
+			// Full
+			if (pMediaQInfo->threadSafeOn) {
+				MUTEX_UNLOCK_ALT(pMediaQInfo->lfHeadMutex);
+			}
+			return NULL;
+		}
+	}
+
+	media_q_item_t *pHead = &pMediaQInfo->pItems[LF_SLOT(pMediaQInfo, head)];
+	if (ATOMIC_LOAD_ACQUIRE(&pHead->taken)) {
+		// Item is still owned by the consumer.
+		if (pMediaQInfo->threadSafeOn) {
+			MUTEX_UNLOCK_ALT(pMediaQInfo->lfHeadMutex);
+		}
+		return NULL;
+	}
+
+	pMediaQInfo->headLocked = TRUE;
+	// Mutex (if acquired) stays locked
+	return pHead;
+}
+
+static void x_openavbMediaQLFHeadUnlock(media_q_info_t *pMediaQInfo)
+{
+	if (pMediaQInfo->headLocked) {
+		pMediaQInfo->headLocked = FALSE;
+		if (pMediaQInfo->threadSafeOn) {
+			MUTEX_UNLOCK_ALT(pMediaQInfo->lfHeadMutex);
+		}
+	}
+}
+
+static bool x_openavbMediaQLFHeadPush(media_q_info_t *pMediaQInfo)
+{
+	if (!pMediaQInfo->headLocked) {
+		return FALSE;
+	}
+
+	U32 head = pMediaQInfo->lfHead;
+	pMediaQInfo->pItems[LF_SLOT(pMediaQInfo, head)].readIdx = 0;		// Reset read index
+
+	ATOMIC_STORE_RELEASE(&pMediaQInfo->lfHead, LF_NEXT(pMediaQInfo, head));
+
+	pMediaQInfo->headLocked = FALSE;
+	if (pMediaQInfo->threadSafeOn) {
+		MUTEX_UNLOCK_ALT(pMediaQInfo->lfHeadMutex);
+	}
+	return TRUE;
+}
+
+// Returns the tail item or NULL if the queue is empty. Consumer side only.
+static media_q_item_t *x_openavbMediaQLFTail(media_q_info_t *pMediaQInfo)
+{
+	if (pMediaQInfo->itemCount <= 0) {
+		return NULL;
+	}
+
+	U32 tail = pMediaQInfo->lfTail;
+	if (tail == ATOMIC_LOAD_ACQUIRE(&pMediaQInfo->lfHead)) {
+		return NULL;
+	}
+	return &pMediaQInfo->pItems[LF_SLOT(pMediaQInfo, tail)];
+}
+
+static void x_openavbMediaQLFTailAdvance(media_q_info_t *pMediaQInfo)
+{
+	ATOMIC_STORE_RELEASE(&pMediaQInfo->lfTail, LF_NEXT(pMediaQInfo, pMediaQInfo->lfTail));
+	pMediaQInfo->tailLocked = FALSE;
+}
+
+static bool x_openavbMediaQLFTailPull(media_q_info_t *pMediaQInfo)
+{
+	media_q_item_t *pTail = x_openavbMediaQLFTail(pMediaQInfo);
+	if (!pTail) {
+		return FALSE;
+	}
+
+	pTail->readIdx = 0;		// Reset read index
+	pTail->dataLen = 0;		// Clears out the data
+	x_openavbMediaQItemReleaseExternal(pTail);
+	x_openavbMediaQLFTailAdvance(pMediaQInfo);
+	return TRUE;
+}
+
+static void x_openavbMediaQLFPurgeStaleTail(media_q_info_t *pMediaQInfo)
+{
+	if (pMediaQInfo->maxStaleTailUsec == 0) {
+		return;
+	}
+
+	media_q_item_t *pTail = x_openavbMediaQLFTail(pMediaQInfo);
+	if (!pTail) {
+		return;
+	}
+
+	S32 delta = openavbAvtpTimeUsecDelta(pTail->pAvtpTime);
+	S32 maxStale = (S32)(0 - pMediaQInfo->maxStaleTailUsec);
+	if (delta >= maxStale) {
+		return;
+	}
+
+	AVB_LOGF_DEBUG("Purging stale MediaQ items: delta %d us, maxStale %d us", delta, maxStale);
+	do {
+		x_openavbMediaQLFTailPull(pMediaQInfo);
+		// Once we have triggered a stale tail purge everything past presentation time.
+		pTail = x_openavbMediaQLFTail(pMediaQInfo);
+	} while (pTail && openavbAvtpTimeIsPast(pTail->pAvtpTime));
+}
+
+static media_q_item_t *x_openavbMediaQLFTailLock(media_q_info_t *pMediaQInfo, bool ignoreTimestamp)
+{
+	if (!ignoreTimestamp) {
+		x_openavbMediaQLFPurgeStaleTail(pMediaQInfo);
+	}
+
+	media_q_item_t *pTail = x_openavbMediaQLFTail(pMediaQInfo);
+	if (!pTail) {
+		return NULL;
+	}
+
+	// Check if tail item is ready.
+	if (!ignoreTimestamp && !openavbAvtpTimeIsPast(pTail->pAvtpTime)) {
+		return NULL;
+	}
+
+	pMediaQInfo->tailLocked = TRUE;
+	return pTail;
+}
+
+// Walks the ready items from the tail to the head snapshot. With pItemCnt NULL
+// returns TRUE once bytes are available, otherwise sets *pItemCnt to the
+// number of ready items.
+static bool x_openavbMediaQLFScan(media_q_info_t *pMediaQInfo, U32 bytes, bool ignoreTimestamp, U32 *pItemCnt)
+{
+	U32 itemCnt = 0;
+	U32 byteCnt = 0;
+	U64 nSecTime = 0;
+
+	if (pMediaQInfo->itemCount > 0) {
+		U32 idx = pMediaQInfo->lfTail;
+		U32 head = ATOMIC_LOAD_ACQUIRE(&pMediaQInfo->lfHead);
+
+		if (!ignoreTimestamp && idx != head) {
+			CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &nSecTime);
+		}
+
+		for (; idx != head; idx = LF_NEXT(pMediaQInfo, idx)) {
+			media_q_item_t *pItem = &pMediaQInfo->pItems[LF_SLOT(pMediaQInfo, idx)];
+
+			if (!ignoreTimestamp && !openavbAvtpTimeIsPastTime(pItem->pAvtpTime, nSecTime))
+				break;
+
+			itemCnt++;
+			if (!pItemCnt) {
+				byteCnt += pItem->dataLen - pItem->readIdx;
+				if (byteCnt >= bytes) {
+					// Met the available byte count
+					return TRUE;
+				}
+			}
+		}
+	}
+
+	if (pItemCnt) {
+		*pItemCnt = itemCnt;
+	}
+	return FALSE;
+}
+
 	
 // CORE_TODO: May need to add mutex protection when merging with OSAL/HAL branch.
 void x_openavbMediaQPurgeStaleTail(media_q_t *pMediaQ)
@@ -163,7 +401,10 @@ void x_openavbMediaQPurgeStaleTail(media_q_t *pMediaQ)
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
 
-			if (pMediaQInfo->maxStaleTailUsec > 0) {
+			if (pMediaQInfo->lockFreeOn) {
+				x_openavbMediaQLFPurgeStaleTail(pMediaQInfo);
+			}
+			else if (pMediaQInfo->maxStaleTailUsec > 0) {
 				bool bFirst = TRUE;
 				bool bMore = TRUE;
 				while (bMore) {
@@ -234,6 +475,10 @@ media_q_t* openavbMediaQCreate()
 			pMediaQInfo->maxLatencyUsec = 0;
 			pMediaQInfo->threadSafeOn = FALSE;
 			pMediaQInfo->maxStaleTailUsec = MICROSECONDS_PER_SECOND;
+			pMediaQInfo->lockFreeOn = FALSE;
+			pMediaQInfo->lfHead = 0;
+			pMediaQInfo->lfTailCache = 0;
+			pMediaQInfo->lfTail = 0;
 		}
 		else {
 			openavbMediaQDelete(pMediaQ);
@@ -259,6 +504,45 @@ void openavbMediaQThreadSafeOn(media_q_t *pMediaQ)
 	AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ);
 }
 
+bool openavbMediaQLockFreeOn(media_q_t *pMediaQ)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_MEDIAQ);
+
+	if (pMediaQ) {
+		if (pMediaQ->pPvtMediaQInfo) {
+			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ);
+				return TRUE;
+			}
+
+			// Switching modes is only possible before any item has been pushed.
+			if (pMediaQInfo->head != 0 || pMediaQInfo->tail != -1 || pMediaQInfo->headLocked) {
+				AVB_LOG_ERROR("Lock-free mode must be enabled before the MediaQ is used");
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ);
+				return FALSE;
+			}
+
+			if (MUTEX_CREATE_ALT(pMediaQInfo->lfHeadMutex) != 0) {
+				AVB_LOG_ERROR("Unable to create MediaQ head mutex");
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ);
+				return FALSE;
+			}
+
+			pMediaQInfo->lfHead = 0;
+			pMediaQInfo->lfTailCache = 0;
+			pMediaQInfo->lfTail = 0;
+			pMediaQInfo->lockFreeOn = TRUE;
+
+			AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ);
+			return TRUE;
+		}
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ);
+	return FALSE;
+}
+
 
 
 bool openavbMediaQSetSize(media_q_t *pMediaQ, int itemCount, int itemSize)
@@ -318,6 +602,14 @@ bool openavbMediaQSetSize(media_q_t *pMediaQ, int itemCount, int itemSize)
 	return TRUE;
 }
 
+int openavbMediaQGetItemCount(media_q_t *pMediaQ)
+{
+	if (pMediaQ && pMediaQ->pPvtMediaQInfo) {
+		return ((media_q_info_t *)(pMediaQ->pPvtMediaQInfo))->itemCount;
+	}
+	return 0;
+}
+
 bool openavbMediaQAllocItemMapData(media_q_t *pMediaQ, int itemPubMapSize, int itemPvtMapSize)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_MEDIAQ);
@@ -433,6 +725,7 @@ bool openavbMediaQDelete(media_q_t *pMediaQ)
 						AVB_LOG_ERROR("Deleting MediaQ with an item TAKEN. The item will be orphaned.");
 					}
 					else {
+						x_openavbMediaQItemReleaseExternal(&pMediaQInfo->pItems[i1]);
 						openavbAvtpTimeDelete(pMediaQInfo->pItems[i1].pAvtpTime);
 						if (pMediaQInfo->pItems[i1].pPubData) {
 							free(pMediaQInfo->pItems[i1].pPubData);
@@ -455,6 +748,9 @@ bool openavbMediaQDelete(media_q_t *pMediaQ)
 				free(pMediaQInfo->pItems);
 				pMediaQInfo->pItems = NULL;
 			}
+			if (pMediaQInfo->lockFreeOn) {
+				MUTEX_DESTROY_ALT(pMediaQInfo->lfHeadMutex);
+			}
 			free(pMediaQ->pPvtMediaQInfo);
 			pMediaQ->pPvtMediaQInfo = NULL;
 
@@ -522,6 +818,10 @@ media_q_item_t *openavbMediaQHeadLock(media_q_t *pMediaQ)
 	if (pMediaQ) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+				return x_openavbMediaQLFHeadLock(pMediaQInfo);
+			}
 			if (pMediaQInfo->threadSafeOn) {
 				MEDIAQ_LOCK();
 			}
@@ -550,7 +850,10 @@ void openavbMediaQHeadUnlock(media_q_t *pMediaQ)
 	if (pMediaQ) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
-			if (pMediaQInfo->itemCount > 0) {
+			if (pMediaQInfo->lockFreeOn) {
+				x_openavbMediaQLFHeadUnlock(pMediaQInfo);
+			}
+			else if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->head > -1) {
 					pMediaQInfo->headLocked = FALSE;
 					if (pMediaQInfo->threadSafeOn) {
@@ -570,6 +873,10 @@ bool openavbMediaQHeadPush(media_q_t *pMediaQ)
 	if (pMediaQ) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+				return x_openavbMediaQLFHeadPush(pMediaQInfo);
+			}
 			if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->head > -1) {
 					media_q_item_t *pHead = &pMediaQInfo->pItems[pMediaQInfo->head];
@@ -617,6 +924,11 @@ media_q_item_t* openavbMediaQTailLock(media_q_t *pMediaQ, bool ignoreTimestamp)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_MEDIAQ_DETAIL);
 
+	if (pMediaQ && pMediaQ->pPvtMediaQInfo && ((media_q_info_t *)(pMediaQ->pPvtMediaQInfo))->lockFreeOn) {
+		AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+		return x_openavbMediaQLFTailLock((media_q_info_t *)(pMediaQ->pPvtMediaQInfo), ignoreTimestamp);
+	}
+
 	if (!ignoreTimestamp) {
 		x_openavbMediaQPurgeStaleTail(pMediaQ);
 	}
@@ -665,7 +977,10 @@ void openavbMediaQTailUnlock(media_q_t *pMediaQ)
 	if (pMediaQ) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
-			if (pMediaQInfo->itemCount > 0) {
+			if (pMediaQInfo->lockFreeOn) {
+				pMediaQInfo->tailLocked = FALSE;
+			}
+			else if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->tail > -1) {
 					pMediaQInfo->tailLocked = FALSE;
 					if (pMediaQInfo->threadSafeOn) {
@@ -685,6 +1000,10 @@ bool openavbMediaQTailPull(media_q_t *pMediaQ)
 	if (pMediaQ) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+				return x_openavbMediaQLFTailPull(pMediaQInfo);
+			}
 			if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->tail > -1) {
 					media_q_item_t *pTail = &pMediaQInfo->pItems[pMediaQInfo->tail];
@@ -710,6 +1029,7 @@ bool openavbMediaQTailPull(media_q_t *pMediaQ)
 
 					pTail->readIdx = 0;		// Reset read index
 					pTail->dataLen = 0;		// Clears out the data
+					x_openavbMediaQItemReleaseExternal(pTail);
 
 					x_openavbMediaQIncrementTail(pMediaQInfo);
 
@@ -736,6 +1056,17 @@ bool openavbMediaQTailItemTake(media_q_t *pMediaQ, media_q_item_t* pItem)
 	if (pMediaQ && pItem) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				if (x_openavbMediaQLFTail(pMediaQInfo) == pItem) {
+					// The producer must see the item as taken before it sees the slot as free.
+					ATOMIC_STORE_RELAXED(&pItem->taken, TRUE);
+					x_openavbMediaQLFTailAdvance(pMediaQInfo);
+					AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+					return TRUE;
+				}
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+				return FALSE;
+			}
 			if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->tail > -1) {
 
@@ -763,9 +1094,19 @@ bool openavbMediaQTailItemGive(media_q_t *pMediaQ, media_q_item_t* pItem)
 	AVB_TRACE_ENTRY(AVB_TRACE_MEDIAQ_DETAIL);
 
 	if (pItem) {
-		pItem->taken = FALSE;
+		if (pMediaQ && pMediaQ->pPvtMediaQInfo && ((media_q_info_t *)(pMediaQ->pPvtMediaQInfo))->lockFreeOn) {
+			pItem->readIdx = 0;		// Reset read index
+			pItem->dataLen = 0;		// Clears out the data
+			x_openavbMediaQItemReleaseExternal(pItem);
+			ATOMIC_STORE_RELEASE(&pItem->taken, FALSE);
+			AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+			return TRUE;
+		}
+
 		pItem->readIdx = 0;		// Reset read index
 		pItem->dataLen = 0;		// Clears out the data
+		x_openavbMediaQItemReleaseExternal(pItem);
+		pItem->taken = FALSE;
 
 		if (pMediaQ) {
 			if (pMediaQ->pPvtMediaQInfo) {
@@ -799,6 +1140,28 @@ bool openavbMediaQTailItemGive(media_q_t *pMediaQ, media_q_item_t* pItem)
 	return FALSE;
 }
 
+bool openavbMediaQItemSetExternal(media_q_item_t *pItem, void *pData, U32 dataLen, openavb_media_q_item_release_t release, void *pRef)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_MEDIAQ_DETAIL);
+
+	if (!pItem || !pData) {
+		AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+		return FALSE;
+	}
+
+	// Release memory attached earlier to an item that was never pushed
+	x_openavbMediaQItemReleaseExternal(pItem);
+
+	pItem->pOwnPubData = pItem->pPubData;
+	pItem->pExtRelease = release;
+	pItem->pExtRef = pRef;
+	pItem->pPubData = pData;
+	pItem->dataLen = dataLen;
+	pItem->readIdx = 0;
+
+	AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+	return TRUE;
+}
 
 bool openavbMediaQUsecTillTail(media_q_t *pMediaQ, U32 *pUsecTill)
 {
@@ -807,6 +1170,12 @@ bool openavbMediaQUsecTillTail(media_q_t *pMediaQ, U32 *pUsecTill)
 	if (pMediaQ && pUsecTill) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				media_q_item_t *pTail = x_openavbMediaQLFTail(pMediaQInfo);
+				bool bOk = pTail && openavbAvtpTimeUsecTill(pTail->pAvtpTime, pUsecTill);
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+				return bOk;
+			}
 			if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->tail > -1) {
 					media_q_item_t *pTail = &pMediaQInfo->pItems[pMediaQInfo->tail];
@@ -839,6 +1208,10 @@ bool openavbMediaQIsAvailableBytes(media_q_t *pMediaQ, U32 bytes, bool ignoreTim
 	if (pMediaQ) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+				return x_openavbMediaQLFScan(pMediaQInfo, bytes, ignoreTimestamp, NULL);
+			}
 			if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->tail > -1) {
 					// Check if tail item is ready.
@@ -914,6 +1287,11 @@ U32 openavbMediaQCountItems(media_q_t *pMediaQ, bool ignoreTimestamp)
 	if (pMediaQ) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				x_openavbMediaQLFScan(pMediaQInfo, 0, ignoreTimestamp, &itemCnt);
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+				return itemCnt;
+			}
 			if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->tail > -1) {
 					// Check if tail item is ready.
@@ -977,6 +1355,12 @@ bool openavbMediaQAnyReadyItems(media_q_t *pMediaQ, bool ignoreTimestamp)
 	if (pMediaQ) {
 		if (pMediaQ->pPvtMediaQInfo) {
 			media_q_info_t *pMediaQInfo = (media_q_info_t *)(pMediaQ->pPvtMediaQInfo);
+			if (pMediaQInfo->lockFreeOn) {
+				media_q_item_t *pTail = x_openavbMediaQLFTail(pMediaQInfo);
+				bool bReady = pTail && (ignoreTimestamp || openavbAvtpTimeIsPast(pTail->pAvtpTime));
+				AVB_TRACE_EXIT(AVB_TRACE_MEDIAQ_DETAIL);
+				return bReady;
+			}
 			if (pMediaQInfo->itemCount > 0) {
 				if (pMediaQInfo->tail > -1) {
 					// Check if tail item is ready.
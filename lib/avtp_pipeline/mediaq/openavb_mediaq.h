@@ -43,6 +43,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 //  However the declarations are included here for easy internal use. 
 media_q_t* openavbMediaQCreate();
 void openavbMediaQThreadSafeOn(media_q_t *pMediaQ);
+bool openavbMediaQLockFreeOn(media_q_t *pMediaQ);
 bool openavbMediaQSetSize(media_q_t *pMediaQ, int itemCount, int itemSize);
 bool openavbMediaQAllocItemMapData(media_q_t *pMediaQ, int itemPubMapSize, int itemPvtMapSize);
 bool openavbMediaQAllocItemIntfData(media_q_t *pMediaQ, int itemIntfSize);
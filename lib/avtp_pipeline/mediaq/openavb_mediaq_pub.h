@@ -45,6 +45,12 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
  * Circular queue for passing data between interfaces and mappers.
  */
 
+/** Release callback for external item data.
+ * Called with the reference given to openavbMediaQItemSetExternal() once the
+ * media queue no longer uses the external memory.
+ */
+typedef void (*openavb_media_q_item_release_t)(void *pRef);
+
 /** Media Queue Item structure.
  */
 typedef struct {
@@ -78,6 +84,12 @@ typedef struct {
 
 	/// For use internally by the interface. Often may not be used.
 	void *pPvtIntfData;
+
+	/// \privatesection
+	/// Set while pPubData references external memory. Managed by the media queue.
+	openavb_media_q_item_release_t pExtRelease;
+	void *pExtRef;
+	void *pOwnPubData;
 } media_q_item_t;
 
 /** Media Queue structure.
@@ -135,6 +147,23 @@ media_q_t* openavbMediaQCreate();
  */
 void openavbMediaQThreadSafeOn(media_q_t *pMediaQ);
 
+/** Enable lock-free access for this media queue.
+ *
+ * Switches the media queue to a wait-free single producer / single consumer
+ * protocol with per-queue head and tail indexes. The producer (interface on a
+ * talker, mapper on a listener) and the consumer can then run in different
+ * threads without taking any mutex. If openavbMediaQThreadSafeOn() is also
+ * called, only the head (producer) functions are serialized and that is done
+ * with a mutex owned by this media queue. An item taken with
+ * openavbMediaQTailItemTake() blocks the head from reaching its slot until it
+ * is given back. This must be called before the media queue is used and can
+ * not be disabled.
+ *
+ * \param pMediaQ A pointer to the media_q_t structure
+ * \return TRUE on success or FALSE on failure
+ */
+bool openavbMediaQLockFreeOn(media_q_t *pMediaQ);
+
 /** Set size of  media queue.
  *
  * Pre-allocate all the items for the media queue. Once allocated the item
@@ -152,6 +181,13 @@ void openavbMediaQThreadSafeOn(media_q_t *pMediaQ);
  */
 bool openavbMediaQSetSize(media_q_t *pMediaQ, int itemCount, int itemSize);
 
+/** Get the number of items in the media queue.
+ *
+ * \param pMediaQ A pointer to the media_q_t structure
+ * \return The item count set with openavbMediaQSetSize(), or 0 if not set yet
+ */
+int openavbMediaQGetItemCount(media_q_t *pMediaQ);
+
 /** Alloc item map data.
  *
  * Items in the media queue may also have per-item data that is managed by the
@@ -320,6 +356,26 @@ bool openavbMediaQTailItemTake(media_q_t *pMediaQ, media_q_item_t* pItem);
  */
 bool openavbMediaQTailItemGive(media_q_t *pMediaQ, media_q_item_t* pItem);
 
+/** Attach external memory to a head item instead of copying into it.
+ *
+ * Points pPubData of an item locked with openavbMediaQHeadLock at pData and
+ * sets dataLen, so a mapper reads the data straight from a buffer owned by
+ * the interface, such as a mapped GStreamer buffer. Mappers must only read
+ * from such an item and may still reject data larger than the item size.
+ * Once the item is pulled from the tail, given back after a take, attached
+ * again or the media queue is deleted, release(pRef) is called and pPubData
+ * points at the storage of the item again. The item should be pushed after
+ * this call.
+ *
+ * \param pItem A head item locked with openavbMediaQHeadLock.
+ * \param pData The external data.
+ * \param dataLen Length of the external data.
+ * \param release Callback releasing the external data. May be NULL.
+ * \param pRef Passed to release.
+ * \return Returns TRUE on success or FALSE on failure.
+ */
+bool openavbMediaQItemSetExternal(media_q_item_t *pItem, void *pData, U32 dataLen, openavb_media_q_item_release_t release, void *pRef);
+
 /** Get microseconds until tail is ready.
  *
  * \param pMediaQ A pointer to the media_q_t structure.
@@ -0,0 +1,266 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : avbstat - shows the statistics published by running talkers and listeners.
+*
+* Each process using the talker / listener library publishes its streams in
+* /dev/shm/openavb_stats.<pid>. The segments are only read, so looking at the
+* statistics never disturbs the streams.
+*/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <limits.h>
+#include <inttypes.h>
+#include "openavb_tl_stats.h"
+
+#define AVBSTAT_SHM_DIR		"/dev/shm"
+
+static const char *gHistNames[OPENAVB_TL_STATS_HISTOGRAMS] = {
+	"tx_lateness_ns",
+	"ptime_error_ns",
+	"map_time_ns",
+	"tx_slack_ns",
+	"mediaq_depth",
+};
+
+static bool gJson = FALSE;
+
+static void avbstatUsage(char *programName)
+{
+	printf(
+		"\n"
+		"Usage: %s [options]\n"
+		"  -h         Prints this message.\n"
+		"  -p val     Only show the streams of process 'val'.\n"
+		"  -i val     Repeat every 'val' seconds until interrupted.\n"
+		"  -j         Print one JSON object per stream instead of a table.\n"
+		"\n",
+		programName);
+}
+
+static void avbstatJsonString(const char *str)
+{
+	putchar('"');
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\') {
+			putchar('\\');
+		}
+		if ((unsigned char)*str >= ' ') {
+			putchar(*str);
+		}
+	}
+	putchar('"');
+}
+
+static void avbstatPrintSlot(U32 pid, U32 idx, openavb_tl_stats_slot_t *pSlot)
+{
+	const char *role = pSlot->role == AVB_ROLE_TALKER ? "talker" : "listener";
+	int i1;
+
+	if (gJson) {
+		printf("{\"pid\":%u,\"slot\":%u,\"role\":\"%s\",\"name\":", pid, idx, role);
+		avbstatJsonString(pSlot->friendlyName);
+		printf(",\"stream\":\"%02x:%02x:%02x:%02x:%02x:%02x/%u\",\"frames\":%" PRIu64 ",\"cpu_ns\":%" PRIu64,
+			pSlot->streamAddr[0], pSlot->streamAddr[1], pSlot->streamAddr[2],
+			pSlot->streamAddr[3], pSlot->streamAddr[4], pSlot->streamAddr[5], pSlot->streamUid,
+			pSlot->frames, pSlot->cpuNS);
+		for (i1 = 0; i1 < OPENAVB_TL_STATS_HISTOGRAMS; i1++) {
+			openavb_histogram_t pHist = &pSlot->hist[i1];
+			if (!openavbHistogramCount(pHist)) {
+				continue;
+			}
+			printf(",\"%s\":{\"samples\":%" PRIu64 ",\"p50\":%" PRIu64 ",\"p99\":%" PRIu64 ",\"p99.9\":%" PRIu64 ",\"max\":%" PRIu64 "}",
+				gHistNames[i1], openavbHistogramCount(pHist),
+				openavbHistogramPercentile(pHist, 50.0),
+				openavbHistogramPercentile(pHist, 99.0),
+				openavbHistogramPercentile(pHist, 99.9),
+				openavbHistogramMax(pHist));
+		}
+		printf("}\n");
+		return;
+	}
+
+	printf("%u/%u %s %s %02x:%02x:%02x:%02x:%02x:%02x/%u frames=%" PRIu64 " cpu_ms=%" PRIu64 "\n",
+		pid, idx, role, pSlot->friendlyName[0] ? pSlot->friendlyName : "-",
+		pSlot->streamAddr[0], pSlot->streamAddr[1], pSlot->streamAddr[2],
+		pSlot->streamAddr[3], pSlot->streamAddr[4], pSlot->streamAddr[5], pSlot->streamUid,
+		pSlot->frames, pSlot->cpuNS / NANOSECONDS_PER_MSEC);
+	for (i1 = 0; i1 < OPENAVB_TL_STATS_HISTOGRAMS; i1++) {
+		openavb_histogram_t pHist = &pSlot->hist[i1];
+		if (!openavbHistogramCount(pHist)) {
+			continue;
+		}
+		printf("    %-16s %12" PRIu64 " samples  p50 %10" PRIu64 "  p99 %10" PRIu64 "  p99.9 %10" PRIu64 "  max %10" PRIu64 "\n",
+			gHistNames[i1], openavbHistogramCount(pHist),
+			openavbHistogramPercentile(pHist, 50.0),
+			openavbHistogramPercentile(pHist, 99.0),
+			openavbHistogramPercentile(pHist, 99.9),
+			openavbHistogramMax(pHist));
+	}
+}
+
+// Print the streams of one process. Returns the number of streams shown.
+static int avbstatShowSegment(const char *name)
+{
+	char path[sizeof(AVBSTAT_SHM_DIR) + NAME_MAX + 1];
+	struct stat st;
+	int shown = 0;
+	U32 i1;
+
+	snprintf(path, sizeof(path), AVBSTAT_SHM_DIR "/%s", name);
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return 0;
+	}
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(openavb_tl_stats_shm_t)) {
+		close(fd);
+		return 0;
+	}
+
+	const openavb_tl_stats_shm_t *pShm = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (pShm == MAP_FAILED) {
+		fprintf(stderr, "Unable to map %s: %s\n", path, strerror(errno));
+		return 0;
+	}
+
+	if (ATOMIC_LOAD_ACQUIRE(&pShm->magic) != OPENAVB_TL_STATS_MAGIC
+		|| pShm->version != OPENAVB_TL_STATS_VERSION
+		|| pShm->slotSize != sizeof(openavb_tl_stats_slot_t)
+		|| sizeof(openavb_tl_stats_shm_t) + (size_t)pShm->nSlots * sizeof(openavb_tl_stats_slot_t) > (size_t)st.st_size) {
+		fprintf(stderr, "Skipping %s, unknown layout\n", path);
+	}
+	else if (kill(pShm->pid, 0) != 0 && errno == ESRCH) {
+		// Left behind by a process that did not clean up
+	}
+	else {
+		openavb_tl_stats_slot_t *pCopy = malloc(sizeof(openavb_tl_stats_slot_t));
+		for (i1 = 0; pCopy && i1 < pShm->nSlots; i1++) {
+			if (!ATOMIC_LOAD_RELAXED(&pShm->slots[i1].inUse)) {
+				continue;
+			}
+			if (!openavbTLStatsSnapshot(&pShm->slots[i1], pCopy)) {
+				fprintf(stderr, "Stream %u/%u busy, skipped\n", pShm->pid, i1);
+				continue;
+			}
+			if (pCopy->inUse) {
+				avbstatPrintSlot(pShm->pid, i1, pCopy);
+				shown++;
+			}
+		}
+		free(pCopy);
+	}
+
+	munmap((void *)pShm, st.st_size);
+	return shown;
+}
+
+static int avbstatShowAll(int pid)
+{
+	const char *prefix = OPENAVB_TL_STATS_SHM_PREFIX + 1;
+	struct dirent *pEntry;
+	int shown = 0;
+
+	DIR *pDir = opendir(AVBSTAT_SHM_DIR);
+	if (!pDir) {
+		fprintf(stderr, "Unable to open " AVBSTAT_SHM_DIR ": %s\n", strerror(errno));
+		return -1;
+	}
+
+	while ((pEntry = readdir(pDir)) != NULL) {
+		if (strncmp(pEntry->d_name, prefix, strlen(prefix)) != 0) {
+			continue;
+		}
+		if (pid > 0 && atoi(pEntry->d_name + strlen(prefix)) != pid) {
+			continue;
+		}
+		shown += avbstatShowSegment(pEntry->d_name);
+	}
+	closedir(pDir);
+
+	return shown;
+}
+
+int main(int argc, char *argv[])
+{
+	int pid = 0;
+	int interval = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "hp:i:j")) != EOF) {
+		switch (opt) {
+			case 'p':
+				pid = atoi(optarg);
+				break;
+			case 'i':
+				interval = atoi(optarg);
+				break;
+			case 'j':
+				gJson = TRUE;
+				break;
+			case 'h':
+			default:
+				avbstatUsage(argv[0]);
+				return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	while (1) {
+		int shown = avbstatShowAll(pid);
+		if (shown < 0) {
+			return 1;
+		}
+		if (shown == 0 && !gJson) {
+			printf("No streams\n");
+		}
+		fflush(stdout);
+
+		if (interval <= 0) {
+			break;
+		}
+		sleep(interval);
+		if (!gJson) {
+			printf("\n");
+		}
+	}
+
+	return 0;
+}
@@ -54,6 +54,9 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 
 bool bRunning = TRUE;
 
+// Seconds streams run in benchmark mode before measuring starts
+#define HARNESS_BENCH_WARMUP_SEC	2
+
 // Platform independent mapping modules
 extern bool openavbMapPipeInitialize(media_q_t *pMediaQ, openavb_map_cb_t *pMapCB, U32 inMaxTransitUsec);
 extern bool openavbMapAVTPAudioInitialize(media_q_t *pMediaQ, openavb_map_cb_t *pMapCB, U32 inMaxTransitUsec);
@@ -120,9 +123,12 @@ void openavbTlHarnessUsage(char *programName)
 		"  -h         Prints this message.\n"
 		"  -i         Enables interactive mode.\n"
 		"  -s val     Stream count. Starts 'val' number of streams for each configuration file. stream_uid will be overriden.\n"
+		"  -S val     Send for all talkers from 'val' scheduler threads pinned to CPUs 0 to val-1 instead of one thread per talker.\n"
 		"  -d val     Last byte of destination address from static pool. Full address will be 91:e0:f0:00:fe:val.\n"
 		"  -I val     Use given (val) interface globally, can be overriden by giving the ifname= option to the config line.\n"
 		"  -l val     Filename of the log file to use.  If not specified, results will be logged to stderr.\n"
+		"  -b val     Benchmark mode. Runs all streams with detailed_stats for 'val' seconds after a short warmup,\n"
+		"             prints one JSON object per stream to stdout and exits.\n"
 		"\n"
 		"Examples:\n"
 		"  %s talker.ini\n"
@@ -137,8 +143,10 @@ void openavbTlHarnessUsage(char *programName)
 		"    Start 1 stream and override the sream_addr in the ini file.\n\n"
 		"  %s -i -s 8 -a 84:7E:40:2C:8F:DE listener.ini\n"
 		"    Work interactively with 8 streams overriding the stream_uid and stream_addr of each.\n\n"
+		"  %s -b 10 -s 4 -d 0 -I ring:veth0 null_talker.ini\n"
+		"    Measure 4 null talkers on veth0 for 10 seconds.\n\n"
 		,
-		programName, programName, programName, programName, programName, programName, programName);
+		programName, programName, programName, programName, programName, programName, programName, programName);
 }
 
 void openavbTlHarnessMenu()
@@ -157,6 +165,116 @@ void openavbTlHarnessMenu()
 }
 
 
+// Print a string as a JSON string literal
+static void openavbTlHarnessJsonString(const char *str)
+{
+	putchar('"');
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\') {
+			putchar('\\');
+		}
+		if ((unsigned char)*str >= ' ') {
+			putchar(*str);
+		}
+	}
+	putchar('"');
+}
+
+static void openavbTlHarnessJsonPercentiles(tl_handle_t handle, tl_hist_t hist)
+{
+	U64 count;
+	U64 p50 = openavbTLStatPercentile(handle, hist, 50.0, &count);
+
+	printf("{\"samples\":%" PRIu64 ",\"p50\":%" PRIu64 ",\"p90\":%" PRIu64 ",\"p99\":%" PRIu64 ",\"p99.9\":%" PRIu64 ",\"max\":%" PRIu64 "}",
+		count, p50,
+		openavbTLStatPercentile(handle, hist, 90.0, NULL),
+		openavbTLStatPercentile(handle, hist, 99.0, NULL),
+		openavbTLStatPercentile(handle, hist, 99.9, NULL),
+		openavbTLStatPercentile(handle, hist, 100.0, NULL));
+}
+
+// Run all streams for benchSeconds and print one JSON object per stream.
+// Frame rate and CPU load cover the measured period only, percentiles the whole run.
+static void openavbTlHarnessBench(tl_handle_t *tlHandleList, char **tlIniList, int tlCount, int benchSeconds)
+{
+	U64 *startFrames = calloc(tlCount, sizeof(U64));
+	U64 *startCpuNS = calloc(tlCount, sizeof(U64));
+	U64 startNS, endNS;
+	int i1;
+
+	if (!startFrames || !startCpuNS) {
+		AVB_LOG_ERROR("Unable to allocate benchmark data");
+		free(startFrames);
+		free(startCpuNS);
+		return;
+	}
+
+	for (i1 = 0; i1 < tlCount; i1++) {
+		printf("Starting: %s\n", tlIniList[i1]);
+		openavbTLRun(tlHandleList[i1]);
+	}
+
+	for (i1 = 0; i1 < HARNESS_BENCH_WARMUP_SEC * 1000 && bRunning; i1++) {
+		SLEEP_MSEC(1);
+	}
+
+	CLOCK_GETTIME64(OPENAVB_CLOCK_MONOTONIC, &startNS);
+	for (i1 = 0; i1 < tlCount; i1++) {
+		startFrames[i1] = openavbTLStat(tlHandleList[i1], TL_STAT_LIVE_FRAMES);
+		startCpuNS[i1] = openavbTLStat(tlHandleList[i1], TL_STAT_CPU_NSEC);
+	}
+
+	for (i1 = 0; i1 < benchSeconds * 1000 && bRunning; i1++) {
+		SLEEP_MSEC(1);
+	}
+
+	CLOCK_GETTIME64(OPENAVB_CLOCK_MONOTONIC, &endNS);
+	double seconds = (double)(endNS - startNS) / NANOSECONDS_PER_SECOND;
+
+	for (i1 = 0; i1 < tlCount; i1++) {
+		tl_handle_t handle = tlHandleList[i1];
+		bool bTalker = openavbTLGetRole(handle) == AVB_ROLE_TALKER;
+		U64 frames = openavbTLStat(handle, TL_STAT_LIVE_FRAMES) - startFrames[i1];
+		U64 cpuNS = openavbTLStat(handle, TL_STAT_CPU_NSEC) - startCpuNS[i1];
+
+		printf("{\"stream\":%d,\"config\":", i1);
+		openavbTlHarnessJsonString(tlIniList[i1]);
+		printf(",\"role\":\"%s\",\"running\":%s,\"seconds\":%.3f,\"frames_per_sec\":%.1f,\"cpu_percent\":%.3f,",
+			bTalker ? "talker" : "listener",
+			openavbTLIsRunning(handle) ? "true" : "false",
+			seconds,
+			frames / seconds,
+			cpuNS * 100.0 / (endNS - startNS));
+		if (bTalker) {
+			printf("\"tx_lateness_ns\":");
+			openavbTlHarnessJsonPercentiles(handle, TL_HIST_TX_LATENESS);
+			printf(",\"tx_slack_ns\":");
+			openavbTlHarnessJsonPercentiles(handle, TL_HIST_TX_SLACK);
+		}
+		else {
+			printf("\"ptime_error_ns\":");
+			openavbTlHarnessJsonPercentiles(handle, TL_HIST_RX_PTIME_ERROR);
+		}
+		printf(",\"map_time_ns\":");
+		openavbTlHarnessJsonPercentiles(handle, TL_HIST_MAP_TIME);
+		printf(",\"mediaq_depth\":");
+		openavbTlHarnessJsonPercentiles(handle, TL_HIST_MEDIAQ_DEPTH);
+		printf("}\n");
+	}
+	fflush(stdout);
+
+	for (i1 = 0; i1 < tlCount; i1++) {
+		if (openavbTLIsRunning(tlHandleList[i1])) {
+			printf("Stopping: %s\n", tlIniList[i1]);
+			openavbTLStop(tlHandleList[i1]);
+		}
+	}
+
+	free(startFrames);
+	free(startCpuNS);
+}
+
+
 /**********************************************
  * main
  */
@@ -170,10 +288,12 @@ int main(int argc, char *argv[])
 	bool optInteractive = FALSE;
 	int optStreamCount = 1;
 	bool optStreamCountSet = FALSE;
+	int optTalkerWorkers = 0;
 	bool optDestAddrSet = FALSE;
 	U8 destAddr[ETH_ALEN] = {0x91, 0xe0, 0xf0, 0x00, 0xfe, 0x00};
 	char *optIfnameGlobal = NULL;
 	char *optLogFileName = NULL;
+	int optBenchSeconds = 0;
 
 	// Talker listener vars
 	int iniIdx = 0;
@@ -231,12 +351,15 @@ int main(int argc, char *argv[])
 
 	bool optDone = FALSE;
 	while (!optDone) {
-		int opt = getopt(argc, argv, "a:his:d:I:l:");
+		int opt = getopt(argc, argv, "a:b:his:S:d:I:l:");
 		if (opt != EOF) {
 			switch (opt) {
 				case 'a':
 					optStreamAddr = strdup(optarg);
 					break;
+				case 'b':
+					optBenchSeconds = atoi(optarg);
+					break;
 				case 'i':
 					optInteractive = TRUE;
 					break;
@@ -244,6 +367,9 @@ int main(int argc, char *argv[])
 					optStreamCount = atoi(optarg);
 					optStreamCountSet = TRUE;
 					break;
+				case 'S':
+					optTalkerWorkers = atoi(optarg);
+					break;
 				case 'd':
 					optDestAddrSet = TRUE;
 					destAddr[5] = strtol(optarg, NULL, 0);
@@ -286,6 +412,10 @@ int main(int argc, char *argv[])
 		exit(-1);
 	}
 
+	if (optTalkerWorkers > 0) {
+		openavbTLSetTalkerWorkers(optTalkerWorkers);
+	}
+
 	if (!openavbTLInitialize(tlCount)) {
 		AVB_LOG_ERROR("Unable to initialize talker listener library");
 		osalAVBFinalize();
@@ -312,6 +442,9 @@ int main(int argc, char *argv[])
 			if (optIfnameGlobal && !strcasestr(iniFile, ",ifname=")) {
 				snprintf(iniFile + strlen(iniFile), sizeof(iniFile), ",ifname=%s", optIfnameGlobal);
 			}
+			if (optBenchSeconds > 0) {
+				snprintf(iniFile + strlen(iniFile), sizeof(iniFile) - strlen(iniFile), ",detailed_stats=1");
+			}
 			tlIniList[tlIndex++] = strdup(iniFile);
 		}
 		else {
@@ -320,6 +453,9 @@ int main(int argc, char *argv[])
 				if (optIfnameGlobal && !strcasestr(iniFile, ",ifname=")) {
 					snprintf(iniFile + strlen(iniFile), sizeof(iniFile), ",ifname=%s", optIfnameGlobal);
 				}
+				if (optBenchSeconds > 0) {
+					snprintf(iniFile + strlen(iniFile), sizeof(iniFile) - strlen(iniFile), ",detailed_stats=1");
+				}
 				tlIniList[tlIndex++] = strdup(iniFile);
 				if (optDestAddrSet) {
 					destAddr[5]++;
@@ -368,7 +504,11 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	if (!optInteractive) {
+	if (optBenchSeconds > 0) {
+		// Benchmark mode
+		openavbTlHarnessBench(tlHandleList, tlIniList, tlCount, optBenchSeconds);
+	}
+	else if (!optInteractive) {
 		// Non-interactive mode
 		// Run any streams where the stop initial state was not requested.
 		for (i1 = 0; i1 < tlCount; i1++) {
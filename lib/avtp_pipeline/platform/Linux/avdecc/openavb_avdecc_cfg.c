@@ -121,6 +121,21 @@ static int cfgCallback(void *user, const char *section, const char *name, const
 			return 0;
 		}
 	}
+	else if (MATCH(section, "event_loop"))
+	{
+		if (MATCH(name, "event_loop")) {
+			errno = 0;
+			pCfg->bEventLoop = (strtoul(value, &pEnd, 10) != 0);
+			if (*pEnd == '\0' && errno == 0)
+				valOK = TRUE;
+		}
+		else {
+			// unmatched item, fail
+			AVB_LOGF_ERROR("Unrecognized configuration item: section=%s, name=%s", section, name);
+			AVB_TRACE_EXIT(AVB_TRACE_ENDPOINT);
+			return 0;
+		}
+	}
 	else if (MATCH(section, "discovery"))
 	{
 		if (MATCH(name, "valid_time")) {
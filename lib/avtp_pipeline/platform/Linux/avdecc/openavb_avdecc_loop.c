@@ -0,0 +1,565 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+ ******************************************************************
+ * MODULE : AVDECC - Event loop
+ * MODULE SUMMARY : Single RX socket, subtype dispatch and timer wheel shared by ADP, AECP and ACMP
+ *
+ * One epoll thread replaces the per-protocol RX threads. Frames are read from a single
+ * raw socket, the VLAN tag is skipped, and the PDU is handed to the handler registered for
+ * its AVTP subtype. Timeouts are kept in a hashed timer wheel and run on the same thread.
+ * An eventfd wakes the loop when a timer is armed from another thread or on shutdown.
+ ******************************************************************
+ */
+
+#include "openavb_platform.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#define	AVB_LOG_COMPONENT	"AVDECC"
+#include "openavb_log.h"
+
+#include "openavb_trace.h"
+#include "openavb_avtp.h"
+#include "openavb_avdecc_loop.h"
+
+// Large enough for the biggest AECP PDU
+#define AVDECC_LOOP_FRAME_LEN (ETH_HDR_LEN_VLAN + 12 + 1480)
+
+// number of buffers (arbitrary, and rounded up by rawsock)
+#define AVDECC_LOOP_NUM_BUFFERS 32
+
+// Frames handled per wakeup before the timers get a turn
+#define AVDECC_LOOP_RX_BATCH 16
+
+// Longest sleep, so a lost wakeup can never stall the loop
+#define AVDECC_LOOP_MAX_WAIT_MSEC 1000
+
+#define AVDECC_LOOP_MAX_MCAST 8
+
+#define WHEEL_MASK (OPENAVB_AVDECC_LOOP_WHEEL_SLOTS - 1)
+
+static MUTEX_HANDLE(openavbAvdeccLoopRxMutex);
+#define RX_LOCK() { MUTEX_CREATE_ERR(); MUTEX_LOCK(openavbAvdeccLoopRxMutex); MUTEX_LOG_ERR("Mutex lock failure"); }
+#define RX_UNLOCK() { MUTEX_CREATE_ERR(); MUTEX_UNLOCK(openavbAvdeccLoopRxMutex); MUTEX_LOG_ERR("Mutex unlock failure"); }
+
+static MUTEX_HANDLE(openavbAvdeccLoopTimerMutex);
+#define TIMER_LOCK() { MUTEX_CREATE_ERR(); MUTEX_LOCK(openavbAvdeccLoopTimerMutex); MUTEX_LOG_ERR("Mutex lock failure"); }
+#define TIMER_UNLOCK() { MUTEX_CREATE_ERR(); MUTEX_UNLOCK(openavbAvdeccLoopTimerMutex); MUTEX_LOG_ERR("Mutex unlock failure"); }
+
+THREAD_TYPE(openavbAvdeccLoopThread);
+THREAD_DEFINITON(openavbAvdeccLoopThread);
+
+typedef struct {
+	U8 addr[ETH_ALEN];
+	int refs;
+} avdecc_loop_mcast_t;
+
+static bool bRunning = FALSE;
+static void *rxSock = NULL;
+static int epollFd = -1;
+static int wakeFd = -1;
+static pthread_t loopThreadId;
+
+// Indexed by the first octet of the AVTP header (cd bit and subtype). Protected by the RX mutex.
+static openavb_avdecc_loop_rx_cb_t rxHandlers[256];
+static avdecc_loop_mcast_t rxMcast[AVDECC_LOOP_MAX_MCAST];
+
+// Wheel state. Protected by the timer mutex.
+static openavb_avdecc_loop_timer_t *wheel[OPENAVB_AVDECC_LOOP_WHEEL_SLOTS];
+static U64 curTick;
+static openavb_avdecc_loop_timer_t *pRunningTimer = NULL;
+static pthread_cond_t timerDoneCond = PTHREAD_COND_INITIALIZER;
+
+static U64 x_nowTick(void)
+{
+	struct timespec now;
+	CLOCK_GETTIME(OPENAVB_CLOCK_MONOTONIC, &now);
+	return ((U64)now.tv_sec * MICROSECONDS_PER_SECOND + now.tv_nsec / NANOSECONDS_PER_USEC) / OPENAVB_AVDECC_LOOP_TICK_USEC;
+}
+
+static void x_wake(void)
+{
+	U64 one = 1;
+	if (wakeFd >= 0 && write(wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+		AVB_LOGF_WARNING("Event loop wakeup failed: %s", strerror(errno));
+	}
+}
+
+static bool x_onLoopThread(void)
+{
+	return bRunning && pthread_equal(pthread_self(), loopThreadId);
+}
+
+// Caller holds the timer mutex.
+static void x_timerUnlink(openavb_avdecc_loop_timer_t *pTimer)
+{
+	if (!pTimer->armed)
+		return;
+
+	if (pTimer->prev)
+		pTimer->prev->next = pTimer->next;
+	else
+		wheel[pTimer->expires & WHEEL_MASK] = pTimer->next;
+	if (pTimer->next)
+		pTimer->next->prev = pTimer->prev;
+	pTimer->next = pTimer->prev = NULL;
+	pTimer->armed = FALSE;
+}
+
+// Caller holds the timer mutex. The timer must expire after curTick.
+static void x_timerLink(openavb_avdecc_loop_timer_t *pTimer)
+{
+	openavb_avdecc_loop_timer_t **ppHead = &wheel[pTimer->expires & WHEEL_MASK];
+	pTimer->prev = NULL;
+	pTimer->next = *ppHead;
+	if (*ppHead)
+		(*ppHead)->prev = pTimer;
+	*ppHead = pTimer;
+	pTimer->armed = TRUE;
+}
+
+// Caller holds the timer mutex. It is released while a callback runs.
+static void x_runSlot(U32 slot, U64 nowTick)
+{
+	openavb_avdecc_loop_timer_t *pTimer = wheel[slot];
+	while (pTimer) {
+		if (pTimer->expires > nowTick) {
+			// Not due yet on this turn of the wheel.
+			pTimer = pTimer->next;
+			continue;
+		}
+
+		x_timerUnlink(pTimer);
+		pRunningTimer = pTimer;
+		TIMER_UNLOCK();
+		pTimer->cb(pTimer->arg);
+		TIMER_LOCK();
+		pRunningTimer = NULL;
+		pthread_cond_broadcast(&timerDoneCond);
+
+		// The callback may have changed this slot; start over.
+		pTimer = wheel[slot];
+	}
+}
+
+static void x_runTimers(void)
+{
+	U64 nowTick = x_nowTick();
+
+	TIMER_LOCK();
+	if (nowTick > curTick) {
+		U64 lastTick = curTick;
+
+		// Advance first so timers re-armed by a callback land in a later tick.
+		curTick = nowTick;
+		if (nowTick - lastTick >= OPENAVB_AVDECC_LOOP_WHEEL_SLOTS) {
+			U32 slot;
+			for (slot = 0; slot < OPENAVB_AVDECC_LOOP_WHEEL_SLOTS; slot++) {
+				x_runSlot(slot, nowTick);
+			}
+		}
+		else {
+			U64 tick;
+			for (tick = lastTick + 1; tick <= nowTick; tick++) {
+				x_runSlot(tick & WHEEL_MASK, nowTick);
+			}
+		}
+	}
+	TIMER_UNLOCK();
+}
+
+// How long the loop may sleep before the next timer is due.
+static int x_waitMsec(void)
+{
+	U64 nowTick = x_nowTick();
+	U64 nextTick = 0;
+	U32 slot;
+
+	TIMER_LOCK();
+	for (slot = 0; slot < OPENAVB_AVDECC_LOOP_WHEEL_SLOTS; slot++) {
+		openavb_avdecc_loop_timer_t *pTimer;
+		for (pTimer = wheel[slot]; pTimer; pTimer = pTimer->next) {
+			if (!nextTick || pTimer->expires < nextTick)
+				nextTick = pTimer->expires;
+		}
+	}
+	TIMER_UNLOCK();
+
+	if (!nextTick)
+		return AVDECC_LOOP_MAX_WAIT_MSEC;
+	if (nextTick <= nowTick)
+		return 0;
+
+	U64 waitMsec = ((nextTick - nowTick) * OPENAVB_AVDECC_LOOP_TICK_USEC + MICROSECONDS_PER_MSEC - 1) / MICROSECONDS_PER_MSEC;
+	return waitMsec > AVDECC_LOOP_MAX_WAIT_MSEC ? AVDECC_LOOP_MAX_WAIT_MSEC : (int)waitMsec;
+}
+
+static void x_rxFrames(void)
+{
+	hdr_info_t hdrInfo;
+	unsigned int offset, len;
+	U8 *pBuf, *pFrame;
+	int i;
+
+	for (i = 0; i < AVDECC_LOOP_RX_BATCH; i++) {
+		pBuf = (U8 *)openavbRawsockGetRxFrame(rxSock, 0, &offset, &len);
+		if (!pBuf)
+			break;
+
+		pFrame = pBuf + offset;
+		memset(&hdrInfo, 0, sizeof(hdr_info_t));
+		offset = openavbRawsockRxParseHdr(rxSock, pBuf, &hdrInfo);
+#ifndef UBUNTU
+		if (hdrInfo.ethertype == ETHERTYPE_8021Q) {
+			// Oh!  Need to look past the VLAN tag
+			U16 vlan_bits = ntohs(*(U16 *)(pFrame + offset));
+			hdrInfo.vlan = TRUE;
+			hdrInfo.vlan_vid = vlan_bits & 0x0FFF;
+			hdrInfo.vlan_pcp = (vlan_bits >> 13) & 0x0007;
+			offset += 2;
+			hdrInfo.ethertype = ntohs(*(U16 *)(pFrame + offset));
+			offset += 2;
+		}
+#endif
+
+		if (hdrInfo.ethertype == ETHERTYPE_AVTP && len > offset) {
+			RX_LOCK();
+			openavb_avdecc_loop_rx_cb_t cb = rxHandlers[*(pFrame + offset)];
+			if (cb) {
+				cb(pFrame + offset, len - offset, &hdrInfo);
+			}
+			RX_UNLOCK();
+		}
+		else {
+			AVB_LOG_WARNING("Received non-AVTP frame!");
+			AVB_LOGF_DEBUG("Unexpected packet data (length %d):", len);
+			AVB_LOG_BUFFER(AVB_LOG_LEVEL_DEBUG, pFrame, len, 16);
+		}
+
+		// Release the frame
+		openavbRawsockRelRxFrame(rxSock, pBuf);
+	}
+}
+
+static void* openavbAvdeccLoopThreadFn(void *pv)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVDECC);
+
+	int rxFd = openavbRawsockGetSocket(rxSock);
+	struct epoll_event events[2];
+
+	AVB_LOG_DEBUG("AVDECC Event Loop Started");
+	while (bRunning) {
+		int nEvents = epoll_wait(epollFd, events, 2, x_waitMsec());
+		if (nEvents < 0 && errno != EINTR) {
+			AVB_LOGF_ERROR("epoll_wait failed: %s", strerror(errno));
+			break;
+		}
+
+		int i;
+		for (i = 0; i < nEvents; i++) {
+			if (events[i].data.fd == wakeFd) {
+				U64 count;
+				if (read(wakeFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+					AVB_LOGF_WARNING("Event loop wakeup read failed: %s", strerror(errno));
+				}
+			}
+			else if (events[i].data.fd == rxFd) {
+				x_rxFrames();
+			}
+		}
+
+		x_runTimers();
+	}
+	AVB_LOG_DEBUG("AVDECC Event Loop Done");
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+	return NULL;
+}
+
+static bool x_epollAdd(int fd)
+{
+	struct epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+		AVB_LOGF_ERROR("epoll_ctl failed: %s", strerror(errno));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void x_close(void)
+{
+	if (epollFd >= 0) {
+		close(epollFd);
+		epollFd = -1;
+	}
+	if (wakeFd >= 0) {
+		close(wakeFd);
+		wakeFd = -1;
+	}
+	if (rxSock) {
+		openavbRawsockClose(rxSock);
+		rxSock = NULL;
+	}
+}
+
+bool openavbAvdeccLoopStart(const char *ifname)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVDECC);
+
+	if (bRunning) {
+		AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+		return TRUE;
+	}
+
+	MUTEX_ATTR_HANDLE(mta);
+	MUTEX_ATTR_INIT(mta);
+	MUTEX_ATTR_SET_TYPE(mta, MUTEX_ATTR_TYPE_DEFAULT);
+	MUTEX_ATTR_SET_NAME(mta, "openavbAvdeccLoopRxMutex");
+	MUTEX_CREATE_ERR();
+	MUTEX_CREATE(openavbAvdeccLoopRxMutex, mta);
+	MUTEX_LOG_ERR("Could not create/initialize 'openavbAvdeccLoopRxMutex' mutex");
+	MUTEX_ATTR_SET_NAME(mta, "openavbAvdeccLoopTimerMutex");
+	MUTEX_CREATE(openavbAvdeccLoopTimerMutex, mta);
+	MUTEX_LOG_ERR("Could not create/initialize 'openavbAvdeccLoopTimerMutex' mutex");
+
+	memset(rxHandlers, 0, sizeof(rxHandlers));
+	memset(rxMcast, 0, sizeof(rxMcast));
+	memset(wheel, 0, sizeof(wheel));
+	curTick = x_nowTick();
+
+#ifndef UBUNTU
+	// This is the normal case for most of our supported platforms
+	rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_8021Q, AVDECC_LOOP_FRAME_LEN, AVDECC_LOOP_NUM_BUFFERS);
+#else
+	rxSock = openavbRawsockOpen(ifname, TRUE, FALSE, ETHERTYPE_AVTP, AVDECC_LOOP_FRAME_LEN, AVDECC_LOOP_NUM_BUFFERS);
+#endif
+	if (!rxSock) {
+		AVB_LOG_ERROR("Invalid socket");
+		x_close();
+		AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+		return FALSE;
+	}
+
+	int rxFd = openavbRawsockGetSocket(rxSock);
+	if (rxFd < 0) {
+		// The loop can only wait on a descriptor; leave the protocols on their own RX threads.
+		AVB_LOG_WARNING("Raw socket backend has no pollable descriptor; AVDECC event loop disabled, using per-protocol threads");
+		x_close();
+		MUTEX_CREATE_ERR();
+		MUTEX_DESTROY(openavbAvdeccLoopRxMutex);
+		MUTEX_LOG_ERR("Error destroying mutex");
+		MUTEX_DESTROY(openavbAvdeccLoopTimerMutex);
+		MUTEX_LOG_ERR("Error destroying mutex");
+		AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+		return TRUE;
+	}
+
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (epollFd < 0 || wakeFd < 0
+		|| !x_epollAdd(wakeFd)
+		|| !x_epollAdd(rxFd)) {
+		AVB_LOGF_ERROR("Unable to set up the AVDECC event loop: %s", strerror(errno));
+		x_close();
+		AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+		return FALSE;
+	}
+
+	bool errResult;
+	bRunning = TRUE;
+	THREAD_CREATE(openavbAvdeccLoopThread, openavbAvdeccLoopThread, NULL, openavbAvdeccLoopThreadFn, NULL);
+	THREAD_CHECK_ERROR(openavbAvdeccLoopThread, "Thread / task creation failed", errResult);
+	if (errResult) {
+		bRunning = FALSE;
+		x_close();
+		AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+		return FALSE;
+	}
+	loopThreadId = openavbAvdeccLoopThread_ThreadData.pthread;
+
+	AVB_LOG_INFO("AVDECC event loop started");
+	AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+	return TRUE;
+}
+
+void openavbAvdeccLoopStop(void)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVDECC);
+
+	if (bRunning) {
+		bRunning = FALSE;
+		x_wake();
+		THREAD_JOIN(openavbAvdeccLoopThread, NULL);
+		x_close();
+
+		MUTEX_CREATE_ERR();
+		MUTEX_DESTROY(openavbAvdeccLoopRxMutex);
+		MUTEX_LOG_ERR("Error destroying mutex");
+		MUTEX_DESTROY(openavbAvdeccLoopTimerMutex);
+		MUTEX_LOG_ERR("Error destroying mutex");
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+}
+
+bool openavbAvdeccLoopRunning(void)
+{
+	return bRunning;
+}
+
+bool openavbAvdeccLoopRegisterRx(U8 subtype, openavb_avdecc_loop_rx_cb_t cb)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVDECC);
+
+	if (!bRunning) {
+		AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+		return FALSE;
+	}
+
+	// Taking the RX mutex waits out a handler that is currently running.
+	RX_LOCK();
+	if (cb && rxHandlers[subtype] && rxHandlers[subtype] != cb) {
+		RX_UNLOCK();
+		AVB_LOGF_ERROR("AVTP subtype 0x%02x already has a handler", subtype);
+		AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+		return FALSE;
+	}
+	rxHandlers[subtype] = cb;
+	RX_UNLOCK();
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+	return TRUE;
+}
+
+bool openavbAvdeccLoopRxMulticast(bool add, const U8 addr[ETH_ALEN])
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_AVDECC);
+
+	if (!bRunning) {
+		AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+		return FALSE;
+	}
+
+	bool ret = TRUE;
+	avdecc_loop_mcast_t *pFree = NULL, *pEntry = NULL;
+	int i;
+
+	RX_LOCK();
+	for (i = 0; i < AVDECC_LOOP_MAX_MCAST; i++) {
+		if (rxMcast[i].refs == 0) {
+			if (!pFree)
+				pFree = &rxMcast[i];
+		}
+		else if (memcmp(rxMcast[i].addr, addr, ETH_ALEN) == 0) {
+			pEntry = &rxMcast[i];
+			break;
+		}
+	}
+
+	if (add) {
+		if (pEntry) {
+			pEntry->refs++;
+		}
+		else if (!pFree) {
+			AVB_LOG_ERROR("Too many AVDECC RX addresses");
+			ret = FALSE;
+		}
+		else if (openavbRawsockRxMulticast(rxSock, TRUE, addr)) {
+			memcpy(pFree->addr, addr, ETH_ALEN);
+			pFree->refs = 1;
+		}
+		else {
+			ret = FALSE;
+		}
+	}
+	else if (pEntry && --pEntry->refs == 0) {
+		ret = openavbRawsockRxMulticast(rxSock, FALSE, addr);
+	}
+	RX_UNLOCK();
+
+	AVB_TRACE_EXIT(AVB_TRACE_AVDECC);
+	return ret;
+}
+
+void openavbAvdeccLoopTimerInit(openavb_avdecc_loop_timer_t *pTimer, openavb_avdecc_loop_timer_cb_t cb, void *arg)
+{
+	memset(pTimer, 0, sizeof(*pTimer));
+	pTimer->cb = cb;
+	pTimer->arg = arg;
+}
+
+void openavbAvdeccLoopTimerStart(openavb_avdecc_loop_timer_t *pTimer, U32 timeoutUsec)
+{
+	// A timer that has not been initialized yet is ignored.
+	if (!bRunning || !pTimer->cb)
+		return;
+
+	U64 ticks = (timeoutUsec + OPENAVB_AVDECC_LOOP_TICK_USEC - 1) / OPENAVB_AVDECC_LOOP_TICK_USEC;
+
+	TIMER_LOCK();
+	x_timerUnlink(pTimer);
+	pTimer->expires = x_nowTick() + ticks;
+	// The slot of curTick has already been processed, such as for a zero timeout started by
+	// a handler of the current tick. Linking there would delay the timer a full turn of the wheel.
+	if (pTimer->expires <= curTick)
+		pTimer->expires = curTick + 1;
+	x_timerLink(pTimer);
+	TIMER_UNLOCK();
+
+	if (!x_onLoopThread()) {
+		// The loop may be sleeping past the new deadline.
+		x_wake();
+	}
+}
+
+void openavbAvdeccLoopTimerCancel(openavb_avdecc_loop_timer_t *pTimer)
+{
+	if (!bRunning)
+		return;
+
+	TIMER_LOCK();
+	x_timerUnlink(pTimer);
+	if (!x_onLoopThread()) {
+		while (pRunningTimer == pTimer) {
+			pthread_cond_wait(&timerDoneCond, &openavbAvdeccLoopTimerMutex);
+		}
+	}
+	TIMER_UNLOCK();
+}
@@ -98,6 +98,18 @@ GstFlowReturn gst_al_push_buffer(GstAppSrc *src, GstAlBuf *buf);
  * \return - a newly allocated buffer
  */
 GstAlBuf* gst_al_alloc_buffer(gint len);
+/**
+ * \brief - wraps memory in a buffer without copying it
+ *
+ * \param data - memory to wrap, must stay valid until notify is called
+ * \param len - length of the memory
+ * \param notify - called with user_data once the buffer is freed,
+ *                 or before returning if wrapping fails
+ * \param user_data - passed to notify
+ *
+ * \return - a buffer referencing data
+ */
+GstAlBuf* gst_al_wrap_buffer(gpointer data, guint len, GDestroyNotify notify, gpointer user_data);
 /**
  * \brief - unrefs a buffer
  *
@@ -162,6 +174,21 @@ GstFlowReturn gst_al_push_rtp_buffer(GstAppSrc *src, GstAlBuf *buf);
  * \return - a newly allocated RTP buffer
  */
 GstAlBuf* gst_al_alloc_rtp_buffer(guint packet_len, guint8 pad_len, guint8 csrc_count);
+/**
+ * \brief - allocates a RTP buffer whose payload references memory without copying it
+ *
+ * Only the RTP header is allocated. With gstreamer 0.10 the payload is copied
+ * and notify is called right away.
+ *
+ * \param data - payload to wrap, must stay valid until notify is called
+ * \param len - length of the payload
+ * \param notify - called with user_data once the buffer is freed,
+ *                 or before returning if wrapping fails
+ * \param user_data - passed to notify
+ *
+ * \return - a RTP buffer referencing data
+ */
+GstAlBuf* gst_al_wrap_rtp_buffer(gpointer data, guint len, GDestroyNotify notify, gpointer user_data);
 /**
  * \brief - unrefs a RTP buffer
  *
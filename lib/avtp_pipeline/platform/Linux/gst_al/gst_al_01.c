@@ -34,6 +34,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
  *  for version 0.10
  */
 
+#include <string.h>
 #include "gst_al.h"
 
 void gst_al_set_callback(GstAppSinkCallbacks *cbfns, GstAlCallback callback)
@@ -59,6 +60,21 @@ GstAlBuf* gst_al_alloc_buffer(gint len)
 	return buf;
 }
 
+GstAlBuf* gst_al_wrap_buffer(gpointer data, guint len, GDestroyNotify notify, gpointer user_data)
+{
+	GstAlBuf *buf = g_new(GstAlBuf,1);
+	buf->m_buffer = gst_buffer_new();
+	GST_BUFFER_DATA(buf->m_buffer) = data;
+	GST_BUFFER_SIZE(buf->m_buffer) = len;
+	// Called with the malloc data when the buffer is finalized
+	GST_BUFFER_MALLOCDATA(buf->m_buffer) = user_data;
+	GST_BUFFER_FREE_FUNC(buf->m_buffer) = notify;
+	GST_BUFFER_FLAG_SET(buf->m_buffer, GST_BUFFER_FLAG_READONLY);
+	buf->m_dptr = data;
+	buf->m_dlen = len;
+	return buf;
+}
+
 GstFlowReturn gst_al_push_buffer(GstAppSrc *src, GstAlBuf *buf)
 {
 	GstFlowReturn gstret = gst_app_src_push_buffer(src, buf->m_buffer);
@@ -117,6 +133,16 @@ GstAlBuf* gst_al_alloc_rtp_buffer(guint payload_len, guint8 pad_len, guint8 csrc
 	return buf;
 }
 
+GstAlBuf* gst_al_wrap_rtp_buffer(gpointer data, guint len, GDestroyNotify notify, gpointer user_data)
+{
+	// 0.10 RTP buffers are a single block, so the payload is copied
+	GstAlBuf *buf = gst_al_alloc_rtp_buffer(len, 0, 0);
+	memcpy(buf->m_dptr, data, len);
+	if(notify)
+		notify(user_data);
+	return buf;
+}
+
 void gst_al_rtp_buffer_unref(GstAlBuf *buf)
 {
 	gst_buffer_unref(buf->m_buffer);
@@ -104,20 +104,47 @@ alloc_success:
 	return buf;
 }
 
+GstAlBuf* gst_al_wrap_buffer(gpointer data, guint len, GDestroyNotify notify, gpointer user_data)
+{
+	GstAlBuf *buf = g_new0(GstAlBuf,1);
+	GstBuffer *buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY, data, len, 0, len, user_data, notify);
+	buf->m_buffer = buffer;
+	if(buffer)
+	{
+		buf->m_dptr = data;
+		buf->m_dlen = len;
+		return buf;
+	}
+	if(notify)
+		notify(user_data);
+	g_free(buf);
+	return NULL;
+}
+
 GstFlowReturn gst_al_push_buffer(GstAppSrc *src, GstAlBuf *buf)
 {
+	// Wrapped buffers are not mapped
+	if(buf->m_memory)
+	{
+		gst_memory_unmap(buf->m_memory, &buf->m_info);
+		gst_memory_unref(buf->m_memory);
+	}
 	GstFlowReturn gstret = gst_app_src_push_buffer(src, buf->m_buffer);
-	gst_memory_unmap(buf->m_memory, &buf->m_info);
-	gst_memory_unref(buf->m_memory);
 	g_free(buf);
 	return gstret;
 }
 
 void gst_al_buffer_unref(GstAlBuf *buf)
 {
-	gst_memory_unmap(buf->m_memory, &buf->m_info);
-	gst_memory_unref(buf->m_memory);
-	gst_sample_unref(buf->m_sample);
+	if(buf->m_memory)
+	{
+		gst_memory_unmap(buf->m_memory, &buf->m_info);
+		gst_memory_unref(buf->m_memory);
+	}
+	if(buf->m_sample)
+		gst_sample_unref(buf->m_sample);
+	else
+		gst_buffer_unref(buf->m_buffer);
 	g_free(buf);
 }
 
@@ -175,6 +202,34 @@ alloc_rtp_success:
 	return buf;
 }
 
+GstAlBuf* gst_al_wrap_rtp_buffer(gpointer data, guint len, GDestroyNotify notify, gpointer user_data)
+{
+	GstAlBuf *buf = g_new0(GstAlBuf, 1);
+	GstBuffer *buffer = gst_rtp_buffer_new_allocate(0, 0, 0);
+	buf->m_buffer = buffer;
+	if(buffer)
+	{
+		// The RTP buffer only maps the header memory, the payload memory is never touched
+		gst_buffer_append_memory(buffer,
+			gst_memory_new_wrapped(GST_MEMORY_FLAG_READONLY, data, len, 0, len, user_data, notify));
+		GstRTPBuffer *rtpbuf = &buf->m_rtpbuf;
+		if( gst_rtp_buffer_map(buffer, GST_MAP_WRITE, rtpbuf))
+		{
+			buf->m_dptr = data;
+			buf->m_dlen = len;
+			return buf;
+		}
+		// Frees the wrapped memory, which calls notify
+		gst_buffer_unref(buffer);
+	}
+	else if(notify)
+	{
+		notify(user_data);
+	}
+	g_free(buf);
+	return NULL;
+}
+
 gboolean gst_al_rtp_buffer_get_marker(GstAlBuf *buf)
 {
 	return gst_rtp_buffer_get_marker(&buf->m_rtpbuf);
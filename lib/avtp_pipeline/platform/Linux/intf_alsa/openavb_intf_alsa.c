@@ -36,6 +36,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 #include "openavb_types_pub.h"
 #include "openavb_audio_pub.h"
 #include "openavb_trace_pub.h"
@@ -44,6 +45,9 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_map_aaf_audio_pub.h"
 #include "openavb_intf_pub.h"
 #include "openavb_mcs.h"
+#include "openavb_audio_conv_pub.h"
+#include "openavb_asrc_pub.h"
+#include "openavb_mcr_hal_pub.h"
 
 #define	AVB_LOG_COMPONENT	"ALSA Interface"
 #include "openavb_log_pub.h"
@@ -53,6 +57,15 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 
 #define PCM_DEVICE_NAME_DEFAULT	"default"
 #define PCM_ACCESS_TYPE			SND_PCM_ACCESS_RW_INTERLEAVED
+#define PCM_ACCESS_TYPE_MMAP	SND_PCM_ACCESS_MMAP_INTERLEAVED
+
+// Listener sample rate converter steering. The frames buffered between the media queue
+// and the DAC are smoothed over ASRC_LEVEL_SEC and, once playback has run for
+// ASRC_SETTLE_SEC, held at that level by working off any error over about ASRC_STEER_SEC.
+#define ASRC_SETTLE_SEC			2.0
+#define ASRC_LEVEL_SEC			0.5
+#define ASRC_STEER_SEC			10.0
+#define ASRC_MAX_PPM			1000.0
 
 typedef struct {
 	/////////////
@@ -86,12 +99,33 @@ typedef struct {
 
 	U32 periodTimeUsec;
 
+	// intf_nv_access: copy samples through the mmap'ed ALSA buffer instead of readi/writei
+	bool mmapAccess;
+
 	/////////////
 	// Variable data
 	/////////////
 	// Handle for the PCM device
 	snd_pcm_t *pcmHandle;
 
+	// Sample format, bytes per frame and frames in the ALSA buffer
+	snd_pcm_format_t pcmFormat;
+	U32 pcmFrameBytes;
+	snd_pcm_uframes_t pcmBufferFrames;
+	// Frames that start playback with mmap access when not started at a presentation time
+	snd_pcm_uframes_t pcmStartFrames;
+
+	// Listener with mmap access and timestamps: playback is started at the first presentation time
+	bool timedStart;
+	bool pcmStarted;
+	// Start error measured from the ALSA timestamps and corrected
+	bool pcmStartChecked;
+	// Presentation time of the first item frame, the silence written ahead of it
+	// and the frames written since playback started
+	U64 pcmStartNSec;
+	U32 pcmStartLead;
+	U64 pcmWrittenFrames;
+
 	// ALSA stream
 	snd_pcm_stream_t pcmStream;
 
@@ -106,6 +140,32 @@ typedef struct {
 
 	// Use Media Clock Synth module instead of timestamps taken during Tx callback
 	bool fixedTimestampEnabled;
+
+	// intf_nv_asrc: resample in the listener to follow the talker media clock
+	bool asrcEnabled;
+
+	// intf_nv_asrc_quality
+	openavb_asrc_quality_t asrcQuality;
+
+	// Listener sample rate converter, created for the first item
+	openavb_asrc_t *pAsrc;
+	// PCM sample size, 0 for float, and whether the samples are byte swapped
+	U32 asrcSampleBytes;
+	bool asrcSwap;
+	U32 asrcItemFrames;
+	float *pAsrcIn;
+	float *pAsrcOut;
+	U8 *pAsrcPcm;
+	// Input item in host order when the samples are byte swapped
+	U8 *pAsrcSwapped;
+
+	// Smoothed frames buffered ahead of the DAC, the level to hold (0 while settling)
+	// and the integral of the error, in frame seconds
+	double asrcLevel;
+	double asrcTarget;
+	double asrcIntegral;
+	// Output frames since playback (re)started
+	U64 asrcFrames;
 } pvt_data_t;
 
 
@@ -395,6 +455,31 @@ void openavbIntfAlsaCfgCB(media_q_t *pMediaQ, const char *name, const char *valu
 			pPvtData->clockSkewPPB = strtol(value, &pEnd, 10);
 		}
 
+		else if (strcmp(name, "intf_nv_access") == 0) {
+			if (strcmp(value, "mmap") == 0) {
+				pPvtData->mmapAccess = TRUE;
+			}
+			else if (strcmp(value, "rw") == 0) {
+				pPvtData->mmapAccess = FALSE;
+			}
+			else {
+				AVB_LOG_ERROR("Invalid value for intf_nv_access, expected rw or mmap.");
+			}
+		}
+
+		else if (strcmp(name, "intf_nv_asrc") == 0) {
+			tmp = strtol(value, &pEnd, 10);
+			if (*pEnd == '\0') {
+				pPvtData->asrcEnabled = (tmp == 1);
+			}
+		}
+
+		else if (strcmp(name, "intf_nv_asrc_quality") == 0) {
+			if (!openavbAsrcQualityFromName(value, &pPvtData->asrcQuality)) {
+				AVB_LOG_ERROR("Invalid value for intf_nv_asrc_quality, expected low, medium or high.");
+			}
+		}
+
 	}
 
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
@@ -467,7 +552,7 @@ void openavbIntfAlsaTxInitCB(media_q_t *pMediaQ)
 		}
 
 		// Set the access type
-		rslt = snd_pcm_hw_params_set_access(pPvtData->pcmHandle, hwParams, PCM_ACCESS_TYPE);
+		rslt = snd_pcm_hw_params_set_access(pPvtData->pcmHandle, hwParams, pPvtData->mmapAccess ? PCM_ACCESS_TYPE_MMAP : PCM_ACCESS_TYPE);
 		if (rslt < 0) {
 			AVB_LOGF_ERROR("snd_pcm_hw_params_set_access() error: %s", snd_strerror(rslt));
 			snd_pcm_close(pPvtData->pcmHandle);
@@ -493,6 +578,7 @@ void openavbIntfAlsaTxInitCB(media_q_t *pMediaQ)
 			AVB_TRACE_EXIT(AVB_TRACE_INTF);
 			return;
 		}
+		pPvtData->pcmFormat = fmt;
 
 		// Set the sample rate
 		U32 rate = pPvtData->audioRate;
@@ -537,6 +623,7 @@ void openavbIntfAlsaTxInitCB(media_q_t *pMediaQ)
 		// Free the hardware parameters
 		snd_pcm_hw_params_free(hwParams);
 		hwParams = NULL;
+		pPvtData->pcmFrameBytes = snd_pcm_frames_to_bytes(pPvtData->pcmHandle, 1);
 
 		// Get ready for playback
 		rslt = snd_pcm_prepare(pPvtData->pcmHandle);
@@ -565,6 +652,60 @@ void openavbIntfAlsaTxInitCB(media_q_t *pMediaQ)
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
 }
 
+// Address of the frame at offset in an interleaved mmap area
+static U8 *x_areaFrame(const snd_pcm_channel_area_t *pAreas, snd_pcm_uframes_t offset)
+{
+	return (U8 *)pAreas[0].addr + (pAreas[0].first + offset * pAreas[0].step) / 8;
+}
+
+// Read up to frames captured frames into pData. With mmap access they are copied straight
+// from the DMA area. Returns frames read or a negative error, -EAGAIN when none are ready.
+static S32 x_pcmRead(pvt_data_t *pPvtData, U8 *pData, U32 frames)
+{
+	if (!pPvtData->mmapAccess) {
+		return snd_pcm_readi(pPvtData->pcmHandle, pData, frames);
+	}
+
+	// Direct access never starts the stream itself, such as after recovering from an overrun
+	if (snd_pcm_state(pPvtData->pcmHandle) == SND_PCM_STATE_PREPARED) {
+		S32 rslt = snd_pcm_start(pPvtData->pcmHandle);
+		if (rslt < 0) {
+			return rslt;
+		}
+	}
+
+	snd_pcm_sframes_t avail = snd_pcm_avail_update(pPvtData->pcmHandle);
+	if (avail < 0) {
+		return avail;
+	}
+	if (avail == 0) {
+		return -EAGAIN;
+	}
+	if ((snd_pcm_uframes_t)avail < frames) {
+		frames = avail;
+	}
+
+	U32 done = 0;
+	while (done < frames) {
+		const snd_pcm_channel_area_t *pAreas;
+		snd_pcm_uframes_t offset, n = frames - done;
+		S32 rslt = snd_pcm_mmap_begin(pPvtData->pcmHandle, &pAreas, &offset, &n);
+		if (rslt < 0) {
+			return done ? (S32)done : rslt;
+		}
+		memcpy(pData + done * pPvtData->pcmFrameBytes, x_areaFrame(pAreas, offset), n * pPvtData->pcmFrameBytes);
+		snd_pcm_sframes_t committed = snd_pcm_mmap_commit(pPvtData->pcmHandle, offset, n);
+		if (committed < 0) {
+			return done ? (S32)done : (S32)committed;
+		}
+		done += committed;
+		if ((snd_pcm_uframes_t)committed != n) {
+			break;
+		}
+	}
+	return done;
+}
+
 // This callback will be called for each AVB transmit interval.
 bool openavbIntfAlsaTxCB(media_q_t *pMediaQ)
 {
@@ -597,22 +738,22 @@ bool openavbIntfAlsaTxCB(media_q_t *pMediaQ)
 					return FALSE;
 				}
 
-				rslt = snd_pcm_readi(pPvtData->pcmHandle, pMediaQItem->pPubData + pMediaQItem->dataLen, pPubMapUncmpAudioInfo->framesPerItem - (pMediaQItem->dataLen / pPubMapUncmpAudioInfo->itemFrameSizeBytes));
+				rslt = x_pcmRead(pPvtData, pMediaQItem->pPubData + pMediaQItem->dataLen, pPubMapUncmpAudioInfo->framesPerItem - (pMediaQItem->dataLen / pPubMapUncmpAudioInfo->itemFrameSizeBytes));
 
 				if (rslt < 0) {
 					switch(rslt) {
 					case -EPIPE:
-						AVB_LOGF_ERROR("snd_pcm_readi() error: %s", snd_strerror(rslt));
+						AVB_LOGF_ERROR("ALSA capture error: %s", snd_strerror(rslt));
 						rslt = snd_pcm_recover(pPvtData->pcmHandle, rslt, 0);
 						if (rslt < 0) {
 							AVB_LOGF_ERROR("snd_pcm_recover: %s", snd_strerror(rslt));
 						}
 						break;
 					case -EAGAIN:
-						{ IF_LOG_INTERVAL(1000) AVB_LOG_DEBUG("snd_pcm_readi() had no data available"); }
+						{ IF_LOG_INTERVAL(1000) AVB_LOG_DEBUG("ALSA capture had no data available"); }
 						break;
 					default:
-						AVB_LOGF_ERROR("Unhandled snd_pcm_readi() error: %s", snd_strerror(rslt));
+						AVB_LOGF_ERROR("Unhandled ALSA capture error: %s", snd_strerror(rslt));
 						break;
 					}
 
@@ -710,7 +851,7 @@ void openavbIntfAlsaRxInitCB(media_q_t *pMediaQ)
 		}
 
 		// Set the access type
-		rslt = snd_pcm_hw_params_set_access(pPvtData->pcmHandle, hwParams, PCM_ACCESS_TYPE);
+		rslt = snd_pcm_hw_params_set_access(pPvtData->pcmHandle, hwParams, pPvtData->mmapAccess ? PCM_ACCESS_TYPE_MMAP : PCM_ACCESS_TYPE);
 		if (rslt < 0) {
 			AVB_LOGF_ERROR("snd_pcm_hw_params_set_access() error: %s", snd_strerror(rslt));
 			snd_pcm_close(pPvtData->pcmHandle);
@@ -736,6 +877,7 @@ void openavbIntfAlsaRxInitCB(media_q_t *pMediaQ)
 			AVB_TRACE_EXIT(AVB_TRACE_INTF);
 			return;
 		}
+		pPvtData->pcmFormat = fmt;
 
 		// Set the sample rate
 		U32 rate = pPvtData->audioRate;
@@ -765,6 +907,25 @@ void openavbIntfAlsaRxInitCB(media_q_t *pMediaQ)
 			return;
 		}
 
+		if (pPvtData->asrcEnabled) {
+			// The converter works on floats, so the samples must be in a layout the audio conversions handle
+			pPvtData->asrcSwap = FALSE;
+			if (snd_pcm_format_float(fmt) && snd_pcm_format_physical_width(fmt) == 32 && snd_pcm_format_cpu_endian(fmt)) {
+				pPvtData->asrcSampleBytes = 0;
+			}
+			else if (snd_pcm_format_signed(fmt) == 1
+					&& snd_pcm_format_width(fmt) == snd_pcm_format_physical_width(fmt)
+					&& snd_pcm_format_width(fmt) >= 16) {
+				// Either byte order, samples are swapped around the conversion when needed
+				pPvtData->asrcSampleBytes = snd_pcm_format_width(fmt) / 8;
+				pPvtData->asrcSwap = !snd_pcm_format_cpu_endian(fmt);
+			}
+			else {
+				AVB_LOG_ERROR("Sample rate converter needs signed 16, 24 or 32 bit or host order float samples, disabled");
+				pPvtData->asrcEnabled = FALSE;
+			}
+		}
+
 
 		// Time based buffer and period setup
 		int dir;
@@ -868,6 +1029,8 @@ void openavbIntfAlsaRxInitCB(media_q_t *pMediaQ)
 		// Free the hardware parameters
 		snd_pcm_hw_params_free(hwParams);
 		hwParams = NULL;
+		pPvtData->pcmFrameBytes = snd_pcm_frames_to_bytes(pPvtData->pcmHandle, 1);
+		pPvtData->pcmBufferFrames = buffer_size;
 
 
 		// Set software parameters
@@ -895,7 +1058,17 @@ void openavbIntfAlsaRxInitCB(media_q_t *pMediaQ)
 			return;
 		}
 
-		rslt = snd_pcm_sw_params_set_start_threshold(pPvtData->pcmHandle, swParams, period_size * pPvtData->startThresholdPeriods);
+		// With timestamps and mmap access playback is started at the first presentation time,
+		// so the threshold is set out of reach. Otherwise it starts once enough frames are written.
+		pPvtData->timedStart = pPvtData->mmapAccess && !pPvtData->ignoreTimestamp;
+		snd_pcm_uframes_t startThreshold = period_size * pPvtData->startThresholdPeriods;
+		// The start threshold only applies to writei, mmap commits are started by x_pcmMmapWrite()
+		pPvtData->pcmStartFrames = startThreshold < buffer_size ? startThreshold : buffer_size;
+		if (pPvtData->timedStart) {
+			snd_pcm_sw_params_get_boundary(swParams, &startThreshold);
+		}
+
+		rslt = snd_pcm_sw_params_set_start_threshold(pPvtData->pcmHandle, swParams, startThreshold);
 		if (rslt < 0) {
 			AVB_LOGF_ERROR("snd_pcm_sw_params_set_start_threshold error(): %s", snd_strerror(rslt));
 			snd_pcm_close(pPvtData->pcmHandle);
@@ -928,6 +1101,31 @@ void openavbIntfAlsaRxInitCB(media_q_t *pMediaQ)
 			return;
 		}
 
+		if (pPvtData->timedStart) {
+			// Timestamps of the hardware pointer tell when the first frame was really heard
+			rslt = snd_pcm_sw_params_set_tstamp_mode(pPvtData->pcmHandle, swParams, SND_PCM_TSTAMP_ENABLE);
+			if (rslt < 0) {
+				AVB_LOGF_ERROR("snd_pcm_sw_params_set_tstamp_mode error(): %s", snd_strerror(rslt));
+				snd_pcm_close(pPvtData->pcmHandle);
+				pPvtData->pcmHandle = NULL;
+				snd_pcm_sw_params_free(swParams);
+				swParams = NULL;
+				AVB_TRACE_EXIT(AVB_TRACE_INTF);
+				return;
+			}
+
+			rslt = snd_pcm_sw_params_set_tstamp_type(pPvtData->pcmHandle, swParams, SND_PCM_TSTAMP_TYPE_MONOTONIC);
+			if (rslt < 0) {
+				AVB_LOGF_ERROR("snd_pcm_sw_params_set_tstamp_type error(): %s", snd_strerror(rslt));
+				snd_pcm_close(pPvtData->pcmHandle);
+				pPvtData->pcmHandle = NULL;
+				snd_pcm_sw_params_free(swParams);
+				swParams = NULL;
+				AVB_TRACE_EXIT(AVB_TRACE_INTF);
+				return;
+			}
+		}
+
 		rslt = snd_pcm_sw_params(pPvtData->pcmHandle, swParams);
 		if (rslt < 0) {
 			AVB_LOGF_ERROR("snd_pcm_sw_params error(): %s", snd_strerror(rslt));
@@ -964,6 +1162,369 @@ void openavbIntfAlsaRxInitCB(media_q_t *pMediaQ)
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
 }
 
+// Copy frames straight into the DMA area. Float samples in pFloat are converted on the way
+// and silence is written when there is no data at all. Waits for room while playback runs.
+// Returns frames written or a negative error.
+static S32 x_pcmMmapWrite(pvt_data_t *pPvtData, const U8 *pData, const float *pFloat, U32 frames)
+{
+	U32 channels = pPvtData->audioChannels;
+	U32 done = 0;
+
+	while (done < frames) {
+		snd_pcm_sframes_t avail = snd_pcm_avail_update(pPvtData->pcmHandle);
+		if (avail < 0) {
+			return done ? (S32)done : (S32)avail;
+		}
+		if (avail == 0) {
+			if (snd_pcm_state(pPvtData->pcmHandle) != SND_PCM_STATE_RUNNING) {
+				// Full and not started, nothing will make room
+				break;
+			}
+			S32 rslt = snd_pcm_wait(pPvtData->pcmHandle, 1000);
+			if (rslt < 0) {
+				return done ? (S32)done : rslt;
+			}
+			continue;
+		}
+
+		const snd_pcm_channel_area_t *pAreas;
+		snd_pcm_uframes_t offset, n = frames - done;
+		if (n > (snd_pcm_uframes_t)avail) {
+			n = avail;
+		}
+		S32 rslt = snd_pcm_mmap_begin(pPvtData->pcmHandle, &pAreas, &offset, &n);
+		if (rslt < 0) {
+			return done ? (S32)done : rslt;
+		}
+		if (pFloat) {
+			openavbAudioConvFloatToInt(x_areaFrame(pAreas, offset), pPvtData->asrcSampleBytes, pFloat + done * channels, n * channels);
+		}
+		else if (pData) {
+			memcpy(x_areaFrame(pAreas, offset), pData + done * pPvtData->pcmFrameBytes, n * pPvtData->pcmFrameBytes);
+		}
+		else {
+			snd_pcm_areas_silence(pAreas, offset, channels, n, pPvtData->pcmFormat);
+		}
+		snd_pcm_sframes_t committed = snd_pcm_mmap_commit(pPvtData->pcmHandle, offset, n);
+		if (committed < 0) {
+			return done ? (S32)done : (S32)committed;
+		}
+		done += committed;
+		pPvtData->pcmWrittenFrames += committed;
+		if (!pPvtData->timedStart && (snd_pcm_uframes_t)(avail - committed) <= pPvtData->pcmBufferFrames - pPvtData->pcmStartFrames
+				&& snd_pcm_state(pPvtData->pcmHandle) == SND_PCM_STATE_PREPARED) {
+			// The start threshold is reached
+			rslt = snd_pcm_start(pPvtData->pcmHandle);
+			if (rslt < 0) {
+				return done ? (S32)done : rslt;
+			}
+		}
+		if ((snd_pcm_uframes_t)committed != n) {
+			break;
+		}
+	}
+	return done;
+}
+
+static S32 x_pcmWriteOnce(pvt_data_t *pPvtData, const void *pData, const float *pFloat, U32 frames)
+{
+	if (pPvtData->mmapAccess) {
+		return x_pcmMmapWrite(pPvtData, pData, pFloat, frames);
+	}
+	return snd_pcm_writei(pPvtData->pcmHandle, pData, frames);
+}
+
+// Write frames, recovering once from an underrun. pFloat may only be used with mmap access,
+// see x_pcmMmapWrite(). Returns frames written or a negative error.
+static S32 x_pcmWrite(pvt_data_t *pPvtData, const void *pData, const float *pFloat, U32 frames)
+{
+	S32 rslt = x_pcmWriteOnce(pPvtData, pData, pFloat, frames);
+	if (rslt < 0) {
+		AVB_LOGF_ERROR("ALSA playback error: %s", snd_strerror(rslt));
+		rslt = snd_pcm_recover(pPvtData->pcmHandle, rslt, 0);
+		if (rslt < 0) {
+			AVB_LOGF_ERROR("snd_pcm_recover: %s", snd_strerror(rslt));
+		}
+		// Playback restarts from an empty buffer, so settle on a new level
+		pPvtData->asrcFrames = 0;
+		pPvtData->asrcTarget = 0;
+		if (pPvtData->timedStart) {
+			// Start again at the presentation time of a later item
+			pPvtData->pcmStarted = FALSE;
+			return rslt < 0 ? rslt : 0;
+		}
+		rslt = x_pcmWriteOnce(pPvtData, pData, pFloat, frames);
+	}
+	return rslt;
+}
+
+// Give up on a timed start, the next item tries again
+static void x_pcmTimedStartReset(pvt_data_t *pPvtData)
+{
+	snd_pcm_drop(pPvtData->pcmHandle);
+	snd_pcm_prepare(pPvtData->pcmHandle);
+	pPvtData->pcmStarted = FALSE;
+}
+
+// Get playback ready to start so the item is heard at its presentation time, with silence
+// covering the time until then. Returns the leading frames of the item to drop because they
+// are already late, or -1 when the item is still too far ahead to start. Once the rest of the
+// item is written x_pcmTimedStartRun() starts the stream.
+static S32 x_pcmTimedStart(media_q_t *pMediaQ, pvt_data_t *pPvtData, media_q_item_t *pMediaQItem)
+{
+	media_q_pub_map_uncmp_audio_info_t *pPubMapUncmpAudioInfo = pMediaQ->pPubMapInfo;
+	U32 framesPerItem = pPubMapUncmpAudioInfo->framesPerItem;
+	U64 presNSec = openavbAvtpTimeGetAvtpTimeNS(pMediaQItem->pAvtpTime);
+	U64 nowNSec;
+	U32 skip = 0, lead = 0;
+
+	CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &nowNSec);
+	if (presNSec < nowNSec) {
+		U64 late = (nowNSec - presNSec) * pPvtData->audioRate / NANOSECONDS_PER_SECOND;
+		if (late >= framesPerItem) {
+			return framesPerItem;
+		}
+		skip = late;
+	}
+	else {
+		U64 ahead = (presNSec - nowNSec) * pPvtData->audioRate / NANOSECONDS_PER_SECOND;
+		if (ahead + framesPerItem > pPvtData->pcmBufferFrames) {
+			return -1;
+		}
+		lead = ahead;
+	}
+
+	pPvtData->pcmWrittenFrames = 0;
+	if (lead && x_pcmMmapWrite(pPvtData, NULL, NULL, lead) != (S32)lead) {
+		AVB_LOG_ERROR("Unable to write the silence ahead of playback");
+		x_pcmTimedStartReset(pPvtData);
+		return -1;
+	}
+
+	pPvtData->pcmStartNSec = presNSec + (U64)skip * NANOSECONDS_PER_SECOND / pPvtData->audioRate;
+	pPvtData->pcmStartLead = lead;
+	return skip;
+}
+
+// Start the playback prepared by x_pcmTimedStart(). Only done once the item is in the buffer
+// behind the silence; with no lead or a late item the buffer would otherwise be empty and
+// the stream would stop with an underrun right away.
+static void x_pcmTimedStartRun(pvt_data_t *pPvtData)
+{
+	snd_pcm_sframes_t avail = snd_pcm_avail_update(pPvtData->pcmHandle);
+	if (avail < 0 || (snd_pcm_uframes_t)avail + pPvtData->pcmStartLead >= pPvtData->pcmBufferFrames) {
+		AVB_LOG_ERROR("Unable to write the first item ahead of playback");
+		x_pcmTimedStartReset(pPvtData);
+		return;
+	}
+
+	S32 rslt = snd_pcm_start(pPvtData->pcmHandle);
+	if (rslt < 0) {
+		AVB_LOGF_ERROR("snd_pcm_start: %s", snd_strerror(rslt));
+		x_pcmTimedStartReset(pPvtData);
+		return;
+	}
+
+	pPvtData->pcmStarted = TRUE;
+	pPvtData->pcmStartChecked = FALSE;
+	AVB_LOGF_INFO("Playback started %u frames ahead of the first presentation time", pPvtData->pcmStartLead);
+}
+
+// Once the hardware pointer has moved, work out from its timestamp when the first item frame
+// is heard and take out the remaining error by dropping or inserting frames. Returns the
+// leading frames of the item about to be written to drop.
+static U32 x_pcmCheckStart(pvt_data_t *pPvtData, U32 frames)
+{
+	snd_pcm_uframes_t avail;
+	snd_htimestamp_t tstamp;
+
+	if (snd_pcm_htimestamp(pPvtData->pcmHandle, &avail, &tstamp) < 0
+			|| (tstamp.tv_sec == 0 && tstamp.tv_nsec == 0)
+			|| avail > pPvtData->pcmBufferFrames) {
+		return 0;
+	}
+	U64 queued = pPvtData->pcmBufferFrames - avail;
+	if (queued >= pPvtData->pcmWrittenFrames) {
+		// Nothing played yet
+		return 0;
+	}
+	S64 played = pPvtData->pcmWrittenFrames - queued;
+
+	// The ALSA timestamp is on the monotonic clock, move it to the wall clock
+	U64 wallNSec, monoNSec;
+	CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &wallNSec);
+	CLOCK_GETTIME64(OPENAVB_CLOCK_MONOTONIC, &monoNSec);
+	S64 tstampNSec = (S64)tstamp.tv_sec * NANOSECONDS_PER_SECOND + tstamp.tv_nsec + (S64)(wallNSec - monoNSec);
+
+	// Frame number played was being heard at the timestamp
+	S64 firstNSec = tstampNSec + ((S64)pPvtData->pcmStartLead - played) * NANOSECONDS_PER_SECOND / (S64)pPvtData->audioRate;
+	S64 errNSec = firstNSec - (S64)pPvtData->pcmStartNSec;
+	S64 errFrames = llround((double)errNSec * pPvtData->audioRate / NANOSECONDS_PER_SECOND);
+	pPvtData->pcmStartChecked = TRUE;
+
+	AVB_LOGF_INFO("Playback start %+" PRId64 " ns from the presentation time, correcting %+" PRId64 " frames", errNSec, -errFrames);
+	if (errFrames > 0) {
+		return errFrames < frames ? errFrames : frames;
+	}
+	if (errFrames < 0) {
+		x_pcmMmapWrite(pPvtData, NULL, NULL, -errFrames);
+	}
+	return 0;
+}
+
+static void x_asrcFree(pvt_data_t *pPvtData)
+{
+	openavbAsrcDelete(pPvtData->pAsrc);
+	pPvtData->pAsrc = NULL;
+	free(pPvtData->pAsrcIn);
+	pPvtData->pAsrcIn = NULL;
+	free(pPvtData->pAsrcOut);
+	pPvtData->pAsrcOut = NULL;
+	free(pPvtData->pAsrcPcm);
+	pPvtData->pAsrcPcm = NULL;
+	free(pPvtData->pAsrcSwapped);
+	pPvtData->pAsrcSwapped = NULL;
+}
+
+static bool x_asrcAlloc(pvt_data_t *pPvtData, U32 frames)
+{
+	U32 channels = pPvtData->audioChannels;
+	U32 sampleBytes = pPvtData->asrcSampleBytes ? pPvtData->asrcSampleBytes : sizeof(float);
+
+	x_asrcFree(pPvtData);
+	pPvtData->pAsrc = openavbAsrcCreate(channels, frames, pPvtData->asrcQuality);
+	if (!pPvtData->pAsrc) {
+		return FALSE;
+	}
+	U32 maxOutFrames = openavbAsrcMaxOutFrames(pPvtData->pAsrc, frames);
+	pPvtData->pAsrcIn = malloc(frames * channels * sizeof(float));
+	pPvtData->pAsrcOut = malloc(maxOutFrames * channels * sizeof(float));
+	pPvtData->pAsrcPcm = malloc(maxOutFrames * channels * sampleBytes);
+	if (pPvtData->asrcSwap) {
+		pPvtData->pAsrcSwapped = malloc(frames * channels * sampleBytes);
+	}
+	if (!pPvtData->pAsrcIn || !pPvtData->pAsrcOut || !pPvtData->pAsrcPcm
+			|| (pPvtData->asrcSwap && !pPvtData->pAsrcSwapped)) {
+		x_asrcFree(pPvtData);
+		return FALSE;
+	}
+	pPvtData->asrcItemFrames = frames;
+	pPvtData->asrcLevel = 0;
+	pPvtData->asrcTarget = 0;
+	pPvtData->asrcIntegral = 0;
+	pPvtData->asrcFrames = 0;
+
+	AVB_LOGF_INFO("Sample rate converter: %s kernels, quality %d, %u frames per item", openavbAsrcKernelName(), pPvtData->asrcQuality, frames);
+	return TRUE;
+}
+
+// Steer the converter ratio so the frames waiting in the media queue, the converter and
+// the ALSA buffer stay constant. A growing level means the DAC runs slower than the talker.
+// With media clock recovery locked the recovered talker rate is applied directly, and the
+// level only has to correct for the DAC.
+static void x_asrcSteer(media_q_t *pMediaQ, pvt_data_t *pPvtData, U32 outFrames)
+{
+	media_q_pub_map_uncmp_audio_info_t *pPubMapUncmpAudioInfo = pMediaQ->pPubMapInfo;
+	double rate = pPvtData->audioRate;
+	snd_pcm_sframes_t delay;
+
+	if (!outFrames || snd_pcm_delay(pPvtData->pcmHandle, &delay) < 0) {
+		return;
+	}
+
+	double level = (double)openavbMediaQCountItems(pMediaQ, TRUE) * pPubMapUncmpAudioInfo->framesPerItem
+		+ openavbAsrcBufferedFrames(pPvtData->pAsrc) + delay;
+	double dt = outFrames / rate;
+	double alpha = dt / ASRC_LEVEL_SEC;
+	if (pPvtData->asrcFrames == 0 || alpha > 1.0) {
+		alpha = 1.0;
+	}
+	pPvtData->asrcLevel += alpha * (level - pPvtData->asrcLevel);
+	pPvtData->asrcFrames += outFrames;
+
+	if (pPvtData->asrcTarget == 0) {
+		if (pPvtData->asrcFrames >= ASRC_SETTLE_SEC * rate) {
+			pPvtData->asrcTarget = pPvtData->asrcLevel > 1.0 ? pPvtData->asrcLevel : 1.0;
+			pPvtData->asrcIntegral = 0;
+			AVB_LOGF_INFO("Sample rate converter holding %.0f frames buffered", pPvtData->asrcTarget);
+		}
+		return;
+	}
+
+	// Critically damped PI loop on the level error
+	const double kp = 1.0 / ASRC_STEER_SEC;
+	const double ki = kp * kp / 4.0;
+	double err = pPvtData->asrcLevel - pPvtData->asrcTarget;
+	double ppm = (kp * err + ki * (pPvtData->asrcIntegral + err * dt)) / rate * 1000000.0;
+	if (ppm > ASRC_MAX_PPM) {
+		ppm = ASRC_MAX_PPM;
+	}
+	else if (ppm < -ASRC_MAX_PPM) {
+		ppm = -ASRC_MAX_PPM;
+	}
+	else {
+		// Only integrate while not saturated
+		pPvtData->asrcIntegral += err * dt;
+	}
+	double mcrRatio;
+	if (!halGetMCRClock(&mcrRatio, NULL)) {
+		mcrRatio = 1.0;
+	}
+	openavbAsrcSetRatio(pPvtData->pAsrc, mcrRatio * (1.0 + ppm / 1000000.0));
+
+	IF_LOG_INTERVAL(10000) AVB_LOGF_DEBUG("Sample rate converter level %.1f target %.1f ratio %+.2f ppm, media clock %+.2f ppm",
+		pPvtData->asrcLevel, pPvtData->asrcTarget, ppm, (mcrRatio - 1.0) * 1000000.0);
+}
+
+// Resample an item and write it. Returns FALSE when the converter is not available.
+static bool x_asrcWrite(media_q_t *pMediaQ, pvt_data_t *pPvtData, const U8 *pData, U32 frames)
+{
+	U32 channels = pPvtData->audioChannels;
+
+	if (!pPvtData->pAsrc || frames > pPvtData->asrcItemFrames) {
+		if (!x_asrcAlloc(pPvtData, frames)) {
+			AVB_LOG_ERROR("Unable to allocate the sample rate converter, disabled");
+			pPvtData->asrcEnabled = FALSE;
+			return FALSE;
+		}
+	}
+
+	if (pPvtData->asrcSwap) {
+		openavbAudioConvSwap(pPvtData->pAsrcSwapped, pData, pPvtData->asrcSampleBytes, frames * channels);
+		openavbAudioConvIntToFloat(pPvtData->pAsrcIn, pPvtData->pAsrcSwapped, pPvtData->asrcSampleBytes, frames * channels);
+	}
+	else if (pPvtData->asrcSampleBytes) {
+		openavbAudioConvIntToFloat(pPvtData->pAsrcIn, pData, pPvtData->asrcSampleBytes, frames * channels);
+	}
+	else {
+		memcpy(pPvtData->pAsrcIn, pData, frames * channels * sizeof(float));
+	}
+
+	U32 outFrames = openavbAsrcProcess(pPvtData->pAsrc, pPvtData->pAsrcIn, frames, pPvtData->pAsrcOut);
+
+	S32 rslt;
+	if (pPvtData->mmapAccess && pPvtData->asrcSampleBytes && !pPvtData->asrcSwap) {
+		// Converted straight into the DMA area
+		rslt = x_pcmWrite(pPvtData, NULL, pPvtData->pAsrcOut, outFrames);
+	}
+	else {
+		const void *pPcm = pPvtData->pAsrcOut;
+		if (pPvtData->asrcSampleBytes) {
+			openavbAudioConvFloatToInt(pPvtData->pAsrcPcm, pPvtData->asrcSampleBytes, pPvtData->pAsrcOut, outFrames * channels);
+			if (pPvtData->asrcSwap) {
+				openavbAudioConvSwap(pPvtData->pAsrcPcm, pPvtData->pAsrcPcm, pPvtData->asrcSampleBytes, outFrames * channels);
+			}
+			pPcm = pPvtData->pAsrcPcm;
+		}
+		rslt = x_pcmWrite(pPvtData, pPcm, NULL, outFrames);
+	}
+	if (rslt >= 0 && (U32)rslt != outFrames) {
+		AVB_LOGF_WARNING("Not all resampled pcm data consumed written:%u  consumed:%d", outFrames, rslt);
+	}
+	x_asrcSteer(pMediaQ, pPvtData, rslt > 0 ? rslt : 0);
+	return TRUE;
+}
+
 // This callback is called when acting as a listener.
 bool openavbIntfAlsaRxCB(media_q_t *pMediaQ)
 {
@@ -981,22 +1542,47 @@ bool openavbIntfAlsaRxCB(media_q_t *pMediaQ)
 		bool moreItems = TRUE;
 
 		while (moreItems) {
-			media_q_item_t *pMediaQItem = openavbMediaQTailLock(pMediaQ, pPvtData->ignoreTimestamp);
+			// Once playback is started at a presentation time, items are written as soon as they
+			// arrive. Their place in the ALSA buffer keeps them in time from then on.
+			media_q_item_t *pMediaQItem = openavbMediaQTailLock(pMediaQ, pPvtData->ignoreTimestamp || pPvtData->timedStart);
 			if (pMediaQItem) {
 				if (pMediaQItem->dataLen) {
-					S32 rslt;
+					U32 frames = pPubMapUncmpAudioInfo->framesPerItem;
+					U32 skip = 0;
+					bool startPcm = FALSE;
+
+					if (pPvtData->timedStart) {
+						if (!pPvtData->pcmStarted) {
+							S32 rslt = x_pcmTimedStart(pMediaQ, pPvtData, pMediaQItem);
+							if (rslt < 0) {
+								// Too early, try again on the next call
+								openavbMediaQTailUnlock(pMediaQ);
+								break;
+							}
+							skip = rslt;
+							startPcm = skip < frames;
+						}
+						else if (!pPvtData->pcmStartChecked) {
+							skip = x_pcmCheckStart(pPvtData, frames);
+						}
+					}
 
-					rslt = snd_pcm_writei(pPvtData->pcmHandle, pMediaQItem->pPubData, pPubMapUncmpAudioInfo->framesPerItem);
-					if (rslt < 0) {
-						AVB_LOGF_ERROR("snd_pcm_writei: %s", snd_strerror(rslt));
-						rslt = snd_pcm_recover(pPvtData->pcmHandle, rslt, 0);
-						if (rslt < 0) {
-							AVB_LOGF_ERROR("snd_pcm_recover: %s", snd_strerror(rslt));
+					if (skip >= frames) {
+						// Late, dropped
+					}
+					else if (pPvtData->asrcEnabled
+							&& x_asrcWrite(pMediaQ, pPvtData, pMediaQItem->pPubData + skip * pPvtData->pcmFrameBytes, frames - skip)) {
+						// Written through the sample rate converter
+					}
+					else {
+						S32 rslt = x_pcmWrite(pPvtData, pMediaQItem->pPubData + skip * pPvtData->pcmFrameBytes, NULL, frames - skip);
+						if (rslt != (S32)(frames - skip)) {
+							AVB_LOGF_WARNING("Not all pcm data consumed written:%u  consumed:%u", pMediaQItem->dataLen, rslt * pPubMapUncmpAudioInfo->audioChannels);
 						}
-						rslt = snd_pcm_writei(pPvtData->pcmHandle, pMediaQItem->pPubData, pPubMapUncmpAudioInfo->framesPerItem);
 					}
-					if (rslt != pPubMapUncmpAudioInfo->framesPerItem) {
-						AVB_LOGF_WARNING("Not all pcm data consumed written:%u  consumed:%u", pMediaQItem->dataLen, rslt * pPubMapUncmpAudioInfo->audioChannels);
+
+					if (startPcm) {
+						x_pcmTimedStartRun(pPvtData);
 					}
 
 					// DEBUG
@@ -1031,6 +1617,8 @@ void openavbIntfAlsaEndCB(media_q_t *pMediaQ)
 			return;
 		}
 
+		x_asrcFree(pPvtData);
+
 		if (pPvtData->pcmHandle) {
 			snd_pcm_close(pPvtData->pcmHandle);
 			pPvtData->pcmHandle = NULL;
@@ -1115,9 +1703,13 @@ extern DLL_EXPORT bool openavbIntfAlsaInitialize(media_q_t *pMediaQ, openavb_int
 		pPvtData->intervalCounter = 0;
 		pPvtData->startThresholdPeriods = 2;	// Default to 2 periods of frames as the start threshold
 		pPvtData->periodTimeUsec = 100000;
+		pPvtData->mmapAccess = FALSE;
 
 		pPvtData->fixedTimestampEnabled = FALSE;
 		pPvtData->clockSkewPPB = 0;
+
+		pPvtData->asrcEnabled = FALSE;
+		pPvtData->asrcQuality = OPENAVB_ASRC_QUALITY_MEDIUM;
 	}
 
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
@@ -69,6 +69,9 @@ typedef struct pvt_data_t
 	GstAlBuf *rxBufs[NBUFS];
 	bool asyncRx;
 	bool blockingRx;
+	bool zeroCopy;
+	gint nTaken;
+	gint maxTaken;
 
 	gint			nWaiting;
 	bool firstSample;
@@ -128,6 +131,35 @@ void openavbIntfH264RtpGstCfgCB(media_q_t *pMediaQ, const char *name, const char
 			pPvtData->ignoreTimestamp = (tmp == 1);
 		}
 	}
+	else if (strcmp(name, "intf_nv_zero_copy") == 0)
+	{
+		tmp = strtol(value, &pEnd, 10);
+		if (*pEnd == '\0')
+		{
+			pPvtData->zeroCopy = (tmp == 1);
+		}
+	}
+}
+
+// Media queue items reference GStreamer memory instead of holding a copy
+typedef struct
+{
+	media_q_t *pMediaQ;
+	media_q_item_t *pItem;
+} taken_item_t;
+
+static void releaseTxBuf(void *pv)
+{
+	gst_al_rtp_buffer_unref((GstAlBuf *)pv);
+}
+
+static void giveTakenItem(gpointer pv)
+{
+	taken_item_t *pTaken = pv;
+	pvt_data_t *pPvtData = pTaken->pMediaQ->pPvtIntfInfo;
+	openavbMediaQTailItemGive(pTaken->pMediaQ, pTaken->pItem);
+	g_atomic_int_add(&pPvtData->nTaken, -1);
+	g_free(pTaken);
 }
 
 void openavbIntfH264RtpGstGenInitCB(media_q_t *pMediaQ)
@@ -330,8 +362,16 @@ bool openavbIntfH264RtpGstTxCB(media_q_t *pMediaQ)
 				return FALSE;
 			}
 
-			pMediaQItem->dataLen = paySize;
-			memcpy(pMediaQItem->pPubData, GST_AL_BUF_DATA(txBuf), paySize);
+			if (pPvtData->zeroCopy)
+			{
+				// The mapper reads the payload from the sample, released when the item is pulled
+				openavbMediaQItemSetExternal(pMediaQItem, GST_AL_BUF_DATA(txBuf), paySize, releaseTxBuf, txBuf);
+			}
+			else
+			{
+				pMediaQItem->dataLen = paySize;
+				memcpy(pMediaQItem->pPubData, GST_AL_BUF_DATA(txBuf), paySize);
+			}
 			if (gst_al_rtp_buffer_get_marker(txBuf))
 			{
 				((media_q_item_map_h264_pub_data_t *)pMediaQItem->pPubMapData)->lastPacket = TRUE;
@@ -345,7 +385,10 @@ bool openavbIntfH264RtpGstTxCB(media_q_t *pMediaQ)
 			openavbAvtpTimeSetToWallTime(pMediaQItem->pAvtpTime);
 			openavbMediaQHeadPush(pMediaQ);
 
-			gst_al_rtp_buffer_unref(txBuf);
+			if (!pPvtData->zeroCopy)
+			{
+				gst_al_rtp_buffer_unref(txBuf);
+			}
 		}
 		else
 		{
@@ -444,6 +487,16 @@ void openavbIntfH264RtpGstRxInitCB(media_q_t *pMediaQ)
 
 	pPvtData->firstSample = true;
 
+	if (pPvtData->zeroCopy && !pPvtData->asyncRx)
+	{
+		// Taken items are given back from GStreamer threads
+		openavbMediaQThreadSafeOn(pMediaQ);
+	}
+	// The RTP depayloader holds the payloads of a frame until its marker packet.
+	// Keep half of the media queue for receiving, copy once that many items are taken.
+	pPvtData->nTaken = 0;
+	pPvtData->maxTaken = openavbMediaQGetItemCount(pMediaQ) / 2;
+
 	GError *error = NULL;
 	pPvtData->pipe = gst_parse_launch(pPvtData->pPipelineStr, &error);
 	if (error)
@@ -537,15 +590,46 @@ bool openavbIntfH264RtpGstRxCB(media_q_t *pMediaQ)
 				continue;
 			}
 		}
-		GstAlBuf *rxBuf = gst_al_alloc_rtp_buffer(pMediaQItem->dataLen, 0,0);
+		GstAlBuf *rxBuf = NULL;
+		bool taken = FALSE;
+
+		// In async mode up to NBUFS buffers may be waiting, more than the media queue has items
+		if (pPvtData->zeroCopy && !pPvtData->asyncRx
+			&& g_atomic_int_get(&pPvtData->nTaken) < pPvtData->maxTaken)
+		{
+			taken_item_t *pTaken = g_new(taken_item_t, 1);
+			pTaken->pMediaQ = pMediaQ;
+			pTaken->pItem = pMediaQItem;
+			taken = openavbMediaQTailItemTake(pMediaQ, pMediaQItem);
+			if (taken)
+			{
+				g_atomic_int_add(&pPvtData->nTaken, 1);
+				// The item goes back to the media queue once GStreamer frees the buffer
+				rxBuf = gst_al_wrap_rtp_buffer(pMediaQItem->pPubData, pMediaQItem->dataLen, giveTakenItem, pTaken);
+			}
+			else
+			{
+				g_free(pTaken);
+			}
+		}
+		else
+		{
+			rxBuf = gst_al_alloc_rtp_buffer(pMediaQItem->dataLen, 0,0);
+		}
 
 		if (!rxBuf)
 		{
 			AVB_LOG_ERROR("gst_rtp_buffer_allocate failed!");
-			openavbMediaQTailUnlock(pMediaQ);
+			if (!taken)
+			{
+				openavbMediaQTailUnlock(pMediaQ);
+			}
 			return FALSE;
 		}
-		memcpy(GST_AL_BUF_DATA(rxBuf), pMediaQItem->pPubData, pMediaQItem->dataLen);
+		if (!taken)
+		{
+			memcpy(GST_AL_BUF_DATA(rxBuf), pMediaQItem->pPubData, pMediaQItem->dataLen);
+		}
 
 		//GST_AL_BUFFER_TIMESTAMP(rxBuf) = GST_CLOCK_TIME_NONE;
 		GST_AL_BUFFER_TIMESTAMP(rxBuf) = ((media_q_item_map_h264_pub_data_t *)pMediaQItem->pPubMapData)->timestamp;
@@ -574,7 +658,10 @@ bool openavbIntfH264RtpGstRxCB(media_q_t *pMediaQ)
 				AVB_LOGF_ERROR("Pushing buffer to appsrc failed with code %d", ret);
 			}
 		}
-		openavbMediaQTailPull(pMediaQ);
+		if (!taken)
+		{
+			openavbMediaQTailPull(pMediaQ);
+		}
 	}
 	return TRUE;
 }
@@ -648,6 +735,7 @@ extern DLL_EXPORT bool openavbIntfH264RtpGstInitialize(media_q_t *pMediaQ, opena
 	pIntfCB->intf_set_stream_uid_cb = openavbIntfH264RtpGstSetStreamUidCB;
 
 	pPvtData->ignoreTimestamp = FALSE;
+	pPvtData->zeroCopy = TRUE;
 
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
 	return TRUE;
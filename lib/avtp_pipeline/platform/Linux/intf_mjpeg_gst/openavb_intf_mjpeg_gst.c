@@ -72,6 +72,9 @@ typedef struct pvt_data_t
 	GstAlBuf *rxBufs[NBUFS];
 	bool asyncRx;
 	bool blockingRx;
+	bool zeroCopy;
+	gint nTaken;
+	gint maxTaken;
 
 	bool get_avtp_timestamp;        /*<! this flag indicates whether
                                         an avtp timestamp should be taken */
@@ -131,6 +134,35 @@ void openavbIntfMjpegGstCfgCB(media_q_t *pMediaQ, const char *name, const char *
 			pPvtData->ignoreTimestamp = (tmp == 1);
 		}
 	}
+	else if (strcmp(name, "intf_nv_zero_copy") == 0)
+	{
+		tmp = strtol(value, &pEnd, 10);
+		if (*pEnd == '\0')
+		{
+			pPvtData->zeroCopy = (tmp == 1);
+		}
+	}
+}
+
+// Media queue items reference GStreamer memory instead of holding a copy
+typedef struct
+{
+	media_q_t *pMediaQ;
+	media_q_item_t *pItem;
+} taken_item_t;
+
+static void releaseTxBuf(void *pv)
+{
+	gst_al_rtp_buffer_unref((GstAlBuf *)pv);
+}
+
+static void giveTakenItem(gpointer pv)
+{
+	taken_item_t *pTaken = pv;
+	pvt_data_t *pPvtData = pTaken->pMediaQ->pPvtIntfInfo;
+	openavbMediaQTailItemGive(pTaken->pMediaQ, pTaken->pItem);
+	g_atomic_int_add(&pPvtData->nTaken, -1);
+	g_free(pTaken);
 }
 
 void openavbIntfMjpegGstGenInitCB(media_q_t *pMediaQ)
@@ -227,8 +259,16 @@ bool openavbIntfMjpegGstTxCB(media_q_t *pMediaQ)
 	media_q_item_t *pMediaQItem = openavbMediaQHeadLock(pMediaQ);
 	if (pMediaQItem)
 	{
-		pMediaQItem->dataLen = paySize;
-		memcpy(pMediaQItem->pPubData, GST_AL_BUF_DATA(txBuf), paySize);
+		if (pPvtData->zeroCopy)
+		{
+			// The mapper reads the payload from the sample, released when the item is pulled
+			openavbMediaQItemSetExternal(pMediaQItem, GST_AL_BUF_DATA(txBuf), paySize, releaseTxBuf, txBuf);
+		}
+		else
+		{
+			pMediaQItem->dataLen = paySize;
+			memcpy(pMediaQItem->pPubData, GST_AL_BUF_DATA(txBuf), paySize);
+		}
 		if (gst_al_rtp_buffer_get_marker(txBuf))
 		{
 			((media_q_item_map_mjpeg_pub_data_t *)pMediaQItem->pPubMapData)->lastFragment = TRUE;
@@ -248,7 +288,10 @@ bool openavbIntfMjpegGstTxCB(media_q_t *pMediaQ)
 		}
 		openavbMediaQHeadPush(pMediaQ);
 
-		gst_al_rtp_buffer_unref(txBuf);
+		if (!pPvtData->zeroCopy)
+		{
+			gst_al_rtp_buffer_unref(txBuf);
+		}
 
 		AVB_TRACE_EXIT(AVB_TRACE_INTF_DETAIL);
 		return TRUE;
@@ -350,6 +393,16 @@ void openavbIntfMjpegGstRxInitCB(media_q_t *pMediaQ)
 		return;
 	}
 
+	if (pPvtData->zeroCopy && !pPvtData->asyncRx)
+	{
+		// Taken items are given back from GStreamer threads
+		openavbMediaQThreadSafeOn(pMediaQ);
+	}
+	// The RTP depayloader holds the payloads of a frame until its marker packet.
+	// Keep half of the media queue for receiving, copy once that many items are taken.
+	pPvtData->nTaken = 0;
+	pPvtData->maxTaken = openavbMediaQGetItemCount(pMediaQ) / 2;
+
 	GError *error = NULL;
 	pPvtData->pipe = gst_parse_launch(pPvtData->pPipelineStr, &error);
 	if (error)
@@ -437,15 +490,46 @@ bool openavbIntfMjpegGstRxCB(media_q_t *pMediaQ)
 				continue;
 			}
 		}
-		GstAlBuf *rxBuf = gst_al_alloc_rtp_buffer(pMediaQItem->dataLen, 0,0);
+		GstAlBuf *rxBuf = NULL;
+		bool taken = FALSE;
+
+		// In async mode up to NBUFS buffers may be waiting, more than the media queue has items
+		if (pPvtData->zeroCopy && !pPvtData->asyncRx
+			&& g_atomic_int_get(&pPvtData->nTaken) < pPvtData->maxTaken)
+		{
+			taken_item_t *pTaken = g_new(taken_item_t, 1);
+			pTaken->pMediaQ = pMediaQ;
+			pTaken->pItem = pMediaQItem;
+			taken = openavbMediaQTailItemTake(pMediaQ, pMediaQItem);
+			if (taken)
+			{
+				g_atomic_int_add(&pPvtData->nTaken, 1);
+				// The item goes back to the media queue once GStreamer frees the buffer
+				rxBuf = gst_al_wrap_rtp_buffer(pMediaQItem->pPubData, pMediaQItem->dataLen, giveTakenItem, pTaken);
+			}
+			else
+			{
+				g_free(pTaken);
+			}
+		}
+		else
+		{
+			rxBuf = gst_al_alloc_rtp_buffer(pMediaQItem->dataLen, 0,0);
+		}
 
 		if (!rxBuf)
 		{
 			AVB_LOG_ERROR("gst_rtp_buffer_allocate failed!");
-			openavbMediaQTailUnlock(pMediaQ);
+			if (!taken)
+			{
+				openavbMediaQTailUnlock(pMediaQ);
+			}
 			return FALSE;
 		}
-		memcpy(GST_AL_BUF_DATA(rxBuf), pMediaQItem->pPubData, pMediaQItem->dataLen);
+		if (!taken)
+		{
+			memcpy(GST_AL_BUF_DATA(rxBuf), pMediaQItem->pPubData, pMediaQItem->dataLen);
+		}
 
 		GST_AL_BUFFER_TIMESTAMP(rxBuf) = GST_CLOCK_TIME_NONE;
 		GST_AL_BUFFER_DURATION(rxBuf) = GST_CLOCK_TIME_NONE;
@@ -493,7 +577,10 @@ bool openavbIntfMjpegGstRxCB(media_q_t *pMediaQ)
 				AVB_LOGF_ERROR("Pushing buffer to appsrc failed with code %d", ret);
 			}
 		}
-		openavbMediaQTailPull(pMediaQ);
+		if (!taken)
+		{
+			openavbMediaQTailPull(pMediaQ);
+		}
 	}
 	return TRUE;
 }
@@ -570,6 +657,7 @@ extern DLL_EXPORT bool openavbIntfMjpegGstInitialize(media_q_t *pMediaQ, openavb
 	pIntfCB->intf_gen_end_cb = openavbIntfMjpegGstGenEndCB;
 
 	pPvtData->ignoreTimestamp = FALSE;
+	pPvtData->zeroCopy = TRUE;
 
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
 	return TRUE;
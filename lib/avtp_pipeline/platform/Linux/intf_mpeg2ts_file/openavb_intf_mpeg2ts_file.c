@@ -42,6 +42,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_trace_pub.h"
 #include "openavb_mediaq_pub.h"
 #include "openavb_intf_pub.h"
+#include "openavb_file_src_pub.h"
 
 #define	AVB_LOG_COMPONENT	"MPEG2TS Interface"
 #include "openavb_log_pub.h" 
@@ -78,11 +79,22 @@ typedef struct {
 	// Ignore timestamp at listener.
 	bool ignoreTimestamp;
 
+	// intf_nv_file_mmap: Map the talker input file instead of reading it with stdio
+	bool fileMmap;
+
+	// intf_nv_read_ahead_bytes: Bytes read ahead of the talker when the file is mapped
+	U32 readAheadBytes;
+
 	/////////////
 	// Variable data
 	/////////////
 	FILE *pFile;
 
+	// Talker input when the file is mapped. Media queue items point into the mapping,
+	// so it stays mapped after the end of the file until the interface is closed.
+	openavb_file_src_t *pFileSrc;
+	bool fileSrcEnded;
+
 	// Talker variables for tracking rewind
 	struct timespec startTime;
 	int nRepeatCount;
@@ -174,6 +186,20 @@ void openavbIntfMpeg2tsFileCfgCB(media_q_t *pMediaQ, const char *name, const cha
 				valueOK = TRUE;
 			}
 		}
+		else if (strcmp(name, "intf_nv_file_mmap") == 0) {
+			tmp = strtoul(value, &pEnd, 10);
+			if (*pEnd == '\0' && pEnd != value && (tmp == 0 || tmp == 1)) {
+				pPvtData->fileMmap = (tmp == 1);
+				valueOK = TRUE;
+			}
+		}
+		else if (strcmp(name, "intf_nv_read_ahead_bytes") == 0) {
+			tmp = strtoul(value, &pEnd, 10);
+			if (*pEnd == '\0' && pEnd != value) {
+				pPvtData->readAheadBytes = tmp;
+				valueOK = TRUE;
+			}
+		}
 		else if (strcmp(name, "intf_nv_enable_proper_bitrate_streaming") == 0) {
 			tmp = strtoul(value, &pEnd, 10);
 			if (*pEnd == '\0' && pEnd != value && (tmp == 0 || tmp == 1)) {
@@ -206,82 +232,112 @@ static void sync_scan(FILE* input)
 	}
 }
 
+// Track the PCRs of one TS packet and raise *pMaxBitrate to the bitrate seen since the previous PCR of its PID
+static void bitrate_scan_packet(const unsigned char *pkt, struct PIDStatus *fPIDStatusTable, double fTSPacketCount, double *pMaxBitrate)
+{
+	unsigned char const adaptation_field_control = (pkt[3]&0x30)>>4;
+	if (adaptation_field_control != 2 && adaptation_field_control != 3)  return;
+	// there's no adaptation_field
+
+	unsigned char const adaptation_field_length = pkt[4];
+	if (adaptation_field_length == 0) return;
+
+	unsigned char const pcrFlag = pkt[5]&0x10;
+	if (pcrFlag == 0) return; // no PCR
+
+	unsigned char const discontinuity_indicator = pkt[5]&0x80;
+	// There's a PCR.  Get it.
+	unsigned int pcrBaseHigh = (pkt[6]<<24)|(pkt[7]<<16)|(pkt[8]<<8)|pkt[9];
+	double fClock = pcrBaseHigh/(F90_KHZ/2);
+	if ((pkt[10]&0x80) != 0) fClock += 1/F90_KHZ; // add in low-bit (if set)
+	unsigned short pcrExt = ((pkt[10]&0x01)<<8) | pkt[11];
+	fClock += pcrExt/F27_MHZ;
+
+	unsigned pid = ((pkt[1]&0x1F)<<8) | pkt[2];
+	int idx = pidTableFindOrCreatePid(fPIDStatusTable, pid);
+	if (!fPIDStatusTable[idx].used) {
+		// We're seeing this PID's PCR for the first time:
+		fPIDStatusTable[idx].used = 1;
+		fPIDStatusTable[idx].firstClock = fClock;
+		fPIDStatusTable[idx].lastClock = fClock;
+		fPIDStatusTable[idx].lastPacketNum = fTSPacketCount;
+	}
+	else {
+		if (discontinuity_indicator == 0) {
+			double duration = fClock - fPIDStatusTable[idx].lastClock;
+			if (duration > 0) {
+				double data = (fTSPacketCount - fPIDStatusTable[idx].lastPacketNum) * 188 * 8;
+				double bitrate = data / duration;
+				if (bitrate > *pMaxBitrate)
+					*pMaxBitrate = bitrate;
+			}
+			fPIDStatusTable[idx].lastClock = fClock;
+			if (duration > 0)
+				fPIDStatusTable[idx].lastPacketNum = fTSPacketCount;
+		}
+		else {
+			fPIDStatusTable[idx].firstClock = fClock;
+			fPIDStatusTable[idx].lastPacketNum = fTSPacketCount;
+		}
+	}
+}
+
 #define TS_PACKETS 1
 static unsigned int openavbComputeFileBitrate(char *fileName, media_q_t *pMediaQ)
 {
+	pvt_data_t *pPvtData = pMediaQ->pPvtIntfInfo;
 	double max_bitrate = 0;
-	FILE *input = fopen(fileName, "rb");
-	if (input != NULL) {
-		unsigned char* packets = (unsigned char *) malloc(188*TS_PACKETS);
-		double fTSPCRCount = 0;
-		struct PIDStatus *fPIDStatusTable = (struct PIDStatus*) calloc(MAX_TABLE_PIDS, sizeof(struct PIDStatus));
-		double fTSPacketCount = 0;
-		int i = 0;
-		for(i = 0; i < MAX_TABLE_PIDS; ++i)
-		{
-			fPIDStatusTable[i].pid = -1;
-			fPIDStatusTable[i].used = 0;
-		}
-		sync_scan(input);
-		while((TS_PACKETS * 188) == fread((void *)packets, 1, 188*TS_PACKETS, input))
-		{
-			unsigned char* pkt;
-			for (pkt = packets; pkt < &(packets[TS_PACKETS*188]); pkt += 188)
-			{
-				fTSPacketCount++;
+	double fTSPacketCount = 0;
+	struct PIDStatus *fPIDStatusTable = (struct PIDStatus*) calloc(MAX_TABLE_PIDS, sizeof(struct PIDStatus));
+	if (!fPIDStatusTable)
+		return 0;
 
-				unsigned char const adaptation_field_control = (pkt[3]&0x30)>>4;
-				if (adaptation_field_control != 2 && adaptation_field_control != 3)  continue;
-				// there's no adaptation_field
-
-				unsigned char const adaptation_field_length = pkt[4];
-				if (adaptation_field_length == 0) continue;
-
-				unsigned char const pcrFlag = pkt[5]&0x10;
-				if (pcrFlag == 0) continue; // no PCR
-
-				unsigned char const discontinuity_indicator = pkt[5]&0x80;
-				// There's a PCR.  Get it.
-				++fTSPCRCount;
-				unsigned int pcrBaseHigh = (pkt[6]<<24)|(pkt[7]<<16)|(pkt[8]<<8)|pkt[9];
-				double fClock = pcrBaseHigh/(F90_KHZ/2);
-				if ((pkt[10]&0x80) != 0) fClock += 1/F90_KHZ; // add in low-bit (if set)
-				unsigned short pcrExt = ((pkt[10]&0x01)<<8) | pkt[11];
-				fClock += pcrExt/F27_MHZ;
-
-				unsigned pid = ((pkt[1]&0x1F)<<8) | pkt[2];
-				int idx = pidTableFindOrCreatePid(fPIDStatusTable, pid);
-				if (!fPIDStatusTable[idx].used) {
-					// We're seeing this PID's PCR for the first time:
-					fPIDStatusTable[idx].used = 1;
-					fPIDStatusTable[idx].firstClock = fClock;
-					fPIDStatusTable[idx].lastClock = fClock;
-					fPIDStatusTable[idx].lastPacketNum = fTSPacketCount;
-				}
-				else {
-					if (discontinuity_indicator == 0) {
-						double duration = fClock - fPIDStatusTable[idx].lastClock;
-						if (duration > 0) {
-							double data = (fTSPacketCount - fPIDStatusTable[idx].lastPacketNum) * 188 * 8;
-							double bitrate = data / duration;
-							if (bitrate > max_bitrate)
-								max_bitrate = bitrate;
-						}
-						fPIDStatusTable[idx].lastClock = fClock;
-						if (duration > 0)
-							fPIDStatusTable[idx].lastPacketNum = fTSPacketCount;
-					}
-					else {
-						fPIDStatusTable[idx].firstClock = fClock;
-						fPIDStatusTable[idx].lastPacketNum = fTSPacketCount;
+	int i = 0;
+	for(i = 0; i < MAX_TABLE_PIDS; ++i)
+	{
+		fPIDStatusTable[i].pid = -1;
+		fPIDStatusTable[i].used = 0;
+	}
+
+	openavb_file_src_t *pSrc = NULL;
+	if (pPvtData->fileMmap)
+		pSrc = openavbFileSrcOpen(fileName, 0, pPvtData->readAheadBytes, FALSE);
+
+	if (pSrc) {
+		// Walk the packets in place
+		U64 dataLen;
+		const unsigned char *data = openavbFileSrcData(pSrc, &dataLen);
+		const unsigned char *pkt = memchr(data, MPEGTS_SYNC_BYTE, dataLen);
+		if (pkt) {
+			const unsigned char *end = data + dataLen;
+			for (; end - pkt >= 188; pkt += 188) {
+				fTSPacketCount++;
+				bitrate_scan_packet(pkt, fPIDStatusTable, fTSPacketCount, &max_bitrate);
+			}
+		}
+		openavbFileSrcClose(pSrc);
+	}
+	else {
+		FILE *input = fopen(fileName, "rb");
+		if (input != NULL) {
+			unsigned char* packets = (unsigned char *) malloc(188*TS_PACKETS);
+			if (packets) {
+				sync_scan(input);
+				while((TS_PACKETS * 188) == fread((void *)packets, 1, 188*TS_PACKETS, input))
+				{
+					unsigned char* pkt;
+					for (pkt = packets; pkt < &(packets[TS_PACKETS*188]); pkt += 188)
+					{
+						fTSPacketCount++;
+						bitrate_scan_packet(pkt, fPIDStatusTable, fTSPacketCount, &max_bitrate);
 					}
 				}
+				free(packets);
 			}
+			fclose(input);
 		}
-		fclose(input);
-		free(fPIDStatusTable);
-		free(packets);
 	}
+	free(fPIDStatusTable);
 
 	return (unsigned int)max_bitrate;
 }
@@ -325,6 +381,10 @@ void openavbIntfMpeg2tsFileTxInitCB(media_q_t *pMediaQ)
 			pPvtData->pFileName = strdup("stdin");
 			pPvtData->pFile = stdin;
 		}
+		else if (pPvtData->fileMmap
+				 && (pPvtData->pFileSrc = openavbFileSrcOpen(pPvtData->pFileName, 0, pPvtData->readAheadBytes, pPvtData->repeat)) != NULL) {
+			// Items are filled straight from the mapping
+		}
 		else {
 			pPvtData->pFile = fopen(pPvtData->pFileName, "rb");
 			if (!pPvtData->pFile) {
@@ -354,7 +414,7 @@ bool openavbIntfMpeg2tsFileTxCB(media_q_t *pMediaQ)
 			return FALSE;
 		}
 
-		if (!pPvtData->pFile) {
+		if (!pPvtData->pFile && (!pPvtData->pFileSrc || pPvtData->fileSrcEnded)) {
 			// input already closed
 			AVB_TRACE_EXIT(AVB_TRACE_MAP_DETAIL);
 			return FALSE;
@@ -374,7 +434,7 @@ bool openavbIntfMpeg2tsFileTxCB(media_q_t *pMediaQ)
 		}
 
 		// handle end-of-file
-		if (feof(pPvtData->pFile)) {
+		if (pPvtData->pFileSrc ? openavbFileSrcAtEnd(pPvtData->pFileSrc) : feof(pPvtData->pFile)) {
 			if (pPvtData->pFileName && pPvtData->repeat) {
 				if (pPvtData->nRepeatCount < 2)
 					; // No delay for first few rewinds - want to buffer some data for restarts
@@ -387,7 +447,10 @@ bool openavbIntfMpeg2tsFileTxCB(media_q_t *pMediaQ)
 				}
 
 				AVB_LOGF_INFO("EOF, rewinding input file: %s", pPvtData->pFileName);
-				fseek(pPvtData->pFile, 0, 0);
+				if (pPvtData->pFileSrc)
+					openavbFileSrcRewind(pPvtData->pFileSrc);
+				else
+					fseek(pPvtData->pFile, 0, 0);
 
 				pPvtData->nRepeatCount++;
 				pPvtData->nBuffersSent = 0;
@@ -409,8 +472,13 @@ bool openavbIntfMpeg2tsFileTxCB(media_q_t *pMediaQ)
 			}
 			else {
 				AVB_LOGF_INFO("EOF, closing input file: %s", pPvtData->pFileName);
-				fclose(pPvtData->pFile);
-				pPvtData->pFile = NULL;
+				if (pPvtData->pFileSrc) {
+					pPvtData->fileSrcEnded = TRUE;
+				}
+				else {
+					fclose(pPvtData->pFile);
+					pPvtData->pFile = NULL;
+				}
 				AVB_TRACE_EXIT(AVB_TRACE_MAP_DETAIL);
 				return FALSE;
 			}
@@ -422,10 +490,22 @@ bool openavbIntfMpeg2tsFileTxCB(media_q_t *pMediaQ)
 			AVB_TRACE_EXIT(AVB_TRACE_MAP_DETAIL);
 			return FALSE;	// Media queue full
 		}
- 
-		size_t result = fread(pMediaQItem->pPubData, 1, pMediaQItem->itemSize, pPvtData->pFile);
+
+		size_t result;
+		if (pPvtData->pFileSrc) {
+			// Hand the mapped bytes to the mapper instead of copying them into the item
+			const U8 *pData;
+			result = openavbFileSrcPeek(pPvtData->pFileSrc, &pData, pMediaQItem->itemSize);
+			if (result > 0) {
+				openavbFileSrcAttach(pPvtData->pFileSrc, pMediaQItem, pData, result);
+				openavbFileSrcAdvance(pPvtData->pFileSrc, result);
+			}
+		}
+		else {
+			result = fread(pMediaQItem->pPubData, 1, pMediaQItem->itemSize, pPvtData->pFile);
+		}
 		if (result == 0) {
-			int e = ferror(pPvtData->pFile);
+			int e = pPvtData->pFile ? ferror(pPvtData->pFile) : 0;
 			if (e != 0) {
 				AVB_LOGF_ERROR("Error reading file: %s, %s", pPvtData->pFileName, strerror(e));
 				fclose(pPvtData->pFile);
@@ -635,6 +715,11 @@ void openavbIntfMpeg2tsFileEndCB(media_q_t *pMediaQ)
 			fclose(pPvtData->pFile);
 			pPvtData->pFile = NULL;
 		}
+
+		if (pPvtData->pFileSrc) {
+			openavbFileSrcClose(pPvtData->pFileSrc);
+			pPvtData->pFileSrc = NULL;
+		}
 	}
 
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
@@ -687,6 +772,8 @@ extern DLL_EXPORT bool openavbIntfMpeg2tsFileInitialize(media_q_t *pMediaQ, open
 		pIntfCB->intf_get_src_bitrate_cb = openavbIntMpeg2tsGetSrcBitrate;
 
 		pPvtData->ignoreTimestamp = FALSE;
+		pPvtData->fileMmap = TRUE;
+		pPvtData->readAheadBytes = OPENAVB_FILE_SRC_READ_AHEAD_DEFAULT;
 
 		pPvtData->fPIDStatusTable = (struct PIDStatus*) calloc(MAX_TABLE_PIDS, sizeof(struct PIDStatus));
 
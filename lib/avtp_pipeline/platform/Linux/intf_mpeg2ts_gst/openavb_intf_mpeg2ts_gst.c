@@ -59,6 +59,9 @@ typedef struct
 
 	bool ignoreTimestamp;
 
+	// Pass gstreamer buffers to and from the mapper without copying
+	bool zeroCopy;
+
 	/////////////
 	// Variable data
 	/////////////
@@ -71,6 +74,9 @@ typedef struct
 	gint			nWaiting;
 	// listener: whether gstreamer wants more pushed data now
 	bool			srcPaused;
+	// listener: media queue items held by gstreamer, and how many may be
+	gint			nTaken;
+	gint			maxTaken;
 
 } pvt_data_t;
 
@@ -109,6 +115,15 @@ void openavbIntfMpeg2tsGstCfgCB(media_q_t *pMediaQ, const char *name, const char
 				valueOK = TRUE;
 			}
 		}
+		else if (strcmp(name, "intf_nv_zero_copy") == 0)
+		{
+			tmp = strtol(value, &pEnd, 10);
+			if (*pEnd == '\0' && pEnd != value && (tmp == 0 || tmp == 1))
+			{
+				pPvtData->zeroCopy = (tmp == 1);
+				valueOK = TRUE;
+			}
+		}
 		else
 		{
 			AVB_LOGF_WARNING("Unknown configuration item: %s", name);
@@ -124,6 +139,27 @@ void openavbIntfMpeg2tsGstCfgCB(media_q_t *pMediaQ, const char *name, const char
 	AVB_TRACE_EXIT(AVB_TRACE_INTF_DETAIL);
 }
 
+// Media queue items reference gstreamer memory instead of holding a copy
+typedef struct
+{
+	media_q_t *pMediaQ;
+	media_q_item_t *pItem;
+} taken_item_t;
+
+static void releaseTxBuf(void *pv)
+{
+	gst_al_buffer_unref((GstAlBuf *)pv);
+}
+
+static void giveTakenItem(gpointer pv)
+{
+	taken_item_t *pTaken = pv;
+	pvt_data_t *pPvtData = pTaken->pMediaQ->pPvtIntfInfo;
+	openavbMediaQTailItemGive(pTaken->pMediaQ, pTaken->pItem);
+	g_atomic_int_add(&pPvtData->nTaken, -1);
+	g_free(pTaken);
+}
+
 void openavbIntfMpeg2tsGstGenInitCB(media_q_t *pMediaQ)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_INTF_DETAIL);
@@ -361,6 +397,14 @@ bool openavbIntfMpeg2tsGstTxCB(media_q_t *pMediaQ)
 				pMediaQItem->dataLen = 0;
 				openavbMediaQHeadUnlock(pMediaQ);
 			}
+			else if (pPvtData->zeroCopy)
+			{
+				// The mapper reads the data from the buffer, released when the item is pulled
+				openavbMediaQItemSetExternal(pMediaQItem, GST_AL_BUF_DATA(txBuf), GST_AL_BUF_SIZE(txBuf), releaseTxBuf, txBuf);
+				openavbAvtpTimeSetToWallTime(pMediaQItem->pAvtpTime);
+				openavbMediaQHeadPush(pMediaQ);
+				txBuf = NULL;
+			}
 			else
 			{
 				memcpy(pMediaQItem->pPubData, GST_AL_BUF_DATA(txBuf), GST_AL_BUF_SIZE(txBuf));
@@ -368,7 +412,8 @@ bool openavbIntfMpeg2tsGstTxCB(media_q_t *pMediaQ)
 				openavbAvtpTimeSetToWallTime(pMediaQItem->pAvtpTime);
 				openavbMediaQHeadPush(pMediaQ);
 			}
-			gst_al_buffer_unref(txBuf);
+			if (txBuf)
+				gst_al_buffer_unref(txBuf);
 		}
 		else
 		{
@@ -409,6 +454,16 @@ void openavbIntfMpeg2tsGstRxInitCB(media_q_t *pMediaQ)
 		pPvtData->bus = (GstBus*)NULL;
 		pPvtData->srcPaused = FALSE;
 
+		if (pPvtData->zeroCopy)
+		{
+			// Taken items are given back from gstreamer threads
+			openavbMediaQThreadSafeOn(pMediaQ);
+		}
+		// The demuxer and decoder queue up buffers; keep half of the media queue
+		// for receiving, copy once that many items are taken.
+		pPvtData->nTaken = 0;
+		pPvtData->maxTaken = openavbMediaQGetItemCount(pMediaQ) / 2;
+
 		GError *error = NULL;
 		pPvtData->pipe = gst_parse_launch(pPvtData->pPipelineStr, &error);
 		if (error)
@@ -490,16 +545,43 @@ bool openavbIntfMpeg2tsGstRxCB(media_q_t *pMediaQ)
 		if (pMediaQItem)
 		{
 			unsigned long len = pMediaQItem->dataLen;
+			bool taken = FALSE;
 			if (len > 0)
 			{
-				GstAlBuf *rxBuf = gst_al_alloc_buffer(len);
+				GstAlBuf *rxBuf = NULL;
+
+				if (pPvtData->zeroCopy
+					&& g_atomic_int_get(&pPvtData->nTaken) < pPvtData->maxTaken)
+				{
+					taken_item_t *pTaken = g_new(taken_item_t, 1);
+					pTaken->pMediaQ = pMediaQ;
+					pTaken->pItem = pMediaQItem;
+					taken = openavbMediaQTailItemTake(pMediaQ, pMediaQItem);
+					if (taken)
+					{
+						g_atomic_int_add(&pPvtData->nTaken, 1);
+						// The item goes back to the media queue once gstreamer frees the buffer
+						rxBuf = gst_al_wrap_buffer(pMediaQItem->pPubData, len, giveTakenItem, pTaken);
+					}
+					else
+					{
+						g_free(pTaken);
+					}
+				}
+				if (!taken)
+				{
+					rxBuf = gst_al_alloc_buffer(len);
+				}
 
 				if (rxBuf)
 				{
 					GST_AL_BUFFER_TIMESTAMP(rxBuf) = GST_CLOCK_TIME_NONE;
 					GST_AL_BUFFER_DURATION(rxBuf) = GST_CLOCK_TIME_NONE;
 
-					memcpy(GST_AL_BUF_DATA(rxBuf), pMediaQItem->pPubData, GST_AL_BUF_SIZE(rxBuf));
+					if (!taken)
+					{
+						memcpy(GST_AL_BUF_DATA(rxBuf), pMediaQItem->pPubData, GST_AL_BUF_SIZE(rxBuf));
+					}
 
 					GstFlowReturn gstret = gst_al_push_buffer(GST_APP_SRC(pPvtData->appsrc), rxBuf);
 					if (gstret != GST_FLOW_OK)
@@ -514,7 +596,10 @@ bool openavbIntfMpeg2tsGstRxCB(media_q_t *pMediaQ)
 					retval = moreData = FALSE;
 				}
 			}
-			openavbMediaQTailPull(pMediaQ);
+			if (!taken)
+			{
+				openavbMediaQTailPull(pMediaQ);
+			}
 		}
 		else
 		{
@@ -589,7 +674,8 @@ extern DLL_EXPORT bool openavbIntfMpeg2tsGstInitialize(media_q_t *pMediaQ, opena
 			return FALSE;
 		}
 
-		//pvt_data_t *pPvtData = pMediaQ->pPvtIntfInfo;
+		pvt_data_t *pPvtData = pMediaQ->pPvtIntfInfo;
+		pPvtData->zeroCopy = TRUE;
 
 		pIntfCB->intf_cfg_cb = openavbIntfMpeg2tsGstCfgCB;
 		pIntfCB->intf_gen_init_cb = openavbIntfMpeg2tsGstGenInitCB;
@@ -47,6 +47,8 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_map_uncmp_audio_pub.h"
 #include "openavb_map_aaf_audio_pub.h"
 #include "openavb_intf_pub.h"
+#include "openavb_audio_conv_pub.h"
+#include "openavb_file_src_pub.h"
 
 #define	AVB_LOG_COMPONENT	"Wav File Interface"
 #include "openavb_log_pub.h"
@@ -81,11 +83,20 @@ typedef struct {
 	// intf_nv_file_name: The fully qualified file name used both the talker and listener.
 	char *pFileName;
 
+	// intf_nv_file_mmap: Map the talker input file instead of reading it with stdio
+	bool fileMmap;
+
+	// intf_nv_read_ahead_bytes: Bytes read ahead of the talker when the file is mapped
+	U32 readAheadBytes;
+
 	/////////////
 	// Variable data
 	/////////////
 	FILE *pFile;
 
+	// Talker input when the file is mapped
+	openavb_file_src_t *pFileSrc;
+
 	// ALSA read/write interval
 	U32 intervalCounter;
 
@@ -372,6 +383,14 @@ void openavbIntfWavFileCfgCB(media_q_t *pMediaQ, const char *name, const char *v
                 AVB_LOG_ERROR("Invalid number of data bytes for intf_nv_number_of_data_bytes.");
             }
         }
+        else if (strcmp(name, "intf_nv_file_mmap") == 0) {
+            val = strtol(value, &pEnd, 10);
+            pPvtData->fileMmap = (val == 1);
+        }
+        else if (strcmp(name, "intf_nv_read_ahead_bytes") == 0) {
+            val = strtol(value, &pEnd, 10);
+            pPvtData->readAheadBytes = val;
+        }
        else if (strcmp(name, "intf_nv_audio_endian") == 0) {
             if (strncasecmp(value, "big", 3) == 0) {
                 pPvtData->audioEndian = AVB_AUDIO_ENDIAN_BIG;
@@ -427,6 +446,15 @@ void openavbIntfWavFileTxInitCB(media_q_t *pMediaQ)
 			}
 		}
 
+		if (pPvtData->fileMmap) {
+			// Map the data of our only supported wav file format, which starts after the 44 byte header.
+			pPvtData->pFileSrc = openavbFileSrcOpen(pPvtData->pFileName, 44, pPvtData->readAheadBytes, TRUE);
+			if (pPvtData->pFileSrc) {
+				fclose(pPvtData->pFile);
+				pPvtData->pFile = NULL;
+			}
+		}
+
 		if (pPvtData->pFile) {
 			// Seek to start of data for our only supported wav file format.
 			fseek(pPvtData->pFile, 44, 0);
@@ -459,7 +487,45 @@ bool openavbIntfWavFileTxCB(media_q_t *pMediaQ)
 				AVB_LOG_ERROR("Media queue item not large enough for samples");
 			}
 
-			if (pPvtData->pFile) {
+			if (pPvtData->pFileSrc) {
+				const U8 *pData;
+				U32 sampleBytes = pPubMapUncmpAudioInfo->itemSampleSizeBytes;
+				U32 bytesRead = openavbFileSrcPeek(pPvtData->pFileSrc, &pData, pPubMapUncmpAudioInfo->itemSize);
+
+				if (bytesRead == pPubMapUncmpAudioInfo->itemSize && pPvtData->audioEndian != AVB_AUDIO_ENDIAN_BIG) {
+					// The mapper reads the samples straight from the mapping
+					openavbFileSrcAttach(pPvtData->pFileSrc, pMediaQItem, pData, bytesRead);
+				}
+				else {
+					if (pPvtData->audioEndian == AVB_AUDIO_ENDIAN_BIG && sampleBytes >= 2 && sampleBytes <= 4) {
+						bytesRead -= bytesRead % sampleBytes;
+						openavbAudioConvSwap(pMediaQItem->pPubData, pData, sampleBytes, bytesRead / sampleBytes);
+					}
+					else {
+						memcpy(pMediaQItem->pPubData, pData, bytesRead);
+					}
+					if (bytesRead < pPubMapUncmpAudioInfo->itemSize) {
+						// Pad reminder of item with anything we didn't read because of end of file.
+						memset(pMediaQItem->pPubData + bytesRead, 0x00, pPubMapUncmpAudioInfo->itemSize - bytesRead);
+					}
+				}
+
+				if (bytesRead < pPubMapUncmpAudioInfo->itemSize) {
+					// Repeat wav file without re-reading the header.
+					openavbFileSrcRewind(pPvtData->pFileSrc);
+				}
+				else {
+					openavbFileSrcAdvance(pPvtData->pFileSrc, bytesRead);
+				}
+				pMediaQItem->dataLen = pPubMapUncmpAudioInfo->itemSize;
+
+				openavbAvtpTimeSetToWallTime(pMediaQItem->pAvtpTime);
+				openavbMediaQHeadPush(pMediaQ);
+
+				AVB_TRACE_EXIT(AVB_TRACE_INTF_DETAIL);
+				return TRUE;
+			}
+			else if (pPvtData->pFile) {
 
 				U32 bytesRead = fread(pMediaQItem->pPubData, 1, pPubMapUncmpAudioInfo->itemSize, pPvtData->pFile);
 
@@ -636,6 +702,11 @@ void openavbIntfWavFileEndCB(media_q_t *pMediaQ)
 			fclose(pPvtData->pFile);
 			pPvtData->pFile = NULL;
 		}
+
+		if (pPvtData->pFileSrc) {
+			openavbFileSrcClose(pPvtData->pFileSrc);
+			pPvtData->pFileSrc = NULL;
+		}
 	}
 
 	AVB_TRACE_EXIT(AVB_TRACE_INTF);
@@ -684,6 +755,8 @@ extern DLL_EXPORT bool openavbIntfWavFileInitialize(media_q_t *pMediaQ, openavb_
 		pIntfCB->intf_end_cb = openavbIntfWavFileEndCB;
 		pIntfCB->intf_gen_end_cb = openavbIntfWavFileGenEndCB;
 		pPvtData->audioEndian = AVB_AUDIO_ENDIAN_LITTLE;		//wave file default
+		pPvtData->fileMmap = TRUE;
+		pPvtData->readAheadBytes = OPENAVB_FILE_SRC_READ_AHEAD_DEFAULT;
 
 		pPvtData->intervalCounter = 0;
 		pPvtData->numOfStoredDataBytes = 0;
@@ -87,6 +87,21 @@ inline static void xSpinUntilNSec(U64 nSec)
 	while (1);
 }
 
+// Cache line size used to keep data written by different threads apart.
+#define CACHE_LINE_SIZE							64
+
+// Atomic access used by lock-free structures shared between threads.
+#define ATOMIC_LOAD_RELAXED(ptr)				   __atomic_load_n(ptr, __ATOMIC_RELAXED)
+#define ATOMIC_LOAD_ACQUIRE(ptr)				   __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE_RELAXED(ptr, val)			   __atomic_store_n(ptr, val, __ATOMIC_RELAXED)
+#define ATOMIC_STORE_RELEASE(ptr, val)			   __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define ATOMIC_FETCH_ADD_RELAXED(ptr, val)		   __atomic_fetch_add(ptr, val, __ATOMIC_RELAXED)
+#define ATOMIC_FETCH_ADD_ACQ_REL(ptr, val)		   __atomic_fetch_add(ptr, val, __ATOMIC_ACQ_REL)
+#define ATOMIC_CAS(ptr, pExpected, desired)		   __atomic_compare_exchange_n(ptr, pExpected, desired, FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define ATOMIC_FENCE_ACQUIRE()					   __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define ATOMIC_FENCE_RELEASE()					   __atomic_thread_fence(__ATOMIC_RELEASE)
+#define ATOMIC_FENCE_FULL()						   __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
 #define RAND()  								   random()
 #define SRAND(seed) 							   srandom(seed)
 
@@ -165,6 +180,12 @@ thread##_type	thread##_ThreadData
 #define THREAD_JOIN(threadhandle, signal)   	   pthread_join(threadhandle##_ThreadData.pthread, (void**)signal)
 #define THREAD_SLEEP(threadhandle, secs)		   sleep(secs)
 
+// Thread specific data. The destructor is called with the thread's value when a thread with a non-NULL value exits.
+#define THREAD_KEY(key)							   pthread_key_t key
+#define THREAD_KEY_CREATE(key, destructor)		   pthread_key_create(&key, destructor)
+#define THREAD_KEY_GET(key)						   pthread_getspecific(key)
+#define THREAD_KEY_SET(key, value)				   pthread_setspecific(key, value)
+
 
 #define SEM_T(sem) sem_t sem;
 #define SEM_ERR_T(err) int err;
@@ -177,6 +198,13 @@ thread##_type	thread##_ThreadData
 	openavbTimeTimespecAddUsec(&timeout, timeoutMSec * MICROSECONDS_PER_MSEC);	\
 	err = sem_timedwait(&sem, &timeout);									\
 }
+#define SEM_TIMEDWAIT_USEC(sem, timeoutUSec, err)							\
+{																			\
+	struct timespec timeout;												\
+	CLOCK_GETTIME(OPENAVB_CLOCK_REALTIME, &timeout);								\
+	openavbTimeTimespecAddUsec(&timeout, timeoutUSec);						\
+	err = sem_timedwait(&sem, &timeout);									\
+}
 #define SEM_POST(sem, err) err = sem_post(&sem);
 #define SEM_DESTROY(sem, err) err = sem_destroy(&sem);
 #define SEM_IS_ERR_NONE(err) (0 == err)
@@ -68,9 +68,15 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 //task TalkerThread
 #define talkerThread_THREAD_STK_SIZE						THREAD_STACK_SIZE
 
+//task talkerSchedThread. Shared talker scheduler workers
+#define talkerSchedThread_THREAD_STK_SIZE					THREAD_STACK_SIZE
+
 //task ListenerThread
 #define listenerThread_THREAD_STK_SIZE 						THREAD_STACK_SIZE
 
+//task avtpRxDemuxThread. One per interface shared by listener streams
+#define avtpRxDemuxThread_THREAD_STK_SIZE					THREAD_STACK_SIZE
+
 //task avdeccMsgThread
 #define avdeccMsgThread_THREAD_STK_SIZE						THREAD_STACK_SIZE
 
@@ -95,6 +101,9 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 //task openavbAcmpMessageRxThread
 #define openavbAcmpMessageRxThread_THREAD_STK_SIZE   			THREAD_STACK_SIZE
 
+//task openavbAvdeccLoopThread. Shared ADP/AECP/ACMP RX and timers
+#define openavbAvdeccLoopThread_THREAD_STK_SIZE   				THREAD_STACK_SIZE
+
 //task openavbAcmpSmTalkerThread
 #define openavbAcmpSmTalkerThread_THREAD_STK_SIZE   			THREAD_STACK_SIZE
 
@@ -68,6 +68,8 @@ static bool x_timeInit(void) {
 		return FALSE;
 	}
 
+	AVB_LOGF_INFO("GPTP %s read path", gptphasseqlock(gPtpMmap) ? "lock-free" : "mutex");
+
 	AVB_LOGF_INFO("local_time = %" PRIu64, gPtpTD.local_time);
 	AVB_LOGF_INFO("ml_phoffset = %" PRId64 ", ls_phoffset = %" PRId64, gPtpTD.ml_phoffset, gPtpTD.ls_phoffset);
 	AVB_LOGF_INFO("ml_freqffset = %Lf, ls_freqoffset = %Lf", gPtpTD.ml_freqoffset, gPtpTD.ls_freqoffset);
@@ -76,7 +78,30 @@ static bool x_timeInit(void) {
 	return TRUE;
 }
 
-static bool x_getPTPTime(U64 *timeNsec) {
+// Per thread copy of the gPTP parameters, folded into one linear conversion
+// from CLOCK_REALTIME to gPTP time:
+//   ptp = base + ratio * (realtime - sysRef)
+// It is refreshed only when the daemon's seqlock sequence changes.
+typedef struct {
+	bool valid;
+	U32 seq;
+	U64 base;
+	U64 sysRef;
+	double ratio;
+} ptp_time_cache_t;
+
+static __thread ptp_time_cache_t tPtpCache;
+
+static void x_refreshPTPCache(ptp_time_cache_t *pCache, const gPtpTimeData *td, U32 seq)
+{
+	pCache->base = td->local_time - td->ml_phoffset;
+	pCache->sysRef = td->local_time + td->ls_phoffset;
+	pCache->ratio = (double)(td->ml_freqoffset * td->ls_freqoffset);
+	pCache->seq = seq;
+	pCache->valid = TRUE;
+}
+
+static bool x_getPTPTimeLocked(U64 *timeNsec) {
 	AVB_TRACE_ENTRY(AVB_TRACE_TIME);
 
 	if (gptpgetdata(gPtpMmap, &gPtpTD) < 0) {
@@ -104,6 +129,36 @@ static bool x_getPTPTime(U64 *timeNsec) {
 	return FALSE;
 }
 
+static bool x_getPTPTime(U64 *timeNsec) {
+	ptp_time_cache_t *pCache = &tPtpCache;
+	struct timespec sysTime;
+
+	if (!gptphasseqlock(gPtpMmap)) {
+		// Daemon only publishes the mutex protected layout (the default, see avb_gptp.h)
+		return x_getPTPTimeLocked(timeNsec);
+	}
+
+	if (!pCache->valid || gptpgetseq(gPtpMmap) != pCache->seq) {
+		gPtpTimeData td;
+		U32 seq;
+		if (gptpgetdata_seqlock(gPtpMmap, &td, &seq) < 0) {
+			AVB_LOG_ERROR("GPTP data fetch failed");
+			return FALSE;
+		}
+		x_refreshPTPCache(pCache, &td, seq);
+		// Keep the shared copy current for the rawsock launch time conversions
+		gPtpTD = td;
+	}
+
+	if (clock_gettime(CLOCK_REALTIME, &sysTime) != 0) {
+		return FALSE;
+	}
+
+	S64 deltaSys = (S64)(((U64)sysTime.tv_sec * (U64)NANOSECONDS_PER_SECOND + (U64)sysTime.tv_nsec) - pCache->sysRef);
+	*timeNsec = pCache->base + (S64)(pCache->ratio * (double)deltaSys);
+	return TRUE;
+}
+
 bool osalAVBTimeInit(void) {
 	AVB_TRACE_ENTRY(AVB_TRACE_TIME);
 
@@ -143,6 +198,9 @@ bool osalClockGettime(openavb_clockId_t openavbClockId, struct timespec *getTime
 		case OPENAVB_TIMER_CLOCK:
 			clockId = CLOCK_MONOTONIC;
 			break;
+		case OPENAVB_CLOCK_THREAD_CPUTIME:
+			clockId = CLOCK_THREAD_CPUTIME_ID;
+			break;
 		case OPENAVB_CLOCK_WALLTIME:
 			break;
 		}
@@ -177,6 +235,9 @@ bool osalClockGettime64(openavb_clockId_t openavbClockId, U64 *timeNsec) {
 		case OPENAVB_TIMER_CLOCK:
 			clockId = CLOCK_MONOTONIC;
 			break;
+		case OPENAVB_CLOCK_THREAD_CPUTIME:
+			clockId = CLOCK_THREAD_CPUTIME_ID;
+			break;
 		case OPENAVB_CLOCK_WALLTIME:
 			break;
 		}
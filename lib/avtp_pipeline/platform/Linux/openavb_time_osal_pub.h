@@ -48,6 +48,7 @@ typedef enum {
 	OPENAVB_CLOCK_REALTIME,
 	OPENAVB_CLOCK_MONOTONIC,
 	OPENAVB_TIMER_CLOCK,
+	OPENAVB_CLOCK_THREAD_CPUTIME,	// CPU time used by the calling thread
 	OPENAVB_CLOCK_WALLTIME
 } openavb_clockId_t;
 
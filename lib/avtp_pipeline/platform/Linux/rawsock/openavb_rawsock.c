@@ -30,8 +30,10 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 *************************************************************************************************************/
 
 #include "sendmmsg_rawsock.h"
+#include "txtime_rawsock.h"
 #include "simple_rawsock.h"
 #include "ring_rawsock.h"
+#include "ringv3_rawsock.h"
 #if AVB_FEATURE_PCAP
 #include "pcap_rawsock.h"
 #if AVB_FEATURE_IGB
@@ -116,6 +118,20 @@ void *openavbRawsockOpen(const char *ifname_uri, bool rx_mode, bool tx_mode, U16
 		// call constructor
 		pvRawsock = ringRawsockOpen(rawsock, ifname, rx_mode, tx_mode, ethertype, frame_size, num_frames);
 
+	} else if (strcmp(proto, "ringv3") == 0) {
+
+		AVB_LOG_INFO("Using *ringv3* block buffer implementation");
+
+		// allocate memory for rawsock object
+		ringv3_rawsock_t *rawsock = calloc(1, sizeof(ringv3_rawsock_t));
+		if (!rawsock) {
+			AVB_LOG_ERROR("Creating rawsock; malloc failed");
+			return NULL;
+		}
+
+		// call constructor
+		pvRawsock = ringv3RawsockOpen(rawsock, ifname, rx_mode, tx_mode, ethertype, frame_size, num_frames);
+
 	} else if (strcmp(proto, "simple") == 0) {
 
 		AVB_LOG_INFO("Using *simple* implementation");
@@ -142,6 +158,19 @@ void *openavbRawsockOpen(const char *ifname_uri, bool rx_mode, bool tx_mode, U16
 
 		// call constructor
 		pvRawsock = sendmmsgRawsockOpen(rawsock, ifname, rx_mode, tx_mode, ethertype, frame_size, num_frames);
+	} else if (strcmp(proto, "txtime") == 0) {
+
+		AVB_LOG_INFO("Using *txtime* launch time implementation");
+
+		// allocate memory for rawsock object
+		txtime_rawsock_t *rawsock = calloc(1, sizeof(txtime_rawsock_t));
+		if (!rawsock) {
+			AVB_LOG_ERROR("Creating rawsock; malloc failed");
+			return NULL;
+		}
+
+		// call constructor
+		pvRawsock = txtimeRawsockOpen(rawsock, ifname, rx_mode, tx_mode, ethertype, frame_size, num_frames);
 #if AVB_FEATURE_PCAP
 	} else if (strcmp(proto, "pcap") == 0) {
 
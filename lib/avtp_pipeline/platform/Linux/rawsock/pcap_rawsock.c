@@ -122,6 +122,7 @@ void *pcapRawsockOpen(pcap_rawsock_t* rawsock, const char *ifname, bool rx_mode,
 	cb->getRxFrame = pcapRawsockGetRxFrame;
 	cb->rxMulticast = pcapRawsockRxMulticast;
 	cb->rxParseHdr = pcapRawsockRxParseHdr;
+	cb->getSocket = pcapRawsockGetSocket;
 
 	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
 	return rawsock;
@@ -210,6 +211,37 @@ U8 *pcapRawsockGetRxFrame(void *pvRawsock, U32 timeout, unsigned int *offset, un
 	return NULL;
 }
 
+// Get the socket used for this rawsock; can be used for poll/select
+int pcapRawsockGetSocket(void *pvRawsock)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK);
+	pcap_rawsock_t *rawsock = (pcap_rawsock_t*)pvRawsock;
+	if (!rawsock || !rawsock->handle) {
+		AVB_LOG_ERROR("Getting socket; invalid arguments");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return -1;
+	}
+
+	int fd = pcap_get_selectable_fd(rawsock->handle);
+	if (fd < 0) {
+		AVB_LOG_WARNING("pcap handle has no selectable descriptor");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return -1;
+	}
+
+	// A poll driven caller drains until no frame is left, so reads must not
+	// sit out the capture timeout once the buffer is empty.
+	char errbuf[PCAP_ERRBUF_SIZE];
+	if (pcap_setnonblock(rawsock->handle, 1, errbuf) < 0) {
+		AVB_LOGF_ERROR("pcap_setnonblock failed: %s", errbuf);
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return -1;
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+	return fd;
+}
+
 int pcapRawsockRxParseHdr(void* pvRawsock, U8* pBuffer, hdr_info_t* pInfo)
 {
 	int hdrLen = baseRawsockRxParseHdr(pvRawsock, pBuffer, pInfo);
@@ -223,27 +255,80 @@ int pcapRawsockRxParseHdr(void* pvRawsock, U8* pBuffer, hdr_info_t* pInfo)
 	return hdrLen;
 }
 
-// Setup the rawsock to receive multicast packets
-bool pcapRawsockRxMulticast(void *pvRawsock, bool add_membership, const U8 addr[ETH_ALEN])
+// Install a capture filter accepting every group in the membership list
+static bool x_pcapSetMcastFilter(pcap_rawsock_t *rawsock)
 {
-	pcap_rawsock_t *rawsock = (pcap_rawsock_t*)pvRawsock;
-
+	// "ether dst xx:xx:xx:xx:xx:xx" joined with " or "
+	char filter_exp[PCAP_RAWSOCK_MAX_MCAST * 33 + 1];
 	struct bpf_program comp_filter_exp;
-	char filter_exp[30];
+	int i, n = 0;
 
-	sprintf(filter_exp, "ether dst %02x:%02x:%02x:%02x:%02x:%02x", addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
+	filter_exp[0] = '\0';
+	for (i = 0; i < rawsock->rxMcastCount; i++) {
+		const U8 *addr = rawsock->rxMcast[i];
+		n += sprintf(filter_exp + n, "%sether dst %02x:%02x:%02x:%02x:%02x:%02x", i ? " or " : "",
+			addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
+	}
 
-	AVB_LOGF_DEBUG("%s %d %s", __func__, (int)add_membership, filter_exp);
+	AVB_LOGF_DEBUG("%s %s", __func__, filter_exp);
 
+	// An empty expression accepts everything, as before the first group was joined
 	if (pcap_compile(rawsock->handle, &comp_filter_exp, filter_exp, 0, PCAP_NETMASK_UNKNOWN) < 0) {
 		AVB_LOGF_ERROR("Could not parse filter %s: %s", filter_exp, pcap_geterr(rawsock->handle));
 		return false;
 	}
 
+	bool ret = true;
 	if (pcap_setfilter(rawsock->handle, &comp_filter_exp) < 0) {
 		AVB_LOGF_ERROR("Could not install filter %s: %s", filter_exp, pcap_geterr(rawsock->handle));
+		ret = false;
+	}
+	pcap_freecode(&comp_filter_exp);
+
+	return ret;
+}
+
+// Setup the rawsock to receive multicast packets
+bool pcapRawsockRxMulticast(void *pvRawsock, bool add_membership, const U8 addr[ETH_ALEN])
+{
+	pcap_rawsock_t *rawsock = (pcap_rawsock_t*)pvRawsock;
+	int i, n;
+
+	if (!rawsock || !rawsock->handle) {
+		AVB_LOG_ERROR("Setting multicast; invalid arguments");
 		return false;
 	}
 
-	return true;
+	AVB_LOGF_DEBUG("%s %d %02x:%02x:%02x:%02x:%02x:%02x", __func__, (int)add_membership,
+		addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
+
+	n = rawsock->rxMcastCount;
+	for (i = 0; i < n; i++) {
+		if (memcmp(rawsock->rxMcast[i], addr, ETH_ALEN) == 0)
+			break;
+	}
+
+	if (add_membership) {
+		if (i < n) {
+			return true;
+		}
+		if (n >= PCAP_RAWSOCK_MAX_MCAST) {
+			AVB_LOGF_ERROR("Setting multicast; filter already holds %d groups", n);
+			return false;
+		}
+		memcpy(rawsock->rxMcast[n], addr, ETH_ALEN);
+		rawsock->rxMcastCount = n + 1;
+		if (!x_pcapSetMcastFilter(rawsock)) {
+			rawsock->rxMcastCount = n;
+			return false;
+		}
+		return true;
+	}
+
+	if (i == n) {
+		return true;
+	}
+	memmove(rawsock->rxMcast[i], rawsock->rxMcast[i + 1], (n - i - 1) * ETH_ALEN);
+	rawsock->rxMcastCount = n - 1;
+	return x_pcapSetMcastFilter(rawsock);
 }
@@ -35,11 +35,16 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "rawsock_impl.h"
 #include <pcap/pcap.h>
 
+#define PCAP_RAWSOCK_MAX_MCAST	32
+
 typedef struct {
 	base_rawsock_t base;
 	pcap_t* handle;
 	U8 txBuffer[1518];
 	struct pcap_pkthdr *rxHeader;
+	// Groups joined on this handle; the capture filter accepts all of them
+	U8 rxMcast[PCAP_RAWSOCK_MAX_MCAST][ETH_ALEN];
+	int rxMcastCount;
 } pcap_rawsock_t;
 
 void *pcapRawsockOpen(pcap_rawsock_t* rawsock, const char *ifname, bool rx_mode, bool tx_mode, U16 ethertype, U32 frame_size, U32 num_frames);
@@ -54,6 +59,8 @@ int pcapRawsockSend(void *pvRawsock);
 
 U8 *pcapRawsockGetRxFrame(void *pvRawsock, U32 timeout, unsigned int *offset, unsigned int *len);
 
+int pcapRawsockGetSocket(void *pvRawsock);
+
 int pcapRawsockRxParseHdr(void* pvRawsock, U8* pBuffer, hdr_info_t* pInfo);
 
 bool pcapRawsockRxMulticast(void *pvRawsock, bool add_membership, const U8 addr[ETH_ALEN]);
@@ -156,6 +156,7 @@ void* ringRawsockOpen(ring_rawsock_t *rawsock, const char *ifname, bool rx_mode,
 	rawsock_cb_t *cb = &rawsock->base.cb;
 	cb->close = ringRawsockClose;
 	cb->getTxFrame = ringRawsockGetTxFrame;
+	cb->getTxFrames = ringRawsockGetTxFrames;
 	cb->relTxFrame = ringRawsockRelTxFrame;
 	cb->txFrameReady = ringRawsockTxFrameReady;
 	cb->send = ringRawsockSend;
@@ -302,6 +303,53 @@ U8* ringRawsockGetTxFrame(void *pvRawsock, bool blocking, unsigned int *len)
 	return (U8*)pBuffer;
 }
 
+// Get a run of consecutive buffers from the ring to use for TX
+int ringRawsockGetTxFrames(void *pvRawsock, bool blocking, U8 **ppFrames, U32 count, unsigned int *len)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	ring_rawsock_t *rawsock = (ring_rawsock_t*)pvRawsock;
+
+	if (!VALID_TX_RAWSOCK(rawsock) || ppFrames == NULL || count == 0) {
+		AVB_LOG_ERROR("Getting TX frames; bad arguments");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return 0;
+	}
+
+	// Wait for the first buffer the same way as for a single frame
+	ppFrames[0] = ringRawsockGetTxFrame(pvRawsock, blocking, len);
+	if (!ppFrames[0]) {
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return 0;
+	}
+
+	// Then take the following buffers for as long as the kernel is done with them
+	U32 nFrames = 1;
+	while (nFrames < count && rawsock->buffersOut < rawsock->frameCount) {
+		volatile struct tpacket2_hdr *pHdr =
+			(struct tpacket2_hdr*)(rawsock->pMem
+								   + (rawsock->blockIndex * rawsock->blockSize)
+								   + (rawsock->bufferIndex * rawsock->bufferSize));
+		if (pHdr->tp_status != TP_STATUS_AVAILABLE) {
+			break;
+		}
+
+		ppFrames[nFrames++] = (U8*)pHdr + rawsock->bufHdrSize;
+
+		if (++(rawsock->bufferIndex) >= (rawsock->frameCount/rawsock->blockCount)) {
+			rawsock->bufferIndex = 0;
+			if (++(rawsock->blockIndex) >= rawsock->blockCount) {
+				rawsock->blockIndex = 0;
+			}
+		}
+		rawsock->buffersOut += 1;
+	}
+
+	AVB_LOGF_VERBOSE("Reserved %d of %d TX frames, out=%d", nFrames, count, rawsock->buffersOut);
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return nFrames;
+}
+
 // Release a TX frame, without marking it as ready to send
 bool ringRawsockRelTxFrame(void *pvRawsock, U8 *pBuffer)
 {
@@ -320,6 +368,22 @@ bool ringRawsockRelTxFrame(void *pvRawsock, U8 *pBuffer)
 	pHdr->tp_status = TP_STATUS_KERNEL;
 	rawsock->buffersOut -= 1;
 
+	// If this is the most recently reserved buffer, hand its slot back.
+	// The kernel stops at the first slot that isn't ready to send, so the
+	// unused tail of a batch must not be left as a hole in the ring.
+	int blockIndex = rawsock->blockIndex;
+	int bufferIndex = rawsock->bufferIndex;
+	if (--bufferIndex < 0) {
+		bufferIndex = (rawsock->frameCount/rawsock->blockCount) - 1;
+		if (--blockIndex < 0) {
+			blockIndex = rawsock->blockCount - 1;
+		}
+	}
+	if ((U8*)pHdr == rawsock->pMem + (blockIndex * rawsock->blockSize) + (bufferIndex * rawsock->bufferSize)) {
+		rawsock->blockIndex = blockIndex;
+		rawsock->bufferIndex = bufferIndex;
+	}
+
 	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
 	return TRUE;
 }
@@ -85,6 +85,9 @@ void ringRawsockClose(void *pvRawsock);
 // Get a buffer from the ring to use for TX
 U8* ringRawsockGetTxFrame(void *pvRawsock, bool blocking, unsigned int *len);
 
+// Get a run of consecutive buffers from the ring to use for TX
+int ringRawsockGetTxFrames(void *pvRawsock, bool blocking, U8 **ppFrames, U32 count, unsigned int *len);
+
 // Release a TX frame, without marking it as ready to send
 bool ringRawsockRelTxFrame(void *pvRawsock, U8 *pBuffer);
 
@@ -0,0 +1,384 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+#include "ringv3_rawsock.h"
+#include "simple_rawsock.h"
+#include <linux/if_packet.h>
+
+#include "openavb_trace.h"
+
+#define	AVB_LOG_COMPONENT	"Raw Socket"
+#include "openavb_log.h"
+
+// Keep enough blocks that the kernel can go on filling while the client works on a few
+#define RINGV3_MIN_BLOCK_COUNT 4
+
+#define RINGV3_BLOCK(rawsock, index) \
+	((volatile struct tpacket_block_desc*)((rawsock)->ring.pMem + ((index) * (rawsock)->ring.blockSize)))
+
+// Wait for the kernel to hand over a block
+static bool x_ringv3Poll(ringv3_rawsock_t *rawsock, U32 timeout)
+{
+	struct timespec ts, *pts = NULL;
+	struct pollfd pfd;
+
+	if (timeout != OPENAVB_RAWSOCK_BLOCK) {
+		ts.tv_sec = timeout / MICROSECONDS_PER_SECOND;
+		ts.tv_nsec = (timeout % MICROSECONDS_PER_SECOND) * NANOSECONDS_PER_USEC;
+		pts = &ts;
+	}
+
+	pfd.fd = rawsock->ring.sock;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	int ret = ppoll(&pfd, 1, pts, NULL);
+	if (ret < 0) {
+		if (errno != EINTR) {
+			AVB_LOGF_ERROR("Getting RX frame; poll failed: %s", strerror(errno));
+		}
+		return FALSE;
+	}
+	return (pfd.revents & POLLIN) != 0;
+}
+
+// Step to the next received frame. If the block being read is used up,
+// move on to the next block, waiting up to timeout for it if bWait is set.
+static struct tpacket3_hdr *x_ringv3NextPkt(ringv3_rawsock_t *rawsock, bool bWait, U32 timeout)
+{
+	while (rawsock->pktsLeft == 0) {
+		int blockIndex = rawsock->ring.blockIndex;
+		volatile struct tpacket_block_desc *pBlock = RINGV3_BLOCK(rawsock, blockIndex);
+
+		if ((pBlock->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+			// The kernel fills the blocks strictly in order, so there is
+			// nothing to do but wait for this one.
+			if (!bWait || !x_ringv3Poll(rawsock, timeout)) {
+				return NULL;
+			}
+			bWait = FALSE;
+			continue;
+		}
+		__sync_synchronize();
+
+		rawsock->pktsLeft = pBlock->hdr.bh1.num_pkts;
+		rawsock->pNextPkt = (U8*)pBlock + pBlock->hdr.bh1.offset_to_first_pkt;
+		rawsock->pBlockPktsOut[blockIndex] = rawsock->pktsLeft;
+		rawsock->ring.buffersOut += 1;
+
+		if (++(rawsock->ring.blockIndex) >= rawsock->ring.blockCount) {
+			rawsock->ring.blockIndex = 0;
+		}
+
+		if (rawsock->pktsLeft == 0) {
+			// Retired by timeout without any frames
+			rawsock->ring.buffersOut -= 1;
+			pBlock->hdr.bh1.block_status = TP_STATUS_KERNEL;
+		}
+	}
+
+	struct tpacket3_hdr *pPkt = (struct tpacket3_hdr*)rawsock->pNextPkt;
+	rawsock->pNextPkt += pPkt->tp_next_offset;
+	rawsock->pktsLeft -= 1;
+	return pPkt;
+}
+
+// Open a rawsock for TX or RX
+void* ringv3RawsockOpen(ringv3_rawsock_t *rawsock, const char *ifname, bool rx_mode, bool tx_mode, U16 ethertype, U32 frame_size, U32 num_frames)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK);
+
+	if (tx_mode) {
+		// TPACKET_V3 has nothing to offer for TX; use the TPACKET_V2 TX ring.
+		void *pvRawsock = ringRawsockOpen(&rawsock->ring, ifname, rx_mode, tx_mode, ethertype, frame_size, num_frames);
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return pvRawsock;
+	}
+
+	if (!simpleRawsockOpen((simple_rawsock_t*)rawsock, ifname, rx_mode,
+			       tx_mode, ethertype, frame_size, num_frames))
+	{
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return NULL;
+	}
+
+	rawsock->ring.pMem = (void*)(-1);
+
+	int val = TPACKET_V3;
+	if (setsockopt(rawsock->ring.sock, SOL_PACKET, PACKET_VERSION, &val, sizeof(val)) < 0) {
+		AVB_LOGF_ERROR("Creating rawsock; set PACKET_VERSION: %s", strerror(errno));
+		ringv3RawsockClose(rawsock);
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return NULL;
+	}
+
+	// Frames are packed into the blocks at whatever length they have;
+	// the frame size only tells the kernel how many fit into the ring.
+	rawsock->ring.bufHdrSize = TPACKET_ALIGN(TPACKET3_HDRLEN);
+	rawsock->ring.bufferSize = TPACKET_ALIGN(rawsock->ring.base.frameSize + rawsock->ring.bufHdrSize);
+
+	// Get number of bytes in a memory page.  The blocks we ask for
+	// must be a multiple of pagesize.
+	int pagesize = getpagesize();
+	rawsock->ring.blockSize = pagesize * 4;
+	while (rawsock->ring.blockSize < rawsock->ring.bufferSize) {
+		rawsock->ring.blockSize *= 2;
+	}
+
+	int buffersPerBlock = rawsock->ring.blockSize / rawsock->ring.bufferSize;
+	rawsock->ring.blockCount = num_frames / buffersPerBlock + 1;
+	if (rawsock->ring.blockCount < RINGV3_MIN_BLOCK_COUNT) {
+		rawsock->ring.blockCount = RINGV3_MIN_BLOCK_COUNT;
+	}
+	rawsock->ring.frameCount = buffersPerBlock * rawsock->ring.blockCount;
+
+	AVB_LOGF_DEBUG("frameSize=%d, bufferSize=%d, blockSize=%d, blockCount=%d, frameCount=%d",
+				   rawsock->ring.base.frameSize, rawsock->ring.bufferSize,
+				   rawsock->ring.blockSize, rawsock->ring.blockCount, rawsock->ring.frameCount);
+
+	struct tpacket_req3 s_packet_req;
+	memset(&s_packet_req, 0, sizeof(s_packet_req));
+	s_packet_req.tp_block_size = rawsock->ring.blockSize;
+	s_packet_req.tp_frame_size = rawsock->ring.bufferSize;
+	s_packet_req.tp_block_nr = rawsock->ring.blockCount;
+	s_packet_req.tp_frame_nr = rawsock->ring.frameCount;
+	s_packet_req.tp_retire_blk_tov = RINGV3_RETIRE_TIMEOUT_MSEC;
+
+	if (setsockopt(rawsock->ring.sock, SOL_PACKET, PACKET_RX_RING,
+				   (char*)&s_packet_req, sizeof(s_packet_req)) < 0) {
+		AVB_LOGF_ERROR("Creating rawsock, RX_RING: %s", strerror(errno));
+		ringv3RawsockClose(rawsock);
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return NULL;
+	}
+
+	rawsock->ring.memSize = rawsock->ring.blockCount * rawsock->ring.blockSize;
+	rawsock->ring.pMem = mmap((void*)0, rawsock->ring.memSize, PROT_READ|PROT_WRITE, MAP_SHARED, rawsock->ring.sock, (off_t)0);
+	if (rawsock->ring.pMem == (void*)(-1)) {
+		AVB_LOGF_ERROR("Creating rawsock; MMAP: %s", strerror(errno));
+		ringv3RawsockClose(rawsock);
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return NULL;
+	}
+	AVB_LOGF_DEBUG("mmap: %p", rawsock->ring.pMem);
+
+	rawsock->pBlockPktsOut = calloc(rawsock->ring.blockCount, sizeof(U32));
+	if (!rawsock->pBlockPktsOut) {
+		AVB_LOG_ERROR("Creating rawsock; malloc failed");
+		ringv3RawsockClose(rawsock);
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return NULL;
+	}
+
+	// Initialize the state of the ring
+	rawsock->ring.blockIndex = 0;
+	rawsock->ring.buffersOut = 0;
+	rawsock->pNextPkt = NULL;
+	rawsock->pktsLeft = 0;
+
+	// fill virtual functions table
+	rawsock_cb_t *cb = &rawsock->ring.base.cb;
+	cb->close = ringv3RawsockClose;
+	cb->rxBufLevel = ringv3RawsockRxBufLevel;
+	cb->getRxFrame = ringv3RawsockGetRxFrame;
+	cb->getRxFrames = ringv3RawsockGetRxFrames;
+	cb->rxParseHdr = ringv3RawsockRxParseHdr;
+	cb->relRxFrame = ringv3RawsockRelRxFrame;
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+	return rawsock;
+}
+
+// Close the rawsock
+void ringv3RawsockClose(void *pvRawsock)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK);
+	ringv3_rawsock_t *rawsock = (ringv3_rawsock_t*)pvRawsock;
+
+	if (rawsock) {
+		free(rawsock->pBlockPktsOut);
+		rawsock->pBlockPktsOut = NULL;
+	}
+
+	ringRawsockClose(pvRawsock);
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+}
+
+// Count RX blocks held by the client
+int ringv3RawsockRxBufLevel(void *pvRawsock)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	ringv3_rawsock_t *rawsock = (ringv3_rawsock_t*)pvRawsock;
+
+	int iBlock, nInUse = 0;
+
+	if (!VALID_RX_RAWSOCK(rawsock)) {
+		AVB_LOG_ERROR("getting buffer level; invalid arguments");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return FALSE;
+	}
+
+	for (iBlock = 0; iBlock < rawsock->ring.blockCount; iBlock++) {
+		if (RINGV3_BLOCK(rawsock, iBlock)->hdr.bh1.block_status & TP_STATUS_USER)
+			nInUse++;
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return nInUse;
+}
+
+// Get a RX frame
+U8* ringv3RawsockGetRxFrame(void *pvRawsock, U32 timeout, unsigned int *offset, unsigned int *len)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+
+	U8 *pBuffer = NULL;
+	if (ringv3RawsockGetRxFrames(pvRawsock, timeout, &pBuffer, offset, len, 1) != 1) {
+		pBuffer = NULL;
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return pBuffer;
+}
+
+// Get up to count RX frames, waiting only for the first one
+int ringv3RawsockGetRxFrames(void *pvRawsock, U32 timeout, U8 **ppFrames, unsigned int *pOffsets, unsigned int *pLens, U32 count)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	ringv3_rawsock_t *rawsock = (ringv3_rawsock_t*)pvRawsock;
+
+	if (!VALID_RX_RAWSOCK(rawsock) || ppFrames == NULL || pOffsets == NULL || pLens == NULL) {
+		AVB_LOG_ERROR("Getting RX frames; invalid arguments");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return 0;
+	}
+
+	U32 nFrames = 0;
+	while (nFrames < count) {
+		struct tpacket3_hdr *pHdr = x_ringv3NextPkt(rawsock, nFrames == 0, timeout);
+		if (!pHdr) {
+			break;
+		}
+
+		// Check the "losing" flag.  That indicates that the ring is full,
+		// and the kernel had to toss some frames. There is no "winning" flag.
+		if ((pHdr->tp_status & TP_STATUS_LOSING)) {
+			if (!rawsock->ring.bLosing) {
+				AVB_LOG_WARNING("Getting RX frame; mmap buffers full");
+				rawsock->ring.bLosing = TRUE;
+			}
+		}
+		else {
+			rawsock->ring.bLosing = FALSE;
+		}
+
+		if (pHdr->tp_snaplen < pHdr->tp_len) {
+			IF_LOG_INTERVAL(1000) AVB_LOGF_WARNING("Getting RX frame; partial frame ignored (len %d, snaplen %d)", pHdr->tp_len, pHdr->tp_snaplen);
+			ringv3RawsockRelRxFrame(rawsock, (U8*)pHdr);
+			continue;
+		}
+
+		ppFrames[nFrames] = (U8*)pHdr;
+		pOffsets[nFrames] = pHdr->tp_mac;
+		pLens[nFrames] = pHdr->tp_snaplen;
+		nFrames++;
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return nFrames;
+}
+
+// Parse the ethernet frame header.  Returns length of header, or -1 for failure
+int ringv3RawsockRxParseHdr(void *pvRawsock, U8 *pBuffer, hdr_info_t *pInfo)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	ringv3_rawsock_t *rawsock = (ringv3_rawsock_t*)pvRawsock;
+	int hdrLen;
+	if (!VALID_RX_RAWSOCK(rawsock)) {
+		AVB_LOG_ERROR("Parsing Ethernet headers; invalid arguments");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return -1;
+	}
+
+	struct tpacket3_hdr *pHdr = (struct tpacket3_hdr*)pBuffer;
+
+	memset(pInfo, 0, sizeof(hdr_info_t));
+
+	eth_hdr_t *pNoTag = (eth_hdr_t*)(pBuffer + pHdr->tp_mac);
+	hdrLen = pHdr->tp_net - pHdr->tp_mac;
+	pInfo->shost = pNoTag->shost;
+	pInfo->dhost = pNoTag->dhost;
+	pInfo->ethertype = ntohs(pNoTag->ethertype);
+	pInfo->ts.tv_sec = pHdr->tp_sec;
+	pInfo->ts.tv_nsec = pHdr->tp_nsec;
+
+	if (pInfo->ethertype == ETHERTYPE_8021Q) {
+		pInfo->vlan = TRUE;
+		pInfo->vlan_vid = pHdr->hv1.tp_vlan_tci & 0x0FFF;
+		pInfo->vlan_pcp = (pHdr->hv1.tp_vlan_tci >> 13) & 0x0007;
+		pInfo->ethertype = ntohs(*(U16*)( ((U8*)(&pNoTag->ethertype)) + 4));
+		hdrLen += 4;
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return hdrLen;
+}
+
+// Release a RX frame held by the client
+bool ringv3RawsockRelRxFrame(void *pvRawsock, U8 *pBuffer)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	ringv3_rawsock_t *rawsock = (ringv3_rawsock_t*)pvRawsock;
+
+	if (!VALID_RX_RAWSOCK(rawsock) || pBuffer == NULL) {
+		AVB_LOG_ERROR("Releasing RX frame; invalid arguments");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return FALSE;
+	}
+
+	int blockIndex = (pBuffer - rawsock->ring.pMem) / rawsock->ring.blockSize;
+	if (blockIndex < 0 || blockIndex >= rawsock->ring.blockCount || rawsock->pBlockPktsOut[blockIndex] == 0) {
+		AVB_LOG_ERROR("Releasing RX frame; frame not held");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return FALSE;
+	}
+
+	// Hand the block back once all of its frames are released
+	if (--(rawsock->pBlockPktsOut[blockIndex]) == 0) {
+		__sync_synchronize();
+		RINGV3_BLOCK(rawsock, blockIndex)->hdr.bh1.block_status = TP_STATUS_KERNEL;
+		rawsock->ring.buffersOut -= 1;
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return TRUE;
+}
@@ -0,0 +1,79 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+#ifndef RINGV3_RAWSOCK_H
+#define RINGV3_RAWSOCK_H
+
+#include "ring_rawsock.h"
+
+// Time after which the kernel hands over a partly filled RX block
+#define RINGV3_RETIRE_TIMEOUT_MSEC 1
+
+// State information for raw socket
+//
+// TX uses the TPACKET_V2 ring of ring_rawsock. RX uses a TPACKET_V3
+// ring where the kernel fills whole blocks of frames, so that one
+// wakeup delivers all frames received within the retire timeout.
+typedef struct {
+	ring_rawsock_t ring;
+
+	// Next frame to hand out from the block being read
+	U8 *pNextPkt;
+	// Number of frames left in the block being read
+	U32 pktsLeft;
+
+	// Frames of each block not yet released by the client.
+	// A block goes back to the kernel when this drops to zero.
+	U32 *pBlockPktsOut;
+} ringv3_rawsock_t;
+
+// Open a rawsock for TX or RX
+void* ringv3RawsockOpen(ringv3_rawsock_t *rawsock, const char *ifname, bool rx_mode, bool tx_mode, U16 ethertype, U32 frame_size, U32 num_frames);
+
+// Close the rawsock
+void ringv3RawsockClose(void *pvRawsock);
+
+// Count RX blocks held by the client
+int ringv3RawsockRxBufLevel(void *pvRawsock);
+
+// Get a RX frame
+U8* ringv3RawsockGetRxFrame(void *pvRawsock, U32 timeout, unsigned int *offset, unsigned int *len);
+
+// Get up to count RX frames, waiting only for the first one
+int ringv3RawsockGetRxFrames(void *pvRawsock, U32 timeout, U8 **ppFrames, unsigned int *pOffsets, unsigned int *pLens, U32 count);
+
+// Parse the ethernet frame header.  Returns length of header, or -1 for failure
+int ringv3RawsockRxParseHdr(void *pvRawsock, U8 *pBuffer, hdr_info_t *pInfo);
+
+// Release a RX frame held by the client
+bool ringv3RawsockRelRxFrame(void *pvRawsock, U8 *pBuffer);
+
+#endif
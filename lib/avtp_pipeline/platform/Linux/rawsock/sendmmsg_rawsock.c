@@ -164,22 +164,35 @@ void* sendmmsgRawsockOpen(sendmmsg_rawsock_t* rawsock, const char *ifname, bool
 		return NULL;
 	}
 
-	// Clear our buffers and other tracking data
-	memset(rawsock->mmsg, 0, sizeof(rawsock->mmsg));
-	memset(rawsock->miov, 0, sizeof(rawsock->miov));
-	memset(rawsock->pktbuf, 0, sizeof(rawsock->pktbuf));
+	// Allocate one message per requested buffer, so that all the frames
+	// of a talker interval can go out with a single sendmmsg call.
+	rawsock->frameCount = num_frames > MSG_COUNT ? num_frames : MSG_COUNT;
+	rawsock->mmsg = calloc(rawsock->frameCount, sizeof(*rawsock->mmsg));
+	rawsock->miov = calloc(rawsock->frameCount, sizeof(*rawsock->miov));
+	rawsock->pktbuf = calloc(rawsock->frameCount, sizeof(*rawsock->pktbuf));
 #if USE_LAUNCHTIME
-	memset(rawsock->cmsgbuf, 0, sizeof(rawsock->cmsgbuf));
+	rawsock->cmsgbuf = calloc(rawsock->frameCount, sizeof(*rawsock->cmsgbuf));
 #endif
+	if (!rawsock->mmsg || !rawsock->miov || !rawsock->pktbuf
+#if USE_LAUNCHTIME
+		|| !rawsock->cmsgbuf
+#endif
+		) {
+		AVB_LOG_ERROR("Creating rawsock; malloc failed");
+		sendmmsgRawsockClose(rawsock);
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return NULL;
+	}
 
 	rawsock->buffersOut = 0;
 	rawsock->buffersReady = 0;
-	rawsock->frameCount = MSG_COUNT;
 
 	// fill virtual functions table
 	rawsock_cb_t *cb = &rawsock->base.cb;
 	cb->close = sendmmsgRawsockClose;
 	cb->getTxFrame = sendmmsgRawsockGetTxFrame;
+	cb->getTxFrames = sendmmsgRawsockGetTxFrames;
+	cb->relTxFrame = sendmmsgRawsockRelTxFrame;
 	cb->txSetMark = sendmmsgRawsockTxSetMark;
 	cb->txSetHdr = sendmmsgRawsockTxSetHdr;
 	cb->txFrameReady = sendmmsgRawsockTxFrameReady;
@@ -203,6 +216,17 @@ void sendmmsgRawsockClose(void *pvRawsock)
 			close(rawsock->sock);
 			rawsock->sock = -1;
 		}
+
+		free(rawsock->mmsg);
+		rawsock->mmsg = NULL;
+		free(rawsock->miov);
+		rawsock->miov = NULL;
+		free(rawsock->pktbuf);
+		rawsock->pktbuf = NULL;
+#if USE_LAUNCHTIME
+		free(rawsock->cmsgbuf);
+		rawsock->cmsgbuf = NULL;
+#endif
 	}
 
 	baseRawsockClose(rawsock);
@@ -238,6 +262,60 @@ U8* sendmmsgRawsockGetTxFrame(void *pvRawsock, bool blocking, unsigned int *len)
 	return  pBuffer;
 }
 
+// Get several buffers to use for TX, all sent by the next sendmmsg call
+int sendmmsgRawsockGetTxFrames(void *pvRawsock, bool blocking, U8 **ppFrames, U32 count, unsigned int *len)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	sendmmsg_rawsock_t *rawsock = (sendmmsg_rawsock_t*)pvRawsock;
+
+	if (!VALID_TX_RAWSOCK(rawsock) || ppFrames == NULL) {
+		AVB_LOG_ERROR("Getting TX frames; bad arguments");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return 0;
+	}
+
+	U32 nFrames = 0;
+	while (nFrames < count && rawsock->buffersOut < rawsock->frameCount) {
+		ppFrames[nFrames++] = rawsock->pktbuf[rawsock->buffersOut];
+		rawsock->buffersOut += 1;
+	}
+	if (nFrames == 0 && count > 0) {
+		AVB_LOG_ERROR("Getting TX frames; too many TX buffers in use");
+	}
+
+	// Remind client how big the frame buffers are
+	if (len)
+		*len = rawsock->base.frameSize;
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return nFrames;
+}
+
+// Release the most recently taken TX frame without sending it
+bool sendmmsgRawsockRelTxFrame(void *pvRawsock, U8 *pBuffer)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	sendmmsg_rawsock_t *rawsock = (sendmmsg_rawsock_t*)pvRawsock;
+
+	if (!VALID_TX_RAWSOCK(rawsock) || pBuffer == NULL) {
+		AVB_LOG_ERROR("Releasing TX frame; invalid argument");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return FALSE;
+	}
+
+	// Buffers are handed out in order, so only the last one taken can go back
+	if (rawsock->buffersOut <= rawsock->buffersReady
+		|| pBuffer != rawsock->pktbuf[rawsock->buffersOut - 1]) {
+		AVB_LOG_ERROR("Releasing TX frame; not the last frame taken");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return FALSE;
+	}
+	rawsock->buffersOut -= 1;
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return TRUE;
+}
+
 // Set the Firewall MARK on the socket
 // The mark is used by FQTSS to identify AVTP packets in kernel.
 // FQTSS creates a mark that includes the AVB class and stream index.
@@ -438,49 +516,19 @@ bool sendmmsgRawsockRxMulticast(void *pvRawsock, bool add_membership, const U8 a
 
 	// In addition to adding the multicast membership, we also want to
 	//	add a packet filter to restrict the packets that we'll receive
-	//	on this socket.  Multicast memeberships are global - not
-	//	per-socket, so without the filter, this socket would receieve
+	//	on this socket.  Multicast memberships are global - not
+	//	per-socket, so without the filter, this socket would receive
 	//	packets for all the multicast addresses added by all other
-	//	sockets.
+	//	sockets.  All groups joined on this socket pass the filter.
 	//
-	if (add_membership)
-	{
-		// Here's the template packet filter code.
-		// It was produced by running:
-		//   tcpdump -dd ether dest host 91:e0:01:02:03:04
-		struct sock_filter bpfCode[] = {
-			{ 0x20, 0, 0, 0x00000002 },
-			{ 0x15, 0, 3, 0x01020304 },   // last 4 bytes of dest mac
-			{ 0x28, 0, 0, 0x00000000 },
-			{ 0x15, 0, 1, 0x000091e0 },   // first 2 bytes of dest mac
-			{ 0x06, 0, 0, 0x0000ffff },
-			{ 0x06, 0, 0, 0x00000000 }
-		};
-
-		// We need to graft our multicast dest address into bpfCode
-		U32 tmp; U8 *buf = (U8*)&tmp;
-		memcpy(buf, mcast_addr.ether_addr_octet + 2, 4);
-		bpfCode[1].k = ntohl(tmp);
-		memset(buf, 0, 4);
-		memcpy(buf + 2, mcast_addr.ether_addr_octet, 2);
-		bpfCode[3].k = ntohl(tmp);
-
-		// Now wrap the filter code in the appropriate structure
-		struct sock_fprog filter;
-		memset(&filter, 0, sizeof(filter));
-		filter.len = 6;
-		filter.filter = bpfCode;
-
-		// And attach it to our socket
-		if (setsockopt(rawsock->sock, SOL_SOCKET, SO_ATTACH_FILTER,
-						&filter, sizeof(filter)) < 0) {
-			AVB_LOGF_ERROR("Setting multicast; setsockopt(SO_ATTACH_FILTER) failed: %s", strerror(errno));
-		}
-	}
-	else {
-		if (setsockopt(rawsock->sock, SOL_SOCKET, SO_DETACH_FILTER, NULL, 0) < 0) {
-			AVB_LOGF_ERROR("Setting multicast; setsockopt(SO_DETACH_FILTER) failed: %s", strerror(errno));
+	if (!simpleRawsockRxMcastFilter(rawsock->sock, rawsock->rxMcast, &rawsock->rxMcastCount, add_membership, mcast_addr.ether_addr_octet)) {
+		if (add_membership) {
+			// Leave the group again rather than receive it unfiltered
+			setsockopt(rawsock->sock, SOL_PACKET, PACKET_DROP_MEMBERSHIP,
+					(void*)&mreq, sizeof(struct packet_mreq));
 		}
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return FALSE;
 	}
 
 	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
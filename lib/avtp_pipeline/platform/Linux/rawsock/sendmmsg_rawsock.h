@@ -39,7 +39,9 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include <sys/socket.h>
 
 #include "rawsock_impl.h"
+#include "simple_rawsock.h"
 
+// Minimum number of messages that can be batched into one sendmmsg call
 #define MSG_COUNT 8
 #define MAX_FRAME_SIZE 1024
 #define USE_LAUNCHTIME 0
@@ -65,13 +67,18 @@ typedef struct {
 	// buffer for receiving frames
 	U8 rxBuffer[1518];
 
-	struct mmsghdr mmsg[MSG_COUNT];
+	// multicast groups joined on this socket
+	U8 rxMcast[SIMPLE_RAWSOCK_MAX_MCAST][ETH_ALEN];
+	int rxMcastCount;
 
-	struct iovec miov[MSG_COUNT];
+	// per-message state, frameCount entries each
+	struct mmsghdr *mmsg;
 
-	unsigned char pktbuf[MSG_COUNT][MAX_FRAME_SIZE];
+	struct iovec *miov;
+
+	unsigned char (*pktbuf)[MAX_FRAME_SIZE];
 #if USE_LAUNCHTIME
-	unsigned char cmsgbuf[MSG_COUNT][CMSG_SPACE(sizeof(uint64_t))];
+	unsigned char (*cmsgbuf)[CMSG_SPACE(sizeof(uint64_t))];
 #endif
 } sendmmsg_rawsock_t;
 
@@ -84,6 +91,12 @@ void sendmmsgRawsockClose(void *pvRawsock);
 // Get a buffer from the simple to use for TX
 U8* sendmmsgRawsockGetTxFrame(void *pvRawsock, bool blocking, unsigned int *len);
 
+// Get several buffers to use for TX, all sent by the next sendmmsg call
+int sendmmsgRawsockGetTxFrames(void *pvRawsock, bool blocking, U8 **ppFrames, U32 count, unsigned int *len);
+
+// Release the most recently taken TX frame without sending it
+bool sendmmsgRawsockRelTxFrame(void *pvRawsock, U8 *pBuffer);
+
 // Set the Firewall MARK on the socket
 // The mark is used by FQTSS to identify AVTP packets in kernel.
 // FQTSS creates a mark that includes the AVB class and stream index.
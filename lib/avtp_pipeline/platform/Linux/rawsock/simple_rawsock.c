@@ -387,6 +387,80 @@ U8* simpleRawsockGetRxFrame(void *pvRawsock, U32 timeout, unsigned int *offset,
 	return pBuffer;
 }
 
+// Track the multicast groups joined on a socket and filter for all of them
+bool simpleRawsockRxMcastFilter(int sock, U8 mcast[][ETH_ALEN], int *pCount, bool add_membership, const U8 addr[ETH_ALEN])
+{
+	int i, n = *pCount;
+	bool added = FALSE;
+
+	for (i = 0; i < n; i++) {
+		if (memcmp(mcast[i], addr, ETH_ALEN) == 0)
+			break;
+	}
+
+	if (add_membership) {
+		if (i == n) {
+			if (n >= SIMPLE_RAWSOCK_MAX_MCAST) {
+				AVB_LOGF_ERROR("Setting multicast; filter already holds %d groups", n);
+				return FALSE;
+			}
+			memcpy(mcast[n++], addr, ETH_ALEN);
+			added = TRUE;
+		}
+	}
+	else if (i < n) {
+		memmove(mcast[i], mcast[i + 1], (n - i - 1) * ETH_ALEN);
+		n--;
+	}
+	*pCount = n;
+
+	if (n == 0) {
+		if (setsockopt(sock, SOL_SOCKET, SO_DETACH_FILTER, NULL, 0) < 0) {
+			AVB_LOGF_ERROR("Setting multicast; setsockopt(SO_DETACH_FILTER) failed: %s", strerror(errno));
+			return FALSE;
+		}
+		return TRUE;
+	}
+
+	// The filter code for one group was produced by running:
+	//   tcpdump -dd ether dest host 91:e0:01:02:03:04
+	// Each group repeats its compare of the dest mac and jumps
+	// to the accept at the end on a match.
+	struct sock_filter bpfCode[SIMPLE_RAWSOCK_MAX_MCAST * 4 + 2];
+	for (i = 0; i < n; i++) {
+		U32 tmp; U8 *buf = (U8*)&tmp;
+		struct sock_filter *pCode = &bpfCode[i * 4];
+
+		memcpy(buf, mcast[i] + 2, 4);
+		pCode[0] = (struct sock_filter){ 0x20, 0, 0, 0x00000002 };
+		pCode[1] = (struct sock_filter){ 0x15, 0, 2, ntohl(tmp) };	// last 4 bytes of dest mac
+		memset(buf, 0, 4);
+		memcpy(buf + 2, mcast[i], 2);
+		pCode[2] = (struct sock_filter){ 0x28, 0, 0, 0x00000000 };
+		pCode[3] = (struct sock_filter){ 0x15, (n - i) * 4 - 3, 0, ntohl(tmp) };	// first 2 bytes of dest mac
+	}
+	bpfCode[n * 4] = (struct sock_filter){ 0x06, 0, 0, 0x00000000 };
+	bpfCode[n * 4 + 1] = (struct sock_filter){ 0x06, 0, 0, 0x0000ffff };
+
+	// Now wrap the filter code in the appropriate structure
+	struct sock_fprog filter;
+	memset(&filter, 0, sizeof(filter));
+	filter.len = n * 4 + 2;
+	filter.filter = bpfCode;
+
+	// And attach it to the socket, replacing the previous filter
+	if (setsockopt(sock, SOL_SOCKET, SO_ATTACH_FILTER,
+					&filter, sizeof(filter)) < 0) {
+		AVB_LOGF_ERROR("Setting multicast; setsockopt(SO_ATTACH_FILTER) failed: %s", strerror(errno));
+		if (added) {
+			// Forget the group we could not filter for; the previous filter stays attached
+			*pCount = n - 1;
+		}
+		return FALSE;
+	}
+	return TRUE;
+}
+
 // Setup the rawsock to receive multicast packets
 bool simpleRawsockRxMulticast(void *pvRawsock, bool add_membership, const U8 addr[ETH_ALEN])
 {
@@ -427,46 +501,16 @@ bool simpleRawsockRxMulticast(void *pvRawsock, bool add_membership, const U8 add
 	//	on this socket.  Multicast memberships are global - not
 	//	per-socket, so without the filter, this socket would receive
 	//	packets for all the multicast addresses added by all other
-	//	sockets.
+	//	sockets.  All groups joined on this socket pass the filter.
 	//
-	if (add_membership)
-	{
-		// Here's the template packet filter code.
-		// It was produced by running:
-		//   tcpdump -dd ether dest host 91:e0:01:02:03:04
-		struct sock_filter bpfCode[] = {
-			{ 0x20, 0, 0, 0x00000002 },
-			{ 0x15, 0, 3, 0x01020304 },   // last 4 bytes of dest mac
-			{ 0x28, 0, 0, 0x00000000 },
-			{ 0x15, 0, 1, 0x000091e0 },   // first 2 bytes of dest mac
-			{ 0x06, 0, 0, 0x0000ffff },
-			{ 0x06, 0, 0, 0x00000000 }
-		};
-
-		// We need to graft our multicast dest address into bpfCode
-		U32 tmp; U8 *buf = (U8*)&tmp;
-		memcpy(buf, mcast_addr.ether_addr_octet + 2, 4);
-		bpfCode[1].k = ntohl(tmp);
-		memset(buf, 0, 4);
-		memcpy(buf + 2, mcast_addr.ether_addr_octet, 2);
-		bpfCode[3].k = ntohl(tmp);
-
-		// Now wrap the filter code in the appropriate structure
-		struct sock_fprog filter;
-		memset(&filter, 0, sizeof(filter));
-		filter.len = 6;
-		filter.filter = bpfCode;
-
-		// And attach it to our socket
-		if (setsockopt(rawsock->sock, SOL_SOCKET, SO_ATTACH_FILTER,
-						&filter, sizeof(filter)) < 0) {
-			AVB_LOGF_ERROR("Setting multicast; setsockopt(SO_ATTACH_FILTER) failed: %s", strerror(errno));
-		}
-	}
-	else {
-		if (setsockopt(rawsock->sock, SOL_SOCKET, SO_DETACH_FILTER, NULL, 0) < 0) {
-			AVB_LOGF_ERROR("Setting multicast; setsockopt(SO_DETACH_FILTER) failed: %s", strerror(errno));
+	if (!simpleRawsockRxMcastFilter(rawsock->sock, rawsock->rxMcast, &rawsock->rxMcastCount, add_membership, mcast_addr.ether_addr_octet)) {
+		if (add_membership) {
+			// Leave the group again rather than receive it unfiltered
+			setsockopt(rawsock->sock, SOL_PACKET, PACKET_DROP_MEMBERSHIP,
+					(void*)&mreq, sizeof(struct packet_mreq));
 		}
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return FALSE;
 	}
 
 	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
@@ -34,6 +34,9 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 
 #include "rawsock_impl.h"
 
+// Max number of multicast groups accepted by the packet filter of one socket
+#define SIMPLE_RAWSOCK_MAX_MCAST	32
+
 // State information for raw socket
 //
 typedef struct {
@@ -47,6 +50,10 @@ typedef struct {
 
 	// buffer for receiving frames
 	U8 rxBuffer[1518];
+
+	// multicast groups joined on this socket
+	U8 rxMcast[SIMPLE_RAWSOCK_MAX_MCAST][ETH_ALEN];
+	int rxMcastCount;
 } simple_rawsock_t;
 
 bool simpleAvbCheckInterface(const char *ifname, if_info_t *info);
@@ -80,6 +87,10 @@ U8* simpleRawsockGetRxFrame(void *pvRawsock, U32 timeout, unsigned int *offset,
 // Setup the rawsock to receive multicast packets
 bool simpleRawsockRxMulticast(void *pvRawsock, bool add_membership, const U8 addr[ETH_ALEN]);
 
+// Add (or remove) addr in the list of joined multicast groups and attach a
+//  packet filter to sock which accepts frames sent to any group in the list.
+bool simpleRawsockRxMcastFilter(int sock, U8 mcast[][ETH_ALEN], int *pCount, bool add_membership, const U8 addr[ETH_ALEN]);
+
 // Allows for filtering of AVTP subtypes at the rawsock level for rawsock implementations that aren't able to
 //  delivery the same packet to multiple sockets.
 bool simpleRawsockRxAVTPSubtype(void *rawsock, U8 subtype);
@@ -0,0 +1,211 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+#include "txtime_rawsock.h"
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+
+#include "openavb_trace.h"
+
+#define	AVB_LOG_COMPONENT	"Raw Socket"
+#include "openavb_log.h"
+
+#ifndef SO_TXTIME
+#define SO_TXTIME 61
+#define SCM_TXTIME SO_TXTIME
+#endif
+
+// Collect the frames the kernel dropped because of their launch time
+static void x_txtimeCheckErrors(txtime_rawsock_t *rawsock)
+{
+	unsigned char control[256];
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+
+	while (1) {
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		if (recvmsg(rawsock->sendmmsg.sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+			break;
+		}
+
+		for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+			struct sock_extended_err *pErr = (struct sock_extended_err *)CMSG_DATA(cmsg);
+			if (pErr->ee_origin != SO_EE_ORIGIN_TXTIME) {
+				continue;
+			}
+
+			rawsock->txTimeErrors++;
+			IF_LOG_INTERVAL(1000) AVB_LOGF_WARNING("Frame dropped by kernel; %s launch time (%lu dropped so far)",
+				pErr->ee_code == SO_EE_CODE_TXTIME_MISSED ? "missed" : "invalid", rawsock->txTimeErrors);
+		}
+	}
+}
+
+// Open a rawsock for TX or RX
+void* txtimeRawsockOpen(txtime_rawsock_t *rawsock, const char *ifname, bool rx_mode, bool tx_mode, U16 ethertype, U32 frame_size, U32 num_frames)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK);
+
+	if (!sendmmsgRawsockOpen(&rawsock->sendmmsg, ifname, rx_mode, tx_mode, ethertype, frame_size, num_frames)) {
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+		return NULL;
+	}
+
+	if (tx_mode) {
+		rawsock->cmsgbuf = calloc(rawsock->sendmmsg.frameCount, sizeof(*rawsock->cmsgbuf));
+		if (!rawsock->cmsgbuf) {
+			AVB_LOG_ERROR("Creating rawsock; malloc failed");
+			txtimeRawsockClose(rawsock);
+			AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+			return NULL;
+		}
+
+		// Have the kernel hold each frame until its launch time,
+		// and tell us about the frames it had to drop instead.
+		struct sock_txtime txtime;
+		memset(&txtime, 0, sizeof(txtime));
+		txtime.clockid = TXTIME_CLOCK_ID;
+		txtime.flags = SOF_TXTIME_REPORT_ERRORS;
+		if (setsockopt(rawsock->sendmmsg.sock, SOL_SOCKET, SO_TXTIME, &txtime, sizeof(txtime)) < 0) {
+			AVB_LOGF_ERROR("Creating rawsock; SO_TXTIME: %s", strerror(errno));
+			txtimeRawsockClose(rawsock);
+			AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+			return NULL;
+		}
+		AVB_LOG_DEBUG("SO_TXTIME OK");
+	}
+
+	// fill virtual functions table
+	rawsock_cb_t *cb = &rawsock->sendmmsg.base.cb;
+	cb->close = txtimeRawsockClose;
+	cb->txFrameReady = txtimeRawsockTxFrameReady;
+	cb->send = txtimeRawsockSend;
+	cb->txLaunchTime = txtimeRawsockTxLaunchTime;
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+	return rawsock;
+}
+
+// Close the rawsock
+void txtimeRawsockClose(void *pvRawsock)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK);
+	txtime_rawsock_t *rawsock = (txtime_rawsock_t*)pvRawsock;
+
+	if (rawsock) {
+		if (rawsock->txTimeMissing || rawsock->txTimeErrors) {
+			AVB_LOGF_INFO("Launch time totals: frames without launch time=%lu, dropped by kernel=%lu",
+				rawsock->txTimeMissing, rawsock->txTimeErrors);
+		}
+
+		free(rawsock->cmsgbuf);
+		rawsock->cmsgbuf = NULL;
+	}
+
+	sendmmsgRawsockClose(pvRawsock);
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK);
+}
+
+// Release a TX frame, and mark it as ready to send at timeNsec
+bool txtimeRawsockTxFrameReady(void *pvRawsock, U8 *pBuffer, unsigned int len, U64 timeNsec)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	txtime_rawsock_t *rawsock = (txtime_rawsock_t*)pvRawsock;
+
+	if (!VALID_TX_RAWSOCK(rawsock)) {
+		AVB_LOG_ERROR("Marking TX frame ready; invalid argument");
+		AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+		return FALSE;
+	}
+
+	int bufidx = rawsock->sendmmsg.buffersReady;
+	assert(pBuffer == rawsock->sendmmsg.pktbuf[bufidx]);
+
+	struct msghdr *msg = &(rawsock->sendmmsg.mmsg[bufidx].msg_hdr);
+	struct iovec *iov = &(rawsock->sendmmsg.miov[bufidx]);
+
+	memset(msg, 0, sizeof(*msg));
+	iov->iov_base = pBuffer;
+	iov->iov_len = len;
+	msg->msg_iov = iov;
+	msg->msg_iovlen = 1;
+
+	if (timeNsec) {
+		struct cmsghdr *cmsg;
+
+		msg->msg_control = rawsock->cmsgbuf[bufidx];
+		msg->msg_controllen = sizeof(rawsock->cmsgbuf[bufidx]);
+
+		cmsg = CMSG_FIRSTHDR(msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_TXTIME;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(timeNsec));
+		memcpy(CMSG_DATA(cmsg), &timeNsec, sizeof(timeNsec));
+	}
+	else {
+		// Without a launch time the frame leaves as soon as possible.
+		// (The ETF qdisc drops such frames.)
+		rawsock->txTimeMissing++;
+		IF_LOG_INTERVAL(1000) AVB_LOG_WARNING("launch time was not passed to TxFrameReady");
+	}
+
+	rawsock->sendmmsg.buffersReady += 1;
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return TRUE;
+}
+
+// The ETF qdisc drops frames without a launch time
+bool txtimeRawsockTxLaunchTime(void *pvRawsock)
+{
+	return TRUE;
+}
+
+// Send all packets that are ready (i.e. tell kernel to send them)
+int txtimeRawsockSend(void *pvRawsock)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+	txtime_rawsock_t *rawsock = (txtime_rawsock_t*)pvRawsock;
+
+	int bytes = sendmmsgRawsockSend(pvRawsock);
+	if (VALID_TX_RAWSOCK(rawsock)) {
+		x_txtimeCheckErrors(rawsock);
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return bytes;
+}
@@ -0,0 +1,74 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+#ifndef TXTIME_RAWSOCK_H
+#define TXTIME_RAWSOCK_H
+
+#include "sendmmsg_rawsock.h"
+
+// Clock the launch times handed to the kernel are based on.
+// gPTP time is TAI, so the system TAI clock must be kept in sync with
+// the PTP clock of the NIC (e.g. by phc2sys).
+#define TXTIME_CLOCK_ID CLOCK_TAI
+
+// State information for raw socket
+//
+// Frames are sent as with sendmmsg_rawsock, each with its launch time
+// attached as SCM_TXTIME control message. The kernel (ETF qdisc) then
+// holds every frame until its launch time.
+typedef struct {
+	sendmmsg_rawsock_t sendmmsg;
+
+	// control message buffer per message
+	unsigned char (*cmsgbuf)[CMSG_SPACE(sizeof(U64))];
+
+	// Number of frames sent without a launch time
+	unsigned long txTimeMissing;
+	// Number of frames the kernel reported as dropped because of their launch time
+	unsigned long txTimeErrors;
+} txtime_rawsock_t;
+
+// Open a rawsock for TX or RX
+void* txtimeRawsockOpen(txtime_rawsock_t *rawsock, const char *ifname, bool rx_mode, bool tx_mode, U16 ethertype, U32 frame_size, U32 num_frames);
+
+// Close the rawsock
+void txtimeRawsockClose(void *pvRawsock);
+
+// Release a TX frame, and mark it as ready to send at timeNsec
+bool txtimeRawsockTxFrameReady(void *pvRawsock, U8 *pBuffer, unsigned int len, U64 timeNsec);
+
+// Send all packets that are ready (i.e. tell kernel to send them)
+int txtimeRawsockSend(void *pvRawsock);
+
+// Frames need a launch time
+bool txtimeRawsockTxLaunchTime(void *pvRawsock);
+
+#endif
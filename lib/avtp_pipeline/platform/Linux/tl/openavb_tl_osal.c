@@ -368,6 +368,33 @@ static int openavbTLCfgCallback(void *user, const char *tlSection, const char *n
 			valOK = TRUE;
 		}
 	}
+	else if (MATCH(name, "mediaq_lock_free")) {
+		errno = 0;
+		long tmp;
+		tmp = strtol(value, &pEnd, 0);
+		if (*pEnd == '\0' && errno == 0) {
+			pCfg->mediaq_lock_free = (tmp == 1);
+			valOK = TRUE;
+		}
+	}
+	else if (MATCH(name, "rx_demux")) {
+		errno = 0;
+		long tmp;
+		tmp = strtol(value, &pEnd, 0);
+		if (*pEnd == '\0' && errno == 0) {
+			pCfg->rx_demux = (tmp == 1);
+			valOK = TRUE;
+		}
+	}
+	else if (MATCH(name, "detailed_stats")) {
+		errno = 0;
+		long tmp;
+		tmp = strtol(value, &pEnd, 0);
+		if (*pEnd == '\0' && errno == 0) {
+			pCfg->detailed_stats = (tmp == 1);
+			valOK = TRUE;
+		}
+	}
 	else if (MATCH(name, "thread_affinity")) {
 		errno = 0;
 		unsigned long tmp;
@@ -0,0 +1,253 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Per stream statistics published in POSIX shared memory.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "openavb_platform.h"
+#include "openavb_trace.h"
+#include "openavb_tl_stats.h"
+
+#define	AVB_LOG_COMPONENT	"Talker / Listener"
+#include "openavb_log.h"
+
+// Attempts to take a consistent copy of a slot before giving up
+#define TL_STATS_SNAPSHOT_TRIES		16
+
+static openavb_tl_stats_shm_t *gStatsShm = NULL;
+static size_t gStatsShmSize = 0;
+static bool gStatsShared = FALSE;
+static char gStatsShmName[32];
+
+static MUTEX_HANDLE(gStatsMutex);
+#define STATS_LOCK() { MUTEX_CREATE_ERR(); MUTEX_LOCK(gStatsMutex); MUTEX_LOG_ERR("Mutex lock failure"); }
+#define STATS_UNLOCK() { MUTEX_CREATE_ERR(); MUTEX_UNLOCK(gStatsMutex); MUTEX_LOG_ERR("Mutex unlock failure"); }
+
+// Bracket changes by the owner that readers must not see half done
+static inline void x_slotWriteBegin(openavb_tl_stats_slot_t *pSlot)
+{
+	ATOMIC_STORE_RELAXED(&pSlot->seq, pSlot->seq + 1);
+	ATOMIC_FENCE_RELEASE();
+}
+
+static inline void x_slotWriteEnd(openavb_tl_stats_slot_t *pSlot)
+{
+	ATOMIC_STORE_RELEASE(&pSlot->seq, pSlot->seq + 1);
+}
+
+bool openavbTLStatsInitialize(U32 nSlots)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	{
+		MUTEX_ATTR_HANDLE(mta);
+		MUTEX_ATTR_INIT(mta);
+		MUTEX_ATTR_SET_TYPE(mta, MUTEX_ATTR_TYPE_DEFAULT);
+		MUTEX_ATTR_SET_NAME(mta, "gStatsMutex");
+		MUTEX_CREATE_ERR();
+		MUTEX_CREATE(gStatsMutex, mta);
+		MUTEX_LOG_ERR("Error creating mutex");
+	}
+
+	gStatsShmSize = sizeof(openavb_tl_stats_shm_t) + nSlots * sizeof(openavb_tl_stats_slot_t);
+	snprintf(gStatsShmName, sizeof(gStatsShmName), OPENAVB_TL_STATS_SHM_PREFIX "%d", (int)getpid());
+
+	int fd = shm_open(gStatsShmName, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (fd >= 0) {
+		if (ftruncate(fd, gStatsShmSize) == 0) {
+			void *pMem = mmap(NULL, gStatsShmSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (pMem != MAP_FAILED) {
+				gStatsShm = pMem;
+				gStatsShared = TRUE;
+			}
+		}
+		close(fd);
+		if (!gStatsShared) {
+			shm_unlink(gStatsShmName);
+		}
+	}
+
+	if (!gStatsShared) {
+		AVB_LOGF_WARNING("Stream statistics not published, unable to create shared memory %s: %s", gStatsShmName, strerror(errno));
+		gStatsShm = calloc(1, gStatsShmSize);
+		if (!gStatsShm) {
+			AVB_LOG_ERROR("Unable to allocate stream statistics");
+			AVB_TRACE_EXIT(AVB_TRACE_TL);
+			return FALSE;
+		}
+	}
+
+	// A new segment is zero filled, so all slots start out free
+	gStatsShm->version = OPENAVB_TL_STATS_VERSION;
+	gStatsShm->pid = getpid();
+	gStatsShm->nSlots = nSlots;
+	gStatsShm->slotSize = sizeof(openavb_tl_stats_slot_t);
+	ATOMIC_STORE_RELEASE(&gStatsShm->magic, OPENAVB_TL_STATS_MAGIC);
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+	return TRUE;
+}
+
+void openavbTLStatsCleanup(void)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	if (gStatsShm) {
+		if (gStatsShared) {
+			munmap(gStatsShm, gStatsShmSize);
+			shm_unlink(gStatsShmName);
+		}
+		else {
+			free(gStatsShm);
+		}
+		gStatsShm = NULL;
+		gStatsShared = FALSE;
+
+		MUTEX_CREATE_ERR();
+		MUTEX_DESTROY(gStatsMutex);
+		MUTEX_LOG_ERR("Error destroying mutex");
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+}
+
+openavb_tl_stats_slot_t *openavbTLStatsAttach(avb_role_t role, const char *friendlyName)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	openavb_tl_stats_slot_t *pSlot = NULL;
+	U32 i1;
+
+	if (!gStatsShm) {
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return NULL;
+	}
+
+	STATS_LOCK();
+	for (i1 = 0; i1 < gStatsShm->nSlots; i1++) {
+		if (!gStatsShm->slots[i1].inUse) {
+			pSlot = &gStatsShm->slots[i1];
+			break;
+		}
+	}
+
+	if (pSlot) {
+		x_slotWriteBegin(pSlot);
+		pSlot->role = role;
+		pSlot->streamUid = 0;
+		memset(pSlot->streamAddr, 0, sizeof(pSlot->streamAddr));
+		memset(pSlot->friendlyName, 0, sizeof(pSlot->friendlyName));
+		if (friendlyName) {
+			strncpy(pSlot->friendlyName, friendlyName, sizeof(pSlot->friendlyName) - 1);
+		}
+		pSlot->frames = 0;
+		pSlot->cpuNS = 0;
+		memset(pSlot->hist, 0, sizeof(pSlot->hist));
+		pSlot->inUse = TRUE;
+		x_slotWriteEnd(pSlot);
+	}
+	else {
+		AVB_LOG_WARNING("No free stream statistics slot");
+	}
+	STATS_UNLOCK();
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+	return pSlot;
+}
+
+void openavbTLStatsDetach(openavb_tl_stats_slot_t *pSlot)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	if (pSlot) {
+		STATS_LOCK();
+		x_slotWriteBegin(pSlot);
+		pSlot->inUse = FALSE;
+		x_slotWriteEnd(pSlot);
+		STATS_UNLOCK();
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+}
+
+void openavbTLStatsSetStreamID(openavb_tl_stats_slot_t *pSlot, const AVBStreamID_t *pStreamID)
+{
+	if (pSlot && pStreamID) {
+		STATS_LOCK();
+		x_slotWriteBegin(pSlot);
+		memcpy(pSlot->streamAddr, pStreamID->addr, ETH_ALEN);
+		pSlot->streamUid = pStreamID->uniqueID;
+		x_slotWriteEnd(pSlot);
+		STATS_UNLOCK();
+	}
+}
+
+void openavbTLStatsReset(openavb_tl_stats_slot_t *pSlot)
+{
+	if (pSlot) {
+		STATS_LOCK();
+		x_slotWriteBegin(pSlot);
+		pSlot->frames = 0;
+		pSlot->cpuNS = 0;
+		memset(pSlot->hist, 0, sizeof(pSlot->hist));
+		x_slotWriteEnd(pSlot);
+		STATS_UNLOCK();
+	}
+}
+
+bool openavbTLStatsSnapshot(const openavb_tl_stats_slot_t *pSlot, openavb_tl_stats_slot_t *pCopy)
+{
+	int tries;
+
+	for (tries = 0; tries < TL_STATS_SNAPSHOT_TRIES; tries++) {
+		U32 seq = ATOMIC_LOAD_ACQUIRE(&pSlot->seq);
+		if (seq & 1) {
+			continue;
+		}
+		memcpy(pCopy, pSlot, sizeof(*pCopy));
+		ATOMIC_FENCE_ACQUIRE();
+		if (ATOMIC_LOAD_RELAXED(&pSlot->seq) == seq) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
@@ -29,35 +29,137 @@ Complete license and copyright information can be found at
 https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 *************************************************************************************************************/
 
+/*
+* MODULE SUMMARY : Software media clock recovery for platforms without a hardware media clock.
+*
+* The AVTP timestamps pushed by the listener mapping modules drive a delay locked loop
+* (see openavb_mcr_dll.h). Interface modules read the recovered clock with halGetMCRClock().
+* As with a hardware media clock there is a single recovered clock, so only one listener
+* should have media clock recovery enabled.
+*/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
 #define	AVB_LOG_COMPONENT	"MCR"
 #include "openavb_pub.h"
 #include "openavb_log.h"
 
 #include "openavb_mcr_hal.h"
+#include "openavb_mcr_dll.h"
+
+static pthread_mutex_t gMcrMutex = PTHREAD_MUTEX_INITIALIZER;
+#define LOCK()  	pthread_mutex_lock(&gMcrMutex)
+#define UNLOCK()	pthread_mutex_unlock(&gMcrMutex)
+
+static bool gMcrRunning = FALSE;
+static openavb_mcr_dll_t gMcrDll;
+
+// Phase adjustment still to be applied, and the most applied per timestamp event
+static S32 gMcrAdjCreditNSec = 0;
+static U32 gMcrAdjGranularityNSec = 0;
 
 
 bool halInitMCR(U32 packetRate, U32 pushInterval, U32 timestampInterval, U32 recoveryInterval)
 {
+	double nominalNSec = 0;
+	if (packetRate && pushInterval) {
+		nominalNSec = (double)NANOSECONDS_PER_SECOND * pushInterval / packetRate;
+	}
+
+	LOCK();
+	openavbMcrDllInit(&gMcrDll, nominalNSec, recoveryInterval, 0);
+	gMcrAdjCreditNSec = 0;
+	gMcrRunning = TRUE;
+	UNLOCK();
+
+	AVB_LOGF_INFO("Software media clock recovery started, nominal event period %.0f ns", nominalNSec);
 	return TRUE;
 }
 
 bool halCloseMCR(void)
 {
+	LOCK();
+	gMcrRunning = FALSE;
+	UNLOCK();
 	return TRUE;
 }
 
 bool halPushMCR(void)
 {
-	return TRUE;	
+	// Events without a timestamp carry nothing to recover the clock from
+	return TRUE;
 }
 
-void halAdjustMCRNSec(S32 adjNSec)
+bool halPushMCRTimestamp(U32 timestamp)
 {
+	LOCK();
+	if (gMcrRunning) {
+		bool bWasLocked = gMcrDll.bLocked;
+		if (openavbMcrDllUpdate(&gMcrDll, timestamp) && gMcrAdjCreditNSec) {
+			S32 adjNSec = gMcrAdjCreditNSec;
+			if (gMcrAdjGranularityNSec && (U32)abs(adjNSec) > gMcrAdjGranularityNSec) {
+				adjNSec = adjNSec > 0 ? (S32)gMcrAdjGranularityNSec : -(S32)gMcrAdjGranularityNSec;
+			}
+			openavbMcrDllShift(&gMcrDll, adjNSec);
+			gMcrAdjCreditNSec -= adjNSec;
+		}
+		if (gMcrDll.bLocked != bWasLocked) {
+			if (gMcrDll.bLocked) {
+				AVB_LOGF_INFO("Media clock locked, rate ratio %.9f", openavbMcrDllRateRatio(&gMcrDll));
+			}
+			else {
+				AVB_LOGF_WARNING("Media clock lost lock, phase error %.0f ns", gMcrDll.errNSec);
+			}
+		}
+	}
+	UNLOCK();
+	return TRUE;
 }
 
-void halAdjustMCRGranularityNSec(U32 adjGranularityNSec)
+bool halGetMCRClock(double *pRateRatio, U32 *pPhaseTimestamp)
 {
-}
+	bool bLocked;
 
+	LOCK();
+	bLocked = gMcrRunning && gMcrDll.bLocked;
+	if (pRateRatio) {
+		*pRateRatio = gMcrRunning ? openavbMcrDllRateRatio(&gMcrDll) : 1.0;
+	}
+	if (pPhaseTimestamp) {
+		*pPhaseTimestamp = gMcrRunning ? openavbMcrDllPhase(&gMcrDll) : 0;
+	}
+	UNLOCK();
 
+	return bLocked;
+}
+
+void halAdjustMCRNSec(S32 adjNSec)
+{
+	LOCK();
+	// Keep at most one event period pending, so repeated calls cannot overflow the credit
+	S64 maxNSec = gMcrDll.periodNSec > 0 ? (S64)gMcrDll.periodNSec : (S64)gMcrDll.nominalNSec;
+	S64 credit = (S64)gMcrAdjCreditNSec + adjNSec;
+	if (maxNSec > 0 && credit > maxNSec) {
+		credit = maxNSec;
+	}
+	else if (maxNSec > 0 && credit < -maxNSec) {
+		credit = -maxNSec;
+	}
+	else if (credit > INT32_MAX) {
+		credit = INT32_MAX;
+	}
+	else if (credit < -INT32_MAX) {
+		credit = -INT32_MAX;
+	}
+	gMcrAdjCreditNSec = (S32)credit;
+	UNLOCK();
+}
 
+void halAdjustMCRGranularityNSec(U32 adjGranularityNSec)
+{
+	LOCK();
+	gMcrAdjGranularityNSec = adjGranularityNSec;
+	UNLOCK();
+}
@@ -32,7 +32,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #ifndef _OPENAVB_HAL_H
 #define _OPENAVB_HAL_H
 
-// halPushMCR() API not defined
-#define HAL_PUSH_MCR(mcrTimeStampPtr) FALSE
+// Timestamps feed the software media clock recovery
+#define HAL_PUSH_MCR(mcrTimeStampPtr) halPushMCRTimestamp(*(mcrTimeStampPtr))
 
 #endif // _OPENAVB_HAL_H
@@ -51,6 +51,21 @@ bool halPushMCR(void)
 	return TRUE;	
 }
 
+bool halPushMCRTimestamp(U32 timestamp)
+{
+	// No software media clock recovery on this platform
+	return TRUE;
+}
+
+bool halGetMCRClock(double *pRateRatio, U32 *pPhaseTimestamp)
+{
+	if (pRateRatio)
+		*pRateRatio = 1.0;
+	if (pPhaseTimestamp)
+		*pPhaseTimestamp = 0;
+	return FALSE;
+}
+
 void halAdjustMCRNSec(S32 adjNSec)
 {
 }
@@ -33,7 +33,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #define _OPENAVB_HAL_H
 
 // Note this remains for backwards compatabilty with older prots. See openavb_mcr_hall_pub.h for newer APIs
-// halPushMCR() API not defined
-#define HAL_PUSH_MCR(mcrTimeStampPtr) FALSE
+// Timestamps are accepted and dropped, see halPushMCRTimestamp()
+#define HAL_PUSH_MCR(mcrTimeStampPtr) halPushMCRTimestamp(*(mcrTimeStampPtr))
 
 #endif // _OPENAVB_HAL_H
@@ -105,6 +105,18 @@ U8 *openavbRawsockGetRxFrame(void *rawsock,	// rawsock handle
 						 U32 *offset,	// offset of frame in the frame buffer
 						 U32 *len);		// returns length of received frame
 
+// Get several received frames at once.  Waits up to usecTimeout for the
+// first frame only, then adds whatever else has already arrived.
+// Each frame must be released with openavbRawsockRelRxFrame.
+// Returns the number of frames stored in ppFrames.
+int openavbRawsockGetRxFrames(void *rawsock,	// rawsock handle
+						 U32 usecTimeout,	// timeout for the first frame (microseconds)
+						 					// or use OPENAVB_RAWSOCK_BLOCK/NONBLOCK
+						 U8 **ppFrames,		// returns the frame buffers
+						 U32 *pOffsets,		// offset of each frame in its frame buffer
+						 U32 *pLens,		// returns length of each received frame
+						 U32 count);		// max number of frames to return
+
 // Parse the frame header.  Returns length of header, or -1 for failure
 int openavbRawsockRxParseHdr(void* rawsock, U8 *pBuffer, hdr_info_t *pInfo);
 
@@ -139,6 +151,18 @@ U8 *openavbRawsockGetTxFrame(void *rawsock,		// rawsock handle
 						   bool blocking,	// TRUE blocks until frame buffer is available.
 						   U32 *size);		// size of the frame buffer
 
+// Reserve up to count consecutive buffers for transmission, so that a
+// whole batch of frames can be filled and then sent with one call to
+// openavbRawsockSend.  Only the first buffer is waited for when blocking;
+// fewer than count may be returned.  Unused buffers must be released with
+// openavbRawsockRelTxFrame, last one first.
+// Returns the number of buffers stored in ppFrames.
+int openavbRawsockGetTxFrames(void *rawsock,	// rawsock handle
+						   bool blocking,	// TRUE blocks until the first frame buffer is available.
+						   U8 **ppFrames,	// receives the frame buffers
+						   U32 count,		// number of frame buffers wanted
+						   U32 *size);		// size of each frame buffer
+
 // Release Tx buffer without sending it
 bool openavbRawsockRelTxFrame(void *rawsock, U8 *pBuffer);
 
@@ -164,4 +188,8 @@ unsigned long openavbRawsockGetTXOutOfBuffers(void *pvRawsock);
 // returns number of TX out of buffer events noticed from the last reporting period
 unsigned long openavbRawsockGetTXOutOfBuffersCyclic(void *pvRawsock);
 
+// TRUE if frames are held until the launch time passed to openavbRawsockTxFrameReady,
+// so every frame needs one
+bool openavbRawsockTxLaunchTime(void *pvRawsock);
+
 #endif // RAWSOCK_H
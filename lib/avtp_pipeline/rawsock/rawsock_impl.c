@@ -38,18 +38,35 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 void baseRawsockSetRxSignalMode(void *rawsock, bool rxSignalMode) {}
 int baseRawsockGetSocket(void *rawsock) { AVB_LOG_ERROR("baseRawsockGetSocket called"); return -1; }
 U8 *baseRawsockGetRxFrame(void *rawsock, U32 usecTimeout, U32 *offset, U32 *len) { AVB_LOG_ERROR("baseRawsockGetRxFrame called"); return NULL; }
+// Implementations that can't deliver several frames at once hand out one frame per call
+int baseRawsockGetRxFrames(void *rawsock, U32 usecTimeout, U8 **ppFrames, U32 *pOffsets, U32 *pLens, U32 count)
+{
+	if (count == 0)
+		return 0;
+	ppFrames[0] = ((base_rawsock_t*)rawsock)->cb.getRxFrame(rawsock, usecTimeout, pOffsets, pLens);
+	return ppFrames[0] ? 1 : 0;
+}
 bool baseRawsockRelRxFrame(void *rawsock, U8 *pFrame) { return false; }
 bool baseRawsockRxMulticast(void *rawsock, bool add_membership, const U8 buf[]) { return false; }
 bool baseRawsockRxAVTPSubtype(void *rawsock, U8 subtype) { return false; }
 bool baseRawsockTxSetMark(void *rawsock, int prio) { return false; }
 U8 *baseRawsockGetTxFrame(void *rawsock, bool blocking, U32 *size) { AVB_LOG_ERROR("baseRawsockGetTxFrame called"); return NULL; }
 bool baseRawsockRelTxFrame(void *rawsock, U8 *pBuffer) { return false; }
+// Implementations that can't reserve several frames at once hand out one frame per call
+int baseRawsockGetTxFrames(void *rawsock, bool blocking, U8 **ppFrames, U32 count, U32 *size)
+{
+	if (count == 0)
+		return 0;
+	ppFrames[0] = ((base_rawsock_t*)rawsock)->cb.getTxFrame(rawsock, blocking, size);
+	return ppFrames[0] ? 1 : 0;
+}
 bool baseRawsockTxFrameReady(void *rawsock, U8 *pFrame, U32 len, U64 timeNsec) { AVB_LOG_ERROR("baseRawsockTxFrameReady called"); return false; }
 int baseRawsockSend(void *rawsock) { AVB_LOG_ERROR("baseRawsockSend called"); return -1; }
 int baseRawsockTxBufLevel(void *rawsock) { return -1; }
 int baseRawsockRxBufLevel(void *rawsock) { return -1; }
 unsigned long baseRawsockGetTXOutOfBuffers(void *pvRawsock) { return 0; }
 unsigned long baseRawsockGetTXOutOfBuffersCyclic(void *pvRawsock) { return 0; }
+bool baseRawsockTxLaunchTime(void *rawsock) { return false; }
 
 void* baseRawsockOpen(base_rawsock_t* rawsock, const char *ifname, bool rx_mode, bool tx_mode, U16 ethertype, U32 frame_size, U32 num_frames)
 {
@@ -67,6 +84,7 @@ void* baseRawsockOpen(base_rawsock_t* rawsock, const char *ifname, bool rx_mode,
 	cb->getSocket = baseRawsockGetSocket;
 	cb->getAddr = baseRawsockGetAddr;
 	cb->getRxFrame = baseRawsockGetRxFrame;
+	cb->getRxFrames = baseRawsockGetRxFrames;
 	cb->rxParseHdr = baseRawsockRxParseHdr;
 	cb->relRxFrame = baseRawsockRelRxFrame;
 	cb->rxMulticast = baseRawsockRxMulticast;
@@ -75,6 +93,7 @@ void* baseRawsockOpen(base_rawsock_t* rawsock, const char *ifname, bool rx_mode,
 	cb->txFillHdr = baseRawsockTxFillHdr;
 	cb->txSetMark = baseRawsockTxSetMark;
 	cb->getTxFrame = baseRawsockGetTxFrame;
+	cb->getTxFrames = baseRawsockGetTxFrames;
 	cb->relTxFrame = baseRawsockRelTxFrame;
 	cb->txFrameReady = baseRawsockTxFrameReady;
 	cb->send = baseRawsockSend;
@@ -82,6 +101,7 @@ void* baseRawsockOpen(base_rawsock_t* rawsock, const char *ifname, bool rx_mode,
 	cb->rxBufLevel = baseRawsockRxBufLevel;
 	cb->getTXOutOfBuffers = baseRawsockGetTXOutOfBuffers;
 	cb->getTXOutOfBuffersCyclic = baseRawsockGetTXOutOfBuffersCyclic;
+	cb->txLaunchTime = baseRawsockTxLaunchTime;
 
 
 	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
@@ -242,6 +262,16 @@ U8 *openavbRawsockGetTxFrame(void *pvRawsock, bool blocking, unsigned int *len)
 	return ret;
 }
 
+int openavbRawsockGetTxFrames(void *pvRawsock, bool blocking, U8 **ppFrames, unsigned int count, unsigned int *len)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+
+	int ret = ((base_rawsock_t*)pvRawsock)->cb.getTxFrames(pvRawsock, blocking, ppFrames, count, len);
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return ret;
+}
+
 bool openavbRawsockTxSetMark(void *pvRawsock, int mark)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK);
@@ -332,6 +362,16 @@ U8 *openavbRawsockGetRxFrame(void *pvRawsock, U32 timeout, unsigned int *offset,
 	return ret;
 }
 
+int openavbRawsockGetRxFrames(void *pvRawsock, U32 timeout, U8 **ppFrames, unsigned int *pOffsets, unsigned int *pLens, unsigned int count)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+
+	int ret = ((base_rawsock_t*)pvRawsock)->cb.getRxFrames(pvRawsock, timeout, ppFrames, pOffsets, pLens, count);
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return ret;
+}
+
 int openavbRawsockRxParseHdr(void *pvRawsock, U8 *pBuffer, hdr_info_t *pInfo)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
@@ -411,3 +451,13 @@ unsigned long openavbRawsockGetTXOutOfBuffersCyclic(void *pvRawsock)
 	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
 	return ret;
 }
+
+bool openavbRawsockTxLaunchTime(void *pvRawsock)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_RAWSOCK_DETAIL);
+
+	bool ret = ((base_rawsock_t*)pvRawsock)->cb.txLaunchTime(pvRawsock);
+
+	AVB_TRACE_EXIT(AVB_TRACE_RAWSOCK_DETAIL);
+	return ret;
+}
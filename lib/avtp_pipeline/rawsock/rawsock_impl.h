@@ -67,6 +67,7 @@ typedef struct {
 	int (*getSocket)(void* rawsock);
 	bool (*getAddr)(void* rawsock, U8 addr[ETH_ALEN]);
 	U8* (*getRxFrame)(void* rawsock, U32 usecTimeout, U32* offset, U32* len);
+	int (*getRxFrames)(void* rawsock, U32 usecTimeout, U8** ppFrames, U32* pOffsets, U32* pLens, U32 count);
 	int (*rxParseHdr)(void* rawsock, U8* pBuffer, hdr_info_t* pInfo);
 	bool (*relRxFrame)(void* rawsock, U8* pFrame);
 	bool (*rxMulticast)(void* rawsock, bool add_membership, const U8 buf[ETH_ALEN]);
@@ -75,6 +76,7 @@ typedef struct {
 	bool (*txFillHdr)(void* rawsock, U8* pBuffer, U32* hdrlen);
 	bool (*txSetMark)(void* rawsock, int prio);
 	U8* (*getTxFrame)(void* rawsock, bool blocking, U32* size);
+	int (*getTxFrames)(void* rawsock, bool blocking, U8** ppFrames, U32 count, U32* size);
 	bool (*relTxFrame)(void* rawsock, U8* pBuffer);
 	bool (*txFrameReady)(void* rawsock, U8* pFrame, U32 len, U64 timeNsec);
 	int (*send)(void* rawsock);
@@ -82,6 +84,7 @@ typedef struct {
 	int (*rxBufLevel)(void* rawsock);
 	unsigned long (*getTXOutOfBuffers)(void* pvRawsock);
 	unsigned long (*getTXOutOfBuffersCyclic)(void* pvRawsock);
+	bool (*txLaunchTime)(void* rawsock);
 } rawsock_cb_t;
 
 // State information for raw socket
@@ -74,6 +74,7 @@ bool listenerStartStream(tl_state_t *pTLState)
 		pListenerData->destAddr,
 		pCfg->raw_rx_buffers,
 		pCfg->rx_signal_mode,
+		pCfg->rx_demux,
 		&pListenerData->avtpHandle);
 	if (IS_OPENAVB_FAILURE(rc)) {
 		AVB_LOG_ERROR("Failed to create AVTP stream");
@@ -81,6 +82,16 @@ bool listenerStartStream(tl_state_t *pTLState)
 		return FALSE;
 	}
 
+	if (pTLState->pStats) {
+		avtp_stats_t avtpStats;
+		avtpStats.mapTime = &pTLState->pStats->hist[TL_HIST_MAP_TIME];
+		avtpStats.txSlack = NULL;
+		avtpStats.ptimeError = &pTLState->pStats->hist[TL_HIST_RX_PTIME_ERROR];
+		avtpStats.pRxFrames = &pTLState->pStats->frames;
+		openavbAvtpConfigStats(pListenerData->avtpHandle, &avtpStats, pCfg->max_transit_usec);
+		openavbTLStatsSetStreamID(pTLState->pStats, &pListenerData->streamID);
+	}
+
 	// Setup timers
 	U64 nowNS;
 	CLOCK_GETTIME64(OPENAVB_TIMER_CLOCK, &nowNS);
@@ -142,6 +153,7 @@ void listenerStopStream(tl_state_t *pTLState)
 static inline void listenerShowStats(listener_data_t *pListenerData, tl_state_t *pTLState)
 {
 	U64 lost = openavbAvtpLost(pListenerData->avtpHandle);
+	U32 dropped = openavbAvtpRxDropped(pListenerData->avtpHandle);
 	U64 bytes = openavbAvtpBytes(pListenerData->avtpHandle);
 	U32 rxbuf = openavbAvtpRxBufferLevel(pListenerData->avtpHandle);
 	U32 mqbuf = openavbMediaQCountItems(pTLState->pMediaQ, TRUE);
@@ -151,6 +163,7 @@ static inline void listenerShowStats(listener_data_t *pListenerData, tl_state_t
 	AVB_LOGRT_INFO(FALSE, LOG_RT_ITEM, FALSE, "calls=%ld, ", LOG_RT_DATATYPE_U32, &pListenerData->nReportCalls);
 	AVB_LOGRT_INFO(FALSE, LOG_RT_ITEM, FALSE, "frames=%ld, ", LOG_RT_DATATYPE_U32, &pListenerData->nReportFrames);
 	AVB_LOGRT_INFO(FALSE, LOG_RT_ITEM, FALSE, "lost=%lld, ", LOG_RT_DATATYPE_U64, &lost);
+	AVB_LOGRT_INFO(FALSE, LOG_RT_ITEM, FALSE, "dropped=%ld, ", LOG_RT_DATATYPE_U32, &dropped);
 	AVB_LOGRT_INFO(FALSE, LOG_RT_ITEM, FALSE, "bytes=%lld, ", LOG_RT_DATATYPE_U64, &bytes);
 	AVB_LOGRT_INFO(FALSE, LOG_RT_ITEM, FALSE, "rxbuf=%d, ", LOG_RT_DATATYPE_U32, &rxbuf);
 	AVB_LOGRT_INFO(FALSE, LOG_RT_ITEM, FALSE, "mqbuf=%d, ", LOG_RT_DATATYPE_U32, &mqbuf);
@@ -176,6 +189,11 @@ static inline bool listenerDoStream(tl_state_t *pTLState)
 
 	if (pTLState->bStreaming) {
 		U64 nowNS;
+		U64 cpuStartNS = 0;
+
+		if (pCfg->detailed_stats && pTLState->pStats) {
+			CLOCK_GETTIME64(OPENAVB_CLOCK_THREAD_CPUTIME, &cpuStartNS);
+		}
 
 		pListenerData->nReportCalls++;
 
@@ -184,6 +202,15 @@ static inline bool listenerDoStream(tl_state_t *pTLState)
 			pListenerData->nReportFrames++;
 		}
 
+		if (pTLState->pStats) {
+			if (pCfg->detailed_stats) {
+				U64 cpuEndNS;
+				CLOCK_GETTIME64(OPENAVB_CLOCK_THREAD_CPUTIME, &cpuEndNS);
+				ATOMIC_STORE_RELAXED(&pTLState->pStats->cpuNS, pTLState->pStats->cpuNS + (cpuEndNS - cpuStartNS));
+			}
+			openavbHistogramRecord(&pTLState->pStats->hist[TL_HIST_MEDIAQ_DEPTH], openavbMediaQCountItems(pTLState->pMediaQ, TRUE));
+		}
+
 		CLOCK_GETTIME64(OPENAVB_TIMER_CLOCK, &nowNS);
 
 		if (pCfg->report_seconds > 0) {
@@ -237,6 +264,8 @@ void openavbTLRunListener(tl_state_t *pTLState)
 		return;
 	}
 
+	pTLState->pStats = openavbTLStatsAttach(AVB_ROLE_LISTENER, pCfg->friendly_name);
+
 	AVBStreamID_t streamID;
 	memset(&streamID, 0, sizeof(streamID));
 	memcpy(streamID.addr, pCfg->stream_addr.mac, ETH_ALEN);
@@ -301,6 +330,9 @@ void openavbTLRunListener(tl_state_t *pTLState)
 		AVB_LOGF_WARNING("Failed to connect to endpoint "STREAMID_FORMAT, STREAMID_ARGS(&streamID));
 	}
 
+	openavbTLStatsDetach(pTLState->pStats);
+	pTLState->pStats = NULL;
+
 	if (pTLState->pPvtListenerData) {
 		free(pTLState->pPvtListenerData);
 		pTLState->pPvtListenerData = NULL;
@@ -355,6 +387,7 @@ void openavbListenerClearStats(tl_state_t *pTLState)
 	LOCK_STATS();
 	memset(&pListenerData->stats, 0, sizeof(pListenerData->stats));
 	UNLOCK_STATS();
+	openavbTLStatsReset(pTLState->pStats);
 
 	AVB_TRACE_EXIT(AVB_TRACE_TL);
 }
@@ -395,6 +428,9 @@ void openavbListenerAddStat(tl_state_t *pTLState, tl_stat_t stat, U64 val)
 		case TL_STAT_RX_BYTES:
 			pListenerData->stats.totalBytes += val;
 			break;
+		case TL_STAT_CPU_NSEC:
+		case TL_STAT_LIVE_FRAMES:
+			break;
 	}
 	UNLOCK_STATS();
 
@@ -438,11 +474,19 @@ U64 openavbListenerGetStat(tl_state_t *pTLState, tl_stat_t stat)
 		case TL_STAT_RX_BYTES:
 			val = pListenerData->stats.totalBytes;
 			break;
+		case TL_STAT_CPU_NSEC:
+			if (pTLState->pStats) {
+				val = ATOMIC_LOAD_RELAXED(&pTLState->pStats->cpuNS);
+			}
+			break;
+		case TL_STAT_LIVE_FRAMES:
+			if (pTLState->pStats) {
+				val = ATOMIC_LOAD_RELAXED(&pTLState->pStats->frames);
+			}
+			break;
 	}
 	UNLOCK_STATS();
 
 	AVB_TRACE_EXIT(AVB_TRACE_TL);
 	return val;
 }
-
-
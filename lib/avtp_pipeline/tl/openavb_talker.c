@@ -39,6 +39,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_tl.h"
 #include "openavb_avtp.h"
 #include "openavb_talker.h"
+#include "openavb_talker_sched.h"
 #include "openavb_avdecc_msg_client.h"
 
 // DEBUG Uncomment to turn on logging for just this module.
@@ -91,6 +92,7 @@ bool talkerStartStream(tl_state_t *pTLState)
 		&pTalkerData->streamID,
 		pTalkerData->destAddr,
 		pCfg->max_transit_usec,
+		transmitInterval,
 		pTalkerData->fwmark,
 		pTalkerData->vlanID,
 		pTalkerData->vlanPCP,
@@ -104,6 +106,16 @@ bool talkerStartStream(tl_state_t *pTLState)
 
 	avtp_stream_t *pStream = (avtp_stream_t *)(pTalkerData->avtpHandle);
 
+	if (pTLState->pStats) {
+		avtp_stats_t avtpStats;
+		avtpStats.mapTime = &pTLState->pStats->hist[TL_HIST_MAP_TIME];
+		avtpStats.txSlack = &pTLState->pStats->hist[TL_HIST_TX_SLACK];
+		avtpStats.ptimeError = NULL;
+		avtpStats.pRxFrames = NULL;
+		openavbAvtpConfigStats(pTalkerData->avtpHandle, &avtpStats, pCfg->max_transit_usec);
+		openavbTLStatsSetStreamID(pTLState->pStats, &pTalkerData->streamID);
+	}
+
 	pTalkerData->wakeRate = transmitInterval / pCfg->batch_factor;
 
 	pTalkerData->sleepUsec = MICROSECONDS_PER_SECOND / pTalkerData->wakeRate;
@@ -147,6 +159,13 @@ bool talkerStartStream(tl_state_t *pTLState)
 	// we're good to go!
 	pTLState->bStreaming = TRUE;
 
+	// Hand the stream to the shared scheduler when one is running. Spin waiting and
+	// blocking interfaces keep pacing themselves on the talker thread.
+	pTalkerData->bScheduled = FALSE;
+	if (!pCfg->spin_wait && !pCfg->tx_blocking_in_intf) {
+		pTalkerData->bScheduled = openavbTalkerSchedAdd(pTLState);
+	}
+
 	AVB_TRACE_EXIT(AVB_TRACE_TL);
 	return TRUE;
 }
@@ -168,6 +187,11 @@ void talkerStopStream(tl_state_t *pTLState)
 		return;
 	}
 
+	if (pTalkerData->bScheduled) {
+		openavbTalkerSchedRemove(pTLState);
+		pTalkerData->bScheduled = FALSE;
+	}
+
 	void *rawsock = NULL;
 	if (pTalkerData->avtpHandle) {
 		rawsock = ((avtp_stream_t*)pTalkerData->avtpHandle)->rawsock;
@@ -215,100 +239,148 @@ static inline void talkerShowStats(talker_data_t *pTalkerData, tl_state_t *pTLSt
 	openavbTalkerAddStat(pTLState, TL_STAT_TX_BYTES, bytes);
 }
 
-static inline bool talkerDoStream(tl_state_t *pTLState)
+// Send the frames for the interval that is now due and advance to the next one.
+// Called from the talker thread, or from a scheduler worker for scheduled streams.
+// Returns TRUE when it is time to service the endpoint IPC.
+bool talkerTxInterval(tl_state_t *pTLState)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_TL);
 
-	if (!pTLState) {
-		AVB_LOG_ERROR("Invalid TLState");
-		AVB_TRACE_EXIT(AVB_TRACE_TL);
-		return FALSE;
-	}
-
 	openavb_tl_cfg_t *pCfg = &pTLState->cfg;
 	talker_data_t *pTalkerData = pTLState->pPvtTalkerData;
 	bool bRet = FALSE;
+	openavb_tl_stats_slot_t *pStats = pTLState->pStats;
+	U64 nowNS;
+	U64 cpuStartNS = 0;
 
-	if (pTLState->bStreaming) {
-		U64 nowNS;
+	if (pStats) {
+		if (pCfg->detailed_stats) {
+			CLOCK_GETTIME64(OPENAVB_CLOCK_THREAD_CPUTIME, &cpuStartNS);
+		}
 
 		if (!pCfg->tx_blocking_in_intf) {
-
+			// nextCycleNS still holds the start of the interval being sent
 			if (!pCfg->spin_wait) {
-				// sleep until the next interval
-				SLEEP_UNTIL_NSEC(pTalkerData->nextCycleNS);
+				CLOCK_GETTIME64(OPENAVB_TIMER_CLOCK, &nowNS);
 			} else {
-#if !IGB_LAUNCHTIME_ENABLED && !ATL_LAUNCHTIME_ENABLED
-				SPIN_UNTIL_NSEC(pTalkerData->nextCycleNS);
-#endif
+				CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &nowNS);
 			}
+			openavbHistogramRecord(&pStats->hist[TL_HIST_TX_LATENESS],
+				nowNS > pTalkerData->nextCycleNS ? nowNS - pTalkerData->nextCycleNS : 0);
+		}
 
-			//AVB_DBG_INTERVAL(8000, TRUE);
+		openavbHistogramRecord(&pStats->hist[TL_HIST_MEDIAQ_DEPTH], openavbMediaQCountItems(pTLState->pMediaQ, TRUE));
+	}
 
-			// send the frames for this interval
-			int i;
-			for (i = pTalkerData->wakeFrames; i > 0; i--) {
-				if (IS_OPENAVB_SUCCESS(openavbAvtpTx(pTalkerData->avtpHandle, i == 1, pCfg->tx_blocking_in_intf)))
-					pTalkerData->cntFrames++;
-				else
-					break;
-			}
+	if (!pCfg->tx_blocking_in_intf) {
+		//AVB_DBG_INTERVAL(8000, TRUE);
+
+		// send the frames for this interval, all with a single rawsock send
+		U32 nSent = 0;
+		openavbAvtpTxBatch(pTalkerData->avtpHandle, pTalkerData->wakeFrames, &nSent);
+		pTalkerData->cntFrames += nSent;
+		if (pStats) {
+			ATOMIC_STORE_RELAXED(&pStats->frames, pStats->frames + nSent);
 		}
-		else {
-			// Interface module block option
-			if (IS_OPENAVB_SUCCESS(openavbAvtpTx(pTalkerData->avtpHandle, TRUE, pCfg->tx_blocking_in_intf)))
-				pTalkerData->cntFrames++;
+	}
+	else {
+		// Interface module block option
+		if (IS_OPENAVB_SUCCESS(openavbAvtpTx(pTalkerData->avtpHandle, TRUE, pCfg->tx_blocking_in_intf))) {
+			pTalkerData->cntFrames++;
+			if (pStats) {
+				ATOMIC_STORE_RELAXED(&pStats->frames, pStats->frames + 1);
+			}
 		}
+	}
 
-		if (!pCfg->spin_wait) {
-			CLOCK_GETTIME64(OPENAVB_TIMER_CLOCK, &nowNS);
-		} else {
-			CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &nowNS);
-		}
+	if (!pCfg->spin_wait) {
+		CLOCK_GETTIME64(OPENAVB_TIMER_CLOCK, &nowNS);
+	} else {
+		CLOCK_GETTIME64(OPENAVB_CLOCK_WALLTIME, &nowNS);
+	}
 
-		if (pTalkerData->cntWakes++ % pTalkerData->wakeRate == 0) {
-			// time to service the endpoint IPC
-			bRet = TRUE;
+	if (pTalkerData->cntWakes++ % pTalkerData->wakeRate == 0) {
+		// time to service the endpoint IPC
+		bRet = TRUE;
 
-			// Don't need to check again for another second.
-			pTalkerData->nextSecondNS = nowNS + NANOSECONDS_PER_SECOND;
-		}
+		// Don't need to check again for another second.
+		pTalkerData->nextSecondNS = nowNS + NANOSECONDS_PER_SECOND;
+	}
 
-		if (pCfg->report_seconds > 0) {
-			if (nowNS > pTalkerData->nextReportNS) {
-				talkerShowStats(pTalkerData, pTLState);
-			  
-				openavbTalkerAddStat(pTLState, TL_STAT_TX_CALLS, pTalkerData->cntWakes);
-				openavbTalkerAddStat(pTLState, TL_STAT_TX_FRAMES, pTalkerData->cntFrames);
+	if (pCfg->report_seconds > 0) {
+		if (nowNS > pTalkerData->nextReportNS) {
+			talkerShowStats(pTalkerData, pTLState);
+		  
+			openavbTalkerAddStat(pTLState, TL_STAT_TX_CALLS, pTalkerData->cntWakes);
+			openavbTalkerAddStat(pTLState, TL_STAT_TX_FRAMES, pTalkerData->cntFrames);
 
-				pTalkerData->cntFrames = 0;
-				pTalkerData->cntWakes = 0;
-				pTalkerData->nextReportNS = nowNS + (pCfg->report_seconds * NANOSECONDS_PER_SECOND);
-			}
-		} else if (pCfg->report_frames > 0 && pTalkerData->cntFrames != pTalkerData->lastReportFrames) {
-			if (pTalkerData->cntFrames % pCfg->report_frames == 1) {
-				talkerShowStats(pTalkerData, pTLState);
-				pTalkerData->lastReportFrames = pTalkerData->cntFrames;
-			}
+			pTalkerData->cntFrames = 0;
+			pTalkerData->cntWakes = 0;
+			pTalkerData->nextReportNS = nowNS + (pCfg->report_seconds * NANOSECONDS_PER_SECOND);
 		}
-
-		if (nowNS > pTalkerData->nextSecondNS) {
-			pTalkerData->nextSecondNS = nowNS + NANOSECONDS_PER_SECOND;
-			bRet = TRUE;
+	} else if (pCfg->report_frames > 0 && pTalkerData->cntFrames != pTalkerData->lastReportFrames) {
+		if (pTalkerData->cntFrames % pCfg->report_frames == 1) {
+			talkerShowStats(pTalkerData, pTLState);
+			pTalkerData->lastReportFrames = pTalkerData->cntFrames;
 		}
+	}
+
+	if (nowNS > pTalkerData->nextSecondNS) {
+		pTalkerData->nextSecondNS = nowNS + NANOSECONDS_PER_SECOND;
+		bRet = TRUE;
+	}
+
+	if (!pCfg->tx_blocking_in_intf) {
+		pTalkerData->nextCycleNS += pTalkerData->intervalNS;
+
+		if ((pTalkerData->nextCycleNS + (pCfg->max_transmit_deficit_usec * 1000)) < nowNS) {
+			// Hit max deficit time. Something must be wrong. Reset the cycle timer.	
+			// Align clock : allows for some performance gain
+			nowNS = ((nowNS + (pTalkerData->intervalNS)) / pTalkerData->intervalNS) * pTalkerData->intervalNS;
+			pTalkerData->nextCycleNS = nowNS + pTalkerData->intervalNS;
+		}				
+	}
+
+	if (pStats && pCfg->detailed_stats) {
+		U64 cpuEndNS;
+		CLOCK_GETTIME64(OPENAVB_CLOCK_THREAD_CPUTIME, &cpuEndNS);
+		ATOMIC_STORE_RELAXED(&pStats->cpuNS, pStats->cpuNS + (cpuEndNS - cpuStartNS));
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+	return bRet;
+}
+
+static inline bool talkerDoStream(tl_state_t *pTLState)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
 
+	if (!pTLState) {
+		AVB_LOG_ERROR("Invalid TLState");
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
+	openavb_tl_cfg_t *pCfg = &pTLState->cfg;
+	talker_data_t *pTalkerData = pTLState->pPvtTalkerData;
+	bool bRet = FALSE;
+
+	if (pTLState->bStreaming && !pTalkerData->bScheduled) {
 		if (!pCfg->tx_blocking_in_intf) {
-			pTalkerData->nextCycleNS += pTalkerData->intervalNS;
-
-			if ((pTalkerData->nextCycleNS + (pCfg->max_transmit_deficit_usec * 1000)) < nowNS) {
-				// Hit max deficit time. Something must be wrong. Reset the cycle timer.	
-				// Align clock : allows for some performance gain
-				nowNS = ((nowNS + (pTalkerData->intervalNS)) / pTalkerData->intervalNS) * pTalkerData->intervalNS;
-				pTalkerData->nextCycleNS = nowNS + pTalkerData->intervalNS;
-			}				
+			if (!pCfg->spin_wait) {
+				// sleep until the next interval
+				SLEEP_UNTIL_NSEC(pTalkerData->nextCycleNS);
+			} else {
+#if !IGB_LAUNCHTIME_ENABLED && !ATL_LAUNCHTIME_ENABLED
+				SPIN_UNTIL_NSEC(pTalkerData->nextCycleNS);
+#endif
+			}
 		}
+
+		bRet = talkerTxInterval(pTLState);
 	}
 	else {
+		// Not streaming, or a scheduler worker is sending for us.
 		SLEEP_MSEC(10);
 
 		// time to service the endpoint IPC
@@ -337,6 +409,8 @@ void openavbTLRunTalker(tl_state_t *pTLState)
 		return;
 	}
 
+	pTLState->pStats = openavbTLStatsAttach(AVB_ROLE_TALKER, pTLState->cfg.friendly_name);
+
 	// Create Stats Mutex
 	{
 		MUTEX_ATTR_HANDLE(mta);
@@ -398,6 +472,9 @@ void openavbTLRunTalker(tl_state_t *pTLState)
 		AVB_LOGF_WARNING("Failed to connect to endpoint"STREAMID_FORMAT, STREAMID_ARGS(&(((talker_data_t *)pTLState->pPvtTalkerData)->streamID)));
 	}
 
+	openavbTLStatsDetach(pTLState->pStats);
+	pTLState->pStats = NULL;
+
 	if (pTLState->pPvtTalkerData) {
 		free(pTLState->pPvtTalkerData);
 		pTLState->pPvtTalkerData = NULL;
@@ -452,6 +529,7 @@ void openavbTalkerClearStats(tl_state_t *pTLState)
 	LOCK_STATS();
 	memset(&pTalkerData->stats, 0, sizeof(pTalkerData->stats));
 	UNLOCK_STATS();
+	openavbTLStatsReset(pTLState->pStats);
 
 	AVB_TRACE_EXIT(AVB_TRACE_TL);
 }
@@ -491,6 +569,8 @@ void openavbTalkerAddStat(tl_state_t *pTLState, tl_stat_t stat, U64 val)
 		case TL_STAT_RX_FRAMES:
 		case TL_STAT_RX_LOST:
 		case TL_STAT_RX_BYTES:
+		case TL_STAT_CPU_NSEC:
+		case TL_STAT_LIVE_FRAMES:
 			break;
 	}
 	UNLOCK_STATS();
@@ -535,10 +615,19 @@ U64 openavbTalkerGetStat(tl_state_t *pTLState, tl_stat_t stat)
 		case TL_STAT_RX_LOST:
 		case TL_STAT_RX_BYTES:
 			break;
+		case TL_STAT_CPU_NSEC:
+			if (pTLState->pStats) {
+				val = ATOMIC_LOAD_RELAXED(&pTLState->pStats->cpuNS);
+			}
+			break;
+		case TL_STAT_LIVE_FRAMES:
+			if (pTLState->pStats) {
+				val = ATOMIC_LOAD_RELAXED(&pTLState->pStats->frames);
+			}
+			break;
 	}
 	UNLOCK_STATS();
 
 	AVB_TRACE_EXIT(AVB_TRACE_TL);
 	return val;
 }
-
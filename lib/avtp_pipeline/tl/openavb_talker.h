@@ -64,6 +64,11 @@ typedef struct {
 	U64				nextSecondNS;
 	unsigned long	lastReportFrames;
 	talker_stats_t	stats;
+
+	// Set while a talker scheduler worker sends for this stream
+	bool			bScheduled;
+	void			*pSchedWorker;
+	U32				schedIndex;
 } talker_data_t;
 
 
@@ -73,6 +78,7 @@ void openavbTalkerClearStats(tl_state_t *pTLState);
 void openavbTalkerAddStat(tl_state_t *pTLState, tl_stat_t stat, U64 val);
 U64 openavbTalkerGetStat(tl_state_t *pTLState, tl_stat_t stat);
 bool talkerStartStream(tl_state_t *pTLState);
+bool talkerTxInterval(tl_state_t *pTLState);
 void talkerStopStream(tl_state_t *pTLState);
 bool openavbTLRunTalkerInit(tl_state_t *pTLState);
 void openavbTLRunTalkerFinish(tl_state_t *pTLState);
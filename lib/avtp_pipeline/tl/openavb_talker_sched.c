@@ -0,0 +1,441 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+
+/*
+* MODULE SUMMARY : Shared talker scheduler.
+*
+* Normally every talker stream has its own thread that sleeps until the
+* next transmit interval of that stream. With many streams in one process
+* that means one wakeup per stream per interval. With the scheduler a
+* small pool of workers does the sending instead. Each worker keeps its
+* streams in a min-heap ordered by the start of their next interval
+* (earliest deadline first) and every stream whose interval starts within
+* TALKER_SCHED_COALESCE_NSEC of the earliest one is sent in the same
+* wakeup. Streams of the same class started together share deadlines, so
+* one wakeup per interval serves all of them.
+*
+* The talker threads keep running to service the endpoint IPC at a low
+* rate. Streams configured with spin_wait or tx_blocking_in_intf are not
+* scheduled and keep sending from their own threads.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "openavb_platform.h"
+#include "openavb_types.h"
+#include "openavb_trace.h"
+#include "openavb_time.h"
+#include "openavb_tl.h"
+#include "openavb_talker.h"
+#include "openavb_talker_sched.h"
+
+#define	AVB_LOG_COMPONENT	"Talker"
+#include "openavb_log.h"
+
+// Streams due within this time after the earliest one are sent in the same wakeup
+#define TALKER_SCHED_COALESCE_NSEC		(20 * NANOSECONDS_PER_USEC)
+
+// Longest a worker sleeps, so a stream added with an earlier deadline is not held up for long
+#define TALKER_SCHED_MAX_SLEEP_NSEC		(10 * NANOSECONDS_PER_MSEC)
+
+// How often each worker logs its statistics
+#define TALKER_SCHED_REPORT_NSEC		(10 * NANOSECONDS_PER_SECOND)
+
+// Initial heap capacity of a worker, grown as needed
+#define TALKER_SCHED_HEAP_INIT			16
+
+THREAD_TYPE(talkerSchedThread);
+
+typedef struct {
+	U32 index;
+
+	// Protects the heap. Held by the worker while it sends a batch of intervals.
+	MUTEX_HANDLE_ALT(mutex);
+	tl_state_t **pHeap;
+	tl_state_t **pDue;		// Streams taken off the heap during one wakeup, same size as pHeap
+	U32 nStreams;
+	U32 heapSize;
+
+	// Posted when a stream is added to an empty worker or on shutdown
+	SEM_T(wakeSem)
+
+	// Statistics since the last report
+	U64 cntWakes;
+	U64 cntIntervals;
+	U64 lateSumNS;
+	U64 lateMaxNS;
+	U64 nextReportNS;
+
+	bool bRunning;
+	THREAD_DEFINITON(talkerSchedThread);
+} talker_sched_worker_t;
+
+static talker_sched_worker_t *gSchedWorkers = NULL;
+static U32 gSchedNumWorkers = 0;
+
+// Protects the choice of worker in openavbTalkerSchedAdd()
+static MUTEX_HANDLE_ALT(gSchedAddMutex);
+
+static inline U64 x_deadline(tl_state_t *pTLState)
+{
+	return ((talker_data_t *)pTLState->pPvtTalkerData)->nextCycleNS;
+}
+
+static inline void x_heapSet(talker_sched_worker_t *pWorker, U32 idx, tl_state_t *pTLState)
+{
+	pWorker->pHeap[idx] = pTLState;
+	((talker_data_t *)pTLState->pPvtTalkerData)->schedIndex = idx;
+}
+
+static void x_heapUp(talker_sched_worker_t *pWorker, U32 idx)
+{
+	tl_state_t *pTLState = pWorker->pHeap[idx];
+	U64 deadline = x_deadline(pTLState);
+
+	while (idx > 0) {
+		U32 parent = (idx - 1) / 2;
+		if (x_deadline(pWorker->pHeap[parent]) <= deadline)
+			break;
+		x_heapSet(pWorker, idx, pWorker->pHeap[parent]);
+		idx = parent;
+	}
+	x_heapSet(pWorker, idx, pTLState);
+}
+
+static void x_heapDown(talker_sched_worker_t *pWorker, U32 idx)
+{
+	tl_state_t *pTLState = pWorker->pHeap[idx];
+	U64 deadline = x_deadline(pTLState);
+
+	while (1) {
+		U32 child = idx * 2 + 1;
+		if (child >= pWorker->nStreams)
+			break;
+		if (child + 1 < pWorker->nStreams && x_deadline(pWorker->pHeap[child + 1]) < x_deadline(pWorker->pHeap[child]))
+			child++;
+		if (deadline <= x_deadline(pWorker->pHeap[child]))
+			break;
+		x_heapSet(pWorker, idx, pWorker->pHeap[child]);
+		idx = child;
+	}
+	x_heapSet(pWorker, idx, pTLState);
+}
+
+static bool x_heapPush(talker_sched_worker_t *pWorker, tl_state_t *pTLState)
+{
+	if (pWorker->nStreams == pWorker->heapSize) {
+		U32 newSize = pWorker->heapSize ? pWorker->heapSize * 2 : TALKER_SCHED_HEAP_INIT;
+		tl_state_t **pNew = realloc(pWorker->pHeap, newSize * sizeof(tl_state_t *));
+		if (!pNew)
+			return FALSE;
+		pWorker->pHeap = pNew;
+		pNew = realloc(pWorker->pDue, newSize * sizeof(tl_state_t *));
+		if (!pNew)
+			return FALSE;
+		pWorker->pDue = pNew;
+		pWorker->heapSize = newSize;
+	}
+	pWorker->pHeap[pWorker->nStreams] = pTLState;
+	x_heapUp(pWorker, pWorker->nStreams++);
+	return TRUE;
+}
+
+static void x_heapRemove(talker_sched_worker_t *pWorker, U32 idx)
+{
+	U32 last = --pWorker->nStreams;
+	if (idx == last)
+		return;
+
+	x_heapSet(pWorker, idx, pWorker->pHeap[last]);
+	if (idx > 0 && x_deadline(pWorker->pHeap[idx]) < x_deadline(pWorker->pHeap[(idx - 1) / 2]))
+		x_heapUp(pWorker, idx);
+	else
+		x_heapDown(pWorker, idx);
+}
+
+static void x_showStats(talker_sched_worker_t *pWorker)
+{
+	AVB_LOGF_INFO("Scheduler worker %u: streams=%u, wakes=%" PRIu64 ", intervals=%" PRIu64 ", late-avg=%" PRIu64 "us, late-max=%" PRIu64 "us",
+		pWorker->index, pWorker->nStreams, pWorker->cntWakes, pWorker->cntIntervals,
+		pWorker->cntIntervals ? (pWorker->lateSumNS / pWorker->cntIntervals) / NANOSECONDS_PER_USEC : 0,
+		pWorker->lateMaxNS / NANOSECONDS_PER_USEC);
+
+	pWorker->cntWakes = 0;
+	pWorker->cntIntervals = 0;
+	pWorker->lateSumNS = 0;
+	pWorker->lateMaxNS = 0;
+}
+
+static void *x_talkerSchedThreadFn(void *pv)
+{
+	talker_sched_worker_t *pWorker = (talker_sched_worker_t *)pv;
+	U64 nowNS, wakeNS;
+	U32 nDue, i;
+
+	AVB_LOGF_INFO("Scheduler worker %u started", pWorker->index);
+
+	CLOCK_GETTIME64(OPENAVB_TIMER_CLOCK, &nowNS);
+	pWorker->nextReportNS = nowNS + TALKER_SCHED_REPORT_NSEC;
+
+	while (ATOMIC_LOAD_ACQUIRE(&pWorker->bRunning)) {
+		MUTEX_LOCK_ALT(pWorker->mutex);
+		bool bEmpty = (pWorker->nStreams == 0);
+		wakeNS = bEmpty ? 0 : x_deadline(pWorker->pHeap[0]);
+		MUTEX_UNLOCK_ALT(pWorker->mutex);
+
+		if (bEmpty) {
+			SEM_ERR_T(err);
+			SEM_WAIT(pWorker->wakeSem, err);
+			SEM_LOG_ERR(err);
+			continue;
+		}
+
+		CLOCK_GETTIME64(OPENAVB_TIMER_CLOCK, &nowNS);
+		if (wakeNS > nowNS + TALKER_SCHED_MAX_SLEEP_NSEC) {
+			SLEEP_UNTIL_NSEC(nowNS + TALKER_SCHED_MAX_SLEEP_NSEC);
+			continue;
+		}
+		SLEEP_UNTIL_NSEC(wakeNS);
+
+		MUTEX_LOCK_ALT(pWorker->mutex);
+		CLOCK_GETTIME64(OPENAVB_TIMER_CLOCK, &nowNS);
+		pWorker->cntWakes++;
+
+		// Take every stream that is due, or will be within the coalescing window, off the heap
+		// first so that each one is sent once per wakeup, then put them back with their next deadline.
+		nDue = 0;
+		while (pWorker->nStreams > 0 && x_deadline(pWorker->pHeap[0]) <= nowNS + TALKER_SCHED_COALESCE_NSEC) {
+			pWorker->pDue[nDue++] = pWorker->pHeap[0];
+			x_heapRemove(pWorker, 0);
+		}
+
+		for (i = 0; i < nDue; i++) {
+			U64 deadline = x_deadline(pWorker->pDue[i]);
+			if (nowNS > deadline) {
+				U64 late = nowNS - deadline;
+				pWorker->lateSumNS += late;
+				if (late > pWorker->lateMaxNS)
+					pWorker->lateMaxNS = late;
+			}
+			pWorker->cntIntervals++;
+
+			talkerTxInterval(pWorker->pDue[i]);
+		}
+
+		// Cannot fail, the heap held these streams a moment ago
+		for (i = 0; i < nDue; i++) {
+			x_heapPush(pWorker, pWorker->pDue[i]);
+		}
+
+		if (nowNS > pWorker->nextReportNS) {
+			x_showStats(pWorker);
+			pWorker->nextReportNS = nowNS + TALKER_SCHED_REPORT_NSEC;
+		}
+		MUTEX_UNLOCK_ALT(pWorker->mutex);
+	}
+
+	AVB_LOGF_INFO("Scheduler worker %u stopped", pWorker->index);
+	return NULL;
+}
+
+bool openavbTalkerSchedInitialize(U32 workers)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	if (gSchedWorkers || workers == 0) {
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
+	if (MUTEX_CREATE_ALT(gSchedAddMutex) != 0) {
+		AVB_LOG_ERROR("Talker scheduler; error creating mutex");
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
+	gSchedWorkers = calloc(workers, sizeof(talker_sched_worker_t));
+	if (!gSchedWorkers) {
+		AVB_LOG_ERROR("Talker scheduler; out of memory");
+		MUTEX_DESTROY_ALT(gSchedAddMutex);
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
+	for (gSchedNumWorkers = 0; gSchedNumWorkers < workers; gSchedNumWorkers++) {
+		talker_sched_worker_t *pWorker = &gSchedWorkers[gSchedNumWorkers];
+		bool errResult;
+		SEM_ERR_T(err);
+
+		pWorker->index = gSchedNumWorkers;
+		if (MUTEX_CREATE_ALT(pWorker->mutex) != 0) {
+			AVB_LOG_ERROR("Talker scheduler; error creating mutex");
+			break;
+		}
+		SEM_INIT(pWorker->wakeSem, 0, err);
+		if (!SEM_IS_ERR_NONE(err)) {
+			SEM_LOG_ERR(err);
+			MUTEX_DESTROY_ALT(pWorker->mutex);
+			break;
+		}
+
+		pWorker->bRunning = TRUE;
+		THREAD_CREATE(talkerSchedThread, pWorker->talkerSchedThread, NULL, x_talkerSchedThreadFn, pWorker);
+		THREAD_CHECK_ERROR(pWorker->talkerSchedThread, "Thread / task creation failed", errResult);
+		if (errResult) {
+			SEM_DESTROY(pWorker->wakeSem, err);
+			SEM_LOG_ERR(err);
+			MUTEX_DESTROY_ALT(pWorker->mutex);
+			break;
+		}
+		THREAD_PIN(pWorker->talkerSchedThread, 1 << (pWorker->index % 32));
+	}
+
+	if (gSchedNumWorkers < workers) {
+		openavbTalkerSchedCleanup();
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
+	AVB_LOGF_INFO("Talker scheduler started with %u workers", workers);
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+	return TRUE;
+}
+
+void openavbTalkerSchedCleanup(void)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	if (!gSchedWorkers) {
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return;
+	}
+
+	U32 i;
+	for (i = 0; i < gSchedNumWorkers; i++) {
+		talker_sched_worker_t *pWorker = &gSchedWorkers[i];
+		SEM_ERR_T(err);
+
+		if (pWorker->nStreams) {
+			AVB_LOGF_WARNING("Talker scheduler worker %u still has %u streams", i, pWorker->nStreams);
+		}
+
+		ATOMIC_STORE_RELEASE(&pWorker->bRunning, FALSE);
+		SEM_POST(pWorker->wakeSem, err);
+		SEM_LOG_ERR(err);
+		THREAD_JOIN(pWorker->talkerSchedThread, NULL);
+
+		x_showStats(pWorker);
+
+		SEM_DESTROY(pWorker->wakeSem, err);
+		SEM_LOG_ERR(err);
+		MUTEX_DESTROY_ALT(pWorker->mutex);
+		free(pWorker->pHeap);
+		free(pWorker->pDue);
+	}
+
+	free(gSchedWorkers);
+	gSchedWorkers = NULL;
+	gSchedNumWorkers = 0;
+	MUTEX_DESTROY_ALT(gSchedAddMutex);
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+}
+
+bool openavbTalkerSchedAdd(tl_state_t *pTLState)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	if (!gSchedWorkers || !pTLState || !pTLState->pPvtTalkerData) {
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
+	talker_data_t *pTalkerData = pTLState->pPvtTalkerData;
+	talker_sched_worker_t *pWorker = NULL;
+	bool bAdded;
+	U32 i;
+
+	MUTEX_LOCK_ALT(gSchedAddMutex);
+	for (i = 0; i < gSchedNumWorkers; i++) {
+		if (!pWorker || gSchedWorkers[i].nStreams < pWorker->nStreams)
+			pWorker = &gSchedWorkers[i];
+	}
+
+	MUTEX_LOCK_ALT(pWorker->mutex);
+	pTalkerData->pSchedWorker = pWorker;
+	bAdded = x_heapPush(pWorker, pTLState);
+	MUTEX_UNLOCK_ALT(pWorker->mutex);
+	MUTEX_UNLOCK_ALT(gSchedAddMutex);
+
+	if (!bAdded) {
+		AVB_LOG_ERROR("Talker scheduler; out of memory, stream stays on its own thread");
+		pTalkerData->pSchedWorker = NULL;
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
+	// Wake a worker that was idle
+	SEM_ERR_T(err);
+	SEM_POST(pWorker->wakeSem, err);
+	SEM_LOG_ERR(err);
+
+	AVB_LOGF_INFO("Talker scheduler; "STREAMID_FORMAT" on worker %u", STREAMID_ARGS(&pTalkerData->streamID), pWorker->index);
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+	return TRUE;
+}
+
+void openavbTalkerSchedRemove(tl_state_t *pTLState)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	if (!pTLState || !pTLState->pPvtTalkerData) {
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return;
+	}
+
+	talker_data_t *pTalkerData = pTLState->pPvtTalkerData;
+	talker_sched_worker_t *pWorker = pTalkerData->pSchedWorker;
+	if (!pWorker) {
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return;
+	}
+
+	// The worker holds the mutex while sending, so the stream is idle once we have it
+	MUTEX_LOCK_ALT(pWorker->mutex);
+	if (pTalkerData->schedIndex < pWorker->nStreams && pWorker->pHeap[pTalkerData->schedIndex] == pTLState) {
+		x_heapRemove(pWorker, pTalkerData->schedIndex);
+	}
+	pTalkerData->pSchedWorker = NULL;
+	MUTEX_UNLOCK_ALT(pWorker->mutex);
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+}
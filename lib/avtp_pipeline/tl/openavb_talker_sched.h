@@ -0,0 +1,58 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+
+/*
+* HEADER SUMMARY : Shared talker scheduler. A small pool of pinned worker
+* threads sends the frames of many talker streams, each worker serving its
+* streams in earliest deadline first order of their next transmit interval.
+*/
+
+#ifndef OPENAVB_TL_TALKER_SCHED_H
+#define OPENAVB_TL_TALKER_SCHED_H 1
+
+#include "openavb_tl.h"
+
+// Start workers threads. Worker n is pinned to CPU n (modulo 32).
+// Called once from openavbTLInitialize() when workers were requested.
+bool openavbTalkerSchedInitialize(U32 workers);
+
+// Stop the workers. Streams must have been removed already.
+void openavbTalkerSchedCleanup(void);
+
+// Hand the transmit intervals of a streaming talker to the least loaded worker.
+// Returns FALSE when the scheduler is not running, the talker thread then keeps sending itself.
+bool openavbTalkerSchedAdd(tl_state_t *pTLState);
+
+// Take the stream back from its worker. Once this returns the worker is not sending for it.
+void openavbTalkerSchedRemove(tl_state_t *pTLState);
+
+#endif  // OPENAVB_TL_TALKER_SCHED_H
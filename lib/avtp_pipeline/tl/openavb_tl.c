@@ -40,7 +40,9 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_trace.h"
 #include "openavb_mediaq.h"
 #include "openavb_talker.h"
+#include "openavb_talker_sched.h"
 #include "openavb_listener.h"
+#include "openavb_avtp_rx_demux.h"
 #include "openavb_avdecc_msg.h"
 #include "openavb_platform.h"
 
@@ -49,6 +51,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_log.h"
 
 U32 gMaxTL;
+static U32 gTalkerWorkers = 0;
 tl_handle_t *gTLHandleList;
 
 // We are accessed from multiple threads, so need a mutex
@@ -280,6 +283,11 @@ EXTERN_DLL_EXPORT bool openavbTLInitialize(U32 maxTL)
 
 	gMaxTL = maxTL;
 
+	if (!openavbAvtpRxDemuxInitialize()) {
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
 	{
 		MUTEX_ATTR_HANDLE(mta);
 		MUTEX_ATTR_INIT(mta);
@@ -290,6 +298,14 @@ EXTERN_DLL_EXPORT bool openavbTLInitialize(U32 maxTL)
 		MUTEX_LOG_ERR("Error creating mutex");
 	}
 
+	if (gTalkerWorkers > 0 && !openavbTalkerSchedInitialize(gTalkerWorkers)) {
+		AVB_LOG_WARNING("Talker scheduler not started, each talker sends from its own thread");
+	}
+
+	if (!openavbTLStatsInitialize(gMaxTL)) {
+		AVB_LOG_WARNING("Stream statistics not available");
+	}
+
 	gTLHandleList = calloc(1, sizeof(tl_handle_t) * gMaxTL);
 	if (gTLHandleList) {
 		AVB_TRACE_EXIT(AVB_TRACE_TL);
@@ -319,6 +335,26 @@ EXTERN_DLL_EXPORT bool openavbTLCleanup()
 		MUTEX_LOG_ERR("Error destroying mutex");
 	}
 
+	openavbTLStatsCleanup();
+	openavbTalkerSchedCleanup();
+	openavbAvtpRxDemuxCleanup();
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+	return TRUE;
+}
+
+EXTERN_DLL_EXPORT bool openavbTLSetTalkerWorkers(U32 workers)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+
+	if (gTLHandleList) {
+		AVB_LOG_ERROR("Talker workers must be set before the TL library is initialized");
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return FALSE;
+	}
+
+	gTalkerWorkers = workers;
+
 	AVB_TRACE_EXIT(AVB_TRACE_TL);
 	return TRUE;
 }
@@ -396,6 +432,9 @@ EXTERN_DLL_EXPORT void openavbTLInitCfg(openavb_tl_cfg_t *pCfg)
 	pCfg->spin_wait = FALSE;
 	pCfg->thread_rt_priority = 0;
 	pCfg->thread_affinity = 0xFFFFFFFF;
+	pCfg->mediaq_lock_free = FALSE;
+	pCfg->rx_demux = FALSE;
+	pCfg->detailed_stats = FALSE;
 
 	AVB_TRACE_EXIT(AVB_TRACE_TL);
 }
@@ -441,6 +480,11 @@ EXTERN_DLL_EXPORT bool openavbTLConfigure(tl_handle_t handle, openavb_tl_cfg_t *
 
 	openavbMediaQSetMaxStaleTail(pTLState->pMediaQ, pCfg->max_stale);
 
+	if (pCfg->mediaq_lock_free && !openavbMediaQLockFreeOn(pTLState->pMediaQ)) {
+		AVB_LOG_ERROR("Unable to enable lock-free media queue");
+		return FALSE;
+	}
+
 	if (!openavbTLOpenLinkLibsOsal(pTLState)) {
 		AVB_LOG_ERROR("Failed to open mapping / interface library");
 		return FALSE;
@@ -741,6 +785,36 @@ EXTERN_DLL_EXPORT U64 openavbTLStat(tl_handle_t handle, tl_stat_t stat)
 	return val;
 }
 
+EXTERN_DLL_EXPORT U64 openavbTLStatPercentile(tl_handle_t handle, tl_hist_t hist, double percentile, U64 *pCount)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_TL);
+	U64 val = 0;
+
+	if (pCount) {
+		*pCount = 0;
+	}
+
+	tl_state_t *pTLState = (tl_state_t *)handle;
+
+	if (!pTLState) {
+		AVB_LOG_ERROR("Invalid handle");
+		AVB_TRACE_EXIT(AVB_TRACE_TL);
+		return 0;
+	}
+
+	// The slot stays mapped after the stream thread gives it back, so a stale pointer is harmless
+	openavb_tl_stats_slot_t *pStats = pTLState->pStats;
+	if (pStats && hist < OPENAVB_TL_STATS_HISTOGRAMS) {
+		val = openavbHistogramPercentile(&pStats->hist[hist], percentile);
+		if (pCount) {
+			*pCount = openavbHistogramCount(&pStats->hist[hist]);
+		}
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_TL);
+	return val;
+}
+
 EXTERN_DLL_EXPORT void openavbTLPauseStream(tl_handle_t handle, bool bPause)
 {
 	AVB_TRACE_ENTRY(AVB_TRACE_TL);
@@ -40,6 +40,7 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include "openavb_osal.h"
 #include "openavb_mediaq_pub.h"
 #include "openavb_tl_pub.h"
+#include "openavb_tl_stats.h"
 
 typedef enum OPENAVB_TL_AVB_VER_STATE 
 {
@@ -89,6 +90,9 @@ typedef struct {
 	// Private listener data.
 	void *pPvtListenerData;
 
+	// Statistics published for avbstat. Set by the talker or listener thread while it runs.
+	openavb_tl_stats_slot_t *pStats;
+
 	// Thread for talker or listener
 	THREAD_DEFINITON(TLThread);
 
@@ -67,8 +67,29 @@ typedef enum {
 	TL_STAT_RX_LOST,
 	/// Number of bytes received
 	TL_STAT_RX_BYTES,
+	/// CPU time in nanoseconds spent sending or receiving (detailed_stats only)
+	TL_STAT_CPU_NSEC,
+	/// Frames sent or received so far. Unlike the totals above this is always current.
+	TL_STAT_LIVE_FRAMES,
 } tl_stat_t;
 
+/// Distributions gathered for every stream, also published to the avbstat tool
+typedef enum {
+	/// Talker wakeup lateness against the start of the transmit interval, in nanoseconds
+	TL_HIST_TX_LATENESS,
+	/// Listener presentation time error, in nanoseconds. This is how much of
+	/// max_transit_usec was already used up when the frame was received,
+	/// so the presentation margin left is max_transit_usec minus this.
+	TL_HIST_RX_PTIME_ERROR,
+	/// Time the mapping module takes for each frame, in nanoseconds
+	TL_HIST_MAP_TIME,
+	/// Talker time from handing a frame to the raw socket until its launch time,
+	/// or its presentation time when launch time is not used, in nanoseconds
+	TL_HIST_TX_SLACK,
+	/// Number of items in the media queue, sampled every transmit interval or receive wakeup
+	TL_HIST_MEDIAQ_DEPTH,
+} tl_hist_t;
+
 /// Maximum number of configuration parameters inside INI file a host can have
 #define MAX_LIB_CFG_ITEMS 64
 
@@ -154,6 +175,12 @@ typedef struct {
 	U32 thread_affinity;
 	/// Real time priority of thread.
 	U32 thread_rt_priority;
+	/// Use the lock-free single producer / single consumer media queue
+	bool mediaq_lock_free;
+	/// Receive through the RX demultiplexer shared by all listeners on the interface (listener only)
+	bool rx_demux;
+	/// Gather the CPU time of the stream, see TL_STAT_CPU_NSEC
+	bool detailed_stats;
 	/// Friendly name for this configuration
 	char friendly_name[FRIENDLY_NAME_SIZE];
 
@@ -202,6 +229,20 @@ typedef struct openavb_tl_cfg_name_value_t {
  */
 bool openavbTLInitialize(U32 maxTL);
 
+/** Send the frames of all talkers from a pool of scheduler threads.
+ *
+ * Instead of every talker thread waking up for each transmit interval of its
+ * stream, the given number of worker threads, pinned to CPUs 0 to workers-1,
+ * send for all talkers in earliest deadline first order. Talkers using
+ * spin_wait or tx_blocking_in_intf always send from their own threads.
+ *
+ * \param workers Number of scheduler threads, 0 (the default) to disable
+ * \return TRUE on success or FALSE on failure
+ *
+ * \warning Must be called before openavbTLInitialize
+ */
+bool openavbTLSetTalkerWorkers(U32 workers);
+
 /** Final cleanup of the talker listener library.
  *
  * This function must be called last after all talkers and listeners have been closed
@@ -374,6 +415,16 @@ tl_init_state_t openavbTLGetInitialState(tl_handle_t handle);
  */
 U64 openavbTLStat(tl_handle_t handle, tl_stat_t stat);
 
+/** Allows pulling latency percentiles for a running stream.
+ *
+ * \param handle The handle return from openavbTLOpen()
+ * \param hist Which distribution to look at
+ * \param percentile Percentage from 0.0 to 100.0. 100.0 returns the maximum.
+ * \param pCount If not NULL receives the number of samples gathered so far
+ * \return the requested percentile in the unit of the distribution, 0 if there are no samples
+ */
+U64 openavbTLStatPercentile(tl_handle_t handle, tl_hist_t hist, double percentile, U64 *pCount);
+
 /** Read an ini file.
  *
  * Parses an input configuration file tp populate configuration structures, and
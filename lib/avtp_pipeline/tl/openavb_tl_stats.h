@@ -0,0 +1,115 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+
+/*
+* HEADER SUMMARY : Per stream statistics published in shared memory.
+*
+* Each process using the TL library creates the POSIX shared memory segment
+* OPENAVB_TL_STATS_SHM_PREFIX followed by its pid, holding one slot per
+* talker or listener. Stream threads update their slot with relaxed atomic
+* stores only. Tools such as avbstat map the segment read-only, so reading
+* the statistics never touches the running process.
+*/
+
+#ifndef OPENAVB_TL_STATS_H
+#define OPENAVB_TL_STATS_H 1
+
+#include "openavb_types.h"
+#include "openavb_histogram.h"
+#include "openavb_tl_pub.h"
+
+#define OPENAVB_TL_STATS_SHM_PREFIX		"/openavb_stats."
+#define OPENAVB_TL_STATS_MAGIC			0x53425641		// "AVBS"
+#define OPENAVB_TL_STATS_VERSION		1
+
+// One histogram per tl_hist_t
+#define OPENAVB_TL_STATS_HISTOGRAMS		(TL_HIST_MEDIAQ_DEPTH + 1)
+
+typedef struct {
+	// Even while the slot is stable and odd while its owner sets it up or clears it.
+	// Readers copy the slot and retry when seq was odd or changed during the copy.
+	U32 seq;
+	// TRUE while a talker or listener owns the slot
+	U32 inUse;
+	// avb_role_t of the owner
+	U32 role;
+	U16 streamUid;
+	U8 streamAddr[ETH_ALEN];
+	char friendlyName[FRIENDLY_NAME_SIZE];
+
+	// Frames sent or received
+	U64 frames;
+	// CPU time spent sending or receiving, only gathered with detailed_stats
+	U64 cpuNS;
+
+	struct openavb_histogram hist[OPENAVB_TL_STATS_HISTOGRAMS];
+
+	// Keep the next slot, written by another thread, off our last cache line
+	U8 pad[CACHE_LINE_SIZE];
+} openavb_tl_stats_slot_t;
+
+typedef struct {
+	U32 magic;
+	U32 version;
+	U32 pid;
+	U32 nSlots;
+	// sizeof(openavb_tl_stats_slot_t) of the writer, so readers can check the layout
+	U32 slotSize;
+	U8 pad[CACHE_LINE_SIZE - 5 * sizeof(U32)];
+	openavb_tl_stats_slot_t slots[];
+} openavb_tl_stats_shm_t;
+
+// Create the segment with room for nSlots streams. Called from openavbTLInitialize().
+// When shared memory is not available the slots are kept in private memory instead.
+bool openavbTLStatsInitialize(U32 nSlots);
+
+// Remove the segment. All slots must have been detached.
+void openavbTLStatsCleanup(void);
+
+// Take a free slot for a stream. Returns NULL when all slots are in use.
+openavb_tl_stats_slot_t *openavbTLStatsAttach(avb_role_t role, const char *friendlyName);
+
+// Give the slot back.
+void openavbTLStatsDetach(openavb_tl_stats_slot_t *pSlot);
+
+// Set the stream ID once it is known.
+void openavbTLStatsSetStreamID(openavb_tl_stats_slot_t *pSlot, const AVBStreamID_t *pStreamID);
+
+// Clear counters and histograms. Values the stream records while the slot is being
+// cleared may survive the reset.
+void openavbTLStatsReset(openavb_tl_stats_slot_t *pSlot);
+
+// Copy a slot, possibly of another process, that is being updated concurrently.
+// Returns FALSE when no consistent copy could be taken.
+bool openavbTLStatsSnapshot(const openavb_tl_stats_slot_t *pSlot, openavb_tl_stats_slot_t *pCopy);
+
+#endif  // OPENAVB_TL_STATS_H
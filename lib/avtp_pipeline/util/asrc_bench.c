@@ -0,0 +1,160 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Benchmark for the asynchronous sample rate converter.
+*
+* Resamples a second of a multi channel sine at each quality preset and sample rate,
+* and prints the cost per channel together with the signal to noise and distortion
+* ratio of the output against the ideal resampled sine.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <glib.h>
+#include "openavb_types_pub.h"
+#include "openavb_asrc_pub.h"
+
+//Common usage: ./asrc_bench -c 8 -f 48 -p 100
+
+#define NANOSECONDS_PER_SECOND		(1000000000ULL)
+#define TIMESPEC_TO_NSEC(ts) (((uint64_t)ts.tv_sec * (uint64_t)NANOSECONDS_PER_SECOND) + (uint64_t)ts.tv_nsec)
+
+static int channels = 8;
+static int framesPerCall = 48;
+static double ppm = 100;
+static double toneHz = 997;
+static int seconds = 1;
+
+static GOptionEntry entries[] =
+{
+  { "channels", 'c', 0, G_OPTION_ARG_INT,    &channels,      "interleaved channels",                 "NUM" },
+  { "frames",   'f', 0, G_OPTION_ARG_INT,    &framesPerCall, "input frames per call (one item)",     "NUM" },
+  { "ppm",      'p', 0, G_OPTION_ARG_DOUBLE, &ppm,           "ratio offset from 1.0",                "PPM" },
+  { "tone",     't', 0, G_OPTION_ARG_DOUBLE, &toneHz,        "test tone frequency",                  "HZ" },
+  { "seconds",  's', 0, G_OPTION_ARG_INT,    &seconds,       "seconds of audio per measurement",     "NUM" },
+  { NULL }
+};
+
+static U64 nowNSec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return TIMESPEC_TO_NSEC(now);
+}
+
+static void bench(openavb_asrc_quality_t quality, const char *name, U32 rate)
+{
+	U32 nIn = rate * seconds;
+	double ratio = 1.0 + ppm / 1000000.0;
+	float *pIn = malloc((size_t)nIn * channels * sizeof(float));
+	float *pOut = malloc((size_t)(nIn / (1.0 - OPENAVB_ASRC_MAX_DEVIATION) + 2 * framesPerCall) * channels * sizeof(float));
+	openavb_asrc_t *pAsrc = openavbAsrcCreate(channels, framesPerCall, quality);
+	U32 i1, i2;
+
+	if (!pIn || !pOut || !pAsrc) {
+		printf("error: out of memory\n");
+		exit(3);
+	}
+
+	// Full scale sine less 1 dB, the same on every channel
+	double w = 2.0 * M_PI * toneHz / rate;
+	for (i1 = 0; i1 < nIn; i1++) {
+		float s = (float)(0.891 * sin(w * i1));
+		for (i2 = 0; i2 < (U32)channels; i2++) {
+			pIn[i1 * channels + i2] = s;
+		}
+	}
+
+	openavbAsrcSetRatio(pAsrc, ratio);
+	U32 nOut = 0;
+	U64 startNSec = nowNSec();
+	for (i1 = 0; i1 + framesPerCall <= nIn; i1 += framesPerCall) {
+		nOut += openavbAsrcProcess(pAsrc, pIn + (size_t)i1 * channels, framesPerCall, pOut + (size_t)nOut * channels);
+	}
+	U64 elapsedNSec = nowNSec() - startNSec;
+
+	// Output frame k sits k * ratio input frames after the first input frame. Skip the
+	// filter start up and the tail still missing its neighbours.
+	double sig = 0, err = 0;
+	for (i1 = 64; i1 + 64 < nOut; i1++) {
+		double ideal = 0.891 * sin(w * i1 * ratio);
+		double e = pOut[(size_t)i1 * channels] - ideal;
+		sig += ideal * ideal;
+		err += e * e;
+	}
+
+	double nsPerFrame = (double)elapsedNSec / ((double)nOut * channels);
+	double cpuPercent = 100.0 * elapsedNSec / ((double)seconds * NANOSECONDS_PER_SECOND * channels);
+	printf("%-7s %6u Hz %9.2f ns/frame/channel %7.3f %% cpu/channel %7.1f dB sinad\n",
+		name, rate, nsPerFrame, cpuPercent, 10.0 * log10(sig / (err > 0 ? err : 1e-30)));
+
+	openavbAsrcDelete(pAsrc);
+	free(pIn);
+	free(pOut);
+}
+
+int main(int argc, char* argv[])
+{
+	GError *error = NULL;
+	GOptionContext *context;
+	static const U32 rates[] = { 48000, 96000, 192000 };
+	static const char *names[] = { "low", "medium", "high" };
+	int i1, i2;
+
+	context = g_option_context_new("- asynchronous sample rate converter benchmark");
+	g_option_context_add_main_entries(context, entries, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		printf("error: %s\n", error->message);
+		exit(1);
+	}
+
+	if (channels <= 0 || framesPerCall <= 0 || seconds <= 0) {
+		printf("error: channels, frames and seconds must be positive\n");
+		exit(2);
+	}
+
+	printf("kernels: %s, %d channels, %d frames per call, ratio %+.1f ppm\n", openavbAsrcKernelName(), channels, framesPerCall, ppm);
+	for (i1 = 0; i1 < 3; i1++) {
+		for (i2 = 0; i2 < 3; i2++) {
+			openavb_asrc_quality_t quality;
+			openavbAsrcQualityFromName(names[i1], &quality);
+			bench(quality, names[i1], rates[i2]);
+		}
+	}
+
+	g_option_context_free(context);
+	return 0;
+}
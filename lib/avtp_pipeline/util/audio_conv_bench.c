@@ -0,0 +1,215 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Microbenchmark for the audio sample conversion kernels.
+*
+* Times each conversion over a buffer of audio samples and prints the cost per
+* sample next to the per sample loops the mappings used before.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <glib.h>
+#include "openavb_types_pub.h"
+#include "openavb_audio_conv_pub.h"
+
+//Common usage: ./audio_conv_bench -n 192 -i 200000
+
+#define NANOSECONDS_PER_SECOND		(1000000000ULL)
+#define TIMESPEC_TO_NSEC(ts) (((uint64_t)ts.tv_sec * (uint64_t)NANOSECONDS_PER_SECOND) + (uint64_t)ts.tv_nsec)
+
+static int nSamples = 192;
+static int iterations = 200000;
+
+static GOptionEntry entries[] =
+{
+  { "samples",    'n', 0, G_OPTION_ARG_INT, &nSamples,   "samples per call (e.g. 8 channels * 24 frames)", "NUM" },
+  { "iterations", 'i', 0, G_OPTION_ARG_INT, &iterations, "calls per measurement",                          "NUM" },
+  { NULL }
+};
+
+static U8 *pIn;
+static U8 *pOut;
+static float *pFloat;
+
+// Previous AAF listener width conversion
+static void refWidthBE(U8 *pOutData, U32 nOutSampleLength, const U8 *pInData, U32 nInSampleLength, U32 n)
+{
+	const U8 *pInDataEnd = pInData + n * nInSampleLength;
+	U32 i;
+	if (nInSampleLength < nOutSampleLength) {
+		while (pInData < pInDataEnd) {
+			for (i = 0; i < nInSampleLength; ++i) {
+				*pOutData++ = *pInData++;
+			}
+			for ( ; i < nOutSampleLength; ++i) {
+				*pOutData++ = 0;
+			}
+		}
+	}
+	else {
+		while (pInData < pInDataEnd) {
+			for (i = 0; i < nOutSampleLength; ++i) {
+				*pOutData++ = *pInData++;
+			}
+			pInData += (nInSampleLength - nOutSampleLength);
+		}
+	}
+}
+
+// Previous 61883-6 talker packing
+static void refAM824Pack(U8 *pAVTPDataUnit, const U8 *pItemData, U32 itemSampleSizeBytes, U32 n, U32 label)
+{
+	U32 i;
+	for (i = 0; i < n; i++) {
+		S32 sample;
+		if (itemSampleSizeBytes == 2) {
+			sample = *(S16 *)pItemData;
+			sample &= 0x0000ffff;
+			sample = sample << 8;
+		}
+		else {
+			sample = *(S32 *)pItemData;
+			sample &= 0x00ffffff;
+		}
+		sample |= label;
+		*(U32 *)(pAVTPDataUnit) = htonl(sample);
+		pAVTPDataUnit += 4;
+		pItemData += itemSampleSizeBytes;
+	}
+}
+
+// Previous 61883-6 listener unpacking
+static void refAM824Unpack(U8 *pItemData, U32 itemSampleSizeBytes, const U8 *pAVTPDataUnit, U32 n)
+{
+	U32 i;
+	for (i = 0; i < n; i++) {
+		S32 sample = ntohl(*(S32 *)pAVTPDataUnit);
+		if (itemSampleSizeBytes == 2) {
+			*(S16 *)(pItemData) = (sample & 0x00ffffff) >> 8;
+		}
+		else {
+			*(S32 *)(pItemData) = sample & 0x00ffffff;
+		}
+		pAVTPDataUnit += 4;
+		pItemData += itemSampleSizeBytes;
+	}
+}
+
+static U64 nowNSec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return TIMESPEC_TO_NSEC(now);
+}
+
+static void report(const char *name, U64 startNSec, U64 endNSec)
+{
+	double nsPerSample = (double)(endNSec - startNSec) / ((double)iterations * nSamples);
+	printf("%-28s %8.3f ns/sample %10.1f Msamples/s\n", name, nsPerSample, 1000.0 / nsPerSample);
+}
+
+#define BENCH(name, call)								\
+	do {												\
+		int i1;											\
+		U64 startNSec = nowNSec();						\
+		for (i1 = 0; i1 < iterations; i1++) {			\
+			call;										\
+			__asm__ __volatile__("" ::: "memory");		\
+		}												\
+		report(name, startNSec, nowNSec());				\
+	} while (0)
+
+int main(int argc, char* argv[])
+{
+	GError *error = NULL;
+	GOptionContext *context;
+	int i1;
+
+	context = g_option_context_new("- audio conversion benchmark");
+	g_option_context_add_main_entries(context, entries, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error))
+	{
+		printf("error: %s\n", error->message);
+		exit(1);
+	}
+
+	if (nSamples <= 0 || iterations <= 0) {
+		printf("error: samples and iterations must be positive\n");
+		exit(2);
+	}
+
+	// One spare sample of slack for the reference loops that store 4 bytes for 3 byte samples
+	pIn = malloc((nSamples + 1) * 4);
+	pOut = malloc((nSamples + 1) * 4);
+	pFloat = malloc(nSamples * sizeof(float));
+	if (!pIn || !pOut || !pFloat) {
+		printf("error: out of memory\n");
+		exit(3);
+	}
+	for (i1 = 0; i1 < (nSamples + 1) * 4; i1++) {
+		pIn[i1] = rand();
+	}
+
+	printf("kernels: %s, %d samples per call, %d calls\n", openavbAudioConvKernelName(), nSamples, iterations);
+
+	BENCH("width 2->4 ref", refWidthBE(pOut, 4, pIn, 2, nSamples));
+	BENCH("width 2->4", openavbAudioConvWidthBE(pOut, 4, pIn, 2, nSamples));
+	BENCH("width 4->2 ref", refWidthBE(pOut, 2, pIn, 4, nSamples));
+	BENCH("width 4->2", openavbAudioConvWidthBE(pOut, 2, pIn, 4, nSamples));
+	BENCH("width 3->4 ref", refWidthBE(pOut, 4, pIn, 3, nSamples));
+	BENCH("width 3->4", openavbAudioConvWidthBE(pOut, 4, pIn, 3, nSamples));
+	BENCH("width 4->3 ref", refWidthBE(pOut, 3, pIn, 4, nSamples));
+	BENCH("width 4->3", openavbAudioConvWidthBE(pOut, 3, pIn, 4, nSamples));
+	BENCH("am824 pack 16 ref", refAM824Pack(pOut, pIn, 2, nSamples, 0x42000000));
+	BENCH("am824 pack 16", openavbAudioConvAM824Pack(pOut, pIn, 2, nSamples, 0x42000000));
+	BENCH("am824 pack 24 ref", refAM824Pack(pOut, pIn, 3, nSamples, 0x40000000));
+	BENCH("am824 pack 24", openavbAudioConvAM824Pack(pOut, pIn, 3, nSamples, 0x40000000));
+	BENCH("am824 unpack 16 ref", refAM824Unpack(pOut, 2, pIn, nSamples));
+	BENCH("am824 unpack 16", openavbAudioConvAM824Unpack(pOut, 2, pIn, nSamples));
+	BENCH("am824 unpack 24 ref", refAM824Unpack(pOut, 3, pIn, nSamples));
+	BENCH("am824 unpack 24", openavbAudioConvAM824Unpack(pOut, 3, pIn, nSamples));
+	BENCH("swap 16", openavbAudioConvSwap(pOut, pIn, 2, nSamples));
+	BENCH("swap 32", openavbAudioConvSwap(pOut, pIn, 4, nSamples));
+	BENCH("int16 -> float", openavbAudioConvIntToFloat(pFloat, pIn, 2, nSamples));
+	BENCH("float -> int16", openavbAudioConvFloatToInt(pOut, 2, pFloat, nSamples));
+	BENCH("int32 -> float", openavbAudioConvIntToFloat(pFloat, pIn, 4, nSamples));
+	BENCH("float -> int32", openavbAudioConvFloatToInt(pOut, 4, pFloat, nSamples));
+
+	free(pIn);
+	free(pOut);
+	free(pFloat);
+	return 0;
+}
@@ -0,0 +1,437 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Polyphase windowed sinc asynchronous sample rate converter.
+*
+* Each output sample is the dot product of the input history around its position
+* with a Kaiser windowed sinc. The filter is tabulated at a fixed number of phases
+* and interpolated linearly between the two nearest, so any ratio can be followed.
+* The interpolated coefficients are shared by all channels, which are kept planar
+* so the dot products run over contiguous memory.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "openavb_asrc_pub.h"
+#include "openavb_audio_conv_pub.h"
+
+// As in openavb_audio_conv.c the AVX2 kernels are built with target attributes and
+// picked at run time.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define ASRC_X86 1
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ASRC_SSE2 1
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ASRC_NEON 1
+#endif
+
+// Alignment of the coefficient rows and channel histories
+#define ASRC_ALIGN			32
+
+typedef struct {
+	U32 taps;
+	U32 phases;
+	// Pass band edge as a fraction of the Nyquist frequency
+	double cutoff;
+	// Kaiser window shape
+	double beta;
+} asrc_preset_t;
+
+static const asrc_preset_t gPresets[] = {
+	[OPENAVB_ASRC_QUALITY_LOW]    = { 16,  128, 0.80, 7.0 },
+	[OPENAVB_ASRC_QUALITY_MEDIUM] = { 32,  256, 0.88, 9.0 },
+	[OPENAVB_ASRC_QUALITY_HIGH]   = { 64, 1024, 0.92, 11.0 },
+};
+
+typedef float (*asrc_dot_t)(const float *pA, const float *pB, U32 n);
+typedef void (*asrc_lerp_t)(float *pOut, const float *pA, const float *pB, float frac, U32 n);
+
+struct openavb_asrc {
+	U32 channels;
+	U32 taps;
+	U32 phases;
+	U32 maxInFrames;
+
+	// phases + 1 rows of taps coefficients
+	float *pCoef;
+	// Coefficients interpolated for the current output sample
+	float *pCoefCur;
+
+	// One history row per channel, histCap frames each
+	float *pHist;
+	U32 histCap;
+	U32 nHist;
+	// Where the next input frame goes in each history row
+	U8 **ppHistTail;
+
+	// Position of the next output sample in the history, in frames
+	double pos;
+	double ratio;
+
+	asrc_dot_t dot;
+	asrc_lerp_t lerp;
+};
+
+static float x_dotScalar(const float *pA, const float *pB, U32 n)
+{
+	float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+	U32 i1;
+	for (i1 = 0; i1 < n; i1 += 4) {
+		sum0 += pA[i1] * pB[i1];
+		sum1 += pA[i1 + 1] * pB[i1 + 1];
+		sum2 += pA[i1 + 2] * pB[i1 + 2];
+		sum3 += pA[i1 + 3] * pB[i1 + 3];
+	}
+	return (sum0 + sum1) + (sum2 + sum3);
+}
+
+static void x_lerpScalar(float *pOut, const float *pA, const float *pB, float frac, U32 n)
+{
+	U32 i1;
+	for (i1 = 0; i1 < n; i1++) {
+		pOut[i1] = pA[i1] + frac * (pB[i1] - pA[i1]);
+	}
+}
+
+#if ASRC_SSE2
+// The history is only 4 byte aligned at an arbitrary position, the coefficients are aligned.
+static float x_dotSSE2(const float *pA, const float *pB, U32 n)
+{
+	__m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+	U32 i1;
+	for (i1 = 0; i1 < n; i1 += 8) {
+		sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(pA + i1), _mm_load_ps(pB + i1)));
+		sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(pA + i1 + 4), _mm_load_ps(pB + i1 + 4)));
+	}
+	sum0 = _mm_add_ps(sum0, sum1);
+	sum0 = _mm_add_ps(sum0, _mm_movehl_ps(sum0, sum0));
+	sum0 = _mm_add_ss(sum0, _mm_shuffle_ps(sum0, sum0, 1));
+	return _mm_cvtss_f32(sum0);
+}
+
+static void x_lerpSSE2(float *pOut, const float *pA, const float *pB, float frac, U32 n)
+{
+	__m128 vFrac = _mm_set1_ps(frac);
+	U32 i1;
+	for (i1 = 0; i1 < n; i1 += 4) {
+		__m128 a = _mm_load_ps(pA + i1);
+		_mm_store_ps(pOut + i1, _mm_add_ps(a, _mm_mul_ps(vFrac, _mm_sub_ps(_mm_load_ps(pB + i1), a))));
+	}
+}
+#endif
+
+#if ASRC_X86
+__attribute__((target("avx2,fma")))
+static float x_dotAVX2(const float *pA, const float *pB, U32 n)
+{
+	__m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+	U32 i1;
+	for (i1 = 0; i1 < n; i1 += 16) {
+		sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i1), _mm256_load_ps(pB + i1), sum0);
+		sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(pA + i1 + 8), _mm256_load_ps(pB + i1 + 8), sum1);
+	}
+	sum0 = _mm256_add_ps(sum0, sum1);
+	__m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum0), _mm256_extractf128_ps(sum0, 1));
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+	return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx2,fma")))
+static void x_lerpAVX2(float *pOut, const float *pA, const float *pB, float frac, U32 n)
+{
+	__m256 vFrac = _mm256_set1_ps(frac);
+	U32 i1;
+	for (i1 = 0; i1 < n; i1 += 8) {
+		__m256 a = _mm256_load_ps(pA + i1);
+		_mm256_store_ps(pOut + i1, _mm256_fmadd_ps(vFrac, _mm256_sub_ps(_mm256_load_ps(pB + i1), a), a));
+	}
+}
+#endif
+
+#if ASRC_NEON
+static float x_dotNEON(const float *pA, const float *pB, U32 n)
+{
+	float32x4_t sum0 = vdupq_n_f32(0), sum1 = vdupq_n_f32(0);
+	U32 i1;
+	for (i1 = 0; i1 < n; i1 += 8) {
+		sum0 = vfmaq_f32(sum0, vld1q_f32(pA + i1), vld1q_f32(pB + i1));
+		sum1 = vfmaq_f32(sum1, vld1q_f32(pA + i1 + 4), vld1q_f32(pB + i1 + 4));
+	}
+	return vaddvq_f32(vaddq_f32(sum0, sum1));
+}
+
+static void x_lerpNEON(float *pOut, const float *pA, const float *pB, float frac, U32 n)
+{
+	U32 i1;
+	for (i1 = 0; i1 < n; i1 += 4) {
+		float32x4_t a = vld1q_f32(pA + i1);
+		vst1q_f32(pOut + i1, vfmaq_n_f32(a, vsubq_f32(vld1q_f32(pB + i1), a), frac));
+	}
+}
+#endif
+
+static bool x_useAVX2(void)
+{
+#if ASRC_X86
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+	return FALSE;
+#endif
+}
+
+const char *openavbAsrcKernelName(void)
+{
+	if (x_useAVX2()) {
+		return "avx2";
+	}
+#if ASRC_NEON
+	return "neon";
+#elif ASRC_SSE2
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+bool openavbAsrcQualityFromName(const char *pName, openavb_asrc_quality_t *pQuality)
+{
+	if (strcasecmp(pName, "low") == 0) {
+		*pQuality = OPENAVB_ASRC_QUALITY_LOW;
+	}
+	else if (strcasecmp(pName, "medium") == 0) {
+		*pQuality = OPENAVB_ASRC_QUALITY_MEDIUM;
+	}
+	else if (strcasecmp(pName, "high") == 0) {
+		*pQuality = OPENAVB_ASRC_QUALITY_HIGH;
+	}
+	else {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+// Zeroth order modified Bessel function of the first kind
+static double x_besselI0(double x)
+{
+	double sum = 1.0, term = 1.0;
+	int k;
+	for (k = 1; k < 50; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12) {
+			break;
+		}
+	}
+	return sum;
+}
+
+// Row p holds the coefficients for an output sample p / phases frames after the
+// history sample at tap taps / 2 - 1. Each row is normalised to unity gain at DC
+// so the gain does not ripple with the phase.
+static void x_buildCoef(openavb_asrc_t *pAsrc, const asrc_preset_t *pPreset)
+{
+	double half = pAsrc->taps / 2;
+	double i0Beta = x_besselI0(pPreset->beta);
+	U32 p, k;
+
+	for (p = 0; p <= pAsrc->phases; p++) {
+		float *pRow = pAsrc->pCoef + p * pAsrc->taps;
+		double frac = (double)p / pAsrc->phases;
+		double sum = 0;
+		for (k = 0; k < pAsrc->taps; k++) {
+			double d = frac + half - 1 - k;
+			double u = d / half;
+			double w = fabs(u) < 1.0 ? x_besselI0(pPreset->beta * sqrt(1.0 - u * u)) / i0Beta : 0.0;
+			double x = M_PI * pPreset->cutoff * d;
+			double h = fabs(x) < 1e-12 ? 1.0 : sin(x) / x;
+			pRow[k] = h * w;
+			sum += pRow[k];
+		}
+		for (k = 0; k < pAsrc->taps; k++) {
+			pRow[k] /= sum;
+		}
+	}
+}
+
+openavb_asrc_t *openavbAsrcCreate(U32 channels, U32 maxInFrames, openavb_asrc_quality_t quality)
+{
+	if (!channels || !maxInFrames || quality > OPENAVB_ASRC_QUALITY_HIGH) {
+		return NULL;
+	}
+
+	openavb_asrc_t *pAsrc = calloc(1, sizeof(openavb_asrc_t));
+	if (!pAsrc) {
+		return NULL;
+	}
+
+	const asrc_preset_t *pPreset = &gPresets[quality];
+	pAsrc->channels = channels;
+	pAsrc->taps = pPreset->taps;
+	pAsrc->phases = pPreset->phases;
+	pAsrc->maxInFrames = maxInFrames;
+	// A full filter, one block and the fractional frame still waiting for its neighbours
+	pAsrc->histCap = (pAsrc->taps + maxInFrames + 1 + (ASRC_ALIGN / sizeof(float) - 1)) & ~(ASRC_ALIGN / sizeof(float) - 1);
+
+	if (posix_memalign((void **)&pAsrc->pCoef, ASRC_ALIGN, (pAsrc->phases + 1) * pAsrc->taps * sizeof(float))
+			|| posix_memalign((void **)&pAsrc->pCoefCur, ASRC_ALIGN, pAsrc->taps * sizeof(float))
+			|| posix_memalign((void **)&pAsrc->pHist, ASRC_ALIGN, (size_t)channels * pAsrc->histCap * sizeof(float))
+			|| !(pAsrc->ppHistTail = calloc(channels, sizeof(U8 *)))) {
+		openavbAsrcDelete(pAsrc);
+		return NULL;
+	}
+	x_buildCoef(pAsrc, pPreset);
+
+	pAsrc->dot = x_dotScalar;
+	pAsrc->lerp = x_lerpScalar;
+#if ASRC_NEON
+	pAsrc->dot = x_dotNEON;
+	pAsrc->lerp = x_lerpNEON;
+#elif ASRC_SSE2
+	pAsrc->dot = x_dotSSE2;
+	pAsrc->lerp = x_lerpSSE2;
+#endif
+#if ASRC_X86
+	if (x_useAVX2()) {
+		pAsrc->dot = x_dotAVX2;
+		pAsrc->lerp = x_lerpAVX2;
+	}
+#endif
+
+	pAsrc->ratio = 1.0;
+	openavbAsrcReset(pAsrc);
+	return pAsrc;
+}
+
+void openavbAsrcDelete(openavb_asrc_t *pAsrc)
+{
+	if (pAsrc) {
+		free(pAsrc->pCoef);
+		free(pAsrc->pCoefCur);
+		free(pAsrc->pHist);
+		free(pAsrc->ppHistTail);
+		free(pAsrc);
+	}
+}
+
+void openavbAsrcReset(openavb_asrc_t *pAsrc)
+{
+	// Start on silence, so the first input frame is output after half a filter
+	memset(pAsrc->pHist, 0, (size_t)pAsrc->channels * pAsrc->histCap * sizeof(float));
+	pAsrc->nHist = pAsrc->taps / 2;
+	pAsrc->pos = pAsrc->taps / 2;
+}
+
+void openavbAsrcSetRatio(openavb_asrc_t *pAsrc, double ratio)
+{
+	if (ratio > 1.0 + OPENAVB_ASRC_MAX_DEVIATION) {
+		ratio = 1.0 + OPENAVB_ASRC_MAX_DEVIATION;
+	}
+	else if (ratio < 1.0 - OPENAVB_ASRC_MAX_DEVIATION) {
+		ratio = 1.0 - OPENAVB_ASRC_MAX_DEVIATION;
+	}
+	pAsrc->ratio = ratio;
+}
+
+double openavbAsrcGetRatio(const openavb_asrc_t *pAsrc)
+{
+	return pAsrc->ratio;
+}
+
+double openavbAsrcBufferedFrames(const openavb_asrc_t *pAsrc)
+{
+	return pAsrc->nHist - pAsrc->pos;
+}
+
+U32 openavbAsrcMaxOutFrames(const openavb_asrc_t *pAsrc, U32 inFrames)
+{
+	// Up to a frame already buffered plus the new ones at the slowest ratio
+	return (U32)((inFrames + 1) / (1.0 - OPENAVB_ASRC_MAX_DEVIATION)) + 1;
+}
+
+U32 openavbAsrcProcess(openavb_asrc_t *pAsrc, const float *pIn, U32 inFrames, float *pOut)
+{
+	U32 half = pAsrc->taps / 2;
+	U32 nOut = 0;
+	U32 i1;
+
+	if (inFrames > pAsrc->maxInFrames) {
+		inFrames = pAsrc->maxInFrames;
+	}
+
+	// Append the block to the channel histories
+	for (i1 = 0; i1 < pAsrc->channels; i1++) {
+		pAsrc->ppHistTail[i1] = (U8 *)(pAsrc->pHist + i1 * pAsrc->histCap + pAsrc->nHist);
+	}
+	openavbAudioConvDeinterleave(pAsrc->ppHistTail, (const U8 *)pIn, sizeof(float), pAsrc->channels, inFrames);
+	pAsrc->nHist += inFrames;
+
+	// Output sample at pos needs the history from floor(pos) - half + 1 to floor(pos) + half
+	while ((U32)pAsrc->pos + half < pAsrc->nHist) {
+		U32 idx = (U32)pAsrc->pos;
+		double phase = (pAsrc->pos - idx) * pAsrc->phases;
+		U32 row = (U32)phase;
+		const float *pRow = pAsrc->pCoef + row * pAsrc->taps;
+		pAsrc->lerp(pAsrc->pCoefCur, pRow, pRow + pAsrc->taps, (float)(phase - row), pAsrc->taps);
+
+		const float *pSrc = pAsrc->pHist + idx - half + 1;
+		for (i1 = 0; i1 < pAsrc->channels; i1++) {
+			*pOut++ = pAsrc->dot(pSrc, pAsrc->pCoefCur, pAsrc->taps);
+			pSrc += pAsrc->histCap;
+		}
+		nOut++;
+		pAsrc->pos += pAsrc->ratio;
+	}
+
+	// Keep only what later output samples still need
+	U32 drop = (U32)pAsrc->pos - half + 1;
+	if (drop > pAsrc->nHist) {
+		drop = pAsrc->nHist;
+	}
+	if (drop) {
+		for (i1 = 0; i1 < pAsrc->channels; i1++) {
+			float *pHist = pAsrc->pHist + i1 * pAsrc->histCap;
+			memmove(pHist, pHist + drop, (pAsrc->nHist - drop) * sizeof(float));
+		}
+		pAsrc->nHist -= drop;
+		pAsrc->pos -= drop;
+	}
+
+	return nOut;
+}
@@ -0,0 +1,126 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* HEADER SUMMARY : Asynchronous sample rate converter public interface
+*/
+
+#ifndef OPENAVB_ASRC_PUB_H
+#define OPENAVB_ASRC_PUB_H 1
+
+#include "openavb_types_pub.h"
+
+/** \file
+ * Asynchronous sample rate converter public interface.
+ *
+ * A polyphase windowed sinc resampler for ratios close to 1.0, used to follow
+ * a media clock that runs slightly faster or slower than the local audio
+ * hardware. The ratio may be changed between calls without clicks. Samples are
+ * interleaved floats; see openavb_audio_conv_pub.h for the integer conversions.
+ *
+ * The filter inner loops run on AVX2 picked at run time or SSE2 on x86, or NEON
+ * on AArch64. A converter keeps per stream state and is not thread safe.
+ */
+
+/** Largest supported deviation of the ratio from 1.0. */
+#define OPENAVB_ASRC_MAX_DEVIATION		0.01
+
+/** Quality and CPU cost presets. SINAD figures are for a 1 kHz tone at 48 kHz,
+ * asrc_bench prints them for other rates and tones. */
+typedef enum {
+	/// 16 taps, about 75 dB SINAD and rolling off above half the Nyquist frequency. Cheapest.
+	OPENAVB_ASRC_QUALITY_LOW,
+	/// 32 taps, about 95 dB SINAD.
+	OPENAVB_ASRC_QUALITY_MEDIUM,
+	/// 64 taps, about 115 dB SINAD.
+	OPENAVB_ASRC_QUALITY_HIGH,
+} openavb_asrc_quality_t;
+
+typedef struct openavb_asrc openavb_asrc_t;
+
+/** Name of the kernel set in use.
+ *
+ * \return "avx2", "sse2", "neon" or "scalar".
+ */
+const char *openavbAsrcKernelName(void);
+
+/** Parse a quality preset name.
+ *
+ * \param pName "low", "medium" or "high".
+ * \param pQuality Set to the preset when the name is known.
+ * \return TRUE when the name is known.
+ */
+bool openavbAsrcQualityFromName(const char *pName, openavb_asrc_quality_t *pQuality);
+
+/** Create a converter.
+ *
+ * \param channels Number of interleaved channels.
+ * \param maxInFrames Largest number of frames passed to one openavbAsrcProcess() call.
+ * \param quality Filter preset.
+ * \return The converter, or NULL when out of memory.
+ */
+openavb_asrc_t *openavbAsrcCreate(U32 channels, U32 maxInFrames, openavb_asrc_quality_t quality);
+
+/** Free a converter. NULL is ignored. */
+void openavbAsrcDelete(openavb_asrc_t *pAsrc);
+
+/** Drop buffered samples, for example after an underrun. The ratio is kept. */
+void openavbAsrcReset(openavb_asrc_t *pAsrc);
+
+/** Set the number of input frames consumed per output frame.
+ *
+ * Values above 1.0 shorten the audio, values below 1.0 stretch it. Clamped to
+ * OPENAVB_ASRC_MAX_DEVIATION around 1.0.
+ */
+void openavbAsrcSetRatio(openavb_asrc_t *pAsrc, double ratio);
+
+/** Current ratio. */
+double openavbAsrcGetRatio(const openavb_asrc_t *pAsrc);
+
+/** Input frames held back by the filter, including the fractional position. */
+double openavbAsrcBufferedFrames(const openavb_asrc_t *pAsrc);
+
+/** Room needed in the output buffer of openavbAsrcProcess() for inFrames input frames. */
+U32 openavbAsrcMaxOutFrames(const openavb_asrc_t *pAsrc, U32 inFrames);
+
+/** Resample a block of frames.
+ *
+ * All input frames are consumed; as many output frames as the input allows are produced.
+ *
+ * \param pAsrc The converter.
+ * \param pIn Interleaved input samples.
+ * \param inFrames Number of input frames, at most maxInFrames.
+ * \param pOut Interleaved output samples, room for openavbAsrcMaxOutFrames() frames.
+ * \return Number of output frames written.
+ */
+U32 openavbAsrcProcess(openavb_asrc_t *pAsrc, const float *pIn, U32 inFrames, float *pOut);
+
+#endif // OPENAVB_ASRC_PUB_H
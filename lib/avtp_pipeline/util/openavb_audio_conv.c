@@ -0,0 +1,599 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Audio sample conversion kernels shared by the audio mappings.
+*/
+
+#include <string.h>
+#include <math.h>
+#include <arpa/inet.h>
+
+#include "openavb_audio_conv_pub.h"
+
+// On x86 the SSSE3 and AVX2 kernels are built with target attributes and picked
+// at run time, so they are used without raising the baseline of the whole build.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define AUDIO_CONV_X86 1
+#define AUDIO_CONV_SHUFFLE_VEC 1
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define AUDIO_CONV_SSE2 1
+#endif
+// vqtbl1q_u8 and round to nearest conversions are only available on AArch64.
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AUDIO_CONV_NEON 1
+#define AUDIO_CONV_SHUFFLE_VEC 1
+#endif
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define AUDIO_CONV_HOST_BE 1
+#endif
+
+// Shuffle index that produces a zero byte. pshufb and tbl both zero any index >= 0x80.
+#define SHUF_ZERO		0x80
+
+// How to build one output sample from one input sample: for each output byte
+// the index of the source byte within the input sample (or SHUF_ZERO), and bits
+// ORed in afterwards.
+typedef struct {
+	U32 inBytes;
+	U32 outBytes;
+	U8 src[4];
+	U8 orBits[4];
+} shuffle_desc_t;
+
+#if AUDIO_CONV_SHUFFLE_VEC
+// Expanded shuffle for the vector kernels
+typedef struct {
+	U8 mask[16];
+	U8 orBits[16];
+	// Samples per 16 byte vector and the bytes they span
+	U32 group;
+	U32 inStep;
+	U32 outStep;
+	U32 inLen;
+	U32 outLen;
+} shuffle_vec_t;
+
+// Expand a sample description into a 16 byte shuffle covering as many whole
+// samples as fit in a vector.
+static void x_shuffleVecInit(shuffle_vec_t *pVec, const shuffle_desc_t *pDesc, U32 nSamples)
+{
+	U32 maxBytes = pDesc->inBytes > pDesc->outBytes ? pDesc->inBytes : pDesc->outBytes;
+	U32 i1, i2;
+
+	pVec->group = 16 / maxBytes;
+	pVec->inStep = pVec->group * pDesc->inBytes;
+	pVec->outStep = pVec->group * pDesc->outBytes;
+	pVec->inLen = nSamples * pDesc->inBytes;
+	pVec->outLen = nSamples * pDesc->outBytes;
+
+	for (i1 = 0; i1 < 16; i1++) {
+		// Bytes past the last whole sample are stored back unchanged when the
+		// strides match, which keeps in place conversions safe.
+		pVec->mask[i1] = pDesc->inBytes == pDesc->outBytes ? i1 : SHUF_ZERO;
+		pVec->orBits[i1] = 0;
+	}
+	for (i1 = 0; i1 < pVec->group; i1++) {
+		for (i2 = 0; i2 < pDesc->outBytes; i2++) {
+			U8 src = pDesc->src[i2];
+			pVec->mask[i1 * pDesc->outBytes + i2] = src == SHUF_ZERO ? SHUF_ZERO : i1 * pDesc->inBytes + src;
+			pVec->orBits[i1 * pDesc->outBytes + i2] = pDesc->orBits[i2];
+		}
+	}
+}
+#endif
+
+#if AUDIO_CONV_X86
+// Returns the number of samples converted; the caller finishes the rest.
+__attribute__((target("ssse3")))
+static U32 x_shuffleSSSE3(U8 *pOut, const U8 *pIn, const shuffle_vec_t *pVec, U32 inOff, U32 outOff)
+{
+	__m128i vMask = _mm_loadu_si128((const __m128i *)pVec->mask);
+	__m128i vOr = _mm_loadu_si128((const __m128i *)pVec->orBits);
+	U32 done = 0;
+
+	while (inOff + 16 <= pVec->inLen && outOff + 16 <= pVec->outLen) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(pIn + inOff));
+		v = _mm_or_si128(_mm_shuffle_epi8(v, vMask), vOr);
+		_mm_storeu_si128((__m128i *)(pOut + outOff), v);
+		inOff += pVec->inStep;
+		outOff += pVec->outStep;
+		done += pVec->group;
+	}
+	return done;
+}
+
+__attribute__((target("avx2")))
+static U32 x_shuffleAVX2(U8 *pOut, const U8 *pIn, const shuffle_vec_t *pVec)
+{
+	__m256i vMask = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)pVec->mask));
+	__m256i vOr = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)pVec->orBits));
+	U32 inOff = 0, outOff = 0;
+	U32 done = 0;
+
+	while (inOff + pVec->inStep + 16 <= pVec->inLen && outOff + pVec->outStep + 16 <= pVec->outLen) {
+		// Two sample groups, one per 128 bit lane. Loads happen before the
+		// stores so in place use stays safe.
+		__m256i v = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(pIn + inOff))),
+			_mm_loadu_si128((const __m128i *)(pIn + inOff + pVec->inStep)), 1);
+		v = _mm256_or_si256(_mm256_shuffle_epi8(v, vMask), vOr);
+		_mm_storeu_si128((__m128i *)(pOut + outOff), _mm256_castsi256_si128(v));
+		_mm_storeu_si128((__m128i *)(pOut + outOff + pVec->outStep), _mm256_extracti128_si256(v, 1));
+		inOff += 2 * pVec->inStep;
+		outOff += 2 * pVec->outStep;
+		done += 2 * pVec->group;
+	}
+	return done + x_shuffleSSSE3(pOut, pIn, pVec, inOff, outOff);
+}
+#endif
+
+#if AUDIO_CONV_NEON
+static U32 x_shuffleNEON(U8 *pOut, const U8 *pIn, const shuffle_vec_t *pVec)
+{
+	uint8x16_t vMask = vld1q_u8(pVec->mask);
+	uint8x16_t vOr = vld1q_u8(pVec->orBits);
+	U32 inOff = 0, outOff = 0;
+	U32 done = 0;
+
+	while (inOff + 16 <= pVec->inLen && outOff + 16 <= pVec->outLen) {
+		uint8x16_t v = vld1q_u8(pIn + inOff);
+		v = vorrq_u8(vqtbl1q_u8(v, vMask), vOr);
+		vst1q_u8(pOut + outOff, v);
+		inOff += pVec->inStep;
+		outOff += pVec->outStep;
+		done += pVec->group;
+	}
+	return done;
+}
+#endif
+
+// Convert as many samples as the vector kernels can. Returns the number of
+// samples converted; the caller finishes the rest with its scalar loop.
+static U32 x_shuffleVec(U8 *pOut, const U8 *pIn, const shuffle_desc_t *pDesc, U32 nSamples)
+{
+	U32 done = 0;
+
+#if AUDIO_CONV_SHUFFLE_VEC
+	shuffle_vec_t vec;
+
+	if (nSamples * pDesc->inBytes < 16 || nSamples * pDesc->outBytes < 16) {
+		return 0;
+	}
+#if AUDIO_CONV_X86
+	if (__builtin_cpu_supports("avx2")) {
+		x_shuffleVecInit(&vec, pDesc, nSamples);
+		done = x_shuffleAVX2(pOut, pIn, &vec);
+	}
+	else if (__builtin_cpu_supports("ssse3")) {
+		x_shuffleVecInit(&vec, pDesc, nSamples);
+		done = x_shuffleSSSE3(pOut, pIn, &vec, 0, 0);
+	}
+#else
+	x_shuffleVecInit(&vec, pDesc, nSamples);
+	done = x_shuffleNEON(pOut, pIn, &vec);
+#endif
+#endif
+
+	return done;
+}
+
+static inline __attribute__((always_inline)) S32 x_loadInt(const U8 *pIn, U32 inBytes)
+{
+	switch (inBytes) {
+		case 2:
+			{
+				S16 s16;
+				memcpy(&s16, pIn, 2);
+				return s16;
+			}
+		case 3:
+#if AUDIO_CONV_HOST_BE
+			return ((S32)(S8)pIn[0] << 16) | ((S32)pIn[1] << 8) | pIn[2];
+#else
+			return ((S32)(S8)pIn[2] << 16) | ((S32)pIn[1] << 8) | pIn[0];
+#endif
+		default:
+			{
+				S32 s32;
+				memcpy(&s32, pIn, 4);
+				return s32;
+			}
+	}
+}
+
+static inline __attribute__((always_inline)) void x_storeInt(U8 *pOut, U32 outBytes, S32 value)
+{
+	switch (outBytes) {
+		case 2:
+			{
+				S16 s16 = (S16)value;
+				memcpy(pOut, &s16, 2);
+			}
+			break;
+		case 3:
+#if AUDIO_CONV_HOST_BE
+			pOut[0] = (U8)(value >> 16);
+			pOut[1] = (U8)(value >> 8);
+			pOut[2] = (U8)value;
+#else
+			pOut[0] = (U8)value;
+			pOut[1] = (U8)(value >> 8);
+			pOut[2] = (U8)(value >> 16);
+#endif
+			break;
+		default:
+			memcpy(pOut, &value, 4);
+			break;
+	}
+}
+
+// Scalar loops, inlined with constant sample sizes so the compiler can unroll
+// the byte handling. They pick up at sample i1 after the vector kernels.
+static inline __attribute__((always_inline)) void x_widthScalar(U8 * __restrict pOut, const U8 * __restrict pIn, U32 i1, U32 nSamples, const U32 inBytes, const U32 outBytes)
+{
+	U32 i2;
+
+	pIn += i1 * inBytes;
+	pOut += i1 * outBytes;
+	for ( ; i1 < nSamples; i1++) {
+		for (i2 = 0; i2 < inBytes && i2 < outBytes; ++i2) {
+			*pOut++ = pIn[i2];
+		}
+		for ( ; i2 < outBytes; ++i2) {
+			*pOut++ = 0; // Value specified in IEEE 1722-2016 Clause 7.3.4.
+		}
+		pIn += inBytes;
+	}
+}
+
+static inline __attribute__((always_inline)) void x_am824PackScalar(U8 * __restrict pOut, const U8 * __restrict pIn, U32 i1, U32 nSamples, U32 label, const U32 inBytes)
+{
+	const U32 mask = inBytes == 2 ? 0x0000ffff : 0x00ffffff;
+
+	pIn += i1 * inBytes;
+	pOut += i1 * 4;
+	for ( ; i1 < nSamples; i1++) {
+		U32 quadlet = htonl(((x_loadInt(pIn, inBytes) & mask) << (24 - 8 * inBytes)) | label);
+		memcpy(pOut, &quadlet, 4);
+		pIn += inBytes;
+		pOut += 4;
+	}
+}
+
+static inline __attribute__((always_inline)) void x_am824UnpackScalar(U8 * __restrict pOut, const U8 * __restrict pIn, U32 i1, U32 nSamples, const U32 outBytes)
+{
+	pIn += i1 * 4;
+	pOut += i1 * outBytes;
+	for ( ; i1 < nSamples; i1++) {
+		U32 quadlet;
+		memcpy(&quadlet, pIn, 4);
+		x_storeInt(pOut, outBytes, (S32)((ntohl(quadlet) & 0x00ffffff) >> (24 - 8 * outBytes)));
+		pIn += 4;
+		pOut += outBytes;
+	}
+}
+
+const char *openavbAudioConvKernelName(void)
+{
+#if AUDIO_CONV_X86
+	if (__builtin_cpu_supports("avx2")) {
+		return "avx2";
+	}
+	if (__builtin_cpu_supports("ssse3")) {
+		return "ssse3";
+	}
+#endif
+#if AUDIO_CONV_NEON
+	return "neon";
+#elif AUDIO_CONV_SSE2
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+void openavbAudioConvWidthBE(U8 *pOut, U32 outBytes, const U8 *pIn, U32 inBytes, U32 nSamples)
+{
+	shuffle_desc_t desc = { inBytes, outBytes, { SHUF_ZERO, SHUF_ZERO, SHUF_ZERO, SHUF_ZERO }, { 0, 0, 0, 0 } };
+	U32 copyBytes = inBytes < outBytes ? inBytes : outBytes;
+	U32 i1;
+
+	if (inBytes == outBytes) {
+		if (pOut != pIn) {
+			memmove(pOut, pIn, nSamples * inBytes);
+		}
+		return;
+	}
+	for (i1 = 0; i1 < copyBytes; i1++) {
+		desc.src[i1] = i1;
+	}
+	i1 = x_shuffleVec(pOut, pIn, &desc, nSamples);
+
+	switch (inBytes * 4 + outBytes) {
+		case 2 * 4 + 3: x_widthScalar(pOut, pIn, i1, nSamples, 2, 3); break;
+		case 2 * 4 + 4: x_widthScalar(pOut, pIn, i1, nSamples, 2, 4); break;
+		case 3 * 4 + 2: x_widthScalar(pOut, pIn, i1, nSamples, 3, 2); break;
+		case 3 * 4 + 4: x_widthScalar(pOut, pIn, i1, nSamples, 3, 4); break;
+		case 4 * 4 + 2: x_widthScalar(pOut, pIn, i1, nSamples, 4, 2); break;
+		default: x_widthScalar(pOut, pIn, i1, nSamples, 4, 3); break;
+	}
+}
+
+void openavbAudioConvSwap(U8 *pOut, const U8 *pIn, U32 sampleBytes, U32 nSamples)
+{
+	shuffle_desc_t desc = { sampleBytes, sampleBytes, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } };
+	U32 i1;
+
+	for (i1 = 0; i1 < sampleBytes; i1++) {
+		desc.src[i1] = sampleBytes - 1 - i1;
+	}
+	i1 = x_shuffleVec(pOut, pIn, &desc, nSamples);
+
+	switch (sampleBytes) {
+		case 2:
+			for ( ; i1 < nSamples; i1++) {
+				U16 u16;
+				memcpy(&u16, pIn + i1 * 2, 2);
+				u16 = __builtin_bswap16(u16);
+				memcpy(pOut + i1 * 2, &u16, 2);
+			}
+			break;
+		case 3:
+			for ( ; i1 < nSamples; i1++) {
+				U8 tmp = pIn[i1 * 3];
+				pOut[i1 * 3 + 1] = pIn[i1 * 3 + 1];
+				pOut[i1 * 3] = pIn[i1 * 3 + 2];
+				pOut[i1 * 3 + 2] = tmp;
+			}
+			break;
+		default:
+			for ( ; i1 < nSamples; i1++) {
+				U32 u32;
+				memcpy(&u32, pIn + i1 * 4, 4);
+				u32 = __builtin_bswap32(u32);
+				memcpy(pOut + i1 * 4, &u32, 4);
+			}
+			break;
+	}
+}
+
+void openavbAudioConvAM824Pack(U8 *pOut, const U8 *pIn, U32 inBytes, U32 nSamples, U32 label)
+{
+	shuffle_desc_t desc = { inBytes, 4, { SHUF_ZERO, SHUF_ZERO, SHUF_ZERO, SHUF_ZERO }, { (U8)(label >> 24), 0, 0, 0 } };
+	U32 i1;
+
+	// Quadlet is label | sample << (24 - 8 * inBytes), most significant byte first
+#if AUDIO_CONV_HOST_BE
+	desc.src[1] = 0;
+	desc.src[2] = 1;
+	if (inBytes == 3) {
+		desc.src[3] = 2;
+	}
+#else
+	desc.src[1] = inBytes - 1;
+	desc.src[2] = inBytes - 2;
+	if (inBytes == 3) {
+		desc.src[3] = 0;
+	}
+#endif
+	i1 = x_shuffleVec(pOut, pIn, &desc, nSamples);
+
+	if (inBytes == 2) {
+		x_am824PackScalar(pOut, pIn, i1, nSamples, label, 2);
+	}
+	else {
+		x_am824PackScalar(pOut, pIn, i1, nSamples, label, 3);
+	}
+}
+
+void openavbAudioConvAM824Unpack(U8 *pOut, U32 outBytes, const U8 *pIn, U32 nSamples)
+{
+	shuffle_desc_t desc = { 4, outBytes, { SHUF_ZERO, SHUF_ZERO, SHUF_ZERO, SHUF_ZERO }, { 0, 0, 0, 0 } };
+	U32 i1;
+
+	// Keep the top outBytes of the 24 bit sample following the label
+	for (i1 = 0; i1 < outBytes; i1++) {
+#if AUDIO_CONV_HOST_BE
+		desc.src[i1] = 1 + i1;
+#else
+		desc.src[i1] = outBytes - i1;
+#endif
+	}
+	i1 = x_shuffleVec(pOut, pIn, &desc, nSamples);
+
+	if (outBytes == 2) {
+		x_am824UnpackScalar(pOut, pIn, i1, nSamples, 2);
+	}
+	else {
+		x_am824UnpackScalar(pOut, pIn, i1, nSamples, 3);
+	}
+}
+
+void openavbAudioConvIntToFloat(float *pOut, const U8 *pIn, U32 inBytes, U32 nSamples)
+{
+	const float scale = 1.0f / (float)(1UL << (inBytes * 8 - 1));
+	U32 i1 = 0;
+
+#if AUDIO_CONV_SSE2
+	__m128 vScale = _mm_set1_ps(scale);
+	if (inBytes == 2) {
+		for ( ; i1 + 8 <= nSamples; i1 += 8) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(pIn + i1 * 2));
+			__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+			_mm_storeu_ps(pOut + i1, _mm_mul_ps(_mm_cvtepi32_ps(lo), vScale));
+			_mm_storeu_ps(pOut + i1 + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vScale));
+		}
+	}
+	else if (inBytes == 4) {
+		for ( ; i1 + 4 <= nSamples; i1 += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(pIn + i1 * 4));
+			_mm_storeu_ps(pOut + i1, _mm_mul_ps(_mm_cvtepi32_ps(v), vScale));
+		}
+	}
+#elif AUDIO_CONV_NEON
+	float32x4_t vScale = vdupq_n_f32(scale);
+	if (inBytes == 2) {
+		for ( ; i1 + 8 <= nSamples; i1 += 8) {
+			int16x8_t v = vreinterpretq_s16_u8(vld1q_u8(pIn + i1 * 2));
+			vst1q_f32(pOut + i1, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), vScale));
+			vst1q_f32(pOut + i1 + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), vScale));
+		}
+	}
+	else if (inBytes == 4) {
+		for ( ; i1 + 4 <= nSamples; i1 += 4) {
+			int32x4_t v = vreinterpretq_s32_u8(vld1q_u8(pIn + i1 * 4));
+			vst1q_f32(pOut + i1, vmulq_f32(vcvtq_f32_s32(v), vScale));
+		}
+	}
+#endif
+
+	for ( ; i1 < nSamples; i1++) {
+		pOut[i1] = (float)x_loadInt(pIn + i1 * inBytes, inBytes) * scale;
+	}
+}
+
+void openavbAudioConvFloatToInt(U8 *pOut, U32 outBytes, const float *pIn, U32 nSamples)
+{
+	const float scale = (float)(1UL << (outBytes * 8 - 1));
+	// Largest float that still converts below the positive limit. For 32 bit
+	// samples 2^31 - 1 is not representable, the next float down is 2^31 - 128.
+	const float maxVal = outBytes == 4 ? 2147483520.0f : scale - 1.0f;
+	const float minVal = -scale;
+	U32 i1 = 0;
+
+#if AUDIO_CONV_SSE2
+	__m128 vScale = _mm_set1_ps(scale);
+	__m128 vMax = _mm_set1_ps(maxVal);
+	__m128 vMin = _mm_set1_ps(minVal);
+	if (outBytes == 2) {
+		for ( ; i1 + 8 <= nSamples; i1 += 8) {
+			__m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(pIn + i1), vScale), vMin), vMax);
+			__m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(pIn + i1 + 4), vScale), vMin), vMax);
+			_mm_storeu_si128((__m128i *)(pOut + i1 * 2), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+		}
+	}
+	else if (outBytes == 4) {
+		for ( ; i1 + 4 <= nSamples; i1 += 4) {
+			__m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(pIn + i1), vScale), vMin), vMax);
+			_mm_storeu_si128((__m128i *)(pOut + i1 * 4), _mm_cvtps_epi32(a));
+		}
+	}
+#elif AUDIO_CONV_NEON
+	float32x4_t vScale = vdupq_n_f32(scale);
+	float32x4_t vMax = vdupq_n_f32(maxVal);
+	float32x4_t vMin = vdupq_n_f32(minVal);
+	if (outBytes == 2) {
+		for ( ; i1 + 8 <= nSamples; i1 += 8) {
+			float32x4_t a = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(pIn + i1), vScale), vMin), vMax);
+			float32x4_t b = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(pIn + i1 + 4), vScale), vMin), vMax);
+			int16x8_t v = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b)));
+			vst1q_u8(pOut + i1 * 2, vreinterpretq_u8_s16(v));
+		}
+	}
+	else if (outBytes == 4) {
+		for ( ; i1 + 4 <= nSamples; i1 += 4) {
+			float32x4_t a = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(pIn + i1), vScale), vMin), vMax);
+			vst1q_u8(pOut + i1 * 4, vreinterpretq_u8_s32(vcvtnq_s32_f32(a)));
+		}
+	}
+#endif
+
+	for ( ; i1 < nSamples; i1++) {
+		float value = pIn[i1] * scale;
+		if (value > maxVal) {
+			value = maxVal;
+		}
+		else if (!(value >= minVal)) {
+			// Also catches NaN
+			value = minVal;
+		}
+		x_storeInt(pOut + i1 * outBytes, outBytes, (S32)lrintf(value));
+	}
+}
+
+void openavbAudioConvInterleave(U8 *pOut, const U8 * const *ppIn, U32 sampleBytes, U32 channels, U32 nFrames)
+{
+	U32 i1, i2;
+
+	for (i1 = 0; i1 < nFrames; i1++) {
+		U32 offset = i1 * sampleBytes;
+		switch (sampleBytes) {
+			case 2:
+				for (i2 = 0; i2 < channels; i2++, pOut += 2) {
+					memcpy(pOut, ppIn[i2] + offset, 2);
+				}
+				break;
+			case 4:
+				for (i2 = 0; i2 < channels; i2++, pOut += 4) {
+					memcpy(pOut, ppIn[i2] + offset, 4);
+				}
+				break;
+			default:
+				for (i2 = 0; i2 < channels; i2++, pOut += sampleBytes) {
+					memcpy(pOut, ppIn[i2] + offset, sampleBytes);
+				}
+				break;
+		}
+	}
+}
+
+void openavbAudioConvDeinterleave(U8 * const *ppOut, const U8 *pIn, U32 sampleBytes, U32 channels, U32 nFrames)
+{
+	U32 i1, i2;
+
+	for (i1 = 0; i1 < nFrames; i1++) {
+		U32 offset = i1 * sampleBytes;
+		switch (sampleBytes) {
+			case 2:
+				for (i2 = 0; i2 < channels; i2++, pIn += 2) {
+					memcpy(ppOut[i2] + offset, pIn, 2);
+				}
+				break;
+			case 4:
+				for (i2 = 0; i2 < channels; i2++, pIn += 4) {
+					memcpy(ppOut[i2] + offset, pIn, 4);
+				}
+				break;
+			default:
+				for (i2 = 0; i2 < channels; i2++, pIn += sampleBytes) {
+					memcpy(ppOut[i2] + offset, pIn, sampleBytes);
+				}
+				break;
+		}
+	}
+}
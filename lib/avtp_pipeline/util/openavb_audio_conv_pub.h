@@ -0,0 +1,139 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* HEADER SUMMARY : Audio sample conversion public interface
+*/
+
+#ifndef OPENAVB_AUDIO_CONV_PUB_H
+#define OPENAVB_AUDIO_CONV_PUB_H 1
+
+#include "openavb_types_pub.h"
+
+/** \file
+ * Audio sample conversion public interface.
+ *
+ * Conversions shared by the audio mapping and interface modules: integer
+ * width changes of network order samples, byte order swaps, IEC 61883-6
+ * AM824 packing, integer to float conversion and channel interleaving.
+ *
+ * The byte rearranging conversions run on AVX2 or SSSE3 kernels picked at run
+ * time on x86, or NEON on AArch64. Float conversions use SSE2 or NEON. Scalar
+ * code covers everything else. The functions keep no state and are safe to call
+ * from any number of streams at once.
+ */
+
+/** Name of the kernel set compiled in.
+ *
+ * \return "avx2", "ssse3", "neon", "sse2" or "scalar".
+ */
+const char *openavbAudioConvKernelName(void);
+
+/** Change the width of big endian integer samples.
+ *
+ * Narrowing drops the least significant bytes, widening pads them with zero
+ * (IEEE 1722-2016 Clause 7.3.4).
+ *
+ * \param pOut Output samples.
+ * \param outBytes Output sample size: 2, 3 or 4.
+ * \param pIn Input samples. May equal pOut only when inBytes == outBytes.
+ * \param inBytes Input sample size: 2, 3 or 4.
+ * \param nSamples Number of samples.
+ */
+void openavbAudioConvWidthBE(U8 *pOut, U32 outBytes, const U8 *pIn, U32 inBytes, U32 nSamples);
+
+/** Reverse the byte order of each sample.
+ *
+ * \param pOut Output samples. May equal pIn.
+ * \param pIn Input samples.
+ * \param sampleBytes Sample size: 2, 3 or 4.
+ * \param nSamples Number of samples.
+ */
+void openavbAudioConvSwap(U8 *pOut, const U8 *pIn, U32 sampleBytes, U32 nSamples);
+
+/** Pack host order samples into network order AM824 quadlets.
+ *
+ * \param pOut Output quadlets, 4 bytes per sample.
+ * \param pIn Input samples.
+ * \param inBytes Input sample size: 2 or 3.
+ * \param nSamples Number of samples.
+ * \param label AM824 label, already shifted into the top byte.
+ */
+void openavbAudioConvAM824Pack(U8 *pOut, const U8 *pIn, U32 inBytes, U32 nSamples, U32 label);
+
+/** Unpack network order AM824 quadlets into host order samples.
+ *
+ * \param pOut Output samples.
+ * \param outBytes Output sample size: 2 or 3. 2 keeps the top 16 of the 24 bits.
+ * \param pIn Input quadlets.
+ * \param nSamples Number of samples.
+ */
+void openavbAudioConvAM824Unpack(U8 *pOut, U32 outBytes, const U8 *pIn, U32 nSamples);
+
+/** Convert host order integer samples to float in [-1.0, 1.0).
+ *
+ * \param pOut Output samples.
+ * \param pIn Input samples.
+ * \param inBytes Input sample size: 2, 3 or 4.
+ * \param nSamples Number of samples.
+ */
+void openavbAudioConvIntToFloat(float *pOut, const U8 *pIn, U32 inBytes, U32 nSamples);
+
+/** Convert float samples to host order integers, saturating out of range values.
+ *
+ * \param pOut Output samples.
+ * \param outBytes Output sample size: 2, 3 or 4.
+ * \param pIn Input samples.
+ * \param nSamples Number of samples.
+ */
+void openavbAudioConvFloatToInt(U8 *pOut, U32 outBytes, const float *pIn, U32 nSamples);
+
+/** Interleave separate channel buffers into frames.
+ *
+ * \param pOut Output frames.
+ * \param ppIn One input buffer per channel.
+ * \param sampleBytes Sample size in bytes.
+ * \param channels Number of channels.
+ * \param nFrames Number of frames.
+ */
+void openavbAudioConvInterleave(U8 *pOut, const U8 * const *ppIn, U32 sampleBytes, U32 channels, U32 nFrames);
+
+/** Split frames into separate channel buffers.
+ *
+ * \param ppOut One output buffer per channel.
+ * \param pIn Input frames.
+ * \param sampleBytes Sample size in bytes.
+ * \param channels Number of channels.
+ * \param nFrames Number of frames.
+ */
+void openavbAudioConvDeinterleave(U8 * const *ppOut, const U8 *pIn, U32 sampleBytes, U32 channels, U32 nFrames);
+
+#endif // OPENAVB_AUDIO_CONV_PUB_H
@@ -0,0 +1,276 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+
+/*
+* MODULE SUMMARY : Memory mapped file source with kernel read ahead, used by the file talker interfaces.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "openavb_platform.h"
+#include "openavb_types_pub.h"
+#include "openavb_trace_pub.h"
+#include "openavb_file_src_pub.h"
+#include "openavb_mediaq_pub.h"
+
+#define	AVB_LOG_COMPONENT	"File Source"
+#include "openavb_log_pub.h"
+
+struct openavb_file_src {
+	U8 *pMap;
+	size_t mapLen;
+
+	// Held by the opener and by each media queue item attached to the mapping
+	U32 refCount;
+
+	// Data region, dataOffset bytes into the mapping
+	const U8 *pData;
+	U64 dataOffset;
+	U64 dataLen;
+
+	// Read position in the data region
+	U64 pos;
+
+	// Read ahead has been requested up to this data offset
+	U64 raEnd;
+	U32 raBytes;
+
+	// Loop mode: the start of the data was read ahead for the next pass
+	bool loop;
+	bool raWrapped;
+
+	size_t pageMask;
+};
+
+// Ask the kernel to start reading [from, from + len) of the data region into the page cache.
+static void x_readAhead(openavb_file_src_t *pSrc, U64 from, U64 len)
+{
+	size_t start = (size_t)(pSrc->dataOffset + from);
+	size_t alignedStart = start & ~pSrc->pageMask;
+	if (madvise(pSrc->pMap + alignedStart, (size_t)len + (start - alignedStart), MADV_WILLNEED) != 0) {
+		IF_LOG_INTERVAL(1000) AVB_LOGF_DEBUG("madvise(MADV_WILLNEED) failed: %s", strerror(errno));
+	}
+}
+
+// Keep the read ahead window in front of the read position. A new window is requested once
+// half of the previous one has been consumed.
+static void x_updateReadAhead(openavb_file_src_t *pSrc)
+{
+	if (pSrc->raEnd < pSrc->dataLen && pSrc->pos + pSrc->raBytes / 2 >= pSrc->raEnd) {
+		U64 len = pSrc->dataLen - pSrc->raEnd;
+		if (len > pSrc->raBytes)
+			len = pSrc->raBytes;
+		x_readAhead(pSrc, pSrc->raEnd, len);
+		pSrc->raEnd += len;
+	}
+
+	if (pSrc->loop && !pSrc->raWrapped && pSrc->raEnd >= pSrc->dataLen
+		&& pSrc->pos + pSrc->raBytes / 2 >= pSrc->dataLen) {
+		U64 len = pSrc->dataLen < pSrc->raBytes ? pSrc->dataLen : pSrc->raBytes;
+		x_readAhead(pSrc, 0, len);
+		pSrc->raWrapped = TRUE;
+	}
+}
+
+openavb_file_src_t *openavbFileSrcOpen(const char *pFileName, U64 dataOffset, U32 readAheadBytes, bool loop)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_INTF);
+
+	if (!pFileName) {
+		AVB_TRACE_EXIT(AVB_TRACE_INTF);
+		return NULL;
+	}
+
+	int fd = open(pFileName, O_RDONLY);
+	if (fd < 0) {
+		AVB_LOGF_ERROR("Unable to open input file: %s, %s", pFileName, strerror(errno));
+		AVB_TRACE_EXIT(AVB_TRACE_INTF);
+		return NULL;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		AVB_LOGF_INFO("Not mapping %s: not a regular file", pFileName);
+		close(fd);
+		AVB_TRACE_EXIT(AVB_TRACE_INTF);
+		return NULL;
+	}
+	if ((U64)st.st_size <= dataOffset || (U64)st.st_size > SIZE_MAX) {
+		AVB_LOGF_INFO("Not mapping %s: size %lld not supported", pFileName, (long long)st.st_size);
+		close(fd);
+		AVB_TRACE_EXIT(AVB_TRACE_INTF);
+		return NULL;
+	}
+
+	U8 *pMap = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file
+	close(fd);
+	if (pMap == MAP_FAILED) {
+		AVB_LOGF_INFO("Not mapping %s: %s", pFileName, strerror(errno));
+		AVB_TRACE_EXIT(AVB_TRACE_INTF);
+		return NULL;
+	}
+
+	openavb_file_src_t *pSrc = calloc(1, sizeof(openavb_file_src_t));
+	if (!pSrc) {
+		munmap(pMap, (size_t)st.st_size);
+		AVB_TRACE_EXIT(AVB_TRACE_INTF);
+		return NULL;
+	}
+
+	pSrc->pMap = pMap;
+	pSrc->mapLen = (size_t)st.st_size;
+	pSrc->refCount = 1;
+	pSrc->dataOffset = dataOffset;
+	pSrc->pData = pMap + dataOffset;
+	pSrc->dataLen = (U64)st.st_size - dataOffset;
+	pSrc->raBytes = readAheadBytes ? readAheadBytes : OPENAVB_FILE_SRC_READ_AHEAD_DEFAULT;
+	pSrc->loop = loop;
+	pSrc->pageMask = (size_t)sysconf(_SC_PAGESIZE) - 1;
+
+	// Larger kernel read ahead, and pages behind the read position are reclaimed first
+	madvise(pSrc->pMap, pSrc->mapLen, MADV_SEQUENTIAL);
+	x_updateReadAhead(pSrc);
+
+	AVB_LOGF_INFO("Mapped %s: %llu data bytes, %u bytes read ahead", pFileName, (unsigned long long)pSrc->dataLen, pSrc->raBytes);
+
+	AVB_TRACE_EXIT(AVB_TRACE_INTF);
+	return pSrc;
+}
+
+void openavbFileSrcClose(openavb_file_src_t *pSrc)
+{
+	openavbFileSrcRelease(pSrc);
+}
+
+void openavbFileSrcRetain(openavb_file_src_t *pSrc)
+{
+	if (pSrc) {
+		ATOMIC_FETCH_ADD_ACQ_REL(&pSrc->refCount, 1);
+	}
+}
+
+void openavbFileSrcRelease(void *pRef)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_INTF);
+
+	openavb_file_src_t *pSrc = (openavb_file_src_t *)pRef;
+	if (pSrc && ATOMIC_FETCH_ADD_ACQ_REL(&pSrc->refCount, (U32)-1) == 1) {
+		munmap(pSrc->pMap, pSrc->mapLen);
+		free(pSrc);
+	}
+
+	AVB_TRACE_EXIT(AVB_TRACE_INTF);
+}
+
+bool openavbFileSrcAttach(openavb_file_src_t *pSrc, media_q_item_t *pItem, const U8 *pData, U32 dataLen)
+{
+	openavbFileSrcRetain(pSrc);
+	if (!openavbMediaQItemSetExternal(pItem, (void *)pData, dataLen, openavbFileSrcRelease, pSrc)) {
+		openavbFileSrcRelease(pSrc);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+const U8 *openavbFileSrcData(openavb_file_src_t *pSrc, U64 *pDataLen)
+{
+	if (!pSrc) {
+		if (pDataLen)
+			*pDataLen = 0;
+		return NULL;
+	}
+	if (pDataLen)
+		*pDataLen = pSrc->dataLen;
+	return pSrc->pData;
+}
+
+U32 openavbFileSrcPeek(openavb_file_src_t *pSrc, const U8 **ppData, U32 maxLen)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_INTF_DETAIL);
+
+	U64 avail = pSrc->dataLen - pSrc->pos;
+	if (avail > maxLen)
+		avail = maxLen;
+	*ppData = pSrc->pData + pSrc->pos;
+
+	AVB_TRACE_EXIT(AVB_TRACE_INTF_DETAIL);
+	return (U32)avail;
+}
+
+void openavbFileSrcAdvance(openavb_file_src_t *pSrc, U32 len)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_INTF_DETAIL);
+
+	pSrc->pos += len;
+	if (pSrc->pos > pSrc->dataLen)
+		pSrc->pos = pSrc->dataLen;
+	x_updateReadAhead(pSrc);
+
+	AVB_TRACE_EXIT(AVB_TRACE_INTF_DETAIL);
+}
+
+U32 openavbFileSrcRead(openavb_file_src_t *pSrc, void *pDest, U32 len)
+{
+	const U8 *pData;
+	U32 avail = openavbFileSrcPeek(pSrc, &pData, len);
+	memcpy(pDest, pData, avail);
+	openavbFileSrcAdvance(pSrc, avail);
+	return avail;
+}
+
+bool openavbFileSrcAtEnd(openavb_file_src_t *pSrc)
+{
+	return pSrc->pos >= pSrc->dataLen;
+}
+
+void openavbFileSrcRewind(openavb_file_src_t *pSrc)
+{
+	AVB_TRACE_ENTRY(AVB_TRACE_INTF);
+
+	pSrc->pos = 0;
+	if (pSrc->raWrapped)
+		pSrc->raEnd = pSrc->dataLen < pSrc->raBytes ? pSrc->dataLen : pSrc->raBytes;
+	else
+		pSrc->raEnd = 0;
+	pSrc->raWrapped = FALSE;
+	x_updateReadAhead(pSrc);
+
+	AVB_TRACE_EXIT(AVB_TRACE_INTF);
+}
@@ -0,0 +1,135 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Attributions: The inih library portion of the source code is licensed from
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt.
+Complete license and copyright information can be found at
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+
+/*
+* HEADER SUMMARY : Memory mapped file source public interface
+*/
+
+#ifndef OPENAVB_FILE_SRC_PUB_H
+#define OPENAVB_FILE_SRC_PUB_H 1
+
+#include "openavb_types_pub.h"
+#include "openavb_mediaq_pub.h"
+
+/** \file
+ * Memory mapped file source public interface.
+ *
+ * Gives talker interface modules read access to a file without calling
+ * read() on the talker thread. The file is mapped read only and the kernel is
+ * asked to read ahead a window in front of the read position, wrapping around
+ * to the start of the data when the source loops, so a page cache miss is
+ * normally served before the talker gets there. The mapped bytes may be
+ * attached to media queue items with openavbFileSrcAttach() and
+ * packetized by the mapping module without a copy.
+ *
+ * A source is used by one thread at a time.
+ */
+
+/** Default number of bytes read ahead of the read position. */
+#define OPENAVB_FILE_SRC_READ_AHEAD_DEFAULT		(4 * 1024 * 1024)
+
+typedef struct openavb_file_src openavb_file_src_t;
+
+/** Map a file.
+ *
+ * Fails for files that cannot be mapped, such as pipes, empty files or files
+ * larger than the address space. Callers fall back to stdio in that case.
+ *
+ * \param pFileName File to map.
+ * \param dataOffset Offset of the first data byte, e.g. past a file header.
+ * \param readAheadBytes Size of the read ahead window. 0 selects the default.
+ * \param loop TRUE if the source will be rewound at the end of the data, so the
+ *        start of the data is read ahead as the end gets near.
+ * \return The source or NULL on failure.
+ */
+openavb_file_src_t *openavbFileSrcOpen(const char *pFileName, U64 dataOffset, U32 readAheadBytes, bool loop);
+
+/** Release the source.
+ *
+ * The file is unmapped and the source freed once no media queue item attached
+ * with openavbFileSrcAttach() references it any more.
+ */
+void openavbFileSrcClose(openavb_file_src_t *pSrc);
+
+/** Take a reference on the mapping, released with openavbFileSrcRelease(). */
+void openavbFileSrcRetain(openavb_file_src_t *pSrc);
+
+/** Drop a reference on the mapping. Has the signature of a media queue item release callback. */
+void openavbFileSrcRelease(void *pRef);
+
+/** Attach mapped bytes to a head media queue item without copying them.
+ *
+ * Like openavbMediaQItemSetExternal(), with the item holding a reference on the
+ * mapping until the media queue releases it, so queued items stay valid after
+ * openavbFileSrcClose().
+ *
+ * \param pSrc The source.
+ * \param pItem A head item locked with openavbMediaQHeadLock.
+ * \param pData Bytes returned by openavbFileSrcPeek() or openavbFileSrcData().
+ * \param dataLen Number of bytes.
+ * \return TRUE on success.
+ */
+bool openavbFileSrcAttach(openavb_file_src_t *pSrc, media_q_item_t *pItem, const U8 *pData, U32 dataLen);
+
+/** The whole mapped data region, starting at dataOffset.
+ *
+ * \param pSrc The source.
+ * \param pDataLen Set to the length of the region.
+ * \return Start of the region. Valid until openavbFileSrcClose().
+ */
+const U8 *openavbFileSrcData(openavb_file_src_t *pSrc, U64 *pDataLen);
+
+/** Bytes at the read position without consuming them.
+ *
+ * \param pSrc The source.
+ * \param ppData Set to the read position in the mapped region.
+ * \param maxLen Most bytes wanted.
+ * \return Number of contiguous bytes available, at most maxLen. 0 at the end of the data.
+ */
+U32 openavbFileSrcPeek(openavb_file_src_t *pSrc, const U8 **ppData, U32 maxLen);
+
+/** Consume bytes returned by openavbFileSrcPeek(). */
+void openavbFileSrcAdvance(openavb_file_src_t *pSrc, U32 len);
+
+/** Copy up to len bytes from the read position and consume them.
+ *
+ * \return Number of bytes copied. Less than len only at the end of the data.
+ */
+U32 openavbFileSrcRead(openavb_file_src_t *pSrc, void *pDest, U32 len);
+
+/** TRUE once all data has been consumed. */
+bool openavbFileSrcAtEnd(openavb_file_src_t *pSrc);
+
+/** Move the read position back to the start of the data. */
+void openavbFileSrcRewind(openavb_file_src_t *pSrc);
+
+#endif // OPENAVB_FILE_SRC_PUB_H
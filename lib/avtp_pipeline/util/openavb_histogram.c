@@ -0,0 +1,129 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Implementation of log-linear histograms used to gather latency percentiles.
+*
+* Values below 2 * OPENAVB_HISTOGRAM_HALF_COUNT get a bucket each. Above that every
+* power of two range is split into OPENAVB_HISTOGRAM_HALF_COUNT equal buckets, so the
+* whole U64 range fits in a few kilobytes with a bounded relative error.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "openavb_platform.h"
+#include "openavb_histogram.h"
+
+static inline U32 bucketIndex(U64 value)
+{
+	if (value < 2 * OPENAVB_HISTOGRAM_HALF_COUNT)
+		return value;
+
+	U32 shift = (63 - __builtin_clzll(value)) - OPENAVB_HISTOGRAM_SUB_BITS + 1;
+	return shift * OPENAVB_HISTOGRAM_HALF_COUNT + (U32)(value >> shift);
+}
+
+// Largest value that lands in the bucket
+static inline U64 bucketHighest(U32 idx)
+{
+	if (idx < 2 * OPENAVB_HISTOGRAM_HALF_COUNT)
+		return idx;
+
+	U32 shift = idx / OPENAVB_HISTOGRAM_HALF_COUNT - 1;
+	U64 sub = idx - shift * OPENAVB_HISTOGRAM_HALF_COUNT;
+	return ((sub + 1) << shift) - 1;
+}
+
+openavb_histogram_t openavbHistogramNew(void)
+{
+	return calloc(1, sizeof(struct openavb_histogram));
+}
+
+void openavbHistogramDelete(openavb_histogram_t pHist)
+{
+	free(pHist);
+}
+
+void openavbHistogramRecord(openavb_histogram_t pHist, U64 value)
+{
+	U64 *pBucket = &pHist->buckets[bucketIndex(value)];
+
+	// Single writer, so plain read-modify-write is enough. The stores are atomic
+	// so readers on other threads never see torn counters.
+	ATOMIC_STORE_RELAXED(pBucket, *pBucket + 1);
+	if (value > pHist->max)
+		ATOMIC_STORE_RELAXED(&pHist->max, value);
+	ATOMIC_STORE_RELAXED(&pHist->count, pHist->count + 1);
+}
+
+void openavbHistogramReset(openavb_histogram_t pHist)
+{
+	memset(pHist, 0, sizeof(*pHist));
+}
+
+U64 openavbHistogramCount(openavb_histogram_t pHist)
+{
+	return ATOMIC_LOAD_RELAXED(&pHist->count);
+}
+
+U64 openavbHistogramMax(openavb_histogram_t pHist)
+{
+	return ATOMIC_LOAD_RELAXED(&pHist->max);
+}
+
+U64 openavbHistogramPercentile(openavb_histogram_t pHist, double percentile)
+{
+	U64 count = ATOMIC_LOAD_RELAXED(&pHist->count);
+	U64 max = ATOMIC_LOAD_RELAXED(&pHist->max);
+	if (count == 0)
+		return 0;
+	if (percentile >= 100.0)
+		return max;
+
+	// Rank of the value looked for, counting from 1
+	U64 rank = (U64)(percentile * count / 100.0 + 0.5);
+	if (rank < 1)
+		rank = 1;
+
+	U64 seen = 0;
+	U32 idx;
+	for (idx = 0; idx < OPENAVB_HISTOGRAM_BUCKETS; idx++) {
+		seen += ATOMIC_LOAD_RELAXED(&pHist->buckets[idx]);
+		if (seen >= rank) {
+			U64 value = bucketHighest(idx);
+			return value < max ? value : max;
+		}
+	}
+
+	// Only reached when records landed between reading count and the buckets
+	return max;
+}
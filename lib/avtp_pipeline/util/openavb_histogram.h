@@ -0,0 +1,80 @@
+/*************************************************************************************************************
+Copyright (c) 2012-2015, Symphony Teleca Corporation, a Harman International Industries, Incorporated company
+Copyright (c) 2016-2017, Harman International Industries, Incorporated
+All rights reserved.
+ 
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ 
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS LISTED "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS LISTED BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+Attributions: The inih library portion of the source code is licensed from 
+Brush Technology and Ben Hoyt - Copyright (c) 2009, Brush Technology and Copyright (c) 2009, Ben Hoyt. 
+Complete license and copyright information can be found at 
+https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
+*************************************************************************************************************/
+
+/*
+* MODULE SUMMARY : Header for log-linear histograms used to gather latency percentiles.
+*/
+
+#ifndef OPENAVB_HISTOGRAM_H
+#define OPENAVB_HISTOGRAM_H 1
+
+#include "openavb_types.h"
+
+// Values are kept with OPENAVB_HISTOGRAM_SUB_BITS significant bits, so a
+// reported percentile is within 1/16 (about 6%) of the recorded value.
+#define OPENAVB_HISTOGRAM_SUB_BITS		5
+#define OPENAVB_HISTOGRAM_HALF_COUNT	(1 << (OPENAVB_HISTOGRAM_SUB_BITS - 1))
+#define OPENAVB_HISTOGRAM_BUCKETS		((64 - OPENAVB_HISTOGRAM_SUB_BITS + 2) * OPENAVB_HISTOGRAM_HALF_COUNT)
+
+// Plain data without pointers, so histograms can be placed in shared memory and
+// read by other processes. A zero filled histogram is empty.
+struct openavb_histogram {
+	U64 count;
+	U64 max;
+	U64 buckets[OPENAVB_HISTOGRAM_BUCKETS];
+};
+
+typedef struct openavb_histogram * openavb_histogram_t;
+
+// Create an empty histogram.
+openavb_histogram_t openavbHistogramNew(void);
+
+// Delete a histogram.
+void openavbHistogramDelete(openavb_histogram_t pHist);
+
+// Record one value. Must only be called from a single thread, while any
+// thread may read the histogram at the same time.
+void openavbHistogramRecord(openavb_histogram_t pHist, U64 value);
+
+// Forget all recorded values. Must not race with openavbHistogramRecord().
+void openavbHistogramReset(openavb_histogram_t pHist);
+
+// Number of values recorded.
+U64 openavbHistogramCount(openavb_histogram_t pHist);
+
+// Largest value recorded.
+U64 openavbHistogramMax(openavb_histogram_t pHist);
+
+// Value below which the given percentage (0.0 to 100.0) of the recorded values fall.
+// Returns 0 for an empty histogram.
+U64 openavbHistogramPercentile(openavb_histogram_t pHist, double percentile);
+
+#endif // OPENAVB_HISTOGRAM_H
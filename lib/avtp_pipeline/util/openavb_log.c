@@ -34,6 +34,9 @@ https://github.com/benhoyt/inih/commit/74d2ca064fb293bc60a77b0bd068075b293cf175.
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "openavb_queue.h"
 #include "openavb_tcal_pub.h"
 
@@ -60,20 +63,120 @@ typedef struct {
 	bool bEnd;
 } log_rt_queue_item_t;
 
+// Per thread log ring (OPENAVB_LOG_RING).
+// Each ring has a single producer (the thread that owns it) and a single consumer (the logging thread).
+// The head and tail are byte offsets that run freely and wrap at 2^32; LOG_RING_SIZE must be a power of 2.
+// A ring is owned by one thread at a time. When its thread exits the ring is released and can be claimed
+// by the next thread that logs, so rings are never freed while the logging thread may be reading them.
+typedef struct log_ring {
+	// Next ring in the list of all rings. Rings are only ever added to the front of the list.
+	struct log_ring *pNext;
+
+	// TRUE while a thread owns this ring.
+	U32 inUse;
+
+	// Thread that currently owns the ring, used in the drop reports.
+	unsigned long threadId;
+
+	// Drop count already reported. Consumer only.
+	U32 droppedReported;
+
+	// Consumer end of the records to process in the current logging thread pass.
+	U32 passHead;
+
+	U8 pad0[CACHE_LINE_SIZE];
+
+	// Offset of the next record to be written. Written only by the producer.
+	U32 head;
+
+	// Producer copy of tail. Refreshed only when the ring looks full.
+	U32 tailCache;
+
+	// Number of records dropped because the ring was full. Written only by the producer.
+	U32 dropped;
+
+	U8 pad1[CACHE_LINE_SIZE];
+
+	// Offset of the next record to be read. Written only by the consumer.
+	U32 tail;
+
+	U8 pad2[CACHE_LINE_SIZE];
+
+	U64 data[LOG_RING_SIZE / sizeof(U64)];
+} log_ring_t;
+
+// Header of each record in a ring. The header is followed by copies of the format, tag, company, component
+// and file name strings, then by one 8 byte slot per argument (including '*' width and precision arguments).
+// A string argument slot holds the string length, and is followed by the string itself (NUL terminated and
+// padded to 8 bytes). Nothing in a record points outside of it, so records stay valid after the interface or
+// mapper module that logged them has been unloaded.
+typedef struct {
+	U32 size;						// Record size in bytes, including the header (a multiple of 8)
+	U32 bPad;						// TRUE if this record only fills the space up to the end of the ring
+	U16 formatOffset;				// Offsets of the string copies within the record, 0 for a NULL string
+	U16 tagOffset;
+	U16 companyOffset;
+	U16 componentOffset;
+	U16 fileOffset;
+	U16 argsOffset;					// Offset of the first argument slot
+	int line;
+	unsigned long threadId;
+	struct timespec nowTS;
+} log_ring_rec_t;
+
+typedef union {
+	U64 u;
+	double d;
+} log_ring_arg_t;
+
+#define LOG_RING_ALIGN(x)		(((x) + 7) & ~7)
+#define LOG_RING_HDR_SIZE		LOG_RING_ALIGN(sizeof(log_ring_rec_t))
+#define LOG_RING_STR_NULL		0xFFFFFFFF		// String slot value for a NULL pointer
+#define LOG_RING_FMT_MAX		512				// Longest format string that is recorded
+#define LOG_RING_NAME_MAX		64				// Tag, company, component and file names are truncated to this
+#define LOG_RING_REC_STR(pRec, offset)	((offset) ? (const char *)(pRec) + (offset) : NULL)
+#define LOG_CONV_SPEC_LEN		32				// Longest conversion specification that is recorded
+
+// Argument type of a printf conversion specification
+typedef enum {
+	LOG_ARG_INT,
+	LOG_ARG_LONG,
+	LOG_ARG_LLONG,
+	LOG_ARG_INTMAX,
+	LOG_ARG_SIZE,
+	LOG_ARG_PTRDIFF,
+	LOG_ARG_DOUBLE,
+	LOG_ARG_PTR,
+	LOG_ARG_STR,
+	LOG_ARG_UNSUPPORTED
+} log_arg_type_t;
+
+typedef struct {
+	const char *pStart;				// The '%' starting the specification
+	int len;						// Length of the specification
+	int starCnt;					// Number of '*' width and precision arguments
+	bool bStarPrecision;			// TRUE if the precision is a '*' argument
+	int precision;					// Precision given in the format, or -1
+	log_arg_type_t type;
+} log_conv_t;
+
 static openavb_queue_t logQueue;
 static openavb_queue_t logRTQueue;
 static FILE *logOutputFd = NULL;
 
 static char msg[LOG_MSG_LEN] = "";
-static char time_msg[LOG_TIME_LEN] = "";
-static char timestamp_msg[LOG_TIMESTAMP_LEN] = "";
-static char file_msg[LOG_FILE_LEN] = "";
-static char proc_msg[LOG_PROC_LEN] = "";
-static char thread_msg[LOG_THREAD_LEN] = "";
 static char full_msg[LOG_FULL_MSG_LEN] = "";
 
 static char rt_msg[LOG_RT_MSG_LEN] = "";
 
+// Used only by the logging thread to render ring records.
+static char ring_msg[LOG_MSG_LEN] = "";
+static char ring_full_msg[LOG_FULL_MSG_LEN] = "";
+
+static log_ring_t *logRingList = NULL;
+static bool logRingOn = FALSE;
+static THREAD_KEY(logRingKey);
+
 static bool loggingThreadRunning = false;
 extern void *loggingThreadFn(void *pv);
 THREAD_TYPE(loggingThread);
@@ -83,6 +186,502 @@ static MUTEX_HANDLE_ALT(gLogMutex);
 #define LOG_LOCK() MUTEX_LOCK_ALT(gLogMutex)
 #define LOG_UNLOCK() MUTEX_UNLOCK_ALT(gLogMutex)
 
+// Builds the full log line with the configured prefix information.
+static void x_logFormatFull(char *pFullMsg, const char *pMsg, const struct timespec *pNowTS, unsigned long threadId,
+	const char *tag, const char *company, const char *component, const char *path, int line)
+{
+	char time_msg[LOG_TIME_LEN] = "";
+	char timestamp_msg[LOG_TIMESTAMP_LEN] = "";
+	char file_msg[LOG_FILE_LEN] = "";
+	char proc_msg[LOG_PROC_LEN] = "";
+	char thread_msg[LOG_THREAD_LEN] = "";
+
+	if (OPENAVB_LOG_FILE_INFO && path) {
+		char* file = strrchr(path, '/');
+		if (!file)
+			file = strrchr(path, '\\');
+		if (file)
+			file += 1;
+		else
+			file = (char*)path;
+		snprintf(file_msg, LOG_FILE_LEN, " %s:%d", file, line);
+	}
+	if (OPENAVB_LOG_PROC_INFO) {
+		snprintf(proc_msg, LOG_PROC_LEN, " P:%5.5d", GET_PID());
+	}
+	if (OPENAVB_LOG_THREAD_INFO) {
+		snprintf(thread_msg, LOG_THREAD_LEN, " T:%lu", threadId);
+	}
+	if (OPENAVB_LOG_TIME_INFO) {
+		time_t tNow = pNowTS->tv_sec;
+		struct tm tmNow;
+		localtime_r(&tNow, &tmNow);
+
+		snprintf(time_msg, LOG_TIME_LEN, "%2.2d:%2.2d:%2.2d", tmNow.tm_hour, tmNow.tm_min, tmNow.tm_sec);
+	}
+	if (OPENAVB_LOG_TIMESTAMP_INFO) {
+		snprintf(timestamp_msg, LOG_TIMESTAMP_LEN, "%lu:%09lu", pNowTS->tv_sec, pNowTS->tv_nsec);
+	}
+
+	// using sprintf and puts allows using static buffers rather than heap.
+	if (OPENAVB_TCAL_LOG_EXTRA_NEWLINE)
+		/* S32 full_msg_len = */ snprintf(pFullMsg, LOG_FULL_MSG_LEN, "[%s%s%s%s %s %s%s] %s: %s\n", time_msg, timestamp_msg, proc_msg, thread_msg, company, component, file_msg, tag, pMsg);
+	else
+		/* S32 full_msg_len = */ snprintf(pFullMsg, LOG_FULL_MSG_LEN, "[%s%s%s%s %s %s%s] %s: %s", time_msg, timestamp_msg, proc_msg, thread_msg, company, component, file_msg, tag, pMsg);
+}
+
+// Finds the next conversion specification in a printf format.
+// Returns a pointer to the character following it, or NULL if there are no more.
+static const char *x_logNextConv(const char *pFmt, log_conv_t *pConv)
+{
+	while (*pFmt) {
+		if (*pFmt != '%') {
+			pFmt++;
+			continue;
+		}
+		if (pFmt[1] == '%') {
+			pFmt += 2;
+			continue;
+		}
+
+		const char *p = pFmt + 1;
+		char lenMod = 0;
+		pConv->pStart = pFmt;
+		pConv->starCnt = 0;
+		pConv->bStarPrecision = FALSE;
+		pConv->precision = -1;
+
+		while (*p && strchr("-+ #0'", *p))
+			p++;
+		if (*p == '*') {
+			pConv->starCnt++;
+			p++;
+		}
+		else {
+			while (*p >= '0' && *p <= '9')
+				p++;
+		}
+		if (*p == '.') {
+			p++;
+			if (*p == '*') {
+				pConv->starCnt++;
+				pConv->bStarPrecision = TRUE;
+				p++;
+			}
+			else {
+				pConv->precision = 0;
+				while (*p >= '0' && *p <= '9')
+					pConv->precision = pConv->precision * 10 + (*p++ - '0');
+			}
+		}
+		switch (*p) {
+			case 'h':
+				lenMod = *p++;
+				if (*p == 'h')
+					p++;
+				break;
+			case 'l':
+				lenMod = *p++;
+				if (*p == 'l') {
+					lenMod = 'q';
+					p++;
+				}
+				break;
+			case 'q': case 'j': case 'z': case 't': case 'L':
+				lenMod = *p++;
+				break;
+			default:
+				break;
+		}
+
+		switch (*p) {
+			case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+				switch (lenMod) {
+					case 'l': pConv->type = LOG_ARG_LONG; break;
+					case 'q': pConv->type = LOG_ARG_LLONG; break;
+					case 'j': pConv->type = LOG_ARG_INTMAX; break;
+					case 'z': pConv->type = LOG_ARG_SIZE; break;
+					case 't': pConv->type = LOG_ARG_PTRDIFF; break;
+					case 'L': pConv->type = LOG_ARG_UNSUPPORTED; break;
+					default: pConv->type = LOG_ARG_INT; break;
+				}
+				if (*p == 'c' && lenMod)
+					pConv->type = LOG_ARG_UNSUPPORTED;
+				break;
+			case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+				pConv->type = (lenMod == 'L') ? LOG_ARG_UNSUPPORTED : LOG_ARG_DOUBLE;
+				break;
+			case 's':
+				pConv->type = lenMod ? LOG_ARG_UNSUPPORTED : LOG_ARG_STR;
+				break;
+			case 'p':
+				pConv->type = LOG_ARG_PTR;
+				break;
+			default:
+				pConv->type = LOG_ARG_UNSUPPORTED;
+				break;
+		}
+		if (*p)
+			p++;
+
+		pConv->len = p - pFmt;
+		if (pConv->len >= LOG_CONV_SPEC_LEN)
+			pConv->type = LOG_ARG_UNSUPPORTED;
+		return p;
+	}
+	return NULL;
+}
+
+// Copies up to maxLen characters of a string into the record at *pOffset and advances *pOffset.
+// Returns the offset of the copy, or 0 for a NULL string.
+static U16 x_logRingPutStr(log_ring_rec_t *pRec, U32 *pOffset, const char *pStr, size_t maxLen)
+{
+	U8 *pOut = (U8 *)pRec + *pOffset;
+	U16 offset = *pOffset;
+	size_t len = 0;
+
+	if (!pStr)
+		return 0;
+	while (len < maxLen && pStr[len])
+		len++;
+	memcpy(pOut, pStr, len);
+	pOut[len] = 0x00;
+	*pOffset += LOG_RING_ALIGN(len + 1);
+	return offset;
+}
+
+// Encodes the arguments of a log message into the record, starting at pRec->argsOffset.
+// Returns the size of the record, or 0 if the message cannot be recorded.
+static U32 x_logRingEncode(log_ring_rec_t *pRec, const char *fmt, va_list args)
+{
+	U8 *pOut = (U8 *)pRec + pRec->argsOffset;
+	U8 *pEnd = (U8 *)pRec + LOG_RING_REC_MAX;
+	const char *p = fmt;
+	log_conv_t conv;
+
+	while ((p = x_logNextConv(p, &conv)) != NULL) {
+		int precision = conv.precision;
+		int i;
+
+		if (conv.type == LOG_ARG_UNSUPPORTED || pOut + (conv.starCnt + 1) * sizeof(log_ring_arg_t) > pEnd)
+			return 0;
+
+		for (i = 0; i < conv.starCnt; i++) {
+			int star = va_arg(args, int);
+			((log_ring_arg_t *)pOut)->u = (U64)(S64)star;
+			pOut += sizeof(log_ring_arg_t);
+			if (conv.bStarPrecision)
+				precision = star;
+		}
+
+		log_ring_arg_t *pArg = (log_ring_arg_t *)pOut;
+		pOut += sizeof(log_ring_arg_t);
+		switch (conv.type) {
+			case LOG_ARG_INT:		pArg->u = (U64)(S64)va_arg(args, int); break;
+			case LOG_ARG_LONG:		pArg->u = (U64)(S64)va_arg(args, long); break;
+			case LOG_ARG_LLONG:		pArg->u = (U64)va_arg(args, long long); break;
+			case LOG_ARG_INTMAX:	pArg->u = (U64)va_arg(args, intmax_t); break;
+			case LOG_ARG_SIZE:		pArg->u = (U64)va_arg(args, size_t); break;
+			case LOG_ARG_PTRDIFF:	pArg->u = (U64)va_arg(args, ptrdiff_t); break;
+			case LOG_ARG_DOUBLE:	pArg->d = va_arg(args, double); break;
+			case LOG_ARG_PTR:		pArg->u = (U64)(uintptr_t)va_arg(args, void *); break;
+			case LOG_ARG_STR:
+				{
+					const char *pStr = va_arg(args, const char *);
+					if (!pStr) {
+						pArg->u = LOG_RING_STR_NULL;
+						break;
+					}
+					// Copy as much of the string as is used and fits, leaving room for the NUL.
+					// A record without room for even the NUL goes through the locked path.
+					if (pOut >= pEnd - 1)
+						return 0;
+					size_t maxLen = pEnd - pOut - 1;
+					if (precision >= 0 && (size_t)precision < maxLen)
+						maxLen = precision;
+					size_t len = 0;
+					while (len < maxLen && pStr[len])
+						len++;
+					memcpy(pOut, pStr, len);
+					pOut[len] = 0x00;
+					pArg->u = len;
+					pOut += LOG_RING_ALIGN(len + 1);
+					if (pOut > pEnd)
+						pOut = pEnd;
+				}
+				break;
+			default:
+				return 0;
+		}
+	}
+
+	return pOut - (U8 *)pRec;
+}
+
+// Appends len characters of literal format text, converting "%%" to "%".
+static size_t x_logAppendLiteral(char *pMsg, size_t msgSize, size_t used, const char *pText, size_t len)
+{
+	size_t i;
+	for (i = 0; i < len && used + 1 < msgSize; i++) {
+		pMsg[used++] = pText[i];
+		if (pText[i] == '%' && i + 1 < len && pText[i + 1] == '%')
+			i++;
+	}
+	pMsg[used] = 0x00;
+	return used;
+}
+
+#define LOG_RING_PRINT(VAL)																\
+	(conv.starCnt == 0 ? snprintf(pMsg + used, msgSize - used, spec, VAL) :				\
+	 conv.starCnt == 1 ? snprintf(pMsg + used, msgSize - used, spec, star[0], VAL) :		\
+	 snprintf(pMsg + used, msgSize - used, spec, star[0], star[1], VAL))
+
+// Formats the message held in a ring record.
+static void x_logRingRender(const log_ring_rec_t *pRec, char *pMsg, size_t msgSize)
+{
+	const U8 *pIn = (const U8 *)pRec + pRec->argsOffset;
+	const char *pLiteral = LOG_RING_REC_STR(pRec, pRec->formatOffset);
+	const char *p = pLiteral;
+	char spec[LOG_CONV_SPEC_LEN];
+	size_t used = 0;
+	log_conv_t conv;
+
+	pMsg[0] = 0x00;
+	while ((p = x_logNextConv(p, &conv)) != NULL) {
+		int star[2] = { 0, 0 };
+		int i, len = 0;
+
+		used = x_logAppendLiteral(pMsg, msgSize, used, pLiteral, conv.pStart - pLiteral);
+		pLiteral = p;
+
+		memcpy(spec, conv.pStart, conv.len);
+		spec[conv.len] = 0x00;
+
+		for (i = 0; i < conv.starCnt; i++) {
+			star[i] = (int)((const log_ring_arg_t *)pIn)->u;
+			pIn += sizeof(log_ring_arg_t);
+		}
+
+		const log_ring_arg_t *pArg = (const log_ring_arg_t *)pIn;
+		pIn += sizeof(log_ring_arg_t);
+		switch (conv.type) {
+			case LOG_ARG_INT:		len = LOG_RING_PRINT((int)pArg->u); break;
+			case LOG_ARG_LONG:		len = LOG_RING_PRINT((long)pArg->u); break;
+			case LOG_ARG_LLONG:		len = LOG_RING_PRINT((long long)pArg->u); break;
+			case LOG_ARG_INTMAX:	len = LOG_RING_PRINT((intmax_t)pArg->u); break;
+			case LOG_ARG_SIZE:		len = LOG_RING_PRINT((size_t)pArg->u); break;
+			case LOG_ARG_PTRDIFF:	len = LOG_RING_PRINT((ptrdiff_t)pArg->u); break;
+			case LOG_ARG_DOUBLE:	len = LOG_RING_PRINT(pArg->d); break;
+			case LOG_ARG_PTR:		len = LOG_RING_PRINT((void *)(uintptr_t)pArg->u); break;
+			case LOG_ARG_STR:
+				if (pArg->u == LOG_RING_STR_NULL) {
+					len = LOG_RING_PRINT((const char *)NULL);
+				}
+				else {
+					len = LOG_RING_PRINT((const char *)pIn);
+					pIn += LOG_RING_ALIGN(pArg->u + 1);
+				}
+				break;
+			default:
+				// Not recorded by x_logRingEncode()
+				return;
+		}
+		if (len > 0)
+			used += ((size_t)len < msgSize - used) ? (size_t)len : msgSize - used - 1;
+	}
+	x_logAppendLiteral(pMsg, msgSize, used, pLiteral, strlen(pLiteral));
+}
+
+// Returns the ring owned by the calling thread, claiming one if needed. Returns NULL if none is available.
+static log_ring_t *x_logRingGet(void)
+{
+	log_ring_t *pRing = (log_ring_t *)THREAD_KEY_GET(logRingKey);
+	if (pRing)
+		return pRing;
+
+	// Reuse a ring released by a thread that has exited.
+	for (pRing = ATOMIC_LOAD_ACQUIRE(&logRingList); pRing; pRing = pRing->pNext) {
+		U32 expected = FALSE;
+		if (ATOMIC_CAS(&pRing->inUse, &expected, TRUE))
+			break;
+	}
+
+	if (!pRing) {
+		pRing = calloc(1, sizeof(log_ring_t));
+		if (!pRing)
+			return NULL;
+		pRing->inUse = TRUE;
+		pRing->pNext = ATOMIC_LOAD_RELAXED(&logRingList);
+		while (!ATOMIC_CAS(&logRingList, &pRing->pNext, pRing));
+	}
+
+	pRing->threadId = (unsigned long)THREAD_SELF();
+	THREAD_KEY_SET(logRingKey, pRing);
+	return pRing;
+}
+
+// Thread exit destructor for the ring key.
+static void x_logRingRelease(void *pv)
+{
+	log_ring_t *pRing = (log_ring_t *)pv;
+	ATOMIC_STORE_RELEASE(&pRing->inUse, FALSE);
+}
+
+// Copies a record into the ring of the calling thread. Producer side only.
+static void x_logRingWrite(log_ring_t *pRing, const log_ring_rec_t *pRec)
+{
+	U32 head = pRing->head;
+	U32 offset = head & (LOG_RING_SIZE - 1);
+	U32 contiguous = LOG_RING_SIZE - offset;
+	U32 needed = pRec->size;
+
+	// Records are never split. If there is not enough room before the end of the ring,
+	// the remaining space is filled with a padding record.
+	if (contiguous < pRec->size)
+		needed += contiguous;
+
+	if (head - pRing->tailCache + needed > LOG_RING_SIZE) {
+		pRing->tailCache = ATOMIC_LOAD_ACQUIRE(&pRing->tail);
+		if (head - pRing->tailCache + needed > LOG_RING_SIZE) {
+			// Full
+			ATOMIC_STORE_RELAXED(&pRing->dropped, pRing->dropped + 1);
+			return;
+		}
+	}
+
+	U8 *pData = (U8 *)pRing->data;
+	if (contiguous < pRec->size) {
+		log_ring_rec_t *pPad = (log_ring_rec_t *)(pData + offset);
+		pPad->size = contiguous;
+		pPad->bPad = TRUE;
+		offset = 0;
+	}
+	memcpy(pData + offset, pRec, pRec->size);
+
+	ATOMIC_STORE_RELEASE(&pRing->head, head + needed);
+}
+
+// Returns the next record of the current pass, or NULL if there is none. Consumer side only.
+static log_ring_rec_t *x_logRingPeek(log_ring_t *pRing)
+{
+	while (pRing->tail != pRing->passHead) {
+		log_ring_rec_t *pRec = (log_ring_rec_t *)((U8 *)pRing->data + (pRing->tail & (LOG_RING_SIZE - 1)));
+		if (!pRec->bPad)
+			return pRec;
+		ATOMIC_STORE_RELEASE(&pRing->tail, pRing->tail + pRec->size);
+	}
+	return NULL;
+}
+
+// Outputs the records in all of the rings, merged in time order. Logging thread only.
+static bool x_logRingDrain(void)
+{
+	log_ring_t *pRing;
+	bool output = FALSE;
+
+	// Only process the records already written, so a busy producer cannot keep the logging thread here.
+	for (pRing = ATOMIC_LOAD_ACQUIRE(&logRingList); pRing; pRing = pRing->pNext)
+		pRing->passHead = ATOMIC_LOAD_ACQUIRE(&pRing->head);
+
+	while (TRUE) {
+		log_ring_t *pBestRing = NULL;
+		log_ring_rec_t *pBest = NULL;
+
+		for (pRing = ATOMIC_LOAD_ACQUIRE(&logRingList); pRing; pRing = pRing->pNext) {
+			log_ring_rec_t *pRec = x_logRingPeek(pRing);
+			if (pRec && (!pBest ||
+					pRec->nowTS.tv_sec < pBest->nowTS.tv_sec ||
+					(pRec->nowTS.tv_sec == pBest->nowTS.tv_sec && pRec->nowTS.tv_nsec < pBest->nowTS.tv_nsec))) {
+				pBest = pRec;
+				pBestRing = pRing;
+			}
+		}
+		if (!pBest)
+			break;
+
+		x_logRingRender(pBest, ring_msg, sizeof(ring_msg));
+		x_logFormatFull(ring_full_msg, ring_msg, &pBest->nowTS, pBest->threadId,
+			LOG_RING_REC_STR(pBest, pBest->tagOffset), LOG_RING_REC_STR(pBest, pBest->companyOffset),
+			LOG_RING_REC_STR(pBest, pBest->componentOffset), LOG_RING_REC_STR(pBest, pBest->fileOffset), pBest->line);
+		fputs(ring_full_msg, logOutputFd);
+		output = TRUE;
+
+		ATOMIC_STORE_RELEASE(&pBestRing->tail, pBestRing->tail + pBest->size);
+	}
+
+	// Report any messages lost since the last pass.
+	for (pRing = ATOMIC_LOAD_ACQUIRE(&logRingList); pRing; pRing = pRing->pNext) {
+		U32 dropped = ATOMIC_LOAD_RELAXED(&pRing->dropped);
+		if (dropped != pRing->droppedReported) {
+			struct timespec nowTS;
+			CLOCK_GETTIME(OPENAVB_CLOCK_REALTIME, &nowTS);
+			snprintf(ring_msg, sizeof(ring_msg), "Log ring of thread %lu was full, %u messages dropped",
+				pRing->threadId, dropped - pRing->droppedReported);
+			x_logFormatFull(ring_full_msg, ring_msg, &nowTS, pRing->threadId,
+				"WARNING", AVB_LOG_COMPANY, AVB_LOG_COMPONENT, __FILE__, __LINE__);
+			fputs(ring_full_msg, logOutputFd);
+			pRing->droppedReported = dropped;
+			output = TRUE;
+		}
+	}
+
+	return output;
+}
+
+// Records a log message in the ring of the calling thread. Returns FALSE if the message must be
+// output through the locked path instead.
+static bool x_logRingLog(const char *tag, const char *company, const char *component, const char *path,
+	int line, const char *fmt, va_list args)
+{
+	U64 recBuf[LOG_RING_REC_MAX / sizeof(U64)];
+	log_ring_rec_t *pRec = (log_ring_rec_t *)recBuf;
+	log_ring_t *pRing;
+	va_list argsCopy;
+	const char *file;
+	U32 offset = LOG_RING_HDR_SIZE;
+	size_t fmtLen = strlen(fmt);
+
+	if (!logRingOn || fmtLen > LOG_RING_FMT_MAX || !(pRing = x_logRingGet()))
+		return FALSE;
+
+	// Only the file name of the path is shown.
+	file = path ? strrchr(path, '/') : NULL;
+	if (!file && path)
+		file = strrchr(path, '\\');
+	file = file ? file + 1 : path;
+
+	pRec->formatOffset = x_logRingPutStr(pRec, &offset, fmt, fmtLen);
+	pRec->tagOffset = x_logRingPutStr(pRec, &offset, tag, LOG_RING_NAME_MAX);
+	pRec->companyOffset = x_logRingPutStr(pRec, &offset, company, LOG_RING_NAME_MAX);
+	pRec->componentOffset = x_logRingPutStr(pRec, &offset, component, LOG_RING_NAME_MAX);
+	pRec->fileOffset = x_logRingPutStr(pRec, &offset, file, LOG_RING_NAME_MAX);
+	pRec->argsOffset = offset;
+
+	va_copy(argsCopy, args);
+	pRec->size = x_logRingEncode(pRec, fmt, argsCopy);
+	va_end(argsCopy);
+	if (!pRec->size)
+		return FALSE;
+
+	pRec->bPad = FALSE;
+	pRec->line = line;
+	pRec->threadId = (unsigned long)THREAD_SELF();
+	CLOCK_GETTIME(OPENAVB_CLOCK_REALTIME, &pRec->nowTS);
+
+	x_logRingWrite(pRing, pRec);
+	return TRUE;
+}
+
+extern U32 DLL_EXPORT avbLogGetDropCount(void)
+{
+	log_ring_t *pRing;
+	U32 dropped = 0;
+
+	for (pRing = ATOMIC_LOAD_ACQUIRE(&logRingList); pRing; pRing = pRing->pNext)
+		dropped += ATOMIC_LOAD_RELAXED(&pRing->dropped);
+	return dropped;
+}
+
 void avbLogRTRender(log_queue_item_t *pLogItem)
 {
 	if (logRTQueue) {
@@ -191,6 +790,8 @@ void *loggingThreadFn(void *pv)
 				flush = TRUE;
 			}
 		}
+		if (x_logRingDrain())
+			flush = TRUE;
 		if (flush)
 			fflush(logOutputFd);
 	} while (loggingThreadRunning);
@@ -224,6 +825,16 @@ extern void DLL_EXPORT avbLogInitEx(FILE* file)
 		THREAD_CREATE(loggingThread, loggingThread, NULL, loggingThreadFn, NULL);
 		THREAD_CHECK_ERROR(loggingThread, "Thread / task creation failed", errResult);
 		if (errResult);		// Already reported
+
+		// The per thread rings are only used when there is a logging thread to output them.
+		if (OPENAVB_LOG_RING && !OPENAVB_LOG_PULL_MODE && !errResult) {
+			if (THREAD_KEY_CREATE(logRingKey, x_logRingRelease) == 0) {
+				logRingOn = TRUE;
+			}
+			else {
+				printf("Failed to initialize logging ring facility\n");
+			}
+		}
 	}
 }
 
@@ -234,6 +845,10 @@ extern void DLL_EXPORT avbLogInit(void)
 
 extern void DLL_EXPORT avbLogExit()
 {
+	// Log messages from any remaining threads now use the locked path. The final pass of the
+	// logging thread outputs what is left in the rings, which are kept as other threads may still hold them.
+	logRingOn = FALSE;
+
 	if (OPENAVB_LOG_FROM_THREAD) {
 		loggingThreadRunning = false;
 		THREAD_JOIN(loggingThread, NULL);
@@ -254,45 +869,18 @@ void __avbLogFn(
 	va_list args)
 {
 	if (level <= AVB_LOG_LEVEL) {
+		if (x_logRingLog(tag, company, component, path, line, fmt, args))
+			return;
+
 		LOG_LOCK();
 
 		vsprintf(msg, fmt, args);
 
-		if (OPENAVB_LOG_FILE_INFO && path) {
-			char* file = strrchr(path, '/');
-			if (!file)
-				file = strrchr(path, '\\');
-			if (file)
-				file += 1;
-			else
-				file = (char*)path;
-			snprintf(file_msg, LOG_FILE_LEN, " %s:%d", file, line);
-		}
-		if (OPENAVB_LOG_PROC_INFO) {
-			snprintf(proc_msg, LOG_PROC_LEN, " P:%5.5d", GET_PID());
-		}
-		if (OPENAVB_LOG_THREAD_INFO) {
-			snprintf(thread_msg, LOG_THREAD_LEN, " T:%lu", THREAD_SELF());
-		}
-		if (OPENAVB_LOG_TIME_INFO) {
-			time_t tNow = time(NULL);
-			struct tm tmNow;
-			localtime_r(&tNow, &tmNow);
-
-			snprintf(time_msg, LOG_TIME_LEN, "%2.2d:%2.2d:%2.2d", tmNow.tm_hour, tmNow.tm_min, tmNow.tm_sec);
-		}
-		if (OPENAVB_LOG_TIMESTAMP_INFO) {
-			struct timespec nowTS;
+		struct timespec nowTS = { 0, 0 };
+		if (OPENAVB_LOG_TIME_INFO || OPENAVB_LOG_TIMESTAMP_INFO) {
 			CLOCK_GETTIME(OPENAVB_CLOCK_REALTIME, &nowTS);
-
-			snprintf(timestamp_msg, LOG_TIMESTAMP_LEN, "%lu:%09lu", nowTS.tv_sec, nowTS.tv_nsec);
 		}
-
-		// using sprintf and puts allows using static buffers rather than heap.
-		if (OPENAVB_TCAL_LOG_EXTRA_NEWLINE)
-			/* S32 full_msg_len = */ snprintf(full_msg, LOG_FULL_MSG_LEN, "[%s%s%s%s %s %s%s] %s: %s\n", time_msg, timestamp_msg, proc_msg, thread_msg, company, component, file_msg, tag, msg);
-		else
-			/* S32 full_msg_len = */ snprintf(full_msg, LOG_FULL_MSG_LEN, "[%s%s%s%s %s %s%s] %s: %s", time_msg, timestamp_msg, proc_msg, thread_msg, company, component, file_msg, tag, msg);
+		x_logFormatFull(full_msg, msg, &nowTS, (unsigned long)THREAD_SELF(), tag, company, component, path, line);
 
 		if (!OPENAVB_LOG_FROM_THREAD && !OPENAVB_LOG_PULL_MODE) {
 			fputs(full_msg, logOutputFd);
@@ -8,6 +8,7 @@
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <sched.h>
 
 /**
  * @brief Open the memory mapping used for IPC
@@ -26,7 +27,9 @@ int gptpinit(int *shm_fd, char **shm_map)
 		perror("shm_open()");
 		return -1;
 	}
-	*shm_map = (char *)mmap(NULL, SHM_SIZE, PROT_READ | PROT_WRITE,
+	/* Map the seqlock region as well. It shares the first page with the
+	 * legacy region, so this is safe against segments sized by old daemons. */
+	*shm_map = (char *)mmap(NULL, SHM_SEQLOCK_SIZE, PROT_READ | PROT_WRITE,
 				MAP_SHARED, *shm_fd, 0);
 	if ((char*)-1 == *shm_map) {
 		perror("mmap()");
@@ -61,7 +64,7 @@ int gptpdeinit(int *shm_fd, char **shm_map)
 	if (NULL == shm_map || NULL == *shm_map) {
 		ret -= 2;
 	} else {
-		if (munmap(*shm_map, SHM_SIZE) == -1) {
+		if (munmap(*shm_map, SHM_SEQLOCK_SIZE) == -1) {
 			ret -= 2;
 		}
 		*shm_map = NULL;
@@ -88,6 +91,107 @@ int gptpgetdata(char *shm_map, gPtpTimeData *td)
 	return 0;
 }
 
+/**
+ * @brief Write the ptp data to IPC memory
+ *
+ * Updates both the mutex protected copy read by old clients and the seqlock
+ * copy. The segment must be at least SHM_SEQLOCK_SIZE bytes.
+ * @param shm_map [in] Pointer to mapping
+ * @param td [in] Data to publish
+ * @return 0 for success, negative for failure
+ */
+
+int gptpsetdata(char *shm_map, const gPtpTimeData *td)
+{
+	gPtpSeqlockData *sl;
+	uint32_t seq;
+
+	if (NULL == shm_map || NULL == td) {
+		return -1;
+	}
+	pthread_mutex_lock((pthread_mutex_t *) shm_map);
+	memcpy(shm_map + sizeof(pthread_mutex_t), td, sizeof(*td));
+
+	sl = (gPtpSeqlockData *)(shm_map + SHM_SEQLOCK_OFFSET);
+	seq = __atomic_load_n(&sl->seq, __ATOMIC_RELAXED);
+	__atomic_store_n(&sl->seq, seq | 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&sl->td, td, sizeof(*td));
+	__atomic_store_n(&sl->seq, (seq | 1) + 1, __ATOMIC_RELEASE);
+	if (__atomic_load_n(&sl->magic, __ATOMIC_RELAXED) != GPTP_SEQLOCK_MAGIC) {
+		sl->version = GPTP_SEQLOCK_VERSION;
+		__atomic_store_n(&sl->magic, GPTP_SEQLOCK_MAGIC, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock((pthread_mutex_t *) shm_map);
+
+	return 0;
+}
+
+/**
+ * @brief Check whether the daemon publishes the seqlock copy
+ * @param shm_map [in] Pointer to mapping
+ * @return true if gptpgetdata_seqlock() may be used
+ */
+
+bool gptphasseqlock(const char *shm_map)
+{
+	const gPtpSeqlockData *sl;
+
+	if (NULL == shm_map) {
+		return false;
+	}
+	sl = (const gPtpSeqlockData *)(shm_map + SHM_SEQLOCK_OFFSET);
+	return __atomic_load_n(&sl->magic, __ATOMIC_ACQUIRE) == GPTP_SEQLOCK_MAGIC
+		&& sl->version == GPTP_SEQLOCK_VERSION;
+}
+
+/**
+ * @brief Read the seqlock sequence number
+ *
+ * The value changes on every update, so callers can keep a copy of the data
+ * and only re-read it when this differs from the sequence it was read at.
+ * @param shm_map [in] Pointer to mapping
+ * @return Current sequence, odd while an update is in progress
+ */
+
+uint32_t gptpgetseq(const char *shm_map)
+{
+	const gPtpSeqlockData *sl = (const gPtpSeqlockData *)(shm_map + SHM_SEQLOCK_OFFSET);
+	return __atomic_load_n(&sl->seq, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Read the ptp data from IPC memory without taking the mutex
+ * @param shm_map [in] Pointer to mapping
+ * @param td [inout] Struct to read the data into
+ * @param seq [out] Sequence the data was read at, may be NULL
+ * @return 0 for success, negative for failure
+ */
+
+int gptpgetdata_seqlock(const char *shm_map, gPtpTimeData *td, uint32_t *seq)
+{
+	const gPtpSeqlockData *sl;
+	uint32_t seq1, seq2;
+
+	if (NULL == shm_map || NULL == td) {
+		return -1;
+	}
+	sl = (const gPtpSeqlockData *)(shm_map + SHM_SEQLOCK_OFFSET);
+	do {
+		while ((seq1 = __atomic_load_n(&sl->seq, __ATOMIC_ACQUIRE)) & 1) {
+			sched_yield();
+		}
+		memcpy(td, &sl->td, sizeof(*td));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		seq2 = __atomic_load_n(&sl->seq, __ATOMIC_RELAXED);
+	} while (seq1 != seq2);
+
+	if (seq) {
+		*seq = seq1;
+	}
+	return 0;
+}
+
 /**
  * @brief Read the ptp data from IPC memory and print its contents
  * @param shm_map [in] Pointer to mapping
@@ -2,6 +2,8 @@
 #define __AVB_GPTP_H__
 
 #include <inttypes.h>
+#include <stddef.h>
+#include <pthread.h>
 
 #define SHM_SIZE (4*8 + sizeof(pthread_mutex_t)) /* 3 - 64 bit and 2 - 32 bits */
 #define SHM_NAME  "/ptp"
@@ -35,6 +37,32 @@ typedef struct {
 	uint16_t port_number;					/* The portNumber field of the interface, or 0x0000 if not supported */
 } gPtpTimeData;
 
+/*
+ * Lock-free copy of gPtpTimeData published by newer daemons after the legacy
+ * mutex protected region. The writer makes seq odd, updates td and then makes
+ * seq even again; readers retry while seq is odd or changed under them.
+ * Old daemons never write here, so magic reads as 0 and readers fall back to
+ * the mutex path.
+ *
+ * The gPTP daemon is maintained outside this tree and does not publish
+ * through gptpsetdata() yet, so the mutex path (gptpgetdata()) remains the
+ * default. The seqlock copy is only read once a daemon sizes its segment to
+ * SHM_SEQLOCK_SIZE and publishes with gptpsetdata().
+ */
+#define GPTP_SEQLOCK_MAGIC   0x50545053	/* "PTPS" */
+#define GPTP_SEQLOCK_VERSION 1
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t seq;
+	uint32_t reserved;
+	gPtpTimeData td;
+} gPtpSeqlockData;
+
+#define SHM_SEQLOCK_OFFSET ((sizeof(pthread_mutex_t) + sizeof(gPtpTimeData) + 63) & ~(size_t)63)
+#define SHM_SEQLOCK_SIZE (SHM_SEQLOCK_OFFSET + sizeof(gPtpSeqlockData))
+
 /*TODO fix this*/
 #ifndef false
 typedef enum { false = 0, true = 1 } bool;
@@ -43,6 +71,10 @@ typedef enum { false = 0, true = 1 } bool;
 int gptpinit(int *shm_fd, char **shm_map);
 int gptpdeinit(int *shm_fd, char **shm_map);
 int gptpgetdata(char *shm_mmap, gPtpTimeData *td);
+int gptpsetdata(char *shm_mmap, const gPtpTimeData *td);
+bool gptphasseqlock(const char *shm_mmap);
+uint32_t gptpgetseq(const char *shm_mmap);
+int gptpgetdata_seqlock(const char *shm_mmap, gPtpTimeData *td, uint32_t *seq);
 int gptpscaling(char *shm_mmap, gPtpTimeData *td);
 bool gptplocaltime(const gPtpTimeData * td, uint64_t* now_local);
 bool gptpmaster2local(const gPtpTimeData *td, const uint64_t master, uint64_t *local);
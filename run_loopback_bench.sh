@@ -0,0 +1,81 @@
+#!/bin/bash
+
+# Loopback benchmark of the AVTP Pipeline.
+# Talkers and listeners run in two openavb_harness instances on the ends of a veth pair, once for
+# every rawsock backend. One JSON object per stream and backend is written to stdout.
+# The AVTP Pipeline must be built without SRP support (AVB_FEATURE_ENDPOINT=0 make avtp_pipeline).
+# For more details, refer to the lib/avtp_pipeline/README.md file.
+
+usage() {
+	echo "Usage: sudo $0 [-s streams] [-t seconds] [-b backends] [-m null|tonegen]"
+	echo "  -s  Number of talker and listener streams. Defaults to 1."
+	echo "  -t  Seconds to measure each backend. Defaults to 10."
+	echo "  -b  Space separated list of rawsock backends. Defaults to \"simple ring sendmmsg pcap\"."
+	echo "  -m  Media source of the talkers. Defaults to null."
+	echo ""
+}
+
+streams=1
+seconds=10
+backends="simple ring sendmmsg pcap"
+source=null
+
+while getopts "s:t:b:m:h" opt; do
+	case $opt in
+		s) streams=$OPTARG ;;
+		t) seconds=$OPTARG ;;
+		b) backends=$OPTARG ;;
+		m) source=$OPTARG ;;
+		*) usage; exit -1 ;;
+	esac
+done
+
+if [ "$(id -u)" != "0" ]; then
+	usage
+	exit -1
+fi
+
+common="max_transit_usec=2000,report_seconds=0"
+case $source in
+	null)
+		talker_ini="null_talker.ini,$common"
+		listener_ini="null_listener.ini,$common"
+		;;
+	tonegen)
+		talker_ini="tonegen_talker.ini,$common"
+		listener_ini="aaf_listener.ini,$common,map_nv_tx_rate=8000,map_nv_packing_factor=1,intf_nv_device_name=null,intf_nv_audio_bit_depth=16"
+		;;
+	*)
+		usage
+		exit -1
+		;;
+esac
+
+scriptdir="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+logdir=$(mktemp -d)
+veth_talker=avbbench0
+veth_listener=avbbench1
+
+ip link add $veth_talker type veth peer name $veth_listener || exit -1
+trap "ip link del $veth_talker; rm -rf $logdir" EXIT
+ip link set $veth_talker up
+ip link set $veth_listener up
+mac=$(cat /sys/class/net/$veth_talker/address)
+
+cd $scriptdir/lib/avtp_pipeline/build/bin
+
+for backend in $backends; do
+	echo "Benchmarking $backend on $veth_talker/$veth_listener" >&2
+
+	# Start the listeners first so their measurement falls within the talkers' run
+	./openavb_harness -b $seconds -s $streams -d 0 -a $mac -I $backend:$veth_listener -l $logdir/listener_$backend.log \
+		$listener_ini > $logdir/listener_$backend.out &
+	listener_pid=$!
+	sleep 1
+	./openavb_harness -b $seconds -s $streams -d 0 -a $mac -I $backend:$veth_talker -l $logdir/talker_$backend.log \
+		$talker_ini > $logdir/talker_$backend.out
+	wait $listener_pid
+
+	grep -h '^{' $logdir/talker_$backend.out $logdir/listener_$backend.out | \
+		sed "s/^{/{\"backend\":\"$backend\",\"source\":\"$source\",\"streams\":$streams,/"
+done